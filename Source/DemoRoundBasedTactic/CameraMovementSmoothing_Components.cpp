@@ -3,69 +3,99 @@
 
 
 #include "CameraMovementSmoothing_Components.h"
+#include "SmoothingMath.h"
+#include "Engine/World.h"
 
 
-/** Helper: compute the decay coefficient for the given half-life and step. */
-static FORCEINLINE float HalfLifeDecayK(float HalfLife, float Dt)
+/** Velocity of a target that moved linearly from Prev to Desire during DeltaTime. */
+template <typename T>
+static T DesireVelocity(const T& Prev, const T& Desire, float DeltaTime)
 {
-	if (HalfLife <= 0.f) return 0.f; // snap to target in one step
-	return FMath::Pow(0.5f, Dt / HalfLife);
+	return DeltaTime > 0.f ? (Desire - Prev) * (1.f / DeltaTime) : T(0);
 }
 
 float UCameraMovement_ExpHalfLifeComponent::Update1D(float DeltaTime)
 {
-	const float K = HalfLifeDecayK(HalfLife, DeltaTime);
-	Current1D = Desire1D + (Current1D - Desire1D) * K;
+	if (bExactMovingTarget)
+	{
+		Current1D = SmoothingMath::ExpSmoothExact(Current1D, PrevDesire1D, DesireVelocity(PrevDesire1D, Desire1D, DeltaTime), HalfLife, DeltaTime);
+	}
+	else
+	{
+		const float K = SmoothingMath::HalfLifeDecayK(HalfLife, DeltaTime);
+		Current1D = Desire1D + (Current1D - Desire1D) * K;
+	}
+	PrevDesire1D = Desire1D;
 	return Current1D;
 }
 
 FVector2D UCameraMovement_ExpHalfLifeComponent::Update2D(float DeltaTime)
 {
-	const float K = HalfLifeDecayK(HalfLife, DeltaTime);
-	Current2D = Desire2D + (Current2D - Desire2D) * K;
+	if (bExactMovingTarget)
+	{
+		Current2D = SmoothingMath::ExpSmoothExact(Current2D, PrevDesire2D, DesireVelocity(PrevDesire2D, Desire2D, DeltaTime), HalfLife, DeltaTime);
+	}
+	else
+	{
+		const float K = SmoothingMath::HalfLifeDecayK(HalfLife, DeltaTime);
+		Current2D = Desire2D + (Current2D - Desire2D) * K;
+	}
+	PrevDesire2D = Desire2D;
 	return Current2D;
 }
 
-/** Advance a critically damped spring (1D) for one step. The target is treated as constant during the step. */
-static FORCEINLINE void SpringUpdate1D(float HalfLife, float Dt, float Desire, float& Current, float& Velocity)
+float UCameraMovement_SpringHalfLifeComponent::Update1D(float DeltaTime)
 {
-	if (HalfLife <= 0.f)
+	if (bExactMovingTarget)
+	{
+		SmoothingMath::SpringUpdateExact(HalfLife, DeltaTime, PrevDesire1D, DesireVelocity(PrevDesire1D, Desire1D, DeltaTime), Current1D, Velocity1D);
+	}
+	else
 	{
-		Current = Desire; Velocity = 0.f; return;
+		SmoothingMath::SpringUpdate1D(HalfLife, DeltaTime, Desire1D, Current1D, Velocity1D);
 	}
-	const float W = FMath::Loge(2.f) / HalfLife;
-	const float E = FMath::Exp(-W * Dt);
-	float y = Current - Desire;
-	const float j = Velocity + W * y;
-	y = (y + j * Dt) * E;
-	Velocity = (Velocity - W * j * Dt) * E;
-	Current = Desire + y;
+	PrevDesire1D = Desire1D;
+	return Current1D;
 }
 
-/** Advance a critically damped spring (2D) for one step. Each component is updated independently. */
-static FORCEINLINE void SpringUpdate2D(float HalfLife, float Dt, const FVector2D& Desire, FVector2D& Current, FVector2D& Velocity)
+FVector2D UCameraMovement_SpringHalfLifeComponent::Update2D(float DeltaTime)
 {
-	if (HalfLife <= 0.f)
+	if (bExactMovingTarget)
 	{
-		Current = Desire; Velocity = FVector2D::ZeroVector; return;
+		SmoothingMath::SpringUpdateExact(HalfLife, DeltaTime, PrevDesire2D, DesireVelocity(PrevDesire2D, Desire2D, DeltaTime), Current2D, Velocity2D);
 	}
-	const float W = FMath::Loge(2.f) / HalfLife;
-	const float E = FMath::Exp(-W * Dt);
-	FVector2D y = Current - Desire;
-	const FVector2D j = Velocity + y * W;
-	y = (y + j * Dt) * E;
-	Velocity = (Velocity - j * (W * Dt)) * E;
-	Current = Desire + y;
+	else
+	{
+		SmoothingMath::SpringUpdate2D(HalfLife, DeltaTime, Desire2D, Current2D, Velocity2D);
+	}
+	PrevDesire2D = Desire2D;
+	return Current2D;
 }
 
-float UCameraMovement_SpringHalfLifeComponent::Update1D(float DeltaTime)
+void UCameraMovement_ExpHalfLifeComponent::BeginPlay()
 {
-	SpringUpdate1D(HalfLife, DeltaTime, Desire1D, Current1D, Velocity1D);
-	return Current1D;
+	Super::BeginPlay();
+	PrevDesire1D = Desire1D;
+	PrevDesire2D = Desire2D;
+	UHalfLifeSmoothingSubsystem::RegisterBatched(this, BatchHandle);
 }
 
-FVector2D UCameraMovement_SpringHalfLifeComponent::Update2D(float DeltaTime)
+void UCameraMovement_ExpHalfLifeComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	SpringUpdate2D(HalfLife, DeltaTime, Desire2D, Current2D, Velocity2D);
-	return Current2D;
+	UHalfLifeSmoothingSubsystem::UnregisterBatched(this, BatchHandle);
+	Super::EndPlay(EndPlayReason);
+}
+
+void UCameraMovement_SpringHalfLifeComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	PrevDesire1D = Desire1D;
+	PrevDesire2D = Desire2D;
+	UHalfLifeSmoothingSubsystem::RegisterBatched(this, BatchHandle);
+}
+
+void UCameraMovement_SpringHalfLifeComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UHalfLifeSmoothingSubsystem::UnregisterBatched(this, BatchHandle);
+	Super::EndPlay(EndPlayReason);
 }
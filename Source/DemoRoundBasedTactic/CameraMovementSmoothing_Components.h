@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "HalfLifeSmoothingSubsystem.h"
 #include "CameraMovementSmoothing_Components.generated.h"
 
 /**
@@ -27,6 +28,22 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Params")
 	float HalfLife = 0.15f;
 
+	/**
+	 * Opt-in: let UHalfLifeSmoothingSubsystem advance both the 1D and 2D state once per frame
+	 * (after actor ticks) instead of calling Update* manually. Do not call Update* when enabled.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Params")
+	bool bUseBatchedUpdate = false;
+
+	/**
+	 * Exact integration for moving targets: Desire is treated as moving linearly from its value at
+	 * the previous Update to its current value, and the step is integrated in closed form.
+	 * The result then does not depend on frame time (one long frame equals many short ones).
+	 * Ignored by the batched update.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Params")
+	bool bExactMovingTarget = false;
+
 	/** Target position/value the camera should converge to (1D). */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "State|1D")
 	float Desire1D = 0.f;
@@ -59,11 +76,26 @@ public:
 
 	/** Instantly set Current1D to Desire1D (no smoothing). */
 	UFUNCTION(BlueprintCallable, Category = "CameraMovement|ExpHalfLife|Utilities")
-	void Snap1D() { Current1D = Desire1D; }
+	void Snap1D() { Current1D = PrevDesire1D = Desire1D; }
 
 	/** Instantly set Current2D to Desire2D (no smoothing). */
 	UFUNCTION(BlueprintCallable, Category = "CameraMovement|ExpHalfLife|Utilities")
-	void Snap2D() { Current2D = Desire2D; }
+	void Snap2D() { Current2D = PrevDesire2D = Desire2D; }
+
+	/** Handle in UHalfLifeSmoothingSubsystem while bUseBatchedUpdate is active (see GetSmoothedValue). */
+	UFUNCTION(BlueprintPure, Category = "CameraMovement|ExpHalfLife|Utilities")
+	FHalfLifeSmootherHandle GetBatchHandle() const { return BatchHandle; }
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	FHalfLifeSmootherHandle BatchHandle;
+
+	/** Desire at the previous Update, the start of the linear target motion (bExactMovingTarget). */
+	float PrevDesire1D = 0.f;
+	FVector2D PrevDesire2D = FVector2D::ZeroVector;
 };
 
 /**
@@ -87,6 +119,22 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Params")
 	float HalfLife = 0.25f;
 
+	/**
+	 * Opt-in: let UHalfLifeSmoothingSubsystem advance both the 1D and 2D state once per frame
+	 * (after actor ticks) instead of calling Update* manually. Do not call Update* when enabled.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Params")
+	bool bUseBatchedUpdate = false;
+
+	/**
+	 * Exact integration for moving targets: Desire is treated as moving linearly from its value at
+	 * the previous Update to its current value, and the step is integrated in closed form.
+	 * The result then does not depend on frame time (one long frame equals many short ones).
+	 * Ignored by the batched update.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Params")
+	bool bExactMovingTarget = false;
+
 	/** Target value (1D). */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "State|1D")
 	float Desire1D = 0.f;
@@ -121,9 +169,24 @@ public:
 
 	/** Instantly set Current1D to Desire1D and reset velocity. */
 	UFUNCTION(BlueprintCallable, Category = "CameraMovement|SpringHalfLife|Utilities")
-	void Snap1D() { Current1D = Desire1D; Velocity1D = 0.f; }
+	void Snap1D() { Current1D = PrevDesire1D = Desire1D; Velocity1D = 0.f; }
 
 	/** Instantly set Current2D to Desire2D and reset velocity. */
 	UFUNCTION(BlueprintCallable, Category = "CameraMovement|SpringHalfLife|Utilities")
-	void Snap2D() { Current2D = Desire2D; Velocity2D = FVector2D::ZeroVector; }
+	void Snap2D() { Current2D = PrevDesire2D = Desire2D; Velocity2D = FVector2D::ZeroVector; }
+
+	/** Handle in UHalfLifeSmoothingSubsystem while bUseBatchedUpdate is active (see GetSmoothedValue). */
+	UFUNCTION(BlueprintPure, Category = "CameraMovement|SpringHalfLife|Utilities")
+	FHalfLifeSmootherHandle GetBatchHandle() const { return BatchHandle; }
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	FHalfLifeSmootherHandle BatchHandle;
+
+	/** Desire at the previous Update, the start of the linear target motion (bExactMovingTarget). */
+	float PrevDesire1D = 0.f;
+	FVector2D PrevDesire2D = FVector2D::ZeroVector;
 };
\ No newline at end of file
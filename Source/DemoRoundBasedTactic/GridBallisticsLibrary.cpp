@@ -0,0 +1,217 @@
+// GridBallisticsLibrary.cpp
+
+#include "GridBallisticsLibrary.h"
+#include "GridHeightField.h"
+#include "GridStats.h"
+#include "GridTopology.h"
+
+#include "Async/ParallelFor.h"
+
+namespace
+{
+    /** Batches smaller than this are traced on the calling thread. */
+    constexpr int32 ParallelArcThreshold = 64;
+
+    /** Arcs per worker task. */
+    constexpr int32 ArcBatchSize = 16;
+
+    /** Ground heights of the grid, from a snapshot (thread-safe) or the provider. */
+    struct FArcHeights
+    {
+        const FGridConfig& Config;
+        const FGridHeightSnapshot* Snapshot;
+        const FGridHeightTiles* Tiles;
+
+        FORCEINLINE float GetHeightAt(int32 X, int32 Y) const
+        {
+            if (Snapshot)
+            {
+                return Snapshot->GetHeightAt(X, Y);
+            }
+            return Config.HeightProvider.IsValid() ? Config.HeightProvider->GetHeightAt(X, Y) : Config.GridOrigin.Z;
+        }
+    };
+
+    /**
+     * Trace one arc in grid-plane units. Returns the first blocking cell, or (-1,-1).
+     * Samples are grouped into stretches of about one height tile; a stretch is skipped
+     * when the arc's lowest point over it (at one of its ends, the arc being concave) is
+     * above the highest tile its cells can touch.
+     */
+    template <typename TopologyType>
+    static FIntPoint TTraceArc(const FGridConfig& Config, const FArcHeights& Heights, const FIntPoint& Launch, const FIntPoint& Target, const FGridArcSettings& Settings)
+    {
+        const FVector2D From = TopologyType::CellToLocal(Launch);
+        const FVector2D To = TopologyType::CellToLocal(Target);
+        const double Distance = FVector2D::Distance(From, To);
+
+        const double FromZ = Heights.GetHeightAt(Launch.X, Launch.Y) + Config.DefaultEyeHeight;
+        const double ToZ = Heights.GetHeightAt(Target.X, Target.Y);
+        const double Bulge = 4.0 * (Settings.ArcHeight + Settings.ArcHeightPerCell * Distance);
+
+        const auto ArcZ = [FromZ, ToZ, Bulge](double T)
+        {
+            return FromZ + (ToZ - FromZ) * T + Bulge * T * (1.0 - T);
+        };
+
+        const double Spacing = FMath::Max(double(Settings.SampleSpacing), 0.05);
+        const int32 NumSamples = FMath::Max(FMath::CeilToInt32(Distance / Spacing), 1);
+        const double InvSamples = 1.0 / NumSamples;
+
+        const FGridHeightTiles* Tiles = Heights.Tiles;
+        const int32 StretchSamples = Tiles ? FMath::Max(FMath::FloorToInt32(Tiles->TileSize / Spacing), 1) : NumSamples;
+
+        for (int32 First = 1; First < NumSamples; First += StretchSamples)
+        {
+            const int32 End = FMath::Min(First + StretchSamples, NumSamples);
+
+            if (Tiles)
+            {
+                const double TA = First * InvSamples;
+                const double TB = (End - 1) * InvSamples;
+                const FIntPoint CellA = TopologyType::LocalToCell(FMath::Lerp(From, To, TA), EGridRoundingPolicy::Floor);
+                const FIntPoint CellB = TopologyType::LocalToCell(FMath::Lerp(From, To, TB), EGridRoundingPolicy::Floor);
+
+                // One cell of slack covers hex rounding and samples between the two ends.
+                const int32 MinX = FMath::Max(FMath::Min(CellA.X, CellB.X) - 1, 0);
+                const int32 MinY = FMath::Max(FMath::Min(CellA.Y, CellB.Y) - 1, 0);
+                const int32 MaxX = FMath::Min(FMath::Max(CellA.X, CellB.X) + 1, Config.Width - 1);
+                const int32 MaxY = FMath::Min(FMath::Max(CellA.Y, CellB.Y) + 1, Config.Height - 1);
+
+                float TileMax = -MAX_flt;
+                const int32 TileShift = FMath::FloorLog2(Tiles->TileSize);
+                for (int32 TileY = MinY >> TileShift; TileY <= (MaxY >> TileShift) && MinX <= MaxX; ++TileY)
+                {
+                    for (int32 TileX = MinX >> TileShift; TileX <= (MaxX >> TileShift); ++TileX)
+                    {
+                        TileMax = FMath::Max(TileMax, Tiles->GetTileMax(TileX, TileY));
+                    }
+                }
+
+                if (FMath::Min(ArcZ(TA), ArcZ(TB)) > TileMax)
+                {
+                    continue;
+                }
+            }
+
+            for (int32 Sample = First; Sample < End; ++Sample)
+            {
+                const double T = Sample * InvSamples;
+                const FIntPoint Cell = TopologyType::LocalToCell(FMath::Lerp(From, To, T), EGridRoundingPolicy::Floor);
+                if (Cell == Launch || Cell == Target ||
+                    Cell.X < 0 || Cell.Y < 0 || Cell.X >= Config.Width || Cell.Y >= Config.Height)
+                {
+                    continue;
+                }
+
+                if (ArcZ(T) <= Heights.GetHeightAt(Cell.X, Cell.Y))
+                {
+                    return Cell;
+                }
+            }
+        }
+
+        return FIntPoint(-1, -1);
+    }
+
+    static FORCEINLINE bool IsInGrid(const FGridConfig& Config, const FIntPoint& Cell)
+    {
+        return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Config.Width && Cell.Y < Config.Height;
+    }
+}
+
+void UGridBallisticsLibrary::TraceArcs(
+    const FGridConfig& Config,
+    FIntPoint Launch,
+    TConstArrayView<FIntPoint> Targets,
+    const FGridArcSettings& Settings,
+    FGridCellMask& OutClear,
+    TArray<FIntPoint>& OutImpacts
+)
+{
+    GRID_QUERY_SCOPE(Ballistics);
+
+    FIntRect Window(MAX_int32, MAX_int32, MIN_int32, MIN_int32);
+    for (const FIntPoint& Target : Targets)
+    {
+        Window.Include(Target);
+    }
+    if (Targets.Num() > 0)
+    {
+        OutClear.Init(Window.Min, Window.Width() + 1, Window.Height() + 1);
+    }
+    else
+    {
+        OutClear.Empty();
+    }
+
+    OutImpacts.Init(FIntPoint(-1, -1), Targets.Num());
+    if (Targets.Num() == 0 || !IsInGrid(Config, Launch))
+    {
+        return;
+    }
+
+    // Hold the snapshot for the whole batch; workers may only read immutable heights.
+    const FGridHeightSnapshotRef Snapshot = Config.HeightProvider.IsValid() ? Config.HeightProvider->GetHeightSnapshot() : nullptr;
+    const FArcHeights Heights{ Config, Snapshot.GetReference(), Config.HeightProvider.IsValid() ? Config.HeightProvider->GetMaxHeightTiles() : nullptr };
+
+    // Bits of one row word may belong to several targets, so workers only write OutImpacts.
+    TArray<bool> Clear;
+    Clear.SetNumZeroed(Targets.Num());
+
+    DispatchGridTopology(Config.Topology, [&](auto Topo)
+    {
+        using TopologyType = decltype(Topo);
+
+        const bool bParallel = Snapshot.IsValid() && Targets.Num() >= ParallelArcThreshold;
+        ParallelFor(TEXT("GridTraceArcs"), Targets.Num(), ArcBatchSize, [&](int32 Index)
+        {
+            const FIntPoint& Target = Targets[Index];
+            if (IsInGrid(Config, Target))
+            {
+                OutImpacts[Index] = TTraceArc<TopologyType>(Config, Heights, Launch, Target, Settings);
+                Clear[Index] = OutImpacts[Index].X < 0;
+            }
+        }, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+    });
+
+    for (int32 Index = 0; Index < Targets.Num(); ++Index)
+    {
+        if (Clear[Index])
+        {
+            OutClear.SetCell(Targets[Index]);
+        }
+    }
+}
+
+void UGridBallisticsLibrary::GetClearArcTargets(
+    const FGridConfig& Config,
+    FIntPoint Launch,
+    const TArray<FIntPoint>& Targets,
+    const FGridArcSettings& Settings,
+    TArray<FIntPoint>& OutClearCells,
+    TArray<FIntPoint>& OutImpacts
+)
+{
+    FGridCellMask Clear;
+    TraceArcs(Config, Launch, Targets, Settings, Clear, OutImpacts);
+
+    OutClearCells.Reset();
+    for (const FIntPoint& Target : Targets)
+    {
+        if (Clear.Contains(Target))
+        {
+            OutClearCells.Add(Target);
+        }
+    }
+}
+
+bool UGridBallisticsLibrary::TraceArc(const FGridConfig& Config, FIntPoint Launch, FIntPoint Target, const FGridArcSettings& Settings, FIntPoint& OutImpact)
+{
+    FGridCellMask Clear;
+    TArray<FIntPoint> Impacts;
+    TraceArcs(Config, Launch, MakeArrayView(&Target, 1), Settings, Clear, Impacts);
+
+    OutImpact = Impacts[0];
+    return Clear.Contains(Target);
+}
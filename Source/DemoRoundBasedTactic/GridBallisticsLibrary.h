@@ -0,0 +1,79 @@
+// GridBallisticsLibrary.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "GridCellMask.h"
+#include "GridTypes.h"
+#include "GridBallisticsLibrary.generated.h"
+
+/** Shape and sampling of a lobbed (artillery, thrown) trajectory. */
+USTRUCT(BlueprintType)
+struct FGridArcSettings
+{
+    GENERATED_BODY()
+
+    /** Height of the arc above the straight launch-to-landing line at its midpoint, in world units. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Ballistics", meta = (ClampMin = "0"))
+    float ArcHeight = 200.f;
+
+    /** Added to ArcHeight per cell of horizontal distance, so long throws arc higher. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Ballistics", meta = (ClampMin = "0"))
+    float ArcHeightPerCell = 25.f;
+
+    /** Horizontal distance between samples, in cells. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Ballistics", meta = (ClampMin = "0.05"))
+    float SampleSpacing = 0.25f;
+};
+
+/**
+ * Terrain clearance of parabolic arcs over a grid's height field.
+ *
+ * An arc starts at GridToWorldEye of the launch cell and lands on the ground of the target
+ * cell; it is blocked where it passes below the top of a cell column other than the launch
+ * and target cells. Samples are taken every SampleSpacing cells, but whole stretches of
+ * an arc are skipped while its lowest point there is above the max height of the
+ * terrain tiles below (FGridHeightTiles), so arcs over open ground cost a few tile reads.
+ */
+UCLASS()
+class DEMOROUNDBASEDTACTIC_API UGridBallisticsLibrary : public UBlueprintFunctionLibrary
+{
+    GENERATED_BODY()
+
+public:
+
+    /**
+     * Check the arcs from Launch to every target cell.
+     *
+     * Large batches are split across worker threads when the heights come from an
+     * immutable snapshot.
+     *
+     * @param OutClear   Window around Targets; bit set if the arc to that cell clears the terrain.
+     * @param OutImpacts Per target, the first cell the arc hits, or (-1,-1) if it is clear
+     *                   or the target is outside the grid.
+     */
+    static void TraceArcs(
+        const FGridConfig& Config,
+        FIntPoint Launch,
+        TConstArrayView<FIntPoint> Targets,
+        const FGridArcSettings& Settings,
+        FGridCellMask& OutClear,
+        TArray<FIntPoint>& OutImpacts
+    );
+
+    /** Blueprint wrapper of TraceArcs. OutClearCells lists the targets whose arc is clear. */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Ballistics")
+    static void GetClearArcTargets(
+        const FGridConfig& Config,
+        FIntPoint Launch,
+        const TArray<FIntPoint>& Targets,
+        const FGridArcSettings& Settings,
+        TArray<FIntPoint>& OutClearCells,
+        TArray<FIntPoint>& OutImpacts
+    );
+
+    /** Single arc. Returns true if it is clear; otherwise OutImpact is the first cell hit. */
+    UFUNCTION(BlueprintPure, Category = "Grid|Ballistics")
+    static bool TraceArc(const FGridConfig& Config, FIntPoint Launch, FIntPoint Target, const FGridArcSettings& Settings, FIntPoint& OutImpact);
+};
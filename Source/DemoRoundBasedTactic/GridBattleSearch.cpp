@@ -0,0 +1,200 @@
+// GridBattleSearch.cpp
+
+#include "GridBattleSearch.h"
+#include "GridStats.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+    struct FSearchNode
+    {
+        /** Action that led here from Parent, and the faction that took it (whose score Value sums). */
+        FGridBattleAction Action;
+        int32 Faction = INDEX_NONE;
+
+        int32 Parent = INDEX_NONE;
+        TArray<int32, TInlineAllocator<16>> Children;
+        TArray<FGridBattleAction> Untried;
+
+        float Value = 0.f;
+        int32 Visits = 0;
+    };
+
+    /** Root statistics of one worker, indexed like the shared root actions. */
+    struct FWorkerResult
+    {
+        TArray<float> Value;
+        TArray<int32> Visits;
+    };
+
+    static int32 SelectChild(const TArray<FSearchNode>& Nodes, const FSearchNode& Node, float Exploration)
+    {
+        const float LogVisits = FMath::Loge(float(FMath::Max(Node.Visits, 1)));
+
+        int32 Best = INDEX_NONE;
+        float BestScore = -MAX_flt;
+        for (const int32 ChildIndex : Node.Children)
+        {
+            const FSearchNode& Child = Nodes[ChildIndex];
+            const float Score = Child.Value / Child.Visits + Exploration * FMath::Sqrt(LogVisits / Child.Visits);
+            if (Score > BestScore)
+            {
+                Best = ChildIndex;
+                BestScore = Score;
+            }
+        }
+        return Best;
+    }
+
+    static void RunWorker(const FGridBattleState& SharedRoot, TConstArrayView<FGridBattleAction> RootActions, const FGridBattleSearchSettings& Settings,
+        int32 Iterations, int32 Seed, FWorkerResult& OutResult)
+    {
+        FRandomStream Random(Seed);
+
+        // Forks of a worker-local root keep the per-iteration reference counting off the
+        // chunks every other worker is forking too.
+        const FGridBattleState Root = SharedRoot.Clone();
+
+        TArray<FSearchNode> Nodes;
+        Nodes.Reserve(Iterations + 1);
+        Nodes.AddDefaulted_GetRef().Untried.Append(RootActions.GetData(), RootActions.Num());
+
+        // Root children in root action order, so workers can be merged by index.
+        TArray<int32> RootChildOfAction;
+        RootChildOfAction.Init(INDEX_NONE, RootActions.Num());
+
+        TArray<FGridBattleAction> Actions;
+        float Scores[FGridBattleState::MaxFactions];
+
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            FGridBattleState State = Root.Fork();
+            int32 NodeIndex = 0;
+
+            // Selection.
+            while (Nodes[NodeIndex].Untried.Num() == 0 && Nodes[NodeIndex].Children.Num() > 0)
+            {
+                NodeIndex = SelectChild(Nodes, Nodes[NodeIndex], Settings.Exploration);
+                State.Apply(Nodes[NodeIndex].Action);
+            }
+
+            // Expansion.
+            if (Nodes[NodeIndex].Untried.Num() > 0 && !State.IsTerminal())
+            {
+                TArray<FGridBattleAction>& Untried = Nodes[NodeIndex].Untried;
+                const int32 Pick = Random.RandRange(0, Untried.Num() - 1);
+                const FGridBattleAction Action = Untried[Pick];
+                Untried.RemoveAtSwap(Pick, 1, EAllowShrinking::No);
+
+                const int32 Faction = State.GetActiveFaction();
+                State.Apply(Action);
+                State.GenerateActions(Actions, Settings.MaxMovesPerNode, Random);
+
+                const int32 ChildIndex = Nodes.AddDefaulted();
+                FSearchNode& Child = Nodes[ChildIndex];
+                Child.Action = Action;
+                Child.Faction = Faction;
+                Child.Parent = NodeIndex;
+                Child.Untried = Actions;
+                Nodes[NodeIndex].Children.Add(ChildIndex);
+
+                if (NodeIndex == 0)
+                {
+                    RootChildOfAction[RootActions.IndexOfByKey(Action)] = ChildIndex;
+                }
+                NodeIndex = ChildIndex;
+            }
+
+            // Playout.
+            for (int32 PlayoutPly = 0; PlayoutPly < Settings.MaxPlayoutPlies && !State.IsTerminal(); ++PlayoutPly)
+            {
+                State.Apply(State.ChooseRolloutAction(Random));
+            }
+
+            // Backpropagation; each node sums the score of the faction that chose it.
+            for (int32 Faction = 0; Faction < FGridBattleState::MaxFactions; ++Faction)
+            {
+                Scores[Faction] = -1.f;
+            }
+            for (; NodeIndex != INDEX_NONE; NodeIndex = Nodes[NodeIndex].Parent)
+            {
+                FSearchNode& Node = Nodes[NodeIndex];
+                ++Node.Visits;
+                if (Node.Faction != INDEX_NONE)
+                {
+                    float& Score = Scores[Node.Faction];
+                    Score = Score < 0.f ? State.Evaluate(Node.Faction) : Score;
+                    Node.Value += Score;
+                }
+            }
+        }
+
+        OutResult.Value.Init(0.f, RootActions.Num());
+        OutResult.Visits.Init(0, RootActions.Num());
+        for (int32 ActionIndex = 0; ActionIndex < RootActions.Num(); ++ActionIndex)
+        {
+            if (RootChildOfAction[ActionIndex] != INDEX_NONE)
+            {
+                const FSearchNode& Child = Nodes[RootChildOfAction[ActionIndex]];
+                OutResult.Value[ActionIndex] = Child.Value;
+                OutResult.Visits[ActionIndex] = Child.Visits;
+            }
+        }
+    }
+}
+
+FGridBattleSearchResult GridBattleSearch::FindBestAction(const FGridBattleState& Root, const FGridBattleSearchSettings& Settings)
+{
+    GRID_QUERY_SCOPE(BattleSearch);
+
+    FGridBattleSearchResult Result;
+    if (Root.IsTerminal())
+    {
+        return Result;
+    }
+
+    // Generated once so that every worker ranks the same candidates.
+    FRandomStream RootRandom(Settings.Seed);
+    TArray<FGridBattleAction> RootActions;
+    Root.GenerateActions(RootActions, Settings.MaxMovesPerNode, RootRandom);
+
+    const int32 Iterations = FMath::Max(Settings.Iterations, 1);
+    const int32 NumWorkers = FMath::Clamp(Settings.NumWorkers, 1, Iterations);
+
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+
+    TArray<FWorkerResult> WorkerResults;
+    WorkerResults.SetNum(NumWorkers);
+    ParallelFor(NumWorkers, [&](int32 Worker)
+    {
+        const int32 WorkerIterations = Iterations / NumWorkers + (Worker < Iterations % NumWorkers ? 1 : 0);
+        RunWorker(Root, RootActions, Settings, WorkerIterations, Settings.Seed + 7919 * (Worker + 1), WorkerResults[Worker]);
+    });
+
+    Result.Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+    Result.Playouts = Iterations;
+    Result.NumWorkers = NumWorkers;
+
+    int32 BestVisits = -1;
+    for (int32 ActionIndex = 0; ActionIndex < RootActions.Num(); ++ActionIndex)
+    {
+        float Value = 0.f;
+        int32 Visits = 0;
+        for (const FWorkerResult& Worker : WorkerResults)
+        {
+            Value += Worker.Value[ActionIndex];
+            Visits += Worker.Visits[ActionIndex];
+        }
+
+        if (Visits > BestVisits)
+        {
+            BestVisits = Visits;
+            Result.BestAction = RootActions[ActionIndex];
+            Result.BestScore = Visits > 0 ? Value / Visits : 0.f;
+        }
+    }
+    return Result;
+}
@@ -0,0 +1,59 @@
+// GridBattleSearch.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBattleState.h"
+
+struct FGridBattleSearchSettings
+{
+    /** Playouts in total, split across the workers. */
+    int32 Iterations = 4096;
+
+    /**
+     * Independent search trees run on the task graph. The result depends on it, so it is a
+     * fixed number rather than the machine's core count: a seeded search picks the same
+     * action everywhere. Trees beyond the available worker threads just queue.
+     */
+    int32 NumWorkers = 8;
+
+    /** Destinations sampled per tree node (FGridBattleState::GenerateActions). */
+    int32 MaxMovesPerNode = 8;
+
+    /** Plies a playout runs before the position is scored with FGridBattleState::Evaluate. */
+    int32 MaxPlayoutPlies = 32;
+
+    /** UCT exploration constant. */
+    float Exploration = 1.41f;
+
+    int32 Seed = 0;
+};
+
+struct FGridBattleSearchResult
+{
+    /** Most visited action of the active unit; Unit is INDEX_NONE if the battle is over. */
+    FGridBattleAction BestAction;
+
+    /** Mean score of BestAction for the active faction, in [0, 1]. */
+    float BestScore = 0.f;
+
+    int32 Playouts = 0;
+    int32 NumWorkers = 0;
+    double Seconds = 0.0;
+
+    double GetPlayoutsPerSecond() const { return Seconds > 0.0 ? Playouts / Seconds : 0.0; }
+};
+
+/**
+ * Monte Carlo tree search over FGridBattleState for the AI.
+ *
+ * Root-parallel: every worker grows its own tree from the same candidate actions and
+ * the root statistics are summed at the end, so workers share nothing but the immutable
+ * root state and never synchronise. Each worker clones the root once; every iteration
+ * forks that clone (pointer copies), replays the selected path and runs a playout with
+ * FGridBattleState::ChooseRolloutAction.
+ */
+namespace GridBattleSearch
+{
+    DEMOROUNDBASEDTACTIC_API FGridBattleSearchResult FindBestAction(const FGridBattleState& Root, const FGridBattleSearchSettings& Settings);
+}
@@ -0,0 +1,350 @@
+// GridBattleSimCommandlet.cpp
+
+#include "GridBattleSimCommandlet.h"
+#include "GridBattleSearch.h"
+#include "GridTraversalGraph.h"
+#include "HeightMapGridBindingComponent.h"
+#include "TerrainHeightMapAsset.h"
+
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/Package.h"
+
+namespace
+{
+    struct FBattleSimSettings
+    {
+        int32 UnitsPerSide = 8;
+        int32 MaxTurns = 200;
+        int32 Iterations = 128;
+    };
+
+    struct FBattleSimResult
+    {
+        int32 Seed = 0;
+        int32 Turns = 0;
+
+        /** Faction with living units at the end, or INDEX_NONE for a draw. */
+        int32 Winner = INDEX_NONE;
+
+        /** CRC over every action taken and the final unit states. */
+        uint32 Hash = 0;
+
+        uint64 SetupCycles = 0;
+        uint64 DecideCycles = 0;
+        uint64 ApplyCycles = 0;
+    };
+
+    static uint32 HashInts(uint32 Hash, std::initializer_list<int32> Values)
+    {
+        for (const int32 Value : Values)
+        {
+            Hash = FCrc::MemCrc32(&Value, sizeof(Value), Hash);
+        }
+        return Hash;
+    }
+
+    /** Two armies in opposite thirds of the map, on random cells that have at least one step. */
+    static void PlaceUnits(const FGridTraversalGraph& Graph, int32 UnitsPerSide, FRandomStream& Random, TArray<FGridBattleUnit>& OutUnits)
+    {
+        const int32 Width = Graph.GetWidth();
+        const int32 Height = Graph.GetHeight();
+        const int32 BandWidth = FMath::Max(Width / 3, 1);
+
+        OutUnits.Reset();
+        for (int32 Faction = 0; Faction < 2; ++Faction)
+        {
+            const int32 MinX = Faction == 0 ? 0 : Width - BandWidth;
+            for (int32 Index = 0; Index < UnitsPerSide; ++Index)
+            {
+                // Bounded retries: a band without passable cells just fields fewer units.
+                for (int32 Attempt = 0; Attempt < 64; ++Attempt)
+                {
+                    const FIntPoint Cell(MinX + Random.RandRange(0, BandWidth - 1), Random.RandRange(0, Height - 1));
+                    const bool bTaken = OutUnits.ContainsByPredicate([&Cell](const FGridBattleUnit& Unit) { return Unit.Cell == Cell; });
+                    if (bTaken || Graph.GetNeighbors(Cell.Y * Width + Cell.X).Num() == 0)
+                    {
+                        continue;
+                    }
+
+                    FGridBattleUnit& Unit = OutUnits.AddDefaulted_GetRef();
+                    Unit.Faction = Faction;
+                    Unit.Cell = Cell;
+                    Unit.HitPoints = Random.RandRange(8, 12);
+                    Unit.MovePoints = Random.RandRange(3, 5);
+                    Unit.AttackRange = Random.RandRange(1, 3);
+                    Unit.AttackDamage = 4 - Unit.AttackRange + Random.RandRange(1, 2);
+                    break;
+                }
+            }
+        }
+    }
+
+    static FBattleSimResult RunBattle(const FGridConfig& Config, const TSharedRef<const FGridTraversalGraph, ESPMode::ThreadSafe>& Graph,
+        const FBattleSimSettings& Settings, int32 Seed)
+    {
+        FBattleSimResult Result;
+        Result.Seed = Seed;
+
+        uint64 StartCycles = FPlatformTime::Cycles64();
+
+        FRandomStream Random(Seed);
+        TArray<FGridBattleUnit> Units;
+        PlaceUnits(*Graph, Settings.UnitsPerSide, Random, Units);
+
+        FGridBattleState State;
+        State.Init(Config, Graph, Units, Settings.MaxTurns);
+
+        FGridBattleSearchSettings SearchSettings;
+        SearchSettings.Iterations = Settings.Iterations;
+        SearchSettings.NumWorkers = 1;
+
+        uint64 Cycles = FPlatformTime::Cycles64();
+        Result.SetupCycles = Cycles - StartCycles;
+
+        while (!State.IsTerminal())
+        {
+            StartCycles = Cycles;
+
+            FGridBattleAction Action;
+            if (Settings.Iterations > 0)
+            {
+                SearchSettings.Seed = static_cast<int32>(Random.GetUnsignedInt());
+                Action = GridBattleSearch::FindBestAction(State, SearchSettings).BestAction;
+            }
+            else
+            {
+                Action = State.ChooseRolloutAction(Random);
+            }
+
+            Cycles = FPlatformTime::Cycles64();
+            Result.DecideCycles += Cycles - StartCycles;
+            StartCycles = Cycles;
+
+            State.Apply(Action);
+            Result.Hash = HashInts(Result.Hash, { Action.Unit, Action.Target, Action.MoveTo.X, Action.MoveTo.Y });
+            ++Result.Turns;
+
+            Cycles = FPlatformTime::Cycles64();
+            Result.ApplyCycles += Cycles - StartCycles;
+        }
+
+        uint32 FactionsAlive = 0;
+        for (const FGridBattleUnit& Unit : State.GetUnits())
+        {
+            Result.Hash = HashInts(Result.Hash, { Unit.Cell.X, Unit.Cell.Y, Unit.HitPoints });
+            FactionsAlive |= Unit.IsAlive() ? (1u << Unit.Faction) : 0u;
+        }
+        Result.Winner = FMath::CountBits(FactionsAlive) == 1 ? FMath::CountTrailingZeros(FactionsAlive) : INDEX_NONE;
+        return Result;
+    }
+
+    static void RunBattles(const FGridConfig& Config, const TSharedRef<const FGridTraversalGraph, ESPMode::ThreadSafe>& Graph,
+        const FBattleSimSettings& Settings, int32 Seed, TArray<FBattleSimResult>& OutResults)
+    {
+        ParallelFor(OutResults.Num(), [&](int32 Battle)
+        {
+            OutResults[Battle] = RunBattle(Config, Graph, Settings, Seed + Battle);
+        });
+    }
+
+    static bool SaveResults(const FString& Path, const TArray<FBattleSimResult>& Results, uint32 CombinedHash,
+        double WallSeconds, double TurnsPerSecond, const TMap<FString, double>& PhaseSeconds)
+    {
+        TArray<TSharedPtr<FJsonValue>> Battles;
+        for (const FBattleSimResult& Result : Results)
+        {
+            TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+            Entry->SetNumberField(TEXT("seed"), Result.Seed);
+            Entry->SetNumberField(TEXT("turns"), Result.Turns);
+            Entry->SetNumberField(TEXT("winner"), Result.Winner);
+            Entry->SetStringField(TEXT("hash"), FString::Printf(TEXT("%08x"), Result.Hash));
+            Battles.Add(MakeShared<FJsonValueObject>(Entry));
+        }
+
+        TSharedRef<FJsonObject> Phases = MakeShared<FJsonObject>();
+        for (const TPair<FString, double>& Phase : PhaseSeconds)
+        {
+            Phases->SetNumberField(Phase.Key, Phase.Value);
+        }
+
+        TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+        Root->SetStringField(TEXT("platform"), FPlatformProperties::PlatformName());
+        Root->SetStringField(TEXT("hash"), FString::Printf(TEXT("%08x"), CombinedHash));
+        Root->SetNumberField(TEXT("wall_seconds"), WallSeconds);
+        Root->SetNumberField(TEXT("turns_per_sec"), TurnsPerSecond);
+        Root->SetObjectField(TEXT("phase_seconds"), Phases);
+        Root->SetArrayField(TEXT("battles"), Battles);
+
+        FString Text;
+        const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Text);
+        return FJsonSerializer::Serialize(Root, Writer) && FFileHelper::SaveStringToFile(Text, *Path);
+    }
+}
+
+UGridBattleSimCommandlet::UGridBattleSimCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UGridBattleSimCommandlet::Main(const FString& Params)
+{
+    FString AssetPath;
+    FParse::Value(*Params, TEXT("Asset="), AssetPath);
+
+    FString TopologyString = TEXT("Square8");
+    FParse::Value(*Params, TEXT("Topology="), TopologyString);
+
+    float CellSize = 100.f;
+    FParse::Value(*Params, TEXT("CellSize="), CellSize);
+
+    int32 NumBattles = 64;
+    FParse::Value(*Params, TEXT("Battles="), NumBattles);
+    NumBattles = FMath::Max(NumBattles, 1);
+
+    int32 Seed = 1;
+    FParse::Value(*Params, TEXT("Seed="), Seed);
+
+    FBattleSimSettings Settings;
+    FParse::Value(*Params, TEXT("UnitsPerSide="), Settings.UnitsPerSide);
+    FParse::Value(*Params, TEXT("MaxTurns="), Settings.MaxTurns);
+    FParse::Value(*Params, TEXT("Iterations="), Settings.Iterations);
+    Settings.UnitsPerSide = FMath::Clamp(Settings.UnitsPerSide, 1, 256);
+    Settings.MaxTurns = FMath::Max(Settings.MaxTurns, 1);
+    Settings.Iterations = FMath::Max(Settings.Iterations, 0);
+
+    const bool bVerify = FParse::Param(*Params, TEXT("Verify"));
+
+    FString ExpectedHash;
+    FParse::Value(*Params, TEXT("ExpectedHash="), ExpectedHash);
+
+    FString OutputPath;
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+    UTerrainHeightMapAsset* Asset = AssetPath.IsEmpty() ? nullptr : LoadObject<UTerrainHeightMapAsset>(nullptr, *AssetPath);
+    if (!Asset)
+    {
+        UE_LOG(LogTemp, Error, TEXT("GridBattleSim: could not load height map asset '%s' (pass -Asset=<object path>)."), *AssetPath);
+        return 1;
+    }
+
+    const int64 TopologyValue = StaticEnum<EGridTopology>()->GetValueByNameString(TopologyString);
+    if (TopologyValue == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Error, TEXT("GridBattleSim: unknown topology '%s'."), *TopologyString);
+        return 1;
+    }
+
+    TMap<FString, double> PhaseSeconds;
+
+    // An unregistered binding component builds the config exactly as in a level.
+    uint64 StartCycles = FPlatformTime::Cycles64();
+
+    UHeightMapGridBindingComponent* Binding = NewObject<UHeightMapGridBindingComponent>(GetTransientPackage());
+    Binding->HeightMapAsset = Asset;
+    Binding->Topology = static_cast<EGridTopology>(TopologyValue);
+    Binding->CellSize = CellSize;
+    Binding->RebuildGridConfig();
+    const FGridConfig Config = Binding->GridConfig;
+
+    PhaseSeconds.Add(TEXT("ConfigBuild"), FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles));
+    if (!Config.HeightProvider.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("GridBattleSim: '%s' has no valid height data."), *AssetPath);
+        return 1;
+    }
+
+    StartCycles = FPlatformTime::Cycles64();
+    const TSharedRef<FGridTraversalGraph, ESPMode::ThreadSafe> Graph = MakeShared<FGridTraversalGraph, ESPMode::ThreadSafe>();
+    Graph->Build(Config, FGridMovementProfile());
+    PhaseSeconds.Add(TEXT("GraphBuild"), FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles));
+
+    UE_LOG(LogTemp, Display, TEXT("GridBattleSim: %dx%d %s grid, %d battles of %d vs. %d units, %d playouts per decision."),
+        Config.Width, Config.Height, *TopologyString, NumBattles, Settings.UnitsPerSide, Settings.UnitsPerSide, Settings.Iterations);
+
+    TArray<FBattleSimResult> Results;
+    Results.SetNum(NumBattles);
+
+    StartCycles = FPlatformTime::Cycles64();
+    RunBattles(Config, Graph, Settings, Seed, Results);
+    const double WallSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+
+    bool bFailed = false;
+
+    // Phase times are summed over all battles, i.e. CPU time rather than wall time.
+    int64 TotalTurns = 0;
+    uint64 SetupCycles = 0;
+    uint64 DecideCycles = 0;
+    uint64 ApplyCycles = 0;
+    uint32 CombinedHash = 0;
+    int32 Wins[2] = {};
+    for (const FBattleSimResult& Result : Results)
+    {
+        TotalTurns += Result.Turns;
+        SetupCycles += Result.SetupCycles;
+        DecideCycles += Result.DecideCycles;
+        ApplyCycles += Result.ApplyCycles;
+        CombinedHash = FCrc::MemCrc32(&Result.Hash, sizeof(Result.Hash), CombinedHash);
+        if (Result.Winner == 0 || Result.Winner == 1)
+        {
+            ++Wins[Result.Winner];
+        }
+    }
+    PhaseSeconds.Add(TEXT("Setup"), FPlatformTime::ToSeconds64(SetupCycles));
+    PhaseSeconds.Add(TEXT("Decide"), FPlatformTime::ToSeconds64(DecideCycles));
+    PhaseSeconds.Add(TEXT("Apply"), FPlatformTime::ToSeconds64(ApplyCycles));
+
+    const double TurnsPerSecond = WallSeconds > 0.0 ? TotalTurns / WallSeconds : 0.0;
+
+    UE_LOG(LogTemp, Display, TEXT("GridBattleSim: %lld turns in %.3f s, %.0f turns/s; wins %d / %d, draws %d."),
+        TotalTurns, WallSeconds, TurnsPerSecond, Wins[0], Wins[1], NumBattles - Wins[0] - Wins[1]);
+    for (const TPair<FString, double>& Phase : PhaseSeconds)
+    {
+        UE_LOG(LogTemp, Display, TEXT("GridBattleSim: %-12s %10.3f s"), *Phase.Key, Phase.Value);
+    }
+    for (const FBattleSimResult& Result : Results)
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("GridBattleSim: seed %d, %d turns, winner %d, hash %08x"), Result.Seed, Result.Turns, Result.Winner, Result.Hash);
+    }
+    UE_LOG(LogTemp, Display, TEXT("GridBattleSim: hash %08x"), CombinedHash);
+
+    if (bVerify)
+    {
+        TArray<FBattleSimResult> Rerun;
+        Rerun.SetNum(NumBattles);
+        RunBattles(Config, Graph, Settings, Seed, Rerun);
+
+        for (int32 Battle = 0; Battle < NumBattles; ++Battle)
+        {
+            if (Rerun[Battle].Hash != Results[Battle].Hash)
+            {
+                UE_LOG(LogTemp, Error, TEXT("GridBattleSim: battle with seed %d is not deterministic (%08x vs. %08x)."),
+                    Results[Battle].Seed, Results[Battle].Hash, Rerun[Battle].Hash);
+                bFailed = true;
+            }
+        }
+    }
+
+    if (!ExpectedHash.IsEmpty() && ExpectedHash != FString::Printf(TEXT("%08x"), CombinedHash))
+    {
+        UE_LOG(LogTemp, Error, TEXT("GridBattleSim: hash %08x differs from expected %s."), CombinedHash, *ExpectedHash);
+        bFailed = true;
+    }
+
+    if (!OutputPath.IsEmpty() && !SaveResults(OutputPath, Results, CombinedHash, WallSeconds, TurnsPerSecond, PhaseSeconds))
+    {
+        UE_LOG(LogTemp, Error, TEXT("GridBattleSim: could not write %s"), *OutputPath);
+        bFailed = true;
+    }
+
+    return bFailed ? 1 : 0;
+}
@@ -0,0 +1,41 @@
+// GridBattleSimCommandlet.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GridBattleSimCommandlet.generated.h"
+
+/**
+ * Headless AI-vs-AI battles on a height map, for throughput and regression runs on
+ * machines without a GPU.
+ *
+ * Usage:
+ *
+ *   UnrealEditor-Cmd <Project>.uproject -run=GridBattleSim -nullrhi -unattended
+ *       -Asset=/Game/Maps/MyHeightMap.MyHeightMap
+ *       [-Topology=Square8] [-CellSize=100]
+ *       [-Battles=64] [-Seed=1] [-UnitsPerSide=8] [-MaxTurns=200]
+ *       [-Iterations=128] [-Verify] [-ExpectedHash=<hash>] [-Output=<results.json>]
+ *
+ * The grid config is built by an unregistered UHeightMapGridBindingComponent, i.e. by
+ * the same RebuildGridConfig code a level runs. Battles run in parallel, one per task;
+ * every unit decision is a single-worker GridBattleSearch with Iterations playouts (0
+ * uses the rollout policy), so a battle depends only on its seed.
+ *
+ * Reports turns (unit activations) per second, time per phase and a determinism hash per
+ * battle plus a combined one. -Verify runs every battle twice and compares the hashes.
+ *
+ * @return 0 on success, 1 if the asset cannot be loaded, a verify run diverges or the
+ *         combined hash differs from ExpectedHash.
+ */
+UCLASS()
+class UGridBattleSimCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UGridBattleSimCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
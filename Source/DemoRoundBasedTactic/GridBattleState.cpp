@@ -0,0 +1,379 @@
+// GridBattleState.cpp
+
+#include "GridBattleState.h"
+#include "GridTopology.h"
+#include "GridTraversalGraph.h"
+
+#include "Math/RandomStream.h"
+
+namespace
+{
+    /** Chance that a rollout step ignores the greedy choice, so playouts of one position differ. */
+    constexpr float RolloutExploreChance = 0.25f;
+
+    /** Score lost per own unit that ends a position under enemy threat. */
+    constexpr float ThreatPenalty = 0.02f;
+}
+
+void FGridBattleState::Init(const FGridConfig& Config, TSharedPtr<const FGridTraversalGraph, ESPMode::ThreadSafe> InGraph, TConstArrayView<FGridBattleUnit> InUnits, int32 InMaxPlies)
+{
+    Topology = Config.Topology;
+    Graph = MoveTemp(InGraph);
+    if (Graph.IsValid() && (Graph->GetWidth() != Config.Width || Graph->GetHeight() != Config.Height))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FGridBattleState: traversal graph does not match the grid; ignoring it."));
+        Graph.Reset();
+    }
+
+    Occupancy.Init(Config.Width, Config.Height, INDEX_NONE);
+    for (TGridCowArray<uint8>& FactionThreat : Threat)
+    {
+        FactionThreat.Init(Config.Width, Config.Height, 0);
+    }
+
+    Units.Reset();
+    FMemory::Memzero(InitialHitPoints);
+    for (const FGridBattleUnit& Unit : InUnits)
+    {
+        const bool bValid = Unit.IsAlive() && Unit.Faction >= 0 && Unit.Faction < MaxFactions &&
+            Unit.Cell.X >= 0 && Unit.Cell.Y >= 0 && Unit.Cell.X < Config.Width && Unit.Cell.Y < Config.Height &&
+            GetUnitAt(Unit.Cell) == INDEX_NONE && Units.Num() < MAX_int16;
+        if (!bValid)
+        {
+            continue;
+        }
+
+        const int32 Index = Units.Add(Unit);
+        Occupancy.Set(Unit.Cell.X, Unit.Cell.Y, static_cast<int16>(Index));
+        ApplyThreat(Unit, +1);
+        InitialHitPoints[Unit.Faction] += Unit.HitPoints;
+    }
+
+    MaxPlies = InMaxPlies;
+    Ply = 0;
+    ActiveUnit = Units.Num() - 1;
+    AdvanceTurn();
+    Ply = 0;
+}
+
+FGridBattleState FGridBattleState::Clone() const
+{
+    FGridBattleState Copy = *this;
+    Copy.Occupancy.Detach();
+    for (TGridCowArray<uint8>& FactionThreat : Copy.Threat)
+    {
+        FactionThreat.Detach();
+    }
+    return Copy;
+}
+
+int32 FGridBattleState::GetStepDistance(const FIntPoint& A, const FIntPoint& B) const
+{
+    return DispatchGridTopology(Topology, [&](auto Topo)
+    {
+        return decltype(Topo)::StepDistance(A, B);
+    });
+}
+
+template <typename VisitorType>
+void FGridBattleState::ForEachStep(const FIntPoint& Cell, VisitorType&& Visit) const
+{
+    const int32 Width = GetWidth();
+    if (Graph.IsValid())
+    {
+        for (const int32 Next : Graph->GetNeighbors(Cell.Y * Width + Cell.X))
+        {
+            Visit(FIntPoint(Next % Width, Next / Width));
+        }
+        return;
+    }
+
+    DispatchGridTopology(Topology, [&](auto Topo)
+    {
+        for (const FGridNeighborOffset& Offset : decltype(Topo)::NeighborOffsets)
+        {
+            const FIntPoint Next(Cell.X + Offset.DX, Cell.Y + Offset.DY);
+            if (Next.X >= 0 && Next.Y >= 0 && Next.X < Width && Next.Y < GetHeight())
+            {
+                Visit(Next);
+            }
+        }
+    });
+}
+
+void FGridBattleState::ApplyThreat(const FGridBattleUnit& Unit, int32 Delta)
+{
+    TGridCowArray<uint8>& FactionThreat = Threat[Unit.Faction];
+    const int32 Range = Unit.AttackRange;
+
+    const int32 MinX = FMath::Max(Unit.Cell.X - Range, 0);
+    const int32 MaxX = FMath::Min(Unit.Cell.X + Range, GetWidth() - 1);
+    const int32 MinY = FMath::Max(Unit.Cell.Y - Range, 0);
+    const int32 MaxY = FMath::Min(Unit.Cell.Y + Range, GetHeight() - 1);
+
+    DispatchGridTopology(Topology, [&](auto Topo)
+    {
+        for (int32 Y = MinY; Y <= MaxY; ++Y)
+        {
+            for (int32 X = MinX; X <= MaxX; ++X)
+            {
+                if (decltype(Topo)::StepDistance(Unit.Cell, FIntPoint(X, Y)) <= Range)
+                {
+                    uint8& Count = FactionThreat.GetMutable(X, Y);
+                    Count = static_cast<uint8>(FMath::Clamp(int32(Count) + Delta, 0, 255));
+                }
+            }
+        }
+    });
+}
+
+void FGridBattleState::MoveUnit(int32 UnitIndex, const FIntPoint& To)
+{
+    FGridBattleUnit& Unit = Units[UnitIndex];
+    ApplyThreat(Unit, -1);
+    Occupancy.Set(Unit.Cell.X, Unit.Cell.Y, INDEX_NONE);
+
+    Unit.Cell = To;
+    Occupancy.Set(To.X, To.Y, static_cast<int16>(UnitIndex));
+    ApplyThreat(Unit, +1);
+}
+
+void FGridBattleState::DamageUnit(int32 UnitIndex, int32 Damage)
+{
+    FGridBattleUnit& Unit = Units[UnitIndex];
+    Unit.HitPoints = FMath::Max(Unit.HitPoints - Damage, 0);
+    if (!Unit.IsAlive())
+    {
+        ApplyThreat(Unit, -1);
+        Occupancy.Set(Unit.Cell.X, Unit.Cell.Y, INDEX_NONE);
+    }
+}
+
+void FGridBattleState::AdvanceTurn()
+{
+    ++Ply;
+
+    uint32 FactionsAlive = 0;
+    for (const FGridBattleUnit& Unit : Units)
+    {
+        FactionsAlive |= Unit.IsAlive() ? (1u << Unit.Faction) : 0u;
+    }
+
+    if (Ply >= MaxPlies || FMath::CountBits(FactionsAlive) <= 1)
+    {
+        ActiveUnit = INDEX_NONE;
+        return;
+    }
+
+    for (int32 Step = 1; Step <= Units.Num(); ++Step)
+    {
+        const int32 Candidate = (ActiveUnit + Step) % Units.Num();
+        if (Units[Candidate].IsAlive())
+        {
+            ActiveUnit = Candidate;
+            return;
+        }
+    }
+    ActiveUnit = INDEX_NONE;
+}
+
+void FGridBattleState::Apply(const FGridBattleAction& Action)
+{
+    if (IsTerminal() || Action.Unit != ActiveUnit)
+    {
+        ensureMsgf(IsTerminal(), TEXT("FGridBattleState::Apply: action of unit %d while unit %d is active."), Action.Unit, ActiveUnit);
+        return;
+    }
+
+    const FGridBattleUnit& Unit = Units[ActiveUnit];
+    if (Action.MoveTo != Unit.Cell)
+    {
+        MoveUnit(ActiveUnit, Action.MoveTo);
+    }
+    if (Units.IsValidIndex(Action.Target) && Units[Action.Target].IsAlive())
+    {
+        DamageUnit(Action.Target, Unit.AttackDamage);
+    }
+
+    AdvanceTurn();
+}
+
+void FGridBattleState::GenerateActions(TArray<FGridBattleAction>& OutActions, int32 MaxMoves, FRandomStream& Random) const
+{
+    OutActions.Reset();
+    if (IsTerminal())
+    {
+        return;
+    }
+
+    const FGridBattleUnit& Unit = Units[ActiveUnit];
+
+    // Free cells within MovePoints steps, breadth first; the unit's own cell comes first.
+    TArray<FIntPoint, TInlineAllocator<128>> Reach;
+    TSet<FIntPoint, DefaultKeyFuncs<FIntPoint>, TInlineSetAllocator<128>> Seen;
+    Reach.Add(Unit.Cell);
+    Seen.Add(Unit.Cell);
+
+    int32 LayerBegin = 0;
+    for (int32 Step = 0; Step < Unit.MovePoints; ++Step)
+    {
+        const int32 LayerEnd = Reach.Num();
+        for (int32 Index = LayerBegin; Index < LayerEnd; ++Index)
+        {
+            ForEachStep(Reach[Index], [&](const FIntPoint& Next)
+            {
+                bool bAlreadySeen = false;
+                Seen.Add(Next, &bAlreadySeen);
+                if (!bAlreadySeen && GetUnitAt(Next) == INDEX_NONE)
+                {
+                    Reach.Add(Next);
+                }
+            });
+        }
+        LayerBegin = LayerEnd;
+    }
+
+    // Keep the own cell plus a random sample of the rest.
+    const int32 NumMoves = FMath::Clamp(MaxMoves, 1, Reach.Num());
+    for (int32 Index = 1; Index < NumMoves; ++Index)
+    {
+        Reach.Swap(Index, Random.RandRange(Index, Reach.Num() - 1));
+    }
+
+    for (int32 Index = 0; Index < NumMoves; ++Index)
+    {
+        const FIntPoint& Destination = Reach[Index];
+        OutActions.Add(FGridBattleAction{ static_cast<int16>(ActiveUnit), static_cast<int16>(INDEX_NONE), Destination });
+
+        for (int32 Target = 0; Target < Units.Num(); ++Target)
+        {
+            const FGridBattleUnit& Enemy = Units[Target];
+            if (Enemy.IsAlive() && Enemy.Faction != Unit.Faction && GetStepDistance(Destination, Enemy.Cell) <= Unit.AttackRange)
+            {
+                OutActions.Add(FGridBattleAction{ static_cast<int16>(ActiveUnit), static_cast<int16>(Target), Destination });
+            }
+        }
+    }
+}
+
+FGridBattleAction FGridBattleState::ChooseRolloutAction(FRandomStream& Random) const
+{
+    const FGridBattleUnit& Unit = Units[ActiveUnit];
+
+    // Weakest enemy in reach of From, and the nearest enemy overall.
+    auto FindTarget = [this, &Unit](const FIntPoint& From)
+    {
+        int32 Best = INDEX_NONE;
+        for (int32 Index = 0; Index < Units.Num(); ++Index)
+        {
+            const FGridBattleUnit& Enemy = Units[Index];
+            if (Enemy.IsAlive() && Enemy.Faction != Unit.Faction && GetStepDistance(From, Enemy.Cell) <= Unit.AttackRange &&
+                (Best == INDEX_NONE || Enemy.HitPoints < Units[Best].HitPoints))
+            {
+                Best = Index;
+            }
+        }
+        return Best;
+    };
+
+    FGridBattleAction Action{ static_cast<int16>(ActiveUnit), static_cast<int16>(INDEX_NONE), Unit.Cell };
+    int32 Target = FindTarget(Unit.Cell);
+    if (Target != INDEX_NONE)
+    {
+        Action.Target = static_cast<int16>(Target);
+        return Action;
+    }
+
+    FIntPoint Goal = Unit.Cell;
+    int32 GoalDistance = MAX_int32;
+    for (const FGridBattleUnit& Enemy : Units)
+    {
+        const int32 Distance = Enemy.IsAlive() && Enemy.Faction != Unit.Faction ? GetStepDistance(Unit.Cell, Enemy.Cell) : MAX_int32;
+        if (Distance < GoalDistance)
+        {
+            Goal = Enemy.Cell;
+            GoalDistance = Distance;
+        }
+    }
+
+    // Greedy walk towards it, with the occasional random step.
+    FIntPoint Cell = Unit.Cell;
+    for (int32 Step = 0; Step < Unit.MovePoints && GetStepDistance(Cell, Goal) > Unit.AttackRange; ++Step)
+    {
+        FIntPoint Greedy = Cell;
+        int32 GreedyDistance = MAX_int32;
+        FIntPoint Wander = Cell;
+        int32 NumFree = 0;
+
+        ForEachStep(Cell, [&](const FIntPoint& Next)
+        {
+            if (GetUnitAt(Next) != INDEX_NONE)
+            {
+                return;
+            }
+            const int32 Distance = GetStepDistance(Next, Goal);
+            if (Distance < GreedyDistance)
+            {
+                Greedy = Next;
+                GreedyDistance = Distance;
+            }
+            if (Random.RandRange(0, NumFree++) == 0)
+            {
+                Wander = Next;
+            }
+        });
+
+        if (NumFree == 0)
+        {
+            break;
+        }
+        Cell = Random.GetFraction() < RolloutExploreChance ? Wander : Greedy;
+    }
+
+    Action.MoveTo = Cell;
+    Target = FindTarget(Cell);
+    Action.Target = static_cast<int16>(Target);
+    return Action;
+}
+
+float FGridBattleState::Evaluate(int32 Faction) const
+{
+    int32 Own = 0;
+    int32 Enemy = 0;
+    int32 InitialOwn = 0;
+    int32 InitialEnemy = 0;
+    int32 Threatened = 0;
+
+    for (int32 Index = 0; Index < MaxFactions; ++Index)
+    {
+        (Index == Faction ? InitialOwn : InitialEnemy) += InitialHitPoints[Index];
+    }
+
+    for (const FGridBattleUnit& Unit : Units)
+    {
+        if (!Unit.IsAlive())
+        {
+            continue;
+        }
+        if (Unit.Faction == Faction)
+        {
+            Own += Unit.HitPoints;
+            for (int32 Other = 0; Other < MaxFactions; ++Other)
+            {
+                if (Other != Faction && GetThreat(Other, Unit.Cell) > 0)
+                {
+                    ++Threatened;
+                    break;
+                }
+            }
+        }
+        else
+        {
+            Enemy += Unit.HitPoints;
+        }
+    }
+
+    const float OwnFraction = InitialOwn > 0 ? float(Own) / InitialOwn : 0.f;
+    const float EnemyFraction = InitialEnemy > 0 ? float(Enemy) / InitialEnemy : 0.f;
+    return FMath::Clamp(0.5f + 0.5f * (OwnFraction - EnemyFraction) - ThreatPenalty * Threatened, 0.f, 1.f);
+}
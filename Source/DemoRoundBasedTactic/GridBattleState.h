@@ -0,0 +1,254 @@
+// GridBattleState.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridTypes.h"
+#include "GridBattleState.generated.h"
+
+class FGridTraversalGraph;
+struct FRandomStream;
+
+/**
+ * Per-cell array of a grid split into square chunks that forks share until one of
+ * them writes (copy-on-write).
+ *
+ * Copying the array copies ChunkSize² fewer pointers than cells and no cell data;
+ * the first write to a shared chunk clones just that chunk. Forks may live on
+ * different threads: chunks are reference counted atomically and never written
+ * while shared. A single array must not be written from two threads at once.
+ */
+template <typename ElementType, int32 ChunkShift = 5>
+class TGridCowArray
+{
+public:
+    static constexpr int32 ChunkSize = 1 << ChunkShift;
+    static constexpr int32 ChunkMask = ChunkSize - 1;
+
+    using FChunkRef = TSharedRef<TArray<ElementType>, ESPMode::ThreadSafe>;
+
+    /** Size the array and fill it with Value. All chunks start out shared. */
+    void Init(int32 InWidth, int32 InHeight, const ElementType& Value)
+    {
+        Width = FMath::Max(InWidth, 0);
+        Height = FMath::Max(InHeight, 0);
+        ChunksX = (Width + ChunkMask) >> ChunkShift;
+
+        FChunkRef Filled = MakeShared<TArray<ElementType>, ESPMode::ThreadSafe>();
+        Filled->Init(Value, ChunkSize * ChunkSize);
+
+        Chunks.Reset();
+        Chunks.Init(Filled, ChunksX * ((Height + ChunkMask) >> ChunkShift));
+    }
+
+    int32 GetWidth() const { return Width; }
+    int32 GetHeight() const { return Height; }
+
+    FORCEINLINE const ElementType& Get(int32 X, int32 Y) const
+    {
+        return (*Chunks[ChunkIndex(X, Y)])[LocalIndex(X, Y)];
+    }
+
+    /** Writable cell; clones its chunk first if a fork still shares it. */
+    FORCEINLINE ElementType& GetMutable(int32 X, int32 Y)
+    {
+        FChunkRef& Chunk = Chunks[ChunkIndex(X, Y)];
+        if (!Chunk.IsUnique())
+        {
+            Chunk = MakeShared<TArray<ElementType>, ESPMode::ThreadSafe>(*Chunk);
+        }
+        return (*Chunk)[LocalIndex(X, Y)];
+    }
+
+    /** Write Value; a no-op (and no clone) if the cell already holds it. */
+    FORCEINLINE void Set(int32 X, int32 Y, const ElementType& Value)
+    {
+        if (!(Get(X, Y) == Value))
+        {
+            GetMutable(X, Y) = Value;
+        }
+    }
+
+    /**
+     * Replace every chunk with a private copy, so this array and its forks stop touching the
+     * reference counts of the chunks it was copied from. Chunks this array holds several
+     * times (e.g. after Init) stay shared among themselves.
+     */
+    void Detach()
+    {
+        TMap<const TArray<ElementType>*, FChunkRef> Copies;
+        TArray<FChunkRef> Detached;
+        Detached.Reserve(Chunks.Num());
+        for (const FChunkRef& Chunk : Chunks)
+        {
+            if (const FChunkRef* Copy = Copies.Find(&Chunk.Get()))
+            {
+                Detached.Add(*Copy);
+                continue;
+            }
+            const FChunkRef& Copy = Copies.Add(&Chunk.Get(), MakeShared<TArray<ElementType>, ESPMode::ThreadSafe>(*Chunk));
+            Detached.Add(Copy);
+        }
+        Chunks = MoveTemp(Detached);
+    }
+
+    /** Number of chunks this array shares with Other (diagnostics). */
+    int32 CountSharedChunks(const TGridCowArray& Other) const
+    {
+        int32 Shared = 0;
+        for (int32 Index = 0; Index < FMath::Min(Chunks.Num(), Other.Chunks.Num()); ++Index)
+        {
+            Shared += &Chunks[Index].Get() == &Other.Chunks[Index].Get() ? 1 : 0;
+        }
+        return Shared;
+    }
+
+private:
+    FORCEINLINE int32 ChunkIndex(int32 X, int32 Y) const { return (Y >> ChunkShift) * ChunksX + (X >> ChunkShift); }
+    FORCEINLINE static int32 LocalIndex(int32 X, int32 Y) { return ((Y & ChunkMask) << ChunkShift) | (X & ChunkMask); }
+
+    int32 Width = 0;
+    int32 Height = 0;
+    int32 ChunksX = 0;
+    TArray<FChunkRef> Chunks;
+};
+
+/** A unit as seen by the AI's battle model. */
+USTRUCT(BlueprintType)
+struct FGridBattleUnit
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Battle")
+    int32 Faction = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Battle")
+    FIntPoint Cell = FIntPoint::ZeroValue;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Battle")
+    int32 HitPoints = 10;
+
+    /** Steps the unit may take per activation (along the traversal graph, ignoring step costs). */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Battle")
+    int32 MovePoints = 4;
+
+    /** Attack reach in grid steps. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Battle")
+    int32 AttackRange = 1;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Battle")
+    int32 AttackDamage = 3;
+
+    bool IsAlive() const { return HitPoints > 0; }
+};
+
+/** One activation: the unit moves to MoveTo (may be its own cell), then attacks Target if set. */
+struct FGridBattleAction
+{
+    int16 Unit = INDEX_NONE;
+    int16 Target = INDEX_NONE;
+    FIntPoint MoveTo = FIntPoint::ZeroValue;
+
+    bool operator==(const FGridBattleAction& Other) const
+    {
+        return Unit == Other.Unit && Target == Other.Target && MoveTo == Other.MoveTo;
+    }
+};
+
+/**
+ * Persistent battle state for AI lookahead, layered over a grid.
+ *
+ * Holds unit stats, cell occupancy and per-faction threat (how many living units of a
+ * faction can attack each cell). Occupancy and threat live in TGridCowArray chunks, so
+ * forking a state (a plain copy) costs a few dozen pointer copies and a unit array,
+ * and applying a hypothetical action only clones the chunks it writes.
+ * Undo is "drop the fork".
+ *
+ * Units activate one at a time in index order, skipping the dead; every activation is
+ * one ply. Movement follows the steps of a shared, immutable FGridTraversalGraph.
+ */
+class DEMOROUNDBASEDTACTIC_API FGridBattleState
+{
+public:
+    static constexpr int32 MaxFactions = 4;
+
+    /**
+     * Set up a battle on Config's grid. Units on cells outside the grid or on occupied
+     * cells are dropped. Graph must be baked for Config's grid; null allows every step
+     * between in-grid neighbour cells.
+     */
+    void Init(const FGridConfig& Config, TSharedPtr<const FGridTraversalGraph, ESPMode::ThreadSafe> InGraph, TConstArrayView<FGridBattleUnit> InUnits, int32 InMaxPlies = 400);
+
+    /** A copy that shares every chunk with this state until either writes. */
+    FGridBattleState Fork() const { return *this; }
+
+    /**
+     * A copy that shares no chunk with this state. Forks of the clone only touch the clone's
+     * reference counts, so each search worker clones the root once and forks from its clone.
+     */
+    FGridBattleState Clone() const;
+
+    int32 GetWidth() const { return Occupancy.GetWidth(); }
+    int32 GetHeight() const { return Occupancy.GetHeight(); }
+    EGridTopology GetTopology() const { return Topology; }
+
+    const TArray<FGridBattleUnit>& GetUnits() const { return Units; }
+
+    /** Unit index on Cell, or INDEX_NONE. */
+    FORCEINLINE int32 GetUnitAt(const FIntPoint& Cell) const { return Occupancy.Get(Cell.X, Cell.Y); }
+
+    /** Number of living units of Faction that can attack Cell from where they stand. */
+    FORCEINLINE int32 GetThreat(int32 Faction, const FIntPoint& Cell) const { return Threat[Faction].Get(Cell.X, Cell.Y); }
+
+    /** Unit to act next, or INDEX_NONE once the battle is over. */
+    int32 GetActiveUnit() const { return ActiveUnit; }
+    int32 GetActiveFaction() const { return Units.IsValidIndex(ActiveUnit) ? Units[ActiveUnit].Faction : INDEX_NONE; }
+
+    int32 GetPly() const { return Ply; }
+
+    /** True when at most one faction has living units or the ply limit is reached. */
+    bool IsTerminal() const { return ActiveUnit == INDEX_NONE; }
+
+    /** Apply an action of the active unit and pass the turn on. Actions must come from GenerateActions or be equally legal. */
+    void Apply(const FGridBattleAction& Action);
+
+    /**
+     * Candidate actions of the active unit: up to MaxMoves destinations (its own cell
+     * first, then the rest of its move range, sampled with Random if larger), each
+     * without attack and with every enemy in range afterwards.
+     */
+    void GenerateActions(TArray<FGridBattleAction>& OutActions, int32 MaxMoves, FRandomStream& Random) const;
+
+    /** Quick action for playouts: attack the weakest enemy in reach, otherwise close in on the nearest one. */
+    FGridBattleAction ChooseRolloutAction(FRandomStream& Random) const;
+
+    /** Score in [0, 1] for Faction: hit point balance, minus a little for own units standing under threat. */
+    float Evaluate(int32 Faction) const;
+
+    int32 GetStepDistance(const FIntPoint& A, const FIntPoint& B) const;
+
+private:
+    void MoveUnit(int32 UnitIndex, const FIntPoint& To);
+    void DamageUnit(int32 UnitIndex, int32 Damage);
+
+    /** Add Delta to the threat of Unit's faction on every cell it can attack. */
+    void ApplyThreat(const FGridBattleUnit& Unit, int32 Delta);
+
+    /** Call Visit(NeighborCell) for every cell one step from Cell. */
+    template <typename VisitorType>
+    void ForEachStep(const FIntPoint& Cell, VisitorType&& Visit) const;
+
+    void AdvanceTurn();
+
+    EGridTopology Topology = EGridTopology::Square4;
+    TSharedPtr<const FGridTraversalGraph, ESPMode::ThreadSafe> Graph;
+
+    TArray<FGridBattleUnit> Units;
+    TGridCowArray<int16> Occupancy;
+    TGridCowArray<uint8> Threat[MaxFactions];
+
+    int32 ActiveUnit = INDEX_NONE;
+    int32 Ply = 0;
+    int32 MaxPlies = 400;
+    int32 InitialHitPoints[MaxFactions] = {};
+};
@@ -0,0 +1,601 @@
+// GridBenchmarkCommandlet.cpp
+
+#include "GridBenchmarkCommandlet.h"
+#include "GridBallisticsLibrary.h"
+#include "GridBattleSearch.h"
+#include "GridCellLayout.h"
+#include "GridGeometryLibrary.h"
+#include "GridHeightField.h"
+#include "GridPathFollowSubsystem.h"
+#include "GridSearchLibrary.h"
+#include "GridTraversalGraph.h"
+#include "GridTypes.h"
+#include "SmoothingMath.h"
+
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace
+{
+    struct FBenchmarkResult
+    {
+        FString Name;
+        double NsPerOp = 0.0;
+        double OpsPerSecond = 0.0;
+    };
+
+    /** Largest grid side the traversal graph cases run at. */
+    constexpr int32 MaxGraphSize = 4096;
+
+    /** Written after every case so the optimizer cannot drop the measured work. */
+    volatile double GBenchmarkSink = 0.0;
+
+    /**
+     * Run Body (which performs NumOps operations and returns a checksum) once to warm
+     * caches, then Repeats times, and return the fastest run in nanoseconds per operation.
+     */
+    template <typename BodyType>
+    static FBenchmarkResult RunCase(const FString& Name, int32 NumOps, int32 Repeats, BodyType&& Body)
+    {
+        GBenchmarkSink = GBenchmarkSink + Body();
+
+        double BestSeconds = MAX_dbl;
+        for (int32 Repeat = 0; Repeat < Repeats; ++Repeat)
+        {
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            const double Checksum = Body();
+            const double Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+
+            GBenchmarkSink = GBenchmarkSink + Checksum;
+            BestSeconds = FMath::Min(BestSeconds, Seconds);
+        }
+
+        FBenchmarkResult Result;
+        Result.Name = Name;
+        Result.NsPerOp = BestSeconds * 1.0e9 / NumOps;
+        Result.OpsPerSecond = BestSeconds > 0.0 ? NumOps / BestSeconds : 0.0;
+
+        UE_LOG(LogTemp, Display, TEXT("%-48s %10.2f ns/op %14.0f ops/s"), *Result.Name, Result.NsPerOp, Result.OpsPerSecond);
+        return Result;
+    }
+
+    /** Cheap deterministic terrain: hashed plateaus, so height reads are not trivially predictable. */
+    static TSharedPtr<IGridHeightProvider> MakeBenchmarkHeights(int32 Size)
+    {
+        TArray<float> Heights;
+        Heights.SetNumUninitialized(Size * Size);
+
+        float* Data = Heights.GetData();
+        for (int32 Y = 0; Y < Size; ++Y)
+        {
+            for (int32 X = 0; X < Size; ++X)
+            {
+                const uint32 Hash = ((uint32(X >> 2) * 73856093u) ^ (uint32(Y >> 2) * 19349663u)) & 1023u;
+                Data[Y * Size + X] = Hash * 0.5f;
+            }
+        }
+
+        FGridHeightSnapshotRef Snapshot = new FGridHeightSnapshot(Size, Size, MoveTemp(Heights));
+        return MakeShared<FArrayGridHeightProvider>(Snapshot);
+    }
+
+    static FGridConfig MakeBenchmarkConfig(int32 Size, EGridTopology Topology, const TSharedPtr<IGridHeightProvider>& Heights)
+    {
+        FGridConfig Config;
+        Config.Width = Size;
+        Config.Height = Size;
+        Config.Topology = Topology;
+        Config.CellSize = 100.f;
+        Config.GridOrigin = FVector(-1000.f, 250.f, 0.f);
+        Config.bUseRotation = true;
+        Config.GridRotation = FRotator(0.f, 30.f, 0.f);
+        Config.HeightProvider = Heights;
+        return Config;
+    }
+
+    static FString TopologyName(EGridTopology Topology)
+    {
+        return StaticEnum<EGridTopology>()->GetNameStringByValue(static_cast<int64>(Topology));
+    }
+
+    static FString RoundingName(EGridRoundingPolicy Rounding)
+    {
+        return StaticEnum<EGridRoundingPolicy>()->GetNameStringByValue(static_cast<int64>(Rounding));
+    }
+
+    static void RunGridCases(int32 Size, int32 NumOps, int32 Repeats, TArray<FBenchmarkResult>& OutResults)
+    {
+        const TSharedPtr<IGridHeightProvider> Heights = MakeBenchmarkHeights(Size);
+
+        // Inputs are generated up front so that only the measured function is timed.
+        FRandomStream Random(Size);
+        TArray<FIntPoint> Cells;
+        Cells.SetNumUninitialized(NumOps);
+        for (FIntPoint& Cell : Cells)
+        {
+            Cell = FIntPoint(Random.RandRange(0, Size - 1), Random.RandRange(0, Size - 1));
+        }
+
+        const EGridTopology Topologies[] = { EGridTopology::Square4, EGridTopology::HexAxial };
+        for (const EGridTopology Topology : Topologies)
+        {
+            const FGridConfig Config = MakeBenchmarkConfig(Size, Topology, Heights);
+            const FString Suffix = FString::Printf(TEXT("%s/%d"), *TopologyName(Topology), Size);
+
+            TArray<FVector> Positions;
+            Positions.SetNumUninitialized(NumOps);
+            for (int32 Index = 0; Index < NumOps; ++Index)
+            {
+                Positions[Index] = UGridGeometryLibrary::GridToWorldGround(Config, Cells[Index])
+                    + FVector(Random.FRandRange(-40.f, 40.f), Random.FRandRange(-40.f, 40.f), 0.f);
+            }
+
+            OutResults.Add(RunCase(TEXT("GridToWorldGround/") + Suffix, NumOps, Repeats, [&]()
+            {
+                double Sum = 0.0;
+                for (const FIntPoint& Cell : Cells)
+                {
+                    Sum += UGridGeometryLibrary::GridToWorldGround(Config, Cell).X;
+                }
+                return Sum;
+            }));
+
+            // Same cells through the batched path used by overlays.
+            TArray<FVector> BatchLocations;
+            BatchLocations.SetNumUninitialized(NumOps);
+            OutResults.Add(RunCase(TEXT("GridToWorldGroundBatch/") + Suffix, NumOps, Repeats, [&]()
+            {
+                UGridGeometryLibrary::GridToWorldGroundBatch(Config, Cells, BatchLocations);
+                double Sum = 0.0;
+                for (const FVector& Location : BatchLocations)
+                {
+                    Sum += Location.X;
+                }
+                return Sum;
+            }));
+
+            const EGridRoundingPolicy Roundings[] = { EGridRoundingPolicy::Floor, EGridRoundingPolicy::Round, EGridRoundingPolicy::Ceil };
+            for (const EGridRoundingPolicy Rounding : Roundings)
+            {
+                // Hex grids ignore the rounding policy; measuring it three times adds nothing.
+                if (Topology == EGridTopology::HexAxial && Rounding != EGridRoundingPolicy::Floor)
+                {
+                    continue;
+                }
+
+                const FString Name = FString::Printf(TEXT("WorldToGrid/%s/%s/%d"), *TopologyName(Topology), *RoundingName(Rounding), Size);
+                OutResults.Add(RunCase(Name, NumOps, Repeats, [&]()
+                {
+                    double Sum = 0.0;
+                    FIntPoint Cell;
+                    for (const FVector& Position : Positions)
+                    {
+                        UGridGeometryLibrary::WorldToGrid(Config, Position, Cell, true, Rounding);
+                        Sum += Cell.X;
+                    }
+                    return Sum;
+                }));
+            }
+        }
+
+        // Movement range on the fly versus over the baked traversal graph. The graph build
+        // needs several GB of scratch past MaxGraphSize, so larger grids skip these cases.
+        if (Size <= MaxGraphSize)
+        {
+            const FGridConfig Config = MakeBenchmarkConfig(Size, EGridTopology::Square8, Heights);
+            const FGridMovementProfile Profile;
+            constexpr int32 NumSearches = 16;
+            constexpr float SearchCost = 12.f;
+
+            FGridTraversalGraph Graph;
+            OutResults.Add(RunCase(FString::Printf(TEXT("TraversalGraphBuild/%d"), Size), Size * Size, Repeats, [&]()
+            {
+                Graph.Build(Config, Profile);
+                return double(Graph.GetNumEdges());
+            }));
+
+            TArray<FIntPoint> ReachCells;
+            TArray<float> ReachCosts;
+            OutResults.Add(RunCase(FString::Printf(TEXT("FindReachableCells/Live/%d"), Size), NumSearches, Repeats, [&]()
+            {
+                double Sum = 0.0;
+                for (int32 Search = 0; Search < NumSearches; ++Search)
+                {
+                    UGridSearchLibrary::FindReachableCells(Config, Profile, Cells[Search % Cells.Num()], SearchCost, ReachCells, ReachCosts);
+                    Sum += ReachCells.Num();
+                }
+                return Sum;
+            }));
+            OutResults.Add(RunCase(FString::Printf(TEXT("FindReachableCells/Graph/%d"), Size), NumSearches, Repeats, [&]()
+            {
+                double Sum = 0.0;
+                for (int32 Search = 0; Search < NumSearches; ++Search)
+                {
+                    UGridSearchLibrary::FindReachableCellsOnGraph(Graph, Cells[Search % Cells.Num()], SearchCost, ReachCells, ReachCosts);
+                    Sum += ReachCells.Num();
+                }
+                return Sum;
+            }));
+        }
+
+        // Artillery preview: every cell within 12 steps of one launch cell.
+        {
+            const FGridConfig Config = MakeBenchmarkConfig(Size, EGridTopology::Square8, Heights);
+            const FIntPoint Launch(Size / 2, Size / 2);
+            TArray<FIntPoint> Targets;
+            for (int32 Y = FMath::Max(Launch.Y - 12, 0); Y <= FMath::Min(Launch.Y + 12, Size - 1); ++Y)
+            {
+                for (int32 X = FMath::Max(Launch.X - 12, 0); X <= FMath::Min(Launch.X + 12, Size - 1); ++X)
+                {
+                    Targets.Add(FIntPoint(X, Y));
+                }
+            }
+
+            const FGridArcSettings ArcSettings;
+            FGridCellMask Clear;
+            TArray<FIntPoint> Impacts;
+            OutResults.Add(RunCase(FString::Printf(TEXT("TraceArcs/%d"), Size), Targets.Num(), Repeats, [&]()
+            {
+                UGridBallisticsLibrary::TraceArcs(Config, Launch, Targets, ArcSettings, Clear, Impacts);
+                return double(Clear.Num());
+            }));
+        }
+
+        // Path following: 256 movers stepping along one shared polyline for 60 frames.
+        {
+            const FGridConfig Config = MakeBenchmarkConfig(Size, EGridTopology::Square8, Heights);
+            TArray<FIntPoint> Path;
+            for (int32 Step = 0; Step < Size; ++Step)
+            {
+                Path.Add(FIntPoint(Step, (Step / 4) % Size));
+            }
+
+            const TSharedRef<const FGridPathPolyline, ESPMode::ThreadSafe> Polyline = FGridPathPolyline::Build(Config, Path, 2);
+            constexpr int32 NumMovers = 256;
+            constexpr int32 NumFrames = 60;
+            const float StepPerFrame = Polyline->GetLength() / NumFrames;
+
+            OutResults.Add(RunCase(FString::Printf(TEXT("PathFollow/Advance/%d"), Size), NumMovers * NumFrames, Repeats, [&]()
+            {
+                TArray<int32> Segments;
+                Segments.Init(0, NumMovers);
+                double Sum = 0.0;
+                FVector Direction;
+                for (int32 Frame = 1; Frame <= NumFrames; ++Frame)
+                {
+                    for (int32 Mover = 0; Mover < NumMovers; ++Mover)
+                    {
+                        Sum += Polyline->Advance(StepPerFrame * Frame, Segments[Mover], Direction).Z;
+                    }
+                }
+                return Sum;
+            }));
+        }
+
+        // Row-major versus tiled height storage, for a wide search and a 3x3 kernel.
+        // Search state is paged per thread (FSearchNodes in GridSearchLibrary.cpp), so neither
+        // layout pays an initialisation of its whole storage and the cases compare neighbour access.
+        {
+            const TArrayView<const float> RowMajorHeights = Heights->GetCellHeights();
+            const FGridMovementProfile Profile;
+            constexpr int32 NumSearches = 4;
+            constexpr float SearchCost = 48.f;
+
+            const EGridCellLayout Layouts[] = { EGridCellLayout::RowMajor, EGridCellLayout::Tiled };
+            for (const EGridCellLayout Layout : Layouts)
+            {
+                const TCHAR* LayoutName = Layout == EGridCellLayout::Tiled ? TEXT("Tiled") : TEXT("RowMajor");
+
+                TGridCellArray<float> LayoutHeights;
+                LayoutHeights.InitFromRowMajor(FGridCellLayout(Layout, Size, Size), RowMajorHeights);
+
+                TArray<FIntPoint> ReachCells;
+                TArray<float> ReachCosts;
+                OutResults.Add(RunCase(FString::Printf(TEXT("CellLayout/FindReachableCells/%s/%d"), LayoutName, Size), NumSearches, Repeats, [&]()
+                {
+                    double Sum = 0.0;
+                    for (int32 Search = 0; Search < NumSearches; ++Search)
+                    {
+                        UGridSearchLibrary::FindReachableCellsInLayout(LayoutHeights, EGridTopology::Square8, Profile, Cells[Search % Cells.Num()], SearchCost, ReachCells, ReachCosts);
+                        Sum += ReachCells.Num();
+                    }
+                    return Sum;
+                }));
+
+                // Steepest drop to any of the 8 neighbours, in storage order.
+                TGridCellArray<float> Slopes;
+                Slopes.Init(LayoutHeights.GetLayout(), 0.f);
+                OutResults.Add(RunCase(FString::Printf(TEXT("CellLayout/SlopeKernel/%s/%d"), LayoutName, Size), Size * Size, Repeats, [&]()
+                {
+                    const float* Source = LayoutHeights.GetData();
+                    LayoutHeights.GetLayout().Dispatch([&](const auto& Indexer)
+                    {
+                        Indexer.ForEachCell([&](const FIntPoint& Cell, int32 Index)
+                        {
+                            const float Z = Source[Index];
+                            float Steepest = 0.f;
+                            for (int32 DY = -1; DY <= 1; ++DY)
+                            {
+                                for (int32 DX = -1; DX <= 1; ++DX)
+                                {
+                                    const int32 X = FMath::Clamp(Cell.X + DX, 0, Size - 1);
+                                    const int32 Y = FMath::Clamp(Cell.Y + DY, 0, Size - 1);
+                                    Steepest = FMath::Max(Steepest, Z - Source[Indexer.ToIndex(X, Y)]);
+                                }
+                            }
+                            Slopes.GetAtIndex(Index) = Steepest;
+                        });
+                    });
+                    return double(Slopes.Get(Size / 2, Size / 2));
+                }));
+            }
+        }
+
+        // Through the interface, as gameplay code sees it.
+        const IGridHeightProvider& Provider = *Heights;
+        OutResults.Add(RunCase(FString::Printf(TEXT("GetHeightAt/%d"), Size), NumOps, Repeats, [&]()
+        {
+            double Sum = 0.0;
+            for (const FIntPoint& Cell : Cells)
+            {
+                Sum += Provider.GetHeightAt(Cell.X, Cell.Y);
+            }
+            return Sum;
+        }));
+    }
+
+    static void RunSmoothingCases(int32 NumOps, int32 Repeats, TArray<FBenchmarkResult>& OutResults)
+    {
+        // Varying frame times, as after hitches; the state carries over between operations.
+        FRandomStream Random(42);
+        TArray<float> Steps;
+        Steps.SetNumUninitialized(NumOps);
+        for (float& Step : Steps)
+        {
+            Step = Random.FRandRange(1.f / 240.f, 1.f / 15.f);
+        }
+
+        const float HalfLife = 0.15f;
+
+        OutResults.Add(RunCase(TEXT("Smoothing/ExpSmoothHL"), NumOps, Repeats, [&]()
+        {
+            float Current = 0.f;
+            for (int32 Index = 0; Index < NumOps; ++Index)
+            {
+                Current = SmoothingMath::ExpSmoothHL(Current, float(Index & 255), HalfLife, Steps[Index]);
+            }
+            return double(Current);
+        }));
+
+        OutResults.Add(RunCase(TEXT("Smoothing/SpringUpdate1D"), NumOps, Repeats, [&]()
+        {
+            float Current = 0.f, Velocity = 0.f;
+            for (int32 Index = 0; Index < NumOps; ++Index)
+            {
+                SmoothingMath::SpringUpdate1D(HalfLife, Steps[Index], float(Index & 255), Current, Velocity);
+            }
+            return double(Current);
+        }));
+
+        OutResults.Add(RunCase(TEXT("Smoothing/SpringUpdate2D"), NumOps, Repeats, [&]()
+        {
+            FVector2D Current = FVector2D::ZeroVector, Velocity = FVector2D::ZeroVector;
+            for (int32 Index = 0; Index < NumOps; ++Index)
+            {
+                SmoothingMath::SpringUpdate2D(HalfLife, Steps[Index], FVector2D(Index & 255, Index & 127), Current, Velocity);
+            }
+            return Current.X;
+        }));
+
+        OutResults.Add(RunCase(TEXT("Smoothing/SpringUpdateExact3D"), NumOps, Repeats, [&]()
+        {
+            FVector Current = FVector::ZeroVector, Velocity = FVector::ZeroVector;
+            const FVector DesireVelocity(10.f, -5.f, 2.f);
+            for (int32 Index = 0; Index < NumOps; ++Index)
+            {
+                SmoothingMath::SpringUpdateExact(HalfLife, Steps[Index], FVector(Index & 255, Index & 127, 0.f), DesireVelocity, Current, Velocity);
+            }
+            return Current.X;
+        }));
+
+        OutResults.Add(RunCase(TEXT("Smoothing/SpringUpdateQuat"), NumOps, Repeats, [&]()
+        {
+            FQuat Current = FQuat::Identity;
+            FVector AngularVelocity = FVector::ZeroVector;
+            const FQuat Desire(FRotator(10.f, 120.f, 0.f));
+            for (int32 Index = 0; Index < NumOps; ++Index)
+            {
+                SmoothingMath::SpringUpdateQuat(HalfLife, Steps[Index], Desire, Current, AngularVelocity);
+            }
+            return double(Current.W);
+        }));
+    }
+
+    /** AI lookahead on a 128x128 map: 8 units a side facing each other across the middle. */
+    static void RunBattleCases(int32 Repeats, TArray<FBenchmarkResult>& OutResults)
+    {
+        constexpr int32 Size = 128;
+        const FGridConfig Config = MakeBenchmarkConfig(Size, EGridTopology::Square8, MakeBenchmarkHeights(Size));
+
+        const TSharedRef<FGridTraversalGraph, ESPMode::ThreadSafe> Graph = MakeShared<FGridTraversalGraph, ESPMode::ThreadSafe>();
+        Graph->Build(Config, FGridMovementProfile());
+
+        TArray<FGridBattleUnit> Units;
+        for (int32 Faction = 0; Faction < 2; ++Faction)
+        {
+            for (int32 Index = 0; Index < 8; ++Index)
+            {
+                FGridBattleUnit& Unit = Units.AddDefaulted_GetRef();
+                Unit.Faction = Faction;
+                Unit.Cell = FIntPoint(56 + Index * 2, Faction == 0 ? 58 : 70);
+                Unit.AttackRange = 1 + Index % 3;
+            }
+        }
+
+        FGridBattleState Root;
+        Root.Init(Config, Graph, Units);
+
+        FGridBattleSearchSettings Settings;
+        Settings.Iterations = 4096;
+
+        OutResults.Add(RunCase(FString::Printf(TEXT("BattleMCTS/Playouts/%d"), Size), Settings.Iterations, Repeats, [&]()
+        {
+            const FGridBattleSearchResult Result = GridBattleSearch::FindBestAction(Root, Settings);
+            return double(Result.BestScore) + Result.BestAction.MoveTo.X;
+        }));
+
+        // Forking is the per-iteration overhead of the search.
+        constexpr int32 NumForks = 4096;
+        OutResults.Add(RunCase(FString::Printf(TEXT("BattleState/ForkApply/%d"), Size), NumForks, Repeats, [&]()
+        {
+            FRandomStream Random(Size);
+            double Sum = 0.0;
+            for (int32 Fork = 0; Fork < NumForks; ++Fork)
+            {
+                FGridBattleState State = Root.Fork();
+                State.Apply(State.ChooseRolloutAction(Random));
+                Sum += State.GetActiveUnit();
+            }
+            return Sum;
+        }));
+    }
+
+    static bool SaveResults(const FString& Path, const TArray<FBenchmarkResult>& Results)
+    {
+        TArray<TSharedPtr<FJsonValue>> Entries;
+        for (const FBenchmarkResult& Result : Results)
+        {
+            TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+            Entry->SetStringField(TEXT("name"), Result.Name);
+            Entry->SetNumberField(TEXT("ns_per_op"), Result.NsPerOp);
+            Entry->SetNumberField(TEXT("ops_per_sec"), Result.OpsPerSecond);
+            Entries.Add(MakeShared<FJsonValueObject>(Entry));
+        }
+
+        TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+        Root->SetStringField(TEXT("platform"), FPlatformProperties::PlatformName());
+        Root->SetArrayField(TEXT("results"), Entries);
+
+        FString Text;
+        const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Text);
+        return FJsonSerializer::Serialize(Root, Writer) && FFileHelper::SaveStringToFile(Text, *Path);
+    }
+
+    static bool LoadBaseline(const FString& Path, TMap<FString, double>& OutNsPerOp)
+    {
+        FString Text;
+        if (!FFileHelper::LoadFileToString(Text, *Path))
+        {
+            return false;
+        }
+
+        TSharedPtr<FJsonObject> Root;
+        if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Root) || !Root.IsValid())
+        {
+            return false;
+        }
+
+        const TArray<TSharedPtr<FJsonValue>>* Entries = nullptr;
+        if (!Root->TryGetArrayField(TEXT("results"), Entries))
+        {
+            return false;
+        }
+
+        for (const TSharedPtr<FJsonValue>& Value : *Entries)
+        {
+            const TSharedPtr<FJsonObject>* Entry = nullptr;
+            FString Name;
+            double NsPerOp = 0.0;
+            if (Value->TryGetObject(Entry) &&
+                (*Entry)->TryGetStringField(TEXT("name"), Name) &&
+                (*Entry)->TryGetNumberField(TEXT("ns_per_op"), NsPerOp))
+            {
+                OutNsPerOp.Add(Name, NsPerOp);
+            }
+        }
+        return true;
+    }
+}
+
+UGridBenchmarkCommandlet::UGridBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UGridBenchmarkCommandlet::Main(const FString& Params)
+{
+    FString SizesString = TEXT("64,512,2048");
+    FParse::Value(*Params, TEXT("Sizes="), SizesString, false);
+
+    int32 NumOps = 1 << 20;
+    FParse::Value(*Params, TEXT("Ops="), NumOps);
+    NumOps = FMath::Max(NumOps, 1);
+
+    int32 Repeats = 5;
+    FParse::Value(*Params, TEXT("Repeats="), Repeats);
+    Repeats = FMath::Max(Repeats, 1);
+
+    float Threshold = 0.10f;
+    FParse::Value(*Params, TEXT("Threshold="), Threshold);
+
+    FString OutputPath;
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+    FString BaselinePath;
+    FParse::Value(*Params, TEXT("Baseline="), BaselinePath);
+
+    TArray<FString> SizeTokens;
+    SizesString.ParseIntoArray(SizeTokens, TEXT(","));
+
+    TArray<FBenchmarkResult> Results;
+    for (const FString& Token : SizeTokens)
+    {
+        const int32 Size = FCString::Atoi(*Token);
+        if (Size > 0)
+        {
+            RunGridCases(Size, NumOps, Repeats, Results);
+        }
+    }
+    RunSmoothingCases(NumOps, Repeats, Results);
+    RunBattleCases(Repeats, Results);
+
+    bool bFailed = false;
+
+    if (!OutputPath.IsEmpty() && !SaveResults(OutputPath, Results))
+    {
+        UE_LOG(LogTemp, Error, TEXT("GridBenchmark: could not write %s"), *OutputPath);
+        bFailed = true;
+    }
+
+    if (!BaselinePath.IsEmpty())
+    {
+        TMap<FString, double> Baseline;
+        if (!LoadBaseline(BaselinePath, Baseline))
+        {
+            UE_LOG(LogTemp, Error, TEXT("GridBenchmark: could not read baseline %s"), *BaselinePath);
+            return 1;
+        }
+
+        for (const FBenchmarkResult& Result : Results)
+        {
+            const double* BaselineNs = Baseline.Find(Result.Name);
+            if (BaselineNs && *BaselineNs > 0.0 && Result.NsPerOp > *BaselineNs * (1.0 + Threshold))
+            {
+                UE_LOG(LogTemp, Error, TEXT("GridBenchmark regression: %s %.2f ns/op vs. baseline %.2f ns/op (+%.1f%%)"),
+                    *Result.Name, Result.NsPerOp, *BaselineNs, (Result.NsPerOp / *BaselineNs - 1.0) * 100.0);
+                bFailed = true;
+            }
+        }
+    }
+
+    return bFailed ? 1 : 0;
+}
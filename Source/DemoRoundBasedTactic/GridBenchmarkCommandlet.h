@@ -0,0 +1,36 @@
+// GridBenchmarkCommandlet.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GridBenchmarkCommandlet.generated.h"
+
+/**
+ * Headless micro-benchmarks for the grid geometry and smoothing hot paths.
+ *
+ * Usage (Linux, no GPU needed):
+ *
+ *   UnrealEditor-Cmd <Project>.uproject -run=GridBenchmark -nullrhi -unattended
+ *       [-Sizes=64,512,2048] [-Ops=1048576] [-Repeats=5]
+ *       [-Output=<results.json>] [-Baseline=<baseline.json>] [-Threshold=0.10]
+ *
+ * Every case runs Ops operations on pre-generated random inputs, Repeats times, and
+ * reports the fastest run as ns/op and ops/s. Grid cases are run per grid size,
+ * topology and (for WorldToGrid) rounding policy. Results are written as JSON to
+ * Output; a previous Output file can be passed back as Baseline. Traversal graph
+ * cases are skipped for sizes above 4096.
+ *
+ * @return 0 on success, 1 if any case is slower than its baseline by more than
+ *         Threshold (a fraction, 0.10 = 10%).
+ */
+UCLASS()
+class UGridBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UGridBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,181 @@
+// GridCellAttributes.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridCellAttributes.generated.h"
+
+/**
+ * Schema entry of one per-cell attribute channel of a UTerrainHeightMapAsset
+ * (terrain type, movement cost multiplier, cover class, blocker flags, ...).
+ *
+ * Values are unsigned integers of NumBits bits; GetFloat maps them to
+ * Value * Scale + Offset for quantized continuous data.
+ */
+USTRUCT(BlueprintType)
+struct FGridAttributeChannelDesc
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid|Attributes")
+    FName Name;
+
+    /** Bits per cell. Rounded up to 1, 2, 4, 8, 16 or 32 so that no value straddles a word. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid|Attributes", meta = (ClampMin = "1", ClampMax = "32"))
+    int32 NumBits = 8;
+
+    /** Value of cells that have never been written. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid|Attributes", meta = (ClampMin = "0"))
+    int32 DefaultValue = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid|Attributes")
+    float Scale = 1.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid|Attributes")
+    float Offset = 0.f;
+
+    /** NumBits as stored. */
+    int32 GetStoredBits() const
+    {
+        return int32(FMath::RoundUpToPowerOfTwo(uint32(FMath::Clamp(NumBits, 1, 32))));
+    }
+};
+
+/**
+ * Storage of one attribute channel: Width * Height values packed row-major
+ * (Index = Y * Width + X, like CellHeights) into 32-bit words.
+ *
+ * Name, size and default record what the data was built for, so that schema edits
+ * (reordering, resizing the grid, a new DefaultValue) can be matched against it.
+ */
+USTRUCT()
+struct FGridPackedAttributeChannel
+{
+    GENERATED_BODY()
+
+    /** Schema channel the data belongs to. */
+    UPROPERTY()
+    FName Name;
+
+    UPROPERTY()
+    int32 Width = 0;
+
+    UPROPERTY()
+    int32 Height = 0;
+
+    /** DefaultValue of the channel when the data was built. */
+    UPROPERTY()
+    int32 DefaultValue = 0;
+
+    UPROPERTY()
+    int32 BitsPerValue = 0;
+
+    UPROPERTY()
+    TArray<uint32> Words;
+
+    static int32 GetNumWords(int32 NumValues, int32 BitsPerValue)
+    {
+        return int32((int64(NumValues) * BitsPerValue + 31) >> 5);
+    }
+};
+
+/**
+ * Read-only view of a packed channel: array indexing and bulk unpacking without copying
+ * or hashing. Valid as long as the asset's channel is not resized.
+ */
+struct FGridAttributeView
+{
+    const uint32* Words = nullptr;
+    int32 Num = 0;
+    int32 BitsPerValue = 0;
+    uint32 Mask = 0;
+    float Scale = 1.f;
+    float Offset = 0.f;
+
+    FGridAttributeView() = default;
+
+    FGridAttributeView(const FGridPackedAttributeChannel& Channel, const FGridAttributeChannelDesc& Desc, int32 InNum)
+        : Words(Channel.Words.GetData())
+        , Num(InNum)
+        , BitsPerValue(Channel.BitsPerValue)
+        , Mask(Channel.BitsPerValue >= 32 ? MAX_uint32 : (1u << Channel.BitsPerValue) - 1)
+        , Scale(Desc.Scale)
+        , Offset(Desc.Offset)
+    {
+    }
+
+    bool IsValid() const { return Words != nullptr && BitsPerValue > 0; }
+
+    /** Raw value of the cell at row-major Index. */
+    FORCEINLINE uint32 operator[](int32 Index) const
+    {
+        checkSlow(Index >= 0 && Index < Num);
+        const int64 Bit = int64(Index) * BitsPerValue;
+        return (Words[Bit >> 5] >> (Bit & 31)) & Mask;
+    }
+
+    FORCEINLINE bool GetBool(int32 Index) const { return (*this)[Index] != 0; }
+    FORCEINLINE float GetFloat(int32 Index) const { return float((*this)[Index]) * Scale + Offset; }
+
+    /** Raw value cast to an enum or integer type. */
+    template <typename ValueType>
+    FORCEINLINE ValueType Get(int32 Index) const { return static_cast<ValueType>((*this)[Index]); }
+
+    /** Unpack every value into OutValues (Num entries). */
+    template <typename ValueType>
+    void Unpack(TArray<ValueType>& OutValues) const
+    {
+        OutValues.SetNumUninitialized(Num);
+        const int32 PerWord = 32 / FMath::Max(BitsPerValue, 1);
+        for (int32 WordIndex = 0, Index = 0; Index < Num; ++WordIndex)
+        {
+            uint32 Word = Words[WordIndex];
+            for (int32 Slot = 0; Slot < PerWord && Index < Num; ++Slot, ++Index)
+            {
+                OutValues[Index] = static_cast<ValueType>(Word & Mask);
+                Word = BitsPerValue >= 32 ? 0 : Word >> BitsPerValue;
+            }
+        }
+    }
+
+    /** Unpack every value as Value * Scale + Offset. */
+    void UnpackFloats(TArray<float>& OutValues) const
+    {
+        Unpack(OutValues);
+        for (float& Value : OutValues)
+        {
+            Value = Value * Scale + Offset;
+        }
+    }
+};
+
+/** Texture channel an attribute is imported from. */
+UENUM(BlueprintType)
+enum class EGridTextureChannel : uint8
+{
+    R,
+    G,
+    B,
+    A,
+};
+
+/** Import rule of one attribute channel for UTerrainHeightMapLibrary::ImportAttributeChannelsFromTexture. */
+USTRUCT(BlueprintType)
+struct FGridAttributeChannelImport
+{
+    GENERATED_BODY()
+
+    /** Schema channel to fill. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Attributes")
+    FName Channel;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Attributes")
+    EGridTextureChannel SourceChannel = EGridTextureChannel::R;
+
+    /**
+     * Right shift applied to the texel before storing, e.g. 4 to keep the top four bits
+     * of an 8-bit channel. Values that still do not fit the channel are clamped.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Attributes", meta = (ClampMin = "0", ClampMax = "15"))
+    int32 Shift = 0;
+};
@@ -0,0 +1,212 @@
+// GridCellLayout.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Memory order of per-cell arrays.
+ *
+ * RowMajor is the project-wide default (Index = Y * Width + X, see UTerrainHeightMapAsset).
+ * On wide maps a vertical step in row-major order jumps a whole row (16 KB of floats at
+ * 4096 cells), so neighbourhood-heavy work (searches, 2D kernels) misses cache on every
+ * row change. Tiled stores 8x8 blocks contiguously instead: all eight neighbours of a cell
+ * lie in the same 256-byte block most of the time.
+ */
+enum class EGridCellLayout : uint8
+{
+    RowMajor,
+    Tiled,
+};
+
+/** Index conversion for the row-major layout. */
+struct FGridRowMajorIndexer
+{
+    static constexpr EGridCellLayout Layout = EGridCellLayout::RowMajor;
+
+    int32 Width = 0;
+    int32 Height = 0;
+
+    FGridRowMajorIndexer() = default;
+    FGridRowMajorIndexer(int32 InWidth, int32 InHeight) : Width(InWidth), Height(InHeight) {}
+
+    /** Size of an array in this layout. */
+    FORCEINLINE int32 GetNumStorage() const { return Width * Height; }
+
+    FORCEINLINE int32 ToIndex(int32 X, int32 Y) const { return Y * Width + X; }
+    FORCEINLINE FIntPoint ToCell(int32 Index) const { return FIntPoint(Index % Width, Index / Width); }
+
+    /** Call Visit(Cell, Index) for every cell, in storage order. */
+    template <typename VisitorType>
+    FORCEINLINE void ForEachCell(VisitorType&& Visit) const
+    {
+        int32 Index = 0;
+        for (int32 Y = 0; Y < Height; ++Y)
+        {
+            for (int32 X = 0; X < Width; ++X)
+            {
+                Visit(FIntPoint(X, Y), Index++);
+            }
+        }
+    }
+};
+
+/**
+ * Index conversion for the tiled layout: 8x8 tiles stored one after another in row-major
+ * tile order, cells row-major inside a tile. The grid is padded to whole tiles; padding
+ * slots are never visited.
+ */
+struct FGridTiledIndexer
+{
+    static constexpr EGridCellLayout Layout = EGridCellLayout::Tiled;
+    static constexpr int32 TileShift = 3;
+    static constexpr int32 TileSize = 1 << TileShift;
+    static constexpr int32 TileMask = TileSize - 1;
+
+    int32 Width = 0;
+    int32 Height = 0;
+    int32 TilesX = 0;
+    int32 TilesY = 0;
+
+    FGridTiledIndexer() = default;
+    FGridTiledIndexer(int32 InWidth, int32 InHeight)
+        : Width(InWidth)
+        , Height(InHeight)
+        , TilesX((InWidth + TileMask) >> TileShift)
+        , TilesY((InHeight + TileMask) >> TileShift)
+    {
+    }
+
+    FORCEINLINE int32 GetNumStorage() const { return (TilesX * TilesY) << (2 * TileShift); }
+
+    FORCEINLINE int32 ToIndex(int32 X, int32 Y) const
+    {
+        const int32 Tile = (Y >> TileShift) * TilesX + (X >> TileShift);
+        return (Tile << (2 * TileShift)) | ((Y & TileMask) << TileShift) | (X & TileMask);
+    }
+
+    FORCEINLINE FIntPoint ToCell(int32 Index) const
+    {
+        const int32 Tile = Index >> (2 * TileShift);
+        const int32 TileY = Tile / TilesX;
+        const int32 TileX = Tile - TileY * TilesX;
+        return FIntPoint((TileX << TileShift) | (Index & TileMask), (TileY << TileShift) | ((Index >> TileShift) & TileMask));
+    }
+
+    template <typename VisitorType>
+    FORCEINLINE void ForEachCell(VisitorType&& Visit) const
+    {
+        for (int32 TileY = 0; TileY < TilesY; ++TileY)
+        {
+            for (int32 TileX = 0; TileX < TilesX; ++TileX)
+            {
+                const int32 MinX = TileX << TileShift;
+                const int32 MinY = TileY << TileShift;
+                const int32 MaxX = FMath::Min(MinX + TileSize, Width);
+                const int32 MaxY = FMath::Min(MinY + TileSize, Height);
+
+                int32 RowIndex = (TileY * TilesX + TileX) << (2 * TileShift);
+                for (int32 Y = MinY; Y < MaxY; ++Y, RowIndex += TileSize)
+                {
+                    for (int32 X = MinX; X < MaxX; ++X)
+                    {
+                        Visit(FIntPoint(X, Y), RowIndex + (X - MinX));
+                    }
+                }
+            }
+        }
+    }
+};
+
+/** Layout chosen at runtime. Hot loops should Dispatch once and use the typed indexer. */
+struct FGridCellLayout
+{
+    EGridCellLayout Layout = EGridCellLayout::RowMajor;
+    int32 Width = 0;
+    int32 Height = 0;
+
+    FGridCellLayout() = default;
+    FGridCellLayout(EGridCellLayout InLayout, int32 InWidth, int32 InHeight) : Layout(InLayout), Width(InWidth), Height(InHeight) {}
+
+    /** Call Func with the FGridRowMajorIndexer or FGridTiledIndexer of this layout; returns its result. */
+    template <typename FuncType>
+    FORCEINLINE decltype(auto) Dispatch(FuncType&& Func) const
+    {
+        if (Layout == EGridCellLayout::Tiled)
+        {
+            return Func(FGridTiledIndexer(Width, Height));
+        }
+        return Func(FGridRowMajorIndexer(Width, Height));
+    }
+
+    int32 GetNumStorage() const { return Dispatch([](const auto& Indexer) { return Indexer.GetNumStorage(); }); }
+    int32 ToIndex(int32 X, int32 Y) const { return Dispatch([X, Y](const auto& Indexer) { return Indexer.ToIndex(X, Y); }); }
+    FIntPoint ToCell(int32 Index) const { return Dispatch([Index](const auto& Indexer) { return Indexer.ToCell(Index); }); }
+};
+
+/**
+ * Per-cell array in a chosen layout. Callers address cells by coordinates and iterate
+ * with ForEachCell, so the layout stays an implementation detail.
+ */
+template <typename ElementType>
+class TGridCellArray
+{
+public:
+    void Init(const FGridCellLayout& InLayout, const ElementType& Value)
+    {
+        Layout = InLayout;
+        Data.Init(Value, Layout.GetNumStorage());
+    }
+
+    /** Copy a row-major array (Index = Y * Width + X) into InLayout. */
+    void InitFromRowMajor(const FGridCellLayout& InLayout, TConstArrayView<ElementType> RowMajor)
+    {
+        check(RowMajor.Num() == InLayout.Width * InLayout.Height);
+
+        Layout = InLayout;
+        Data.SetNumZeroed(Layout.GetNumStorage());
+        Layout.Dispatch([this, RowMajor](const auto& Indexer)
+        {
+            Indexer.ForEachCell([this, RowMajor, &Indexer](const FIntPoint& Cell, int32 Index)
+            {
+                Data[Index] = RowMajor[Cell.Y * Indexer.Width + Cell.X];
+            });
+        });
+    }
+
+    /** Copy back into row-major order. */
+    void CopyToRowMajor(TArray<ElementType>& OutRowMajor) const
+    {
+        OutRowMajor.SetNumUninitialized(Layout.Width * Layout.Height);
+        ForEachCell([&OutRowMajor, this](const FIntPoint& Cell, const ElementType& Value)
+        {
+            OutRowMajor[Cell.Y * Layout.Width + Cell.X] = Value;
+        });
+    }
+
+    const FGridCellLayout& GetLayout() const { return Layout; }
+    int32 GetWidth() const { return Layout.Width; }
+    int32 GetHeight() const { return Layout.Height; }
+
+    FORCEINLINE const ElementType& Get(int32 X, int32 Y) const { return Data[Layout.ToIndex(X, Y)]; }
+    FORCEINLINE ElementType& Get(int32 X, int32 Y) { return Data[Layout.ToIndex(X, Y)]; }
+
+    /** Storage-order access for code that has dispatched on the layout itself. */
+    FORCEINLINE const ElementType& GetAtIndex(int32 Index) const { return Data[Index]; }
+    FORCEINLINE ElementType& GetAtIndex(int32 Index) { return Data[Index]; }
+    const ElementType* GetData() const { return Data.GetData(); }
+
+    /** Call Visit(Cell, Value) for every cell, in storage order. */
+    template <typename VisitorType>
+    void ForEachCell(VisitorType&& Visit) const
+    {
+        Layout.Dispatch([this, &Visit](const auto& Indexer)
+        {
+            Indexer.ForEachCell([this, &Visit](const FIntPoint& Cell, int32 Index) { Visit(Cell, Data[Index]); });
+        });
+    }
+
+private:
+    FGridCellLayout Layout;
+    TArray<ElementType> Data;
+};
@@ -0,0 +1,205 @@
+// GridCellMask.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Bitset over a rectangular window of grid cells.
+ *
+ * Used wherever a query produces "a set of cells" (field of view, ability templates,
+ * overlays) so that results are a few machine words per row instead of a TArray<FIntPoint>.
+ * The window is given in grid coordinates and is usually much smaller than the grid;
+ * bits are stored row-major in 64-bit words, each row padded to whole words, so that
+ * rows can be combined and filtered a word (or a SIMD register) at a time.
+ *
+ * Cells outside the window are never set; Contains returns false for them.
+ */
+struct DEMOROUNDBASEDTACTIC_API FGridCellMask
+{
+    FGridCellMask() = default;
+
+    FGridCellMask(const FIntPoint& InOrigin, int32 InWidth, int32 InHeight)
+    {
+        Init(InOrigin, InWidth, InHeight);
+    }
+
+    /** Resize the window to InWidth × InHeight cells starting at InOrigin and clear every bit. */
+    void Init(const FIntPoint& InOrigin, int32 InWidth, int32 InHeight)
+    {
+        Origin = InOrigin;
+        Width = FMath::Max(InWidth, 0);
+        Height = FMath::Max(InHeight, 0);
+        WordsPerRow = (Width + 63) >> 6;
+        Words.Reset();
+        Words.SetNumZeroed(WordsPerRow * Height);
+    }
+
+    /** Clear every bit, keeping the window. */
+    void ClearAll()
+    {
+        FMemory::Memzero(Words.GetData(), Words.Num() * sizeof(uint64));
+    }
+
+    /** Drop the window and the storage. */
+    void Empty()
+    {
+        Origin = FIntPoint::ZeroValue;
+        Width = Height = WordsPerRow = 0;
+        Words.Empty();
+    }
+
+    FIntPoint GetOrigin() const { return Origin; }
+    int32 GetWidth() const { return Width; }
+    int32 GetHeight() const { return Height; }
+    int32 GetWordsPerRow() const { return WordsPerRow; }
+
+    /** Window in grid coordinates, as a half-open rectangle. */
+    FIntRect GetWindow() const { return FIntRect(Origin, Origin + FIntPoint(Width, Height)); }
+
+    FORCEINLINE bool IsInWindow(int32 GridX, int32 GridY) const
+    {
+        return uint32(GridX - Origin.X) < uint32(Width) && uint32(GridY - Origin.Y) < uint32(Height);
+    }
+
+    FORCEINLINE bool Contains(int32 GridX, int32 GridY) const
+    {
+        if (!IsInWindow(GridX, GridY))
+        {
+            return false;
+        }
+        const int32 LocalX = GridX - Origin.X;
+        return (Words[(GridY - Origin.Y) * WordsPerRow + (LocalX >> 6)] >> (LocalX & 63)) & 1;
+    }
+
+    FORCEINLINE bool Contains(const FIntPoint& Cell) const { return Contains(Cell.X, Cell.Y); }
+
+    /** Set or clear one cell. Cells outside the window are ignored. */
+    FORCEINLINE void SetCell(int32 GridX, int32 GridY, bool bValue = true)
+    {
+        if (!IsInWindow(GridX, GridY))
+        {
+            return;
+        }
+        const int32 LocalX = GridX - Origin.X;
+        uint64& Word = Words[(GridY - Origin.Y) * WordsPerRow + (LocalX >> 6)];
+        const uint64 Bit = uint64(1) << (LocalX & 63);
+        Word = bValue ? (Word | Bit) : (Word & ~Bit);
+    }
+
+    FORCEINLINE void SetCell(const FIntPoint& Cell, bool bValue = true) { SetCell(Cell.X, Cell.Y, bValue); }
+
+    /** Words of one window row (LocalY in [0, Height)). Padding bits past Width are always zero. */
+    FORCEINLINE uint64* GetRowWords(int32 LocalY) { return Words.GetData() + LocalY * WordsPerRow; }
+    FORCEINLINE const uint64* GetRowWords(int32 LocalY) const { return Words.GetData() + LocalY * WordsPerRow; }
+
+    /** Number of set cells. */
+    int32 Num() const
+    {
+        int32 Count = 0;
+        for (const uint64 Word : Words)
+        {
+            Count += FMath::CountBits(Word);
+        }
+        return Count;
+    }
+
+    bool IsEmpty() const
+    {
+        for (const uint64 Word : Words)
+        {
+            if (Word != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** Call Func(FIntPoint Cell) for every set cell, row by row. */
+    template <typename FuncType>
+    void ForEachSetCell(FuncType&& Func) const
+    {
+        for (int32 LocalY = 0; LocalY < Height; ++LocalY)
+        {
+            const uint64* Row = GetRowWords(LocalY);
+            for (int32 WordIndex = 0; WordIndex < WordsPerRow; ++WordIndex)
+            {
+                uint64 Word = Row[WordIndex];
+                while (Word != 0)
+                {
+                    const int32 Bit = (int32)FMath::CountTrailingZeros64(Word);
+                    Word &= Word - 1;
+                    Func(FIntPoint(Origin.X + (WordIndex << 6) + Bit, Origin.Y + LocalY));
+                }
+            }
+        }
+    }
+
+    /**
+     * Call Func(FIntPoint Cell, bool bNowSet) for every cell whose bit differs between
+     * Old and New. The windows may differ; cells outside a window count as clear.
+     */
+    template <typename FuncType>
+    static void ForEachDifference(const FGridCellMask& Old, const FGridCellMask& New, FuncType&& Func)
+    {
+        if (Old.Origin == New.Origin && Old.Width == New.Width && Old.Height == New.Height)
+        {
+            // Same window: XOR whole words.
+            for (int32 Index = 0; Index < New.Words.Num(); ++Index)
+            {
+                uint64 Changed = Old.Words[Index] ^ New.Words[Index];
+                while (Changed != 0)
+                {
+                    const int32 Bit = (int32)FMath::CountTrailingZeros64(Changed);
+                    Changed &= Changed - 1;
+                    const int32 LocalY = Index / New.WordsPerRow;
+                    const int32 LocalX = ((Index % New.WordsPerRow) << 6) + Bit;
+                    Func(FIntPoint(New.Origin.X + LocalX, New.Origin.Y + LocalY), ((New.Words[Index] >> Bit) & 1) != 0);
+                }
+            }
+            return;
+        }
+
+        Old.ForEachSetCell([&New, &Func](const FIntPoint& Cell)
+        {
+            if (!New.Contains(Cell))
+            {
+                Func(Cell, false);
+            }
+        });
+        New.ForEachSetCell([&Old, &Func](const FIntPoint& Cell)
+        {
+            if (!Old.Contains(Cell))
+            {
+                Func(Cell, true);
+            }
+        });
+    }
+
+    /** Set cells as an array, row by row. */
+    TArray<FIntPoint> ToCellArray() const
+    {
+        TArray<FIntPoint> Cells;
+        Cells.Reserve(Num());
+        ForEachSetCell([&Cells](const FIntPoint& Cell) { Cells.Add(Cell); });
+        return Cells;
+    }
+
+    bool operator==(const FGridCellMask& Other) const
+    {
+        return Origin == Other.Origin && Width == Other.Width && Height == Other.Height && Words == Other.Words;
+    }
+
+    bool operator!=(const FGridCellMask& Other) const { return !(*this == Other); }
+
+    /** Heap bytes held by the bits. */
+    SIZE_T GetAllocatedSize() const { return Words.GetAllocatedSize(); }
+
+private:
+    FIntPoint Origin = FIntPoint::ZeroValue;
+    int32 Width = 0;
+    int32 Height = 0;
+    int32 WordsPerRow = 0;
+    TArray<uint64> Words;
+};
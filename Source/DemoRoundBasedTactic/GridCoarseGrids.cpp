@@ -0,0 +1,219 @@
+// GridCoarseGrids.cpp
+
+#include "GridCoarseGrids.h"
+#include "GridStats.h"
+#include "GridTraversalGraph.h"
+
+#include "Async/ParallelFor.h"
+
+void FGridCoarseGrids::Reset()
+{
+    FineWidth = 0;
+    FineHeight = 0;
+    for (FLevel& Level : Levels)
+    {
+        Level = FLevel{};
+    }
+}
+
+void FGridCoarseGrids::Build(const FGridTraversalGraph& Graph)
+{
+    GRID_QUERY_SCOPE(CoarseGrid);
+
+    if (!Graph.IsValid())
+    {
+        Reset();
+        return;
+    }
+
+    FineWidth = Graph.GetWidth();
+    FineHeight = Graph.GetHeight();
+    for (int32 Level = 1; Level <= NumLevels; ++Level)
+    {
+        FLevel& Data = Levels[Level - 1];
+        Data.Width = (FineWidth + GetFactor(Level) - 1) >> Level;
+        Data.Height = (FineHeight + GetFactor(Level) - 1) >> Level;
+        Data.Cells.Reset();
+        Data.Cells.SetNum(Data.Width * Data.Height);
+    }
+
+    AggregateFromGraph(Graph, FIntRect(0, 0, Levels[0].Width, Levels[0].Height));
+    for (int32 Level = 2; Level <= NumLevels; ++Level)
+    {
+        AggregateFromLevel(Level, FIntRect(0, 0, GetWidth(Level), GetHeight(Level)));
+    }
+}
+
+void FGridCoarseGrids::UpdateRegion(const FGridTraversalGraph& Graph, const FIntRect& Rebaked)
+{
+    if (!IsValid() || Graph.GetWidth() != FineWidth || Graph.GetHeight() != FineHeight)
+    {
+        Build(Graph);
+        return;
+    }
+    if (Rebaked.Min.X >= Rebaked.Max.X || Rebaked.Min.Y >= Rebaked.Max.Y)
+    {
+        return;
+    }
+
+    GRID_QUERY_SCOPE(CoarseGrid);
+
+    // Links only count steps out of a block, so the blocks holding re-baked cells are all that change.
+    for (int32 Level = 1; Level <= NumLevels; ++Level)
+    {
+        const int32 Round = GetFactor(Level) - 1;
+        const FIntRect CoarseRect(
+            Rebaked.Min.X >> Level, Rebaked.Min.Y >> Level,
+            FMath::Min((Rebaked.Max.X + Round) >> Level, GetWidth(Level)),
+            FMath::Min((Rebaked.Max.Y + Round) >> Level, GetHeight(Level)));
+
+        if (Level == 1)
+        {
+            AggregateFromGraph(Graph, CoarseRect);
+        }
+        else
+        {
+            AggregateFromLevel(Level, CoarseRect);
+        }
+    }
+}
+
+void FGridCoarseGrids::AggregateFromGraph(const FGridTraversalGraph& Graph, const FIntRect& CoarseRect)
+{
+    FLevel& Data = Levels[0];
+    const FGridHeightSnapshot* Heights = Graph.GetHeights().GetReference();
+
+    ParallelFor(CoarseRect.Height(), [&](int32 Row)
+    {
+        const int32 CY = CoarseRect.Min.Y + Row;
+        for (int32 CX = CoarseRect.Min.X; CX < CoarseRect.Max.X; ++CX)
+        {
+            FGridCoarseCell& Cell = Data.Cells[CY * Data.Width + CX];
+            Cell.MinHeight = MAX_flt;
+            Cell.MaxHeight = -MAX_flt;
+            Cell.NumCells = 0;
+            Cell.NumPassable = 0;
+            Cell.Links = 0;
+
+            double HeightSum = 0.0;
+            for (int32 Y = CY * 2; Y < FMath::Min(CY * 2 + 2, FineHeight); ++Y)
+            {
+                for (int32 X = CX * 2; X < FMath::Min(CX * 2 + 2, FineWidth); ++X)
+                {
+                    const int32 Index = Y * FineWidth + X;
+                    const float Z = Heights ? Heights->GetHeightAt(X, Y) : 0.f;
+                    Cell.MinHeight = FMath::Min(Cell.MinHeight, Z);
+                    Cell.MaxHeight = FMath::Max(Cell.MaxHeight, Z);
+                    HeightSum += Z;
+                    ++Cell.NumCells;
+
+                    const TConstArrayView<int32> Neighbors = Graph.GetNeighbors(Index);
+                    Cell.NumPassable += !Graph.IsCellBlocked(Index) && Neighbors.Num() > 0 ? 1 : 0;
+
+                    for (const int32 Next : Neighbors)
+                    {
+                        const int32 DX = ((Next % FineWidth) >> 1) - CX;
+                        const int32 DY = ((Next / FineWidth) >> 1) - CY;
+                        if (DX != 0 || DY != 0)
+                        {
+                            Cell.Links |= 1u << FGridCoarseCell::GetLinkBit(DX, DY);
+                        }
+                    }
+                }
+            }
+            Cell.MeanHeight = float(HeightSum / FMath::Max<int32>(Cell.NumCells, 1));
+        }
+    });
+}
+
+void FGridCoarseGrids::AggregateFromLevel(int32 Level, const FIntRect& CoarseRect)
+{
+    const FLevel& Below = Levels[Level - 2];
+    FLevel& Data = Levels[Level - 1];
+
+    for (int32 CY = CoarseRect.Min.Y; CY < CoarseRect.Max.Y; ++CY)
+    {
+        for (int32 CX = CoarseRect.Min.X; CX < CoarseRect.Max.X; ++CX)
+        {
+            FGridCoarseCell& Cell = Data.Cells[CY * Data.Width + CX];
+            Cell.MinHeight = MAX_flt;
+            Cell.MaxHeight = -MAX_flt;
+            Cell.NumCells = 0;
+            Cell.NumPassable = 0;
+            Cell.Links = 0;
+
+            double HeightSum = 0.0;
+            for (int32 Y = CY * 2; Y < FMath::Min(CY * 2 + 2, Below.Height); ++Y)
+            {
+                for (int32 X = CX * 2; X < FMath::Min(CX * 2 + 2, Below.Width); ++X)
+                {
+                    const FGridCoarseCell& Child = Below.Cells[Y * Below.Width + X];
+                    Cell.MinHeight = FMath::Min(Cell.MinHeight, Child.MinHeight);
+                    Cell.MaxHeight = FMath::Max(Cell.MaxHeight, Child.MaxHeight);
+                    HeightSum += double(Child.MeanHeight) * Child.NumCells;
+                    Cell.NumCells += Child.NumCells;
+                    Cell.NumPassable += Child.NumPassable;
+
+                    // A child link leaves this block iff the linked child has another parent.
+                    for (int32 DY = -1; DY <= 1; ++DY)
+                    {
+                        for (int32 DX = -1; DX <= 1; ++DX)
+                        {
+                            if ((DX != 0 || DY != 0) && Child.HasLink(DX, DY))
+                            {
+                                const int32 PX = ((X + DX) >> 1) - CX;
+                                const int32 PY = ((Y + DY) >> 1) - CY;
+                                if (PX != 0 || PY != 0)
+                                {
+                                    Cell.Links |= 1u << FGridCoarseCell::GetLinkBit(PX, PY);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            Cell.MeanHeight = float(HeightSum / FMath::Max<int32>(Cell.NumCells, 1));
+        }
+    }
+}
+
+void FGridCoarseGrids::AddOccupant(const FIntPoint& Cell, int32 Faction, int32 Delta)
+{
+    if (!IsValid() || Faction < 0 || Faction >= FGridCoarseCell::MaxFactions ||
+        Cell.X < 0 || Cell.Y < 0 || Cell.X >= FineWidth || Cell.Y >= FineHeight)
+    {
+        return;
+    }
+
+    for (int32 Level = 1; Level <= NumLevels; ++Level)
+    {
+        FLevel& Data = Levels[Level - 1];
+        const FIntPoint Coarse = FineToCoarse(Cell, Level);
+        uint16& Count = Data.Cells[Coarse.Y * Data.Width + Coarse.X].Occupants[Faction];
+        Count = static_cast<uint16>(FMath::Clamp(int32(Count) + Delta, 0, int32(MAX_uint16)));
+    }
+}
+
+void FGridCoarseGrids::MoveOccupant(const FIntPoint& From, const FIntPoint& To, int32 Faction)
+{
+    // Moves inside the smallest block change nothing on any level.
+    if (FineToCoarse(From, 1) != FineToCoarse(To, 1))
+    {
+        AddOccupant(From, Faction, -1);
+        AddOccupant(To, Faction, +1);
+    }
+}
+
+FIntRect FGridCoarseGrids::CoarseToFineRect(const FIntPoint& CoarseCell, int32 Level) const
+{
+    const FIntPoint Min(CoarseCell.X << Level, CoarseCell.Y << Level);
+    return FIntRect(Min, FIntPoint(
+        FMath::Min(Min.X + GetFactor(Level), FineWidth),
+        FMath::Min(Min.Y + GetFactor(Level), FineHeight)));
+}
+
+FIntPoint FGridCoarseGrids::CoarseToFineCenter(const FIntPoint& CoarseCell, int32 Level) const
+{
+    const FIntRect Rect = CoarseToFineRect(CoarseCell, Level);
+    return FIntPoint((Rect.Min.X + Rect.Max.X - 1) / 2, (Rect.Min.Y + Rect.Max.Y - 1) / 2);
+}
@@ -0,0 +1,125 @@
+// GridCoarseGrids.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FGridTraversalGraph;
+
+/** Aggregate of a square block of fine cells. */
+struct FGridCoarseCell
+{
+    static constexpr int32 MaxFactions = 4;
+
+    /** Ground height statistics over the block's fine cells. */
+    float MinHeight = 0.f;
+    float MaxHeight = 0.f;
+    float MeanHeight = 0.f;
+
+    /** Fine cells in the block (fewer than Factor² along the right and top edges of the grid). */
+    uint16 NumCells = 0;
+
+    /** Fine cells that are not blocked and have at least one step out. */
+    uint16 NumPassable = 0;
+
+    /**
+     * Bit GetLinkBit(DX, DY) is set if some fine step leads from this block into the
+     * neighbouring block at (DX, DY). Follows step direction, like the fine graph.
+     */
+    uint8 Links = 0;
+
+    /** Occupants per faction (see FGridCoarseGrids::AddOccupant). */
+    uint16 Occupants[MaxFactions] = {};
+
+    float GetPassableFraction() const { return NumCells > 0 ? float(NumPassable) / NumCells : 0.f; }
+
+    bool HasLink(int32 DX, int32 DY) const { return (Links & (1u << GetLinkBit(DX, DY))) != 0; }
+
+    /** Bit of the neighbour block at DX, DY in [-1, 1] (not both zero). */
+    static FORCEINLINE int32 GetLinkBit(int32 DX, int32 DY)
+    {
+        const int32 Slot = (DY + 1) * 3 + (DX + 1);
+        return Slot > 4 ? Slot - 1 : Slot;
+    }
+};
+
+/**
+ * Downsampled copies of a grid at 2x, 4x and 8x for strategic AI reasoning (flanks,
+ * objectives, front lines), where scoring 1/64th of the cells is plenty.
+ *
+ * Level 1 aggregates 2x2 blocks of the FGridTraversalGraph it is built from: height
+ * statistics, passable cells and which neighbouring blocks a fine step leads into.
+ * Every further level aggregates 2x2 cells of the one below, so links stay exact: a
+ * coarse link exists iff some fine step crosses between the two blocks. Occupancy
+ * counts per faction are maintained by the owner through AddOccupant / MoveOccupant.
+ *
+ * Works for every topology; hex grids are downsampled in axial coordinates.
+ *
+ * After the graph re-bakes a rectangle, UpdateRegion re-aggregates only the blocks
+ * above it on every level.
+ */
+class DEMOROUNDBASEDTACTIC_API FGridCoarseGrids
+{
+public:
+    static constexpr int32 NumLevels = 3;
+
+    /** Aggregate every level from Graph. Occupancy counts are cleared. */
+    void Build(const FGridTraversalGraph& Graph);
+
+    /** Re-aggregate the blocks above Rebaked (fine cells) after Graph re-baked it. Occupancy is kept. */
+    void UpdateRegion(const FGridTraversalGraph& Graph, const FIntRect& Rebaked);
+
+    /** Add Delta occupants of Faction on the fine cell Cell, on every level. */
+    void AddOccupant(const FIntPoint& Cell, int32 Faction, int32 Delta = 1);
+
+    /** Move one occupant of Faction between fine cells; free if they share every block. */
+    void MoveOccupant(const FIntPoint& From, const FIntPoint& To, int32 Faction);
+
+    void Reset();
+
+    bool IsValid() const { return FineWidth > 0; }
+
+    /** Level 1..NumLevels: one coarse cell per GetFactor(Level)² fine cells. */
+    static constexpr int32 GetFactor(int32 Level) { return 1 << Level; }
+
+    int32 GetWidth(int32 Level) const { return Levels[Level - 1].Width; }
+    int32 GetHeight(int32 Level) const { return Levels[Level - 1].Height; }
+
+    FORCEINLINE const FGridCoarseCell& GetCell(int32 Level, const FIntPoint& CoarseCell) const
+    {
+        const FLevel& Data = Levels[Level - 1];
+        return Data.Cells[CoarseCell.Y * Data.Width + CoarseCell.X];
+    }
+
+    TConstArrayView<FGridCoarseCell> GetCells(int32 Level) const { return Levels[Level - 1].Cells; }
+
+    /** Coarse cell on Level that contains the fine cell. Also maps between levels (pass Level difference). */
+    static FORCEINLINE FIntPoint FineToCoarse(const FIntPoint& FineCell, int32 Level)
+    {
+        return FIntPoint(FineCell.X >> Level, FineCell.Y >> Level);
+    }
+
+    /** Fine cells covered by a coarse cell on Level (half-open, clipped to the grid). */
+    FIntRect CoarseToFineRect(const FIntPoint& CoarseCell, int32 Level) const;
+
+    /** Fine cell nearest to the centre of a coarse cell on Level. */
+    FIntPoint CoarseToFineCenter(const FIntPoint& CoarseCell, int32 Level) const;
+
+private:
+    struct FLevel
+    {
+        int32 Width = 0;
+        int32 Height = 0;
+        TArray<FGridCoarseCell> Cells;
+    };
+
+    /** Aggregate the level 1 cells in CoarseRect from fine cells; keeps their occupancy. */
+    void AggregateFromGraph(const FGridTraversalGraph& Graph, const FIntRect& CoarseRect);
+
+    /** Aggregate the cells in CoarseRect of Level (>= 2) from the level below; keeps their occupancy. */
+    void AggregateFromLevel(int32 Level, const FIntRect& CoarseRect);
+
+    int32 FineWidth = 0;
+    int32 FineHeight = 0;
+    FLevel Levels[NumLevels];
+};
@@ -1,6 +1,10 @@
 // GridGeometryLibrary.cpp
 
 #include "GridGeometryLibrary.h"
+#include "GridHeightField.h"
+#include "GridLayers.h"
+#include "GridStats.h"
+#include "GridTopology.h"
 #include "Math/RotationMatrix.h"
 
 namespace
@@ -41,35 +45,380 @@ namespace
 
         return Config.GridOrigin.Z;
     }
+
+    /** Topology-specialised body of UGridGeometryLibrary::GridToWorldGround. */
+    template <typename TopologyType>
+    static FVector TGridToWorldGround(const FGridConfig& Config, const FIntPoint& GridCoord)
+    {
+        FVector XAxis;
+        FVector YAxis;
+        ResolveGridAxes(Config, XAxis, YAxis);
+
+        const FVector2D Lateral = TopologyType::CellToLocal(GridCoord) * Config.CellSize;
+
+        const FVector LateralOffset =
+            XAxis * Lateral.X +
+            YAxis * Lateral.Y;
+
+        FVector WorldPos = Config.GridOrigin + LateralOffset;
+        WorldPos.Z = GetGroundHeight(Config, GridCoord.X, GridCoord.Y);
+
+        return WorldPos;
+    }
+
+    /** Topology-specialised body of UGridGeometryLibrary::WorldToGrid. */
+    template <typename TopologyType>
+    static bool TWorldToGrid(
+        const FGridConfig& Config,
+        const FVector& WorldPosition,
+        FIntPoint& OutGrid,
+        bool bClampToBounds,
+        EGridRoundingPolicy Rounding)
+    {
+        // Early-out if the grid has no area.
+        if (Config.Width <= 0 || Config.Height <= 0 || Config.CellSize <= KINDA_SMALL_NUMBER)
+        {
+            OutGrid = FIntPoint(-1, -1);
+            return false;
+        }
+
+        FVector XAxis;
+        FVector YAxis;
+        ResolveGridAxes(Config, XAxis, YAxis);
+
+        // Translate into grid-local space (relative to GridOrigin).
+        const FVector Local = WorldPosition - Config.GridOrigin;
+
+        // Project onto the grid axes (we ignore the vertical component) and
+        // express the result in cell units.
+        const FVector2D Continuous(
+            FVector::DotProduct(Local, XAxis) / Config.CellSize,
+            FVector::DotProduct(Local, YAxis) / Config.CellSize);
+
+        FIntPoint Cell = TopologyType::LocalToCell(Continuous, Rounding);
+
+        if (bClampToBounds)
+        {
+            Cell.X = FMath::Clamp(Cell.X, 0, Config.Width - 1);
+            Cell.Y = FMath::Clamp(Cell.Y, 0, Config.Height - 1);
+
+            OutGrid = Cell;
+            return true;
+        }
+
+        // Out-of-bounds: indicate failure and mark the output as invalid.
+        if (Cell.X < 0 || Cell.X >= Config.Width || Cell.Y < 0 || Cell.Y >= Config.Height)
+        {
+            OutGrid = FIntPoint(-1, -1);
+            return false;
+        }
+
+        OutGrid = Cell;
+        return true;
+    }
+
+    /**
+     * Walk the cells of a regular 2D lattice crossed by a ray segment (Amanatides & Woo DDA).
+     *
+     * Positions are expressed in lattice units (one unit = one lattice cell), the ray
+     * parameter T is in world units. Visit(CellX, CellY, TEnter, TExit) is called for each
+     * crossed cell in order and returns true to stop the walk.
+     *
+     * Indices are clamped into [MinX,MaxX] × [MinY,MaxY] so that rounding on shared
+     * boundaries can never step outside the caller's region.
+     *
+     * @return True if Visit requested a stop.
+     */
+    template <typename VisitorType>
+    static bool MarchLattice2D(
+        const FVector2D& Origin,
+        const FVector2D& Dir,
+        double TStart,
+        double TEnd,
+        int32 MinX, int32 MinY,
+        int32 MaxX, int32 MaxY,
+        VisitorType&& Visit)
+    {
+        const FVector2D Start = Origin + Dir * TStart;
+
+        int32 CellX = FMath::Clamp(FMath::FloorToInt32(Start.X), MinX, MaxX);
+        int32 CellY = FMath::Clamp(FMath::FloorToInt32(Start.Y), MinY, MaxY);
+
+        const int32 StepX = Dir.X > 0.0 ? 1 : -1;
+        const int32 StepY = Dir.Y > 0.0 ? 1 : -1;
+
+        const double TDeltaX = FMath::IsNearlyZero(Dir.X) ? BIG_NUMBER : FMath::Abs(1.0 / Dir.X);
+        const double TDeltaY = FMath::IsNearlyZero(Dir.Y) ? BIG_NUMBER : FMath::Abs(1.0 / Dir.Y);
+
+        const double NextBoundaryX = static_cast<double>(CellX + (StepX > 0 ? 1 : 0));
+        const double NextBoundaryY = static_cast<double>(CellY + (StepY > 0 ? 1 : 0));
+
+        double TMaxX = FMath::IsNearlyZero(Dir.X) ? BIG_NUMBER : (NextBoundaryX - Origin.X) / Dir.X;
+        double TMaxY = FMath::IsNearlyZero(Dir.Y) ? BIG_NUMBER : (NextBoundaryY - Origin.Y) / Dir.Y;
+
+        double TEnter = TStart;
+        while (TEnter < TEnd)
+        {
+            const double TExit = FMath::Min3(TMaxX, TMaxY, TEnd);
+            if (Visit(CellX, CellY, TEnter, FMath::Max(TEnter, TExit)))
+            {
+                return true;
+            }
+
+            TEnter = TExit;
+            if (TMaxX < TMaxY)
+            {
+                CellX += StepX;
+                TMaxX += TDeltaX;
+            }
+            else
+            {
+                CellY += StepY;
+                TMaxY += TDeltaY;
+            }
+
+            if (CellX < MinX || CellX > MaxX || CellY < MinY || CellY > MaxY)
+            {
+                break;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Walk the hex cells crossed by a ray segment, in order.
+     *
+     * Positions are grid-plane coordinates in cell units, T is in world units. A hex is
+     * the set of points closer to its centre than to any neighbour's, so the ray leaves a
+     * cell through the first of the six half-way lines between the centres it crosses,
+     * and enters that neighbour. Visit(CellX, CellY, TEnter, TExit) is called for cells
+     * inside [0,Width) × [0,Height) only and returns true to stop the walk.
+     *
+     * @return True if Visit requested a stop.
+     */
+    template <typename VisitorType>
+    static bool MarchHex2D(
+        const FVector2D& Origin,
+        const FVector2D& Dir,
+        double TStart,
+        double TEnd,
+        int32 Width,
+        int32 Height,
+        VisitorType&& Visit)
+    {
+        using HexTopology = TGridTopology<EGridTopology::HexAxial>;
+
+        // Unit vectors from a centre towards each neighbour's centre.
+        FVector2D Normals[HexTopology::NumNeighbors];
+        double Rates[HexTopology::NumNeighbors];
+        for (int32 N = 0; N < HexTopology::NumNeighbors; ++N)
+        {
+            const FGridNeighborOffset& Offset = HexTopology::NeighborOffsets[N];
+            Normals[N] = FVector2D(Offset.DX + 0.5 * Offset.DY, HexTopology::RowSpacing * Offset.DY);
+            Rates[N] = FVector2D::DotProduct(Dir, Normals[N]);
+        }
+
+        FIntPoint Cell = HexTopology::LocalToCell(Origin + Dir * TStart, EGridRoundingPolicy::Round);
+
+        // Ties at hex corners may cost extra zero-length steps; this bounds the walk regardless.
+        const int32 MaxSteps = 2 * (Width + Height) + 8;
+
+        double TEnter = TStart;
+        for (int32 Step = 0; Step < MaxSteps && TEnter < TEnd; ++Step)
+        {
+            const FVector2D Relative = Origin - HexTopology::CellToLocal(Cell);
+
+            double TExit = TEnd;
+            int32 Exit = INDEX_NONE;
+            for (int32 N = 0; N < HexTopology::NumNeighbors; ++N)
+            {
+                if (Rates[N] <= 0.0)
+                {
+                    continue;
+                }
+
+                // The edge towards neighbour N is where (P - Centre) . Normal reaches 0.5.
+                const double T = (0.5 - FVector2D::DotProduct(Relative, Normals[N])) / Rates[N];
+                if (T < TExit)
+                {
+                    TExit = T;
+                    Exit = N;
+                }
+            }
+            TExit = FMath::Max(TExit, TEnter);
+
+            if (Cell.X >= 0 && Cell.X < Width && Cell.Y >= 0 && Cell.Y < Height && Visit(Cell.X, Cell.Y, TEnter, TExit))
+            {
+                return true;
+            }
+
+            if (Exit == INDEX_NONE)
+            {
+                break;
+            }
+
+            Cell.X += HexTopology::NeighborOffsets[Exit].DX;
+            Cell.Y += HexTopology::NeighborOffsets[Exit].DY;
+            TEnter = TExit;
+        }
+
+        return false;
+    }
+
+    /**
+     * Clip a ray on the grid plane (cell units) to the grid's footprint.
+     *
+     * Square grids are clipped to [0,Width] × [0,Height]. Hex grids are clipped in
+     * fractional axial coordinates to [-1,Width] × [-1,Height], which contains every hex
+     * of the grid; cells walked in the margin are skipped by MarchHex2D.
+     *
+     * @return False if the ray misses the footprint.
+     */
+    static bool ClipRayToGrid(const FGridConfig& Config, const FVector2D& Origin, const FVector2D& Dir, double& InOutTStart, double& InOutTEnd)
+    {
+        FVector2D O = Origin;
+        FVector2D D = Dir;
+        double Min = 0.0;
+        const double Extents[2] = { static_cast<double>(Config.Width), static_cast<double>(Config.Height) };
+
+        if (Config.Topology == EGridTopology::HexAxial)
+        {
+            // Inverse of TGridTopology<HexAxial>::CellToLocal, without the rounding.
+            constexpr double RowSpacing = TGridTopology<EGridTopology::HexAxial>::RowSpacing;
+            const double OR = (Origin.Y - 0.5) / RowSpacing;
+            const double DR = Dir.Y / RowSpacing;
+            O = FVector2D((Origin.X - 0.5) - 0.5 * OR, OR);
+            D = FVector2D(Dir.X - 0.5 * DR, DR);
+            Min = -1.0;
+        }
+
+        for (int32 Axis = 0; Axis < 2; ++Axis)
+        {
+            if (FMath::IsNearlyZero(D[Axis]))
+            {
+                if (O[Axis] < Min || O[Axis] > Extents[Axis])
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            double T0 = (Min - O[Axis]) / D[Axis];
+            double T1 = (Extents[Axis] - O[Axis]) / D[Axis];
+            if (T0 > T1)
+            {
+                Swap(T0, T1);
+            }
+
+            InOutTStart = FMath::Max(InOutTStart, T0);
+            InOutTEnd = FMath::Min(InOutTEnd, T1);
+            if (InOutTStart > InOutTEnd)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Project a world ray (Dir normalised) onto the grid plane in cell units and clip it
+     * to the grid's footprint and to [0, MaxDistance]. T stays in world units.
+     *
+     * @return False if the ray misses the grid.
+     */
+    static bool MakeGridRay(const FGridConfig& Config, const FVector& RayOrigin, const FVector& Dir, double MaxDistance,
+        FVector2D& OutOrigin2D, FVector2D& OutDir2D, double& OutTStart, double& OutTEnd)
+    {
+        FVector XAxis;
+        FVector YAxis;
+        ResolveGridAxes(Config, XAxis, YAxis);
+
+        const double InvCellSize = 1.0 / Config.CellSize;
+        const FVector Local = RayOrigin - Config.GridOrigin;
+
+        OutOrigin2D = FVector2D(FVector::DotProduct(Local, XAxis) * InvCellSize, FVector::DotProduct(Local, YAxis) * InvCellSize);
+        OutDir2D = FVector2D(FVector::DotProduct(Dir, XAxis) * InvCellSize, FVector::DotProduct(Dir, YAxis) * InvCellSize);
+
+        OutTStart = 0.0;
+        OutTEnd = MaxDistance;
+        return ClipRayToGrid(Config, OutOrigin2D, OutDir2D, OutTStart, OutTEnd);
+    }
+
+    /**
+     * Test a ray segment [TA, TB] against a flat column of height ColumnTop.
+     * Returns the hit parameter through OutT if the segment enters the column.
+     */
+    static FORCEINLINE bool IntersectColumn(double ZA, double ZB, double TA, double TB, double ColumnTop, double& OutT)
+    {
+        if (ZA <= ColumnTop)
+        {
+            // Entered through the side of the column (or started inside it).
+            OutT = TA;
+            return true;
+        }
+
+        if (ZB <= ColumnTop)
+        {
+            // Crossed the column top inside the cell.
+            OutT = TA + (ZA - ColumnTop) / (ZA - ZB) * (TB - TA);
+            return true;
+        }
+
+        return false;
+    }
 }
 
 FVector UGridGeometryLibrary::GridToWorldGround(const FGridConfig& Config, FIntPoint GridCoord)
 {
+    return DispatchGridTopology(Config.Topology, [&](auto Topo)
+    {
+        return TGridToWorldGround<decltype(Topo)>(Config, GridCoord);
+    });
+}
+
+FVector UGridGeometryLibrary::GridToWorldEye(const FGridConfig& Config, FIntPoint GridCoord)
+{
+    FVector Result = GridToWorldGround(Config, GridCoord);
+    Result.Z += Config.DefaultEyeHeight;
+    return Result;
+}
+
+void UGridGeometryLibrary::GridToWorldGroundBatch(const FGridConfig& Config, TConstArrayView<FIntPoint> Cells, TArrayView<FVector> OutLocations)
+{
+    GRID_QUERY_SCOPE(GridToWorld);
+    GRID_QUERY_COUNT(HeightRead, Cells.Num());
+    check(Cells.Num() == OutLocations.Num());
+
     FVector XAxis;
     FVector YAxis;
     ResolveGridAxes(Config, XAxis, YAxis);
+    XAxis *= Config.CellSize;
+    YAxis *= Config.CellSize;
 
-    // Offset to move from the cell origin to the cell centre.
-    constexpr float HalfCell = 0.5f;
-
-    const float LateralX = (static_cast<float>(GridCoord.X) + HalfCell) * Config.CellSize;
-    const float LateralY = (static_cast<float>(GridCoord.Y) + HalfCell) * Config.CellSize;
+    const IGridHeightProvider* Provider = Config.HeightProvider.Get();
+    const FGridHeightSnapshot* Snapshot = Provider ? Provider->GetHeightSnapshot() : nullptr;
 
-    const FVector LateralOffset =
-        XAxis * LateralX +
-        YAxis * LateralY;
+    DispatchGridTopology(Config.Topology, [&](auto Topo)
+    {
+        using TopologyType = decltype(Topo);
 
-    FVector WorldPos = Config.GridOrigin + LateralOffset;
-    WorldPos.Z = GetGroundHeight(Config, GridCoord.X, GridCoord.Y);
+        for (int32 Index = 0; Index < Cells.Num(); ++Index)
+        {
+            const FIntPoint& Cell = Cells[Index];
+            const FVector2D Lateral = TopologyType::CellToLocal(Cell);
 
-    return WorldPos;
+            FVector& WorldPos = OutLocations[Index];
+            WorldPos = Config.GridOrigin + XAxis * Lateral.X + YAxis * Lateral.Y;
+            WorldPos.Z = Snapshot ? Snapshot->GetHeightAt(Cell.X, Cell.Y) : GetGroundHeight(Config, Cell.X, Cell.Y);
+        }
+    });
 }
 
-FVector UGridGeometryLibrary::GridToWorldEye(const FGridConfig& Config, FIntPoint GridCoord)
+void UGridGeometryLibrary::GetGridAxes(const FGridConfig& Config, FVector& OutAxisX, FVector& OutAxisY)
 {
-    FVector Result = GridToWorldGround(Config, GridCoord);
-    Result.Z += Config.DefaultEyeHeight;
-    return Result;
+    ResolveGridAxes(Config, OutAxisX, OutAxisY);
 }
 
 bool UGridGeometryLibrary::WorldToGrid(
@@ -80,66 +429,217 @@ bool UGridGeometryLibrary::WorldToGrid(
     EGridRoundingPolicy Rounding
 )
 {
-    // Early-out if the grid has no area.
-    if (Config.Width <= 0 || Config.Height <= 0 || Config.CellSize <= KINDA_SMALL_NUMBER)
+    return DispatchGridTopology(Config.Topology, [&](auto Topo)
+    {
+        return TWorldToGrid<decltype(Topo)>(Config, WorldPosition, OutGrid, bClampToBounds, Rounding);
+    });
+}
+
+bool UGridGeometryLibrary::RaycastHeightField(
+    const FGridConfig& Config,
+    const FVector& RayOrigin,
+    const FVector& RayDirection,
+    float MaxDistance,
+    FIntPoint& OutGrid,
+    FVector& OutHitPoint
+)
+{
+    GRID_QUERY_SCOPE(Raycast);
+
+    OutGrid = FIntPoint(-1, -1);
+    OutHitPoint = FVector::ZeroVector;
+
+    const FVector Dir = RayDirection.GetSafeNormal();
+    if (Config.Width <= 0 || Config.Height <= 0 || Config.CellSize <= KINDA_SMALL_NUMBER ||
+        Dir.IsZero() || MaxDistance <= 0.f)
     {
-        OutGrid = FIntPoint(-1, -1);
         return false;
     }
 
-    FVector XAxis;
-    FVector YAxis;
-    ResolveGridAxes(Config, XAxis, YAxis);
+    // Express the ray in lattice units on the grid plane; Z stays in world units.
+    FVector2D Origin2D;
+    FVector2D Dir2D;
+    double TStart = 0.0;
+    double TEnd = 0.0;
+    if (!MakeGridRay(Config, RayOrigin, Dir, MaxDistance, Origin2D, Dir2D, TStart, TEnd))
+    {
+        return false;
+    }
 
-    // Translate into grid-local space (relative to GridOrigin).
-    const FVector Local = WorldPosition - Config.GridOrigin;
+    const double OriginZ = RayOrigin.Z;
+    const double DirZ = Dir.Z;
 
-    // Project onto the grid axes (we ignore the vertical component).
-    const float U = FVector::DotProduct(Local, XAxis);
-    const float V = FVector::DotProduct(Local, YAxis);
+    double HitT = 0.0;
+    FIntPoint HitCell(-1, -1);
+
+    // Visit one cell column and record the first hit.
+    auto VisitCell = [&](int32 CellX, int32 CellY, double TA, double TB) -> bool
+    {
+        const double Top = GetGroundHeight(Config, CellX, CellY);
+        if (IntersectColumn(OriginZ + DirZ * TA, OriginZ + DirZ * TB, TA, TB, Top, HitT))
+        {
+            HitCell = FIntPoint(CellX, CellY);
+            return true;
+        }
+        return false;
+    };
 
-    // Continuous grid coordinates in cell units.
-    const float Fx = U / Config.CellSize;
-    const float Fy = V / Config.CellSize;
+    const FGridHeightTiles* Tiles =
+        Config.HeightProvider.IsValid() ? Config.HeightProvider->GetMaxHeightTiles() : nullptr;
 
-    int32 Gx = 0;
-    int32 Gy = 0;
+    bool bHit = false;
 
-    switch (Rounding)
+    if (Config.Topology == EGridTopology::HexAxial)
+    {
+        bHit = MarchHex2D(Origin2D, Dir2D, TStart, TEnd, Config.Width, Config.Height, VisitCell);
+    }
+    else if (Tiles)
     {
-    case EGridRoundingPolicy::Round:
-        Gx = FMath::RoundToInt(Fx);
-        Gy = FMath::RoundToInt(Fy);
-        break;
+        // Two-level march: tiles first, cells only inside tiles the ray can actually touch.
+        const double TileScale = 1.0 / Tiles->TileSize;
+
+        bHit = MarchLattice2D(Origin2D * TileScale, Dir2D * TileScale, TStart, TEnd,
+            0, 0, Tiles->NumTilesX - 1, Tiles->NumTilesY - 1,
+            [&](int32 TileX, int32 TileY, double TA, double TB) -> bool
+            {
+                const double LowestZ = OriginZ + DirZ * (DirZ < 0.0 ? TB : TA);
+                if (LowestZ > Tiles->GetTileMax(TileX, TileY))
+                {
+                    return false;
+                }
 
-    case EGridRoundingPolicy::Ceil:
-        Gx = FMath::CeilToInt(Fx);
-        Gy = FMath::CeilToInt(Fy);
-        break;
+                const int32 MinX = TileX * Tiles->TileSize;
+                const int32 MinY = TileY * Tiles->TileSize;
+                const int32 MaxX = FMath::Min(MinX + Tiles->TileSize, Config.Width) - 1;
+                const int32 MaxY = FMath::Min(MinY + Tiles->TileSize, Config.Height) - 1;
 
-    case EGridRoundingPolicy::Floor:
-    default:
-        Gx = FMath::FloorToInt(Fx);
-        Gy = FMath::FloorToInt(Fy);
-        break;
+                return MarchLattice2D(Origin2D, Dir2D, TA, TB, MinX, MinY, MaxX, MaxY, VisitCell);
+            });
+    }
+    else
+    {
+        bHit = MarchLattice2D(Origin2D, Dir2D, TStart, TEnd,
+            0, 0, Config.Width - 1, Config.Height - 1, VisitCell);
     }
 
-    if (bClampToBounds)
+    if (!bHit)
     {
-        Gx = FMath::Clamp(Gx, 0, Config.Width - 1);
-        Gy = FMath::Clamp(Gy, 0, Config.Height - 1);
+        return false;
+    }
 
-        OutGrid = FIntPoint(Gx, Gy);
-        return true;
+    OutGrid = HitCell;
+    OutHitPoint = RayOrigin + Dir * HitT;
+    return true;
+}
+
+float UGridGeometryLibrary::GetLayerHeight(const FGridConfig& Config, FIntPoint GridCoord, int32 Layer)
+{
+    if (Layer > 0 && Config.Layers.IsValid() &&
+        GridCoord.X >= 0 && GridCoord.Y >= 0 && GridCoord.X < Config.Width && GridCoord.Y < Config.Height)
+    {
+        const int32 CellIndex = GridCoord.Y * Config.Width + GridCoord.X;
+        if (Layer < Config.Layers->GetNumLayers(CellIndex))
+        {
+            return Config.Layers->GetExtraLayerHeight(CellIndex, Layer);
+        }
     }
 
-    // Out-of-bounds: indicate failure and mark the output as invalid.
-    if (Gx < 0 || Gx >= Config.Width || Gy < 0 || Gy >= Config.Height)
+    return GetGroundHeight(Config, GridCoord.X, GridCoord.Y);
+}
+
+int32 UGridGeometryLibrary::GetNumLayers(const FGridConfig& Config, FIntPoint GridCoord)
+{
+    if (!Config.Layers.IsValid() ||
+        GridCoord.X < 0 || GridCoord.Y < 0 || GridCoord.X >= Config.Width || GridCoord.Y >= Config.Height)
     {
-        OutGrid = FIntPoint(-1, -1);
-        return false;
+        return 1;
+    }
+    return Config.Layers->GetNumLayers(GridCoord.Y * Config.Width + GridCoord.X);
+}
+
+FVector UGridGeometryLibrary::GridToWorldGroundLayered(const FGridConfig& Config, const FGridLayeredCell& LayeredCell)
+{
+    FVector Result = GridToWorldGround(Config, LayeredCell.Cell);
+    if (LayeredCell.Layer > 0)
+    {
+        Result.Z = GetLayerHeight(Config, LayeredCell.Cell, LayeredCell.Layer);
+    }
+    return Result;
+}
+
+bool UGridGeometryLibrary::RaycastHeightFieldLayered(
+    const FGridConfig& Config,
+    const FVector& RayOrigin,
+    const FVector& RayDirection,
+    float MaxDistance,
+    FGridLayeredCell& OutCell,
+    FVector& OutHitPoint
+)
+{
+    FIntPoint GroundCell;
+    const bool bGroundHit = RaycastHeightField(Config, RayOrigin, RayDirection, MaxDistance, GroundCell, OutHitPoint);
+    OutCell = FGridLayeredCell(GroundCell, 0);
+
+    const FVector Dir = RayDirection.GetSafeNormal();
+    if (!Config.Layers.IsValid() || Dir.Z >= -KINDA_SMALL_NUMBER)
+    {
+        return bGroundHit;
+    }
+
+    FVector2D Origin2D;
+    FVector2D Dir2D;
+    double TStart = 0.0;
+    double TEnd = 0.0;
+    if (!MakeGridRay(Config, RayOrigin, Dir, MaxDistance, Origin2D, Dir2D, TStart, TEnd))
+    {
+        return bGroundHit;
+    }
+
+    // Decks can only be hit before the ground hit, in cells the ray crosses on the way there.
+    const FGridLayerData& Layers = *Config.Layers;
+    double BestT = bGroundHit ? FVector::Dist(RayOrigin, OutHitPoint) : TEnd;
+    int32 BestLayer = INDEX_NONE;
+    FIntPoint BestCell(-1, -1);
+
+    auto VisitCell = [&](int32 CellX, int32 CellY, double TA, double TB) -> bool
+    {
+        const int32 CellIndex = CellY * Config.Width + CellX;
+        if (!Layers.HasExtraLayers(CellIndex))
+        {
+            return false;
+        }
+
+        for (int32 Layer = 1; Layer < Layers.GetNumLayers(CellIndex); ++Layer)
+        {
+            const double T = (Layers.GetExtraLayerHeight(CellIndex, Layer) - RayOrigin.Z) / Dir.Z;
+            if (T >= 0.0 && T >= TA && T <= TB && T < BestT)
+            {
+                BestT = T;
+                BestLayer = Layer;
+                BestCell = FIntPoint(CellX, CellY);
+            }
+        }
+
+        // Cells are visited in ray order, so the first deck hit is the nearest.
+        return BestLayer != INDEX_NONE;
+    };
+
+    const double WalkEnd = FMath::Min(TEnd, BestT);
+    if (Config.Topology == EGridTopology::HexAxial)
+    {
+        MarchHex2D(Origin2D, Dir2D, TStart, WalkEnd, Config.Width, Config.Height, VisitCell);
+    }
+    else
+    {
+        MarchLattice2D(Origin2D, Dir2D, TStart, WalkEnd, 0, 0, Config.Width - 1, Config.Height - 1, VisitCell);
+    }
+
+    if (BestLayer == INDEX_NONE)
+    {
+        return bGroundHit;
     }
 
-    OutGrid = FIntPoint(Gx, Gy);
+    OutCell = FGridLayeredCell(BestCell, BestLayer);
+    OutHitPoint = RayOrigin + Dir * BestT;
     return true;
 }
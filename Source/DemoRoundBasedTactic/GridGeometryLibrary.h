@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "GridTypes.h"
+#include "GridLayers.h"
 #include "GridGeometryLibrary.generated.h"
 
 /**
@@ -41,6 +42,20 @@ public:
     UFUNCTION(BlueprintPure, Category = "Grid")
     static FVector GridToWorldEye(const FGridConfig& Config, FIntPoint GridCoord);
 
+    /**
+     * GridToWorldGround for many cells at once: the topology and grid axes are resolved
+     * once and heights are read straight from the height snapshot when there is one.
+     * Every cell must lie inside the grid. OutLocations must have Cells.Num() elements.
+     */
+    static void GridToWorldGroundBatch(const FGridConfig& Config, TConstArrayView<FIntPoint> Cells, TArrayView<FVector> OutLocations);
+
+    /**
+     * World-space basis of the grid plane: the directions of the grid X and Y axes,
+     * resolved from either GridRotation or AxisX / AxisY and normalized.
+     */
+    UFUNCTION(BlueprintPure, Category = "Grid")
+    static void GetGridAxes(const FGridConfig& Config, FVector& OutAxisX, FVector& OutAxisY);
+
     /**
      * Convert a world-space position back into a logical grid coordinate.
      *
@@ -51,7 +66,8 @@ public:
      *                       If false and the position lies outside the grid, the function
      *                       returns false and OutGrid is set to (-1,-1).
      * @param Rounding      Rounding policy used when mapping from continuous
-     *                      coordinates to integer indices.
+     *                      coordinates to integer indices. Hex grids always
+     *                      map to the containing cell and ignore this value.
      *
      * @return True if OutGrid lies inside the valid grid range (or has been clamped there),
      *         false if the position was outside the grid and bClampToBounds was false.
@@ -64,4 +80,68 @@ public:
         bool bClampToBounds,
         EGridRoundingPolicy Rounding = EGridRoundingPolicy::Floor
     );
+
+    /**
+     * Intersect a world-space ray with the grid's height field.
+     *
+     * Unlike WorldToGrid this takes the vertical component into account: each cell
+     * is treated as a flat column whose top is the ground height at that cell, and
+     * the ray is marched through the cells it crosses (2D DDA) until it first dips
+     * below a column top. If the height provider exposes coarse max-height tiles,
+     * whole tiles the ray passes above are skipped. Hex grids are walked cell to
+     * cell through the hex edges the ray crosses instead of a DDA.
+     *
+     * Intended for per-frame cursor / camera picking on hilly terrain without
+     * physics traces against the landscape.
+     *
+     * @param Config       Grid configuration.
+     * @param RayOrigin    World-space ray start.
+     * @param RayDirection World-space ray direction (does not need to be normalized).
+     * @param MaxDistance  Maximum distance along the ray, in world units.
+     * @param OutGrid      First cell hit, or (-1,-1) if nothing was hit.
+     * @param OutHitPoint  Exact world-space hit point on the cell top or side.
+     *
+     * @return True if the ray hit a cell within MaxDistance.
+     */
+    UFUNCTION(BlueprintPure, Category = "Grid")
+    static bool RaycastHeightField(
+        const FGridConfig& Config,
+        const FVector& RayOrigin,
+        const FVector& RayDirection,
+        float MaxDistance,
+        FIntPoint& OutGrid,
+        FVector& OutHitPoint
+    );
+
+    /**
+     * World-space height of one surface of a cell: the ground for layer 0, otherwise the
+     * extra layer from Config.Layers. Layers the cell does not have fall back to the ground.
+     */
+    UFUNCTION(BlueprintPure, Category = "Grid|Layers")
+    static float GetLayerHeight(const FGridConfig& Config, FIntPoint GridCoord, int32 Layer);
+
+    /** Number of surfaces of a cell, including the ground; 1 when the grid has no extra layers. */
+    UFUNCTION(BlueprintPure, Category = "Grid|Layers")
+    static int32 GetNumLayers(const FGridConfig& Config, FIntPoint GridCoord);
+
+    /** GridToWorldGround on a given surface of the cell. */
+    UFUNCTION(BlueprintPure, Category = "Grid|Layers")
+    static FVector GridToWorldGroundLayered(const FGridConfig& Config, const FGridLayeredCell& LayeredCell);
+
+    /**
+     * RaycastHeightField that can also hit extra layers. Each extra layer is a flat deck
+     * over its cell, hit from above only, so rays pass under bridges. Cost is the ground
+     * raycast plus a second walk over the cells the ray crosses before the ground hit,
+     * testing the decks of those cells only; without Config.Layers it is the ground
+     * raycast alone.
+     */
+    UFUNCTION(BlueprintPure, Category = "Grid|Layers")
+    static bool RaycastHeightFieldLayered(
+        const FGridConfig& Config,
+        const FVector& RayOrigin,
+        const FVector& RayDirection,
+        float MaxDistance,
+        FGridLayeredCell& OutCell,
+        FVector& OutHitPoint
+    );
 };
@@ -0,0 +1,142 @@
+// GridHeightBake.cpp
+
+#include "GridHeightBake.h"
+#include "GridGeometryLibrary.h"
+#include "GridStats.h"
+#include "GridTopology.h"
+
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+
+#include <atomic>
+
+namespace
+{
+    /** Half size of the square sampled around a cell centre, in cell units. */
+    template <typename TopologyType>
+    constexpr double GetSampleHalfExtent()
+    {
+        // Hex cells: the square inscribed in the hex's inscribed circle (radius 0.5).
+        return TopologyType::Kind == EGridTopology::HexAxial ? 0.35355339059327376220 : 0.5;
+    }
+}
+
+bool GridHeightBake::BakeHeights(UWorld* World, const FGridConfig& Frame, const FGridHeightBakeSettings& Settings, const AActor* IgnoreActor, FGridHeightBakeResult& OutResult)
+{
+    GRID_QUERY_SCOPE(HeightBake);
+
+    OutResult = FGridHeightBakeResult{};
+    if (!World || Frame.Width <= 0 || Frame.Height <= 0 || Frame.CellSize <= KINDA_SMALL_NUMBER)
+    {
+        return false;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    const int32 NumCells = Frame.Width * Frame.Height;
+    const int32 SamplesPerAxis = FMath::Clamp(Settings.SamplesPerAxis, 1, 8);
+
+    OutResult.Width = Frame.Width;
+    OutResult.Height = Frame.Height;
+    OutResult.Heights.SetNumUninitialized(NumCells);
+
+    FVector XAxis;
+    FVector YAxis;
+    UGridGeometryLibrary::GetGridAxes(Frame, XAxis, YAxis);
+    XAxis *= Frame.CellSize;
+    YAxis *= Frame.CellSize;
+
+    const double TopZ = Frame.GridOrigin.Z + Settings.TraceAbove;
+    const double BottomZ = Frame.GridOrigin.Z - Settings.TraceBelow;
+    const float MissHeight = float(Frame.GridOrigin.Z);
+
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GridHeightBake), Settings.bTraceComplex, IgnoreActor);
+    QueryParams.bReturnPhysicalMaterial = false;
+
+    std::atomic<int64> NumMisses{ 0 };
+
+    DispatchGridTopology(Frame.Topology, [&](auto Topo)
+    {
+        using TopologyType = decltype(Topo);
+        constexpr double HalfExtent = GetSampleHalfExtent<TopologyType>();
+
+        // Sample offsets from the cell centre, shared by every cell.
+        TArray<FVector2D, TInlineAllocator<64>> Offsets;
+        for (int32 SY = 0; SY < SamplesPerAxis; ++SY)
+        {
+            for (int32 SX = 0; SX < SamplesPerAxis; ++SX)
+            {
+                Offsets.Add(FVector2D(
+                    ((SX + 0.5) / SamplesPerAxis * 2.0 - 1.0) * HalfExtent,
+                    ((SY + 0.5) / SamplesPerAxis * 2.0 - 1.0) * HalfExtent));
+            }
+        }
+
+        ParallelFor(TEXT("GridHeightBake"), Frame.Height, 1, [&](int32 Y)
+        {
+            int64 RowMisses = 0;
+            FHitResult Hit;
+
+            for (int32 X = 0; X < Frame.Width; ++X)
+            {
+                const FVector2D Center = TopologyType::CellToLocal(FIntPoint(X, Y));
+
+                // Reduce over hits only; misses would drag the cell towards MissHeight.
+                float MinZ = MAX_flt;
+                float MaxZ = -MAX_flt;
+                double SumZ = 0.0;
+                int32 NumHits = 0;
+
+                for (const FVector2D& Offset : Offsets)
+                {
+                    const FVector2D Local = Center + Offset;
+                    FVector Start = Frame.GridOrigin + XAxis * Local.X + YAxis * Local.Y;
+                    FVector End = Start;
+                    Start.Z = TopZ;
+                    End.Z = BottomZ;
+
+                    if (!World->LineTraceSingleByChannel(Hit, Start, End, Settings.TraceChannel, QueryParams))
+                    {
+                        ++RowMisses;
+                        continue;
+                    }
+
+                    const float Z = float(Hit.ImpactPoint.Z);
+                    MinZ = FMath::Min(MinZ, Z);
+                    MaxZ = FMath::Max(MaxZ, Z);
+                    SumZ += Z;
+                    ++NumHits;
+                }
+
+                const int32 Index = Y * Frame.Width + X;
+                if (NumHits == 0)
+                {
+                    OutResult.Heights[Index] = MissHeight;
+                    continue;
+                }
+
+                switch (Settings.Reduce)
+                {
+                case EGridHeightBakeReduce::Min:
+                    OutResult.Heights[Index] = MinZ;
+                    break;
+                case EGridHeightBakeReduce::Mean:
+                    OutResult.Heights[Index] = float(SumZ / NumHits);
+                    break;
+                case EGridHeightBakeReduce::Max:
+                default:
+                    OutResult.Heights[Index] = MaxZ;
+                    break;
+                }
+            }
+
+            NumMisses += RowMisses;
+        });
+
+        OutResult.NumTraces = int64(NumCells) * Offsets.Num();
+    });
+
+    OutResult.NumMisses = NumMisses.load();
+    OutResult.Seconds = FPlatformTime::Seconds() - StartTime;
+    return true;
+}
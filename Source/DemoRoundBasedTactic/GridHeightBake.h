@@ -0,0 +1,88 @@
+// GridHeightBake.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "GridTypes.h"
+#include "GridHeightBake.generated.h"
+
+class AActor;
+class UWorld;
+
+/** How the samples of one cell are combined into its height. */
+UENUM(BlueprintType)
+enum class EGridHeightBakeReduce : uint8
+{
+    /** Highest sample: units stand on top of rocks and walls. */
+    Max,
+    Min,
+    Mean,
+};
+
+USTRUCT(BlueprintType)
+struct FGridHeightBakeSettings
+{
+    GENERATED_BODY()
+
+    /** Grid size in cells, used when the binding has no height map asset to take it from. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Bake", meta = (ClampMin = "1"))
+    int32 Width = 256;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Bake", meta = (ClampMin = "1"))
+    int32 Height = 256;
+
+    /** Samples per cell along each axis; a cell is sampled SamplesPerAxis² times on a regular inner lattice. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Bake", meta = (ClampMin = "1", ClampMax = "8"))
+    int32 SamplesPerAxis = 2;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Bake")
+    EGridHeightBakeReduce Reduce = EGridHeightBakeReduce::Max;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Bake")
+    TEnumAsByte<ECollisionChannel> TraceChannel = ECC_WorldStatic;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Bake")
+    bool bTraceComplex = false;
+
+    /** Traces run from this far above the grid origin ... */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Bake", meta = (ClampMin = "0"))
+    float TraceAbove = 50000.f;
+
+    /** ... to this far below it. Samples that hit nothing get the grid origin's height. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Bake", meta = (ClampMin = "0"))
+    float TraceBelow = 50000.f;
+};
+
+/** Heights sampled from level geometry, row-major (Index = Y * Width + X) like CellHeights. */
+struct FGridHeightBakeResult
+{
+    int32 Width = 0;
+    int32 Height = 0;
+
+    /** Samples of each cell combined by FGridHeightBakeSettings::Reduce. */
+    TArray<float> Heights;
+
+    int64 NumTraces = 0;
+    int64 NumMisses = 0;
+    double Seconds = 0.0;
+};
+
+namespace GridHeightBake
+{
+    /**
+     * Sample World under every cell of Frame (a config from
+     * UHeightMapGridBindingComponent::MakeGridFrame).
+     *
+     * Each cell is traced straight down along the world Z axis at SamplesPerAxis² points.
+     * Rows are traced in parallel with synchronous scene queries, which are safe to issue
+     * from worker threads. The async trace API is not used, because it only completes
+     * when the world ticks, and editor and commandlet worlds do not tick.
+     *
+     * Square cells are sampled over their square. Hex cells are sampled over the square
+     * inscribed in the hex.
+     *
+     * @return False if the world or frame is unusable.
+     */
+    DEMOROUNDBASEDTACTIC_API bool BakeHeights(UWorld* World, const FGridConfig& Frame, const FGridHeightBakeSettings& Settings, const AActor* IgnoreActor, FGridHeightBakeResult& OutResult);
+}
@@ -0,0 +1,122 @@
+// GridHeightBakeCommandlet.cpp
+
+#include "GridHeightBakeCommandlet.h"
+#include "GridHeightBake.h"
+#include "HeightMapGridBindingComponent.h"
+#include "TerrainHeightMapAsset.h"
+
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "Misc/PackageName.h"
+#include "Misc/Parse.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+UGridHeightBakeCommandlet::UGridHeightBakeCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UGridHeightBakeCommandlet::Main(const FString& Params)
+{
+    FString MapPath;
+    FParse::Value(*Params, TEXT("Map="), MapPath);
+
+    FString ActorName;
+    FParse::Value(*Params, TEXT("Actor="), ActorName);
+
+    FGridHeightBakeSettings Settings;
+    FParse::Value(*Params, TEXT("Width="), Settings.Width);
+    FParse::Value(*Params, TEXT("Height="), Settings.Height);
+    FParse::Value(*Params, TEXT("Samples="), Settings.SamplesPerAxis);
+    Settings.Width = FMath::Max(Settings.Width, 1);
+    Settings.Height = FMath::Max(Settings.Height, 1);
+    Settings.SamplesPerAxis = FMath::Clamp(Settings.SamplesPerAxis, 1, 8);
+    Settings.bTraceComplex = FParse::Param(*Params, TEXT("Complex"));
+
+    FString ReduceString = TEXT("Max");
+    FParse::Value(*Params, TEXT("Reduce="), ReduceString);
+    const int64 ReduceValue = StaticEnum<EGridHeightBakeReduce>()->GetValueByNameString(ReduceString);
+    if (ReduceValue == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Error, TEXT("GridHeightBake: unknown reduction '%s'."), *ReduceString);
+        return 1;
+    }
+    Settings.Reduce = static_cast<EGridHeightBakeReduce>(ReduceValue);
+
+    UPackage* MapPackage = MapPath.IsEmpty() ? nullptr : LoadPackage(nullptr, *MapPath, LOAD_None);
+    UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+    if (!World)
+    {
+        UE_LOG(LogTemp, Error, TEXT("GridHeightBake: could not load map '%s' (pass -Map=<package path>)."), *MapPath);
+        return 1;
+    }
+
+    // A loaded level has no physics scene or registered components until it is initialized.
+    World->AddToRoot();
+    World->WorldType = EWorldType::Editor;
+    World->InitWorld(UWorld::InitializationValues()
+        .CreatePhysicsScene(true)
+        .ShouldSimulatePhysics(false)
+        .AllowAudioPlayback(false)
+        .RequiresHitProxies(false)
+        .CreateNavigation(false)
+        .CreateAISystem(false));
+    World->UpdateWorldComponents(true, false);
+
+    TArray<UHeightMapGridBindingComponent*> Bindings;
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        if (!ActorName.IsEmpty() && It->GetName() != ActorName && It->GetActorNameOrLabel() != ActorName)
+        {
+            continue;
+        }
+        TInlineComponentArray<UHeightMapGridBindingComponent*> Components(*It);
+        Bindings.Append(Components);
+    }
+
+    int32 Result = 0;
+    bool bLevelChanged = false;
+    if (Bindings.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("GridHeightBake: no UHeightMapGridBindingComponent found in '%s'."), *MapPath);
+        Result = 1;
+    }
+
+    for (UHeightMapGridBindingComponent* Binding : Bindings)
+    {
+        const UTerrainHeightMapAsset* Previous = Binding->HeightMapAsset;
+        const UTerrainHeightMapAsset* Baked = UTerrainHeightMapLibrary::BakeHeightMapAssetFromLevel(Binding, Settings);
+        if (!Baked)
+        {
+            UE_LOG(LogTemp, Error, TEXT("GridHeightBake: baking '%s' on '%s' failed."), *Binding->GetName(), *Binding->GetOwner()->GetName());
+            Result = 1;
+            continue;
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("GridHeightBake: '%s' -> %s"), *Binding->GetOwner()->GetName(), *Baked->GetPathName());
+        bLevelChanged |= Baked != Previous;
+    }
+
+    if (bLevelChanged)
+    {
+        const FString FilePath = FPackageName::LongPackageNameToFilename(MapPackage->GetName(), FPackageName::GetMapPackageExtension());
+
+        FSavePackageArgs SaveArgs;
+        SaveArgs.TopLevelFlags = RF_Standalone;
+        SaveArgs.Error = GError;
+        if (!UPackage::SavePackage(MapPackage, World, *FilePath, SaveArgs))
+        {
+            UE_LOG(LogTemp, Error, TEXT("GridHeightBake: could not save map '%s'."), *FilePath);
+            Result = 1;
+        }
+    }
+
+    World->DestroyWorld(false);
+    World->RemoveFromRoot();
+    return Result;
+}
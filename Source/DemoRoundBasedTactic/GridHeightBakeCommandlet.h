@@ -0,0 +1,36 @@
+// GridHeightBakeCommandlet.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GridHeightBakeCommandlet.generated.h"
+
+/**
+ * Bakes the height map assets of a level's grids from its landscape and meshes, for
+ * build machines and batch re-bakes after level edits.
+ *
+ * Usage:
+ *
+ *   UnrealEditor-Cmd <Project>.uproject -run=GridHeightBake -unattended
+ *       -Map=/Game/Maps/MyLevel
+ *       [-Actor=<actor name>] [-Width=256] [-Height=256] [-Samples=2]
+ *       [-Reduce=Max|Min|Mean] [-Complex]
+ *
+ * Every UHeightMapGridBindingComponent in the level (or only those on -Actor) is baked
+ * with UTerrainHeightMapLibrary::BakeHeightMapAssetFromLevel. -Width / -Height only
+ * apply to components without a HeightMapAsset; the level is saved if such a component
+ * got a new asset.
+ *
+ * @return 0 on success, 1 if the map cannot be loaded, no grid was found or a bake failed.
+ */
+UCLASS()
+class UGridHeightBakeCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UGridHeightBakeCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
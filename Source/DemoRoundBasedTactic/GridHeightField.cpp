@@ -0,0 +1,155 @@
+// GridHeightField.cpp
+
+#include "GridHeightField.h"
+
+void FGridHeightTiles::Build(int32 Width, int32 Height, TArrayView<const float> CellHeights, int32 InTileSize)
+{
+    TileSize = static_cast<int32>(FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(InTileSize, 1))));
+    NumTilesX = 0;
+    NumTilesY = 0;
+    TileMaxHeights.Reset();
+
+    if (Width <= 0 || Height <= 0 || CellHeights.Num() != Width * Height)
+    {
+        return;
+    }
+
+    NumTilesX = FMath::DivideAndRoundUp(Width, TileSize);
+    NumTilesY = FMath::DivideAndRoundUp(Height, TileSize);
+    TileMaxHeights.Init(-MAX_flt, NumTilesX * NumTilesY);
+
+    // One pass over the rows; each row only touches NumTilesX entries.
+    for (int32 Y = 0; Y < Height; ++Y)
+    {
+        const float* Row = CellHeights.GetData() + Y * Width;
+        float* TileRow = TileMaxHeights.GetData() + (Y / TileSize) * NumTilesX;
+
+        for (int32 TileX = 0; TileX < NumTilesX; ++TileX)
+        {
+            const int32 X0 = TileX * TileSize;
+            const int32 X1 = FMath::Min(X0 + TileSize, Width);
+
+            float RowMax = TileRow[TileX];
+            for (int32 X = X0; X < X1; ++X)
+            {
+                RowMax = FMath::Max(RowMax, Row[X]);
+            }
+            TileRow[TileX] = RowMax;
+        }
+    }
+}
+
+FGridHeightSnapshot::FGridHeightSnapshot(int32 InWidth, int32 InHeight, TArray<float> InCellHeights, int32 InHeightVersion)
+    : Width(InWidth)
+    , Height(InHeight)
+    , HeightVersion(InHeightVersion)
+    , CellHeights(MoveTemp(InCellHeights))
+{
+#if DO_CHECK
+    check(CellHeights.Num() == Width * Height);
+#endif
+
+    MaxHeightTiles.Build(Width, Height, CellHeights);
+}
+
+FGridHeightSnapshotPublisher::~FGridHeightSnapshotPublisher()
+{
+    for (FSlot& Slot : Slots)
+    {
+        if (const FGridHeightSnapshot* Old = Slot.Snapshot.exchange(nullptr))
+        {
+            Old->Release();
+        }
+        if (Slot.Retired)
+        {
+            Slot.Retired->Release();
+            Slot.Retired = nullptr;
+        }
+    }
+}
+
+FGridHeightSnapshotRef FGridHeightSnapshotPublisher::Acquire() const
+{
+    for (;;)
+    {
+        // Announce the read on the slot before loading its pointer: Publish does not
+        // release a slot's snapshot while a reader sits between the load and its AddRef.
+        const int32 SlotIndex = CurrentSlot.load();
+        const FSlot& Slot = Slots[SlotIndex];
+
+        Slot.Readers.fetch_add(1);
+        FGridHeightSnapshotRef Result(Slot.Snapshot.load());
+        Slot.Readers.fetch_sub(1);
+
+        // A null pointer in a slot that is no longer current means the slot was retired
+        // after we read its index; the new snapshot is in another slot.
+        if (Result.IsValid() || CurrentSlot.load() == SlotIndex)
+        {
+            return Result;
+        }
+    }
+}
+
+void FGridHeightSnapshotPublisher::Publish(FGridHeightSnapshotRef NewSnapshot)
+{
+    const FGridHeightSnapshot* NewPtr = NewSnapshot.GetReference();
+    if (NewPtr)
+    {
+        NewPtr->AddRef(); // owned by the slot
+    }
+
+    const int32 OldIndex = CurrentSlot.load();
+
+    // Readers only ever start on the current slot, so a retired slot can only hold
+    // readers that read the slot index just before it was retired; they leave after a
+    // few instructions, and with several slots there is practically always a free one.
+    int32 FreeIndex = INDEX_NONE;
+    while (FreeIndex == INDEX_NONE)
+    {
+        ReclaimRetired();
+        for (int32 Index = 0; Index < NumSlots; ++Index)
+        {
+            if (Index != OldIndex && !Slots[Index].Retired && !Slots[Index].Snapshot.load())
+            {
+                FreeIndex = Index;
+                break;
+            }
+        }
+        if (FreeIndex == INDEX_NONE)
+        {
+            FPlatformProcess::YieldThread();
+        }
+    }
+
+    Slots[FreeIndex].Snapshot.store(NewPtr);
+    CurrentSlot.store(FreeIndex);
+
+    // From here on, readers that still arrive at the old slot find it empty and retry.
+    Slots[OldIndex].Retired = Slots[OldIndex].Snapshot.exchange(nullptr);
+    ReclaimRetired();
+}
+
+void FGridHeightSnapshotPublisher::ReclaimRetired()
+{
+    for (FSlot& Slot : Slots)
+    {
+        if (Slot.Retired && Slot.Readers.load() == 0)
+        {
+            Slot.Retired->Release();
+            Slot.Retired = nullptr;
+        }
+    }
+}
+
+FArrayGridHeightProvider::FArrayGridHeightProvider(int32 InWidth,
+    int32 InHeight,
+    const TArray<float>& InCellHeights)
+    : Snapshot(new FGridHeightSnapshot(InWidth, InHeight, InCellHeights)) // copy into an internal buffer
+{
+}
+
+FArrayGridHeightProvider::FArrayGridHeightProvider(FGridHeightSnapshotRef InSnapshot)
+    : Snapshot(MoveTemp(InSnapshot))
+{
+    check(Snapshot.IsValid());
+}
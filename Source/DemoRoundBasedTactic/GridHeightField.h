@@ -0,0 +1,189 @@
+// GridHeightField.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridTypes.h"
+#include "Templates/RefCounting.h"
+
+#include <atomic>
+
+/**
+ * Coarse max-height pyramid level used to accelerate height field queries.
+ *
+ * The grid is partitioned into square tiles of TileSize × TileSize cells and the
+ * maximum ground height of every tile is stored in a small row-major array
+ * (Index = TileY * NumTilesX + TileX). Ray marching and arc sampling can then
+ * skip a whole tile whenever the query stays above its maximum height.
+ */
+struct DEMOROUNDBASEDTACTIC_API FGridHeightTiles
+{
+    /** Number of cells along one side of a tile. Always a power of two. */
+    int32 TileSize = 8;
+
+    /** Number of tiles along the grid X axis. */
+    int32 NumTilesX = 0;
+
+    /** Number of tiles along the grid Y axis. */
+    int32 NumTilesY = 0;
+
+    /** Maximum ground height per tile, row-major. */
+    TArray<float> TileMaxHeights;
+
+    /**
+     * Rebuild the tile maxima from a row-major height array (Index = Y * Width + X).
+     *
+     * @param InTileSize Requested tile size; rounded up to the next power of two.
+     */
+    void Build(int32 Width, int32 Height, TArrayView<const float> CellHeights, int32 InTileSize = 8);
+
+    /** True if Build has produced at least one tile. */
+    bool IsValid() const { return TileMaxHeights.Num() > 0; }
+
+    /** Maximum ground height of the given tile. Coordinates must be in range. */
+    FORCEINLINE float GetTileMax(int32 TileX, int32 TileY) const
+    {
+        return TileMaxHeights[TileY * NumTilesX + TileX];
+    }
+};
+
+/**
+ * Immutable, reference-counted copy of a grid's height data.
+ *
+ * A snapshot never changes after construction, so any thread may read it for as
+ * long as it holds a reference. Editing terrain or rebuilding a grid publishes a
+ * new snapshot instead of mutating the old one (see FGridHeightSnapshotPublisher);
+ * the old data is freed once the last reader drops its reference.
+ */
+class DEMOROUNDBASEDTACTIC_API FGridHeightSnapshot : public FRefCountBase
+{
+public:
+    FGridHeightSnapshot(int32 InWidth, int32 InHeight, TArray<float> InCellHeights, int32 InHeightVersion = 0);
+
+    int32 GetWidth() const { return Width; }
+    int32 GetHeight() const { return Height; }
+
+    /** FGridConfigVersion::HeightVersion of the config this snapshot was published for. */
+    int32 GetHeightVersion() const { return HeightVersion; }
+
+    FORCEINLINE float GetHeightAt(int32 GridX, int32 GridY) const
+    {
+        const int32 Index = GridY * Width + GridX;
+#if DO_CHECK
+        check(Index >= 0 && Index < CellHeights.Num());
+#endif
+        return CellHeights.GetData()[Index];
+    }
+
+    /** Direct read-only access to the row-major height buffer (Index = Y * Width + X). */
+    TArrayView<const float> GetCellHeights() const { return CellHeights; }
+
+    const FGridHeightTiles& GetMaxHeightTiles() const { return MaxHeightTiles; }
+
+private:
+    int32 Width = 0;
+    int32 Height = 0;
+    int32 HeightVersion = 0;
+    TArray<float> CellHeights;
+    FGridHeightTiles MaxHeightTiles;
+};
+
+using FGridHeightSnapshotRef = TRefCountPtr<const FGridHeightSnapshot>;
+
+/**
+ * Single-writer, many-reader publication point for height snapshots (RCU style).
+ *
+ * Readers call Acquire from any thread and get a reference to the current
+ * snapshot; they never block and never see a half-written snapshot. The writer
+ * (game thread) calls Publish to swap in new data atomically and never waits for
+ * readers: the previous snapshot is retired into its slot and the publisher drops
+ * its reference as soon as no reader is still between loading the pointer from that
+ * slot and taking its own reference (checked on every Publish). Readers that already
+ * hold a reference keep the old data alive until they release it.
+ *
+ * Acquire once per job (path search, LOS batch, ...) rather than per cell: the
+ * handle is what makes the data stable for the duration of the job.
+ */
+class DEMOROUNDBASEDTACTIC_API FGridHeightSnapshotPublisher
+{
+public:
+    FGridHeightSnapshotPublisher() = default;
+    ~FGridHeightSnapshotPublisher();
+
+    FGridHeightSnapshotPublisher(const FGridHeightSnapshotPublisher&) = delete;
+    FGridHeightSnapshotPublisher& operator=(const FGridHeightSnapshotPublisher&) = delete;
+
+    /** Current snapshot, or null if nothing has been published. Safe from any thread. */
+    FGridHeightSnapshotRef Acquire() const;
+
+    /** Replace the current snapshot. Must only be called from one thread at a time. */
+    void Publish(FGridHeightSnapshotRef NewSnapshot);
+
+private:
+    struct FSlot
+    {
+        /** Owned reference (manually counted) to the snapshot published in this slot. */
+        std::atomic<const FGridHeightSnapshot*> Snapshot{ nullptr };
+
+        /** Readers currently between loading Snapshot and adding their reference. */
+        mutable std::atomic<int32> Readers{ 0 };
+
+        /** Owned reference taken out of Snapshot, released once Readers drains. Writer only. */
+        const FGridHeightSnapshot* Retired = nullptr;
+    };
+
+    /** Release retired snapshots whose slot has no pending reader. Writer only. */
+    void ReclaimRetired();
+
+    static constexpr int32 NumSlots = 4;
+
+    FSlot Slots[NumSlots];
+
+    /** Slot readers load from. */
+    std::atomic<int32> CurrentSlot{ 0 };
+};
+
+/**
+ * Height provider backed by an immutable FGridHeightSnapshot, typically built
+ * from UTerrainHeightMapAsset::CellHeights.
+ *
+ * The snapshot also carries a coarse FGridHeightTiles level so that picking and
+ * other ray queries can skip flat or low areas quickly. Because the data is
+ * immutable the provider may be read from any thread.
+ */
+class DEMOROUNDBASEDTACTIC_API FArrayGridHeightProvider final : public IGridHeightProvider
+{
+public:
+    FArrayGridHeightProvider(int32 InWidth,
+        int32 InHeight,
+        const TArray<float>& InCellHeights);
+
+    explicit FArrayGridHeightProvider(FGridHeightSnapshotRef InSnapshot);
+
+    virtual float GetHeightAt(int32 GridX, int32 GridY) const override
+    {
+        return Snapshot->GetHeightAt(GridX, GridY);
+    }
+
+    virtual const FGridHeightTiles* GetMaxHeightTiles() const override
+    {
+        return Snapshot->GetMaxHeightTiles().IsValid() ? &Snapshot->GetMaxHeightTiles() : nullptr;
+    }
+
+    virtual const FGridHeightSnapshot* GetHeightSnapshot() const override
+    {
+        return Snapshot.GetReference();
+    }
+
+    int32 GetWidth() const { return Snapshot->GetWidth(); }
+    int32 GetHeight() const { return Snapshot->GetHeight(); }
+
+    /** Direct read-only access to the row-major height buffer. */
+    TArrayView<const float> GetCellHeights() const { return Snapshot->GetCellHeights(); }
+
+    /** The immutable data behind this provider. */
+    const FGridHeightSnapshotRef& GetSnapshot() const { return Snapshot; }
+
+private:
+    FGridHeightSnapshotRef Snapshot;
+};
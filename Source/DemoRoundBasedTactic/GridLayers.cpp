@@ -0,0 +1,68 @@
+// GridLayers.cpp
+
+#include "GridLayers.h"
+
+TSharedPtr<const FGridLayerData, ESPMode::ThreadSafe> FGridLayerData::Create(int32 Width, int32 Height, TConstArrayView<FGridLayerSurface> Surfaces)
+{
+    if (Width <= 0 || Height <= 0)
+    {
+        return nullptr;
+    }
+
+    TArray<FGridLayerSurface> Sorted;
+    Sorted.Reserve(Surfaces.Num());
+    for (const FGridLayerSurface& Surface : Surfaces)
+    {
+        if (Surface.Cell.X >= 0 && Surface.Cell.Y >= 0 && Surface.Cell.X < Width && Surface.Cell.Y < Height)
+        {
+            Sorted.Add(Surface);
+        }
+    }
+    if (Sorted.Num() == 0)
+    {
+        return nullptr;
+    }
+
+    Sorted.Sort([Width](const FGridLayerSurface& A, const FGridLayerSurface& B)
+    {
+        const int32 IndexA = A.Cell.Y * Width + A.Cell.X;
+        const int32 IndexB = B.Cell.Y * Width + B.Cell.X;
+        return IndexA != IndexB ? IndexA < IndexB : A.Height < B.Height;
+    });
+
+    TSharedPtr<FGridLayerData, ESPMode::ThreadSafe> Data = MakeShared<FGridLayerData, ESPMode::ThreadSafe>();
+    Data->Width = Width;
+    Data->Height = Height;
+    Data->ExtraCounts.SetNumZeroed(Width * Height);
+    Data->OverflowHeights.Reserve(Sorted.Num());
+    Data->OverflowCells.Reserve(Sorted.Num());
+
+    for (const FGridLayerSurface& Surface : Sorted)
+    {
+        const int32 CellIndex = Surface.Cell.Y * Width + Surface.Cell.X;
+        uint8& Count = Data->ExtraCounts[CellIndex];
+        if (Count == MaxExtraLayers)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("FGridLayerData: cell (%d, %d) has more than %d extra layers; extra surfaces dropped."),
+                Surface.Cell.X, Surface.Cell.Y, MaxExtraLayers);
+            continue;
+        }
+        ++Count;
+        Data->OverflowHeights.Add(Surface.Height);
+        Data->OverflowCells.Add(CellIndex);
+    }
+
+    const int32 NumCells = Width * Height;
+    Data->BlockStarts.SetNumUninitialized((NumCells + BlockMask) >> BlockShift);
+    int32 Slot = 0;
+    for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+    {
+        if ((CellIndex & BlockMask) == 0)
+        {
+            Data->BlockStarts[CellIndex >> BlockShift] = Slot;
+        }
+        Slot += Data->ExtraCounts[CellIndex];
+    }
+
+    return Data;
+}
@@ -0,0 +1,113 @@
+// GridLayers.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridLayers.generated.h"
+
+/**
+ * A walkable surface of a grid, addressed as (X, Y, Layer).
+ * Layer 0 is the terrain ground; layers 1.. are extra surfaces above it (bridge decks,
+ * building floors), in order of increasing height.
+ */
+USTRUCT(BlueprintType)
+struct FGridLayeredCell
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
+    FIntPoint Cell = FIntPoint::ZeroValue;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
+    int32 Layer = 0;
+
+    FGridLayeredCell() = default;
+    FGridLayeredCell(const FIntPoint& InCell, int32 InLayer = 0) : Cell(InCell), Layer(InLayer) {}
+
+    bool operator==(const FGridLayeredCell& Other) const { return Cell == Other.Cell && Layer == Other.Layer; }
+    bool operator!=(const FGridLayeredCell& Other) const { return !(*this == Other); }
+};
+
+/** Authoring entry: one extra surface of a cell at a world-space height. */
+USTRUCT(BlueprintType)
+struct FGridLayerSurface
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
+    FIntPoint Cell = FIntPoint::ZeroValue;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
+    float Height = 0.f;
+};
+
+/**
+ * Extra surfaces of a grid on top of its single-height terrain.
+ *
+ * Most cells have only the ground, so the per-cell cost is one byte (number of extra
+ * layers) plus one offset per 32 cells; the extra layers themselves are packed into an
+ * overflow array ordered by cell, then height. Code that finds no extra layers on a cell
+ * falls through to the plain ground path, and grids without any extra layers carry no
+ * FGridLayerData at all (FGridConfig::Layers is null).
+ *
+ * Immutable after Create; shared between threads like a height snapshot.
+ */
+class DEMOROUNDBASEDTACTIC_API FGridLayerData
+{
+public:
+    static constexpr int32 MaxExtraLayers = MAX_uint8;
+
+    /**
+     * Pack Surfaces for a Width × Height grid. Surfaces outside the grid are dropped, as are
+     * surfaces past MaxExtraLayers on one cell. Null if no surface remains.
+     */
+    static TSharedPtr<const FGridLayerData, ESPMode::ThreadSafe> Create(int32 Width, int32 Height, TConstArrayView<FGridLayerSurface> Surfaces);
+
+    int32 GetWidth() const { return Width; }
+    int32 GetHeight() const { return Height; }
+
+    /** Number of surfaces of a cell (Index = Y * Width + X), including the ground. */
+    FORCEINLINE int32 GetNumLayers(int32 CellIndex) const { return 1 + ExtraCounts[CellIndex]; }
+
+    FORCEINLINE bool HasExtraLayers(int32 CellIndex) const { return ExtraCounts[CellIndex] != 0; }
+
+    /** Overflow slot of layer 1 of a cell; layer L is at slot + L - 1. */
+    FORCEINLINE int32 GetOverflowStart(int32 CellIndex) const
+    {
+        int32 Slot = BlockStarts[CellIndex >> BlockShift];
+        for (int32 Index = CellIndex & ~BlockMask; Index < CellIndex; ++Index)
+        {
+            Slot += ExtraCounts[Index];
+        }
+        return Slot;
+    }
+
+    /** Height of an extra layer (1 .. GetNumLayers - 1) of a cell. */
+    FORCEINLINE float GetExtraLayerHeight(int32 CellIndex, int32 Layer) const
+    {
+        return OverflowHeights[GetOverflowStart(CellIndex) + Layer - 1];
+    }
+
+    int32 GetNumOverflow() const { return OverflowHeights.Num(); }
+    FORCEINLINE float GetOverflowHeight(int32 Slot) const { return OverflowHeights[Slot]; }
+    FORCEINLINE int32 GetOverflowCell(int32 Slot) const { return OverflowCells[Slot]; }
+
+    /** Layer number of an overflow slot. */
+    FORCEINLINE int32 GetOverflowLayer(int32 Slot) const { return Slot - GetOverflowStart(OverflowCells[Slot]) + 1; }
+
+private:
+    static constexpr int32 BlockShift = 5;
+    static constexpr int32 BlockMask = (1 << BlockShift) - 1;
+
+    int32 Width = 0;
+    int32 Height = 0;
+
+    /** Extra layers per cell. */
+    TArray<uint8> ExtraCounts;
+
+    /** Overflow slot of the first cell of every block of 32 cells. */
+    TArray<int32> BlockStarts;
+
+    TArray<float> OverflowHeights;
+    TArray<int32> OverflowCells;
+};
@@ -0,0 +1,78 @@
+// GridMovementRules.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridTopology.h"
+#include "GridTypes.h"
+
+/**
+ * Step rules of FGridMovementProfile, shared by the on-the-fly searches and the
+ * baked traversal graph so that both always agree on passability and costs.
+ */
+namespace GridMovement
+{
+    /**
+     * Cost of a single step between two ground heights, or a negative value if the
+     * profile forbids the step.
+     */
+    FORCEINLINE float EvaluateStep(const FGridMovementProfile& Profile, float FromZ, float ToZ, float BaseCost)
+    {
+        const float Rise = ToZ - FromZ;
+        if (Rise > Profile.MaxStepUp || -Rise > Profile.MaxStepDown)
+        {
+            return -1.f;
+        }
+
+        return BaseCost
+            + FMath::Max(Rise, 0.f) * Profile.ClimbCostPerUnit
+            + FMath::Max(-Rise, 0.f) * Profile.DescendCostPerUnit;
+    }
+
+    /**
+     * Call Visit(NeighborCell, NeighborIndex, StepCost) for every passable neighbour of Cell
+     * on a Width × Height grid, reading ground heights through HeightAt(X, Y).
+     * Fully unrolled per topology; diagonal corner checks only exist in the Square8 instantiation.
+     */
+    template <typename TopologyType, typename HeightFuncType, typename VisitorType>
+    FORCEINLINE void ForEachPassableNeighbor(
+        int32 Width,
+        int32 Height,
+        const FGridMovementProfile& Profile,
+        const FIntPoint& Cell,
+        float CellZ,
+        HeightFuncType&& HeightAt,
+        VisitorType&& Visit)
+    {
+        for (int32 N = 0; N < TopologyType::NumNeighbors; ++N)
+        {
+            const FGridNeighborOffset& Offset = TopologyType::NeighborOffsets[N];
+            const FIntPoint Next(Cell.X + Offset.DX, Cell.Y + Offset.DY);
+            if (Next.X < 0 || Next.X >= Width || Next.Y < 0 || Next.Y >= Height)
+            {
+                continue;
+            }
+
+            const float Cost = EvaluateStep(Profile, CellZ, HeightAt(Next.X, Next.Y), TopologyType::StepCosts[N]);
+            if (Cost < 0.f)
+            {
+                continue;
+            }
+
+            if constexpr (TopologyType::Kind == EGridTopology::Square8)
+            {
+                if (Offset.DX != 0 && Offset.DY != 0 && !Profile.bAllowCornerCutting)
+                {
+                    const float SideA = EvaluateStep(Profile, CellZ, HeightAt(Next.X, Cell.Y), 1.f);
+                    const float SideB = EvaluateStep(Profile, CellZ, HeightAt(Cell.X, Next.Y), 1.f);
+                    if (SideA < 0.f || SideB < 0.f)
+                    {
+                        continue;
+                    }
+                }
+            }
+
+            Visit(Next, Next.Y * Width + Next.X, Cost);
+        }
+    }
+}
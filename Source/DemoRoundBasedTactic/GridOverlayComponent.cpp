@@ -0,0 +1,292 @@
+// GridOverlayComponent.cpp
+
+#include "GridOverlayComponent.h"
+#include "GridGeometryLibrary.h"
+#include "HeightMapGridBindingComponent.h"
+#include "Math/RotationMatrix.h"
+
+namespace
+{
+    /** Copy of Mask restricted to the cells of a Width × Height grid. */
+    FGridCellMask ClipToGrid(const FGridCellMask& Mask, int32 Width, int32 Height)
+    {
+        const FIntRect Window = Mask.GetWindow();
+        if (Window.Min.X >= 0 && Window.Min.Y >= 0 && Window.Max.X <= Width && Window.Max.Y <= Height)
+        {
+            return Mask;
+        }
+
+        const FIntPoint Min(FMath::Max(Window.Min.X, 0), FMath::Max(Window.Min.Y, 0));
+        const FIntPoint Max(FMath::Min(Window.Max.X, Width), FMath::Min(Window.Max.Y, Height));
+        FGridCellMask Clipped(Min, Max.X - Min.X, Max.Y - Min.Y);
+        Mask.ForEachSetCell([&Clipped](const FIntPoint& Cell) { Clipped.SetCell(Cell); });
+        return Clipped;
+    }
+}
+
+UGridOverlayComponent::UGridOverlayComponent()
+{
+    // Pure visuals: no collision, shadows or navigation, and instances move whenever the overlay changes.
+    SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    SetGenerateOverlapEvents(false);
+    SetCanEverAffectNavigation(false);
+    CastShadow = false;
+    Mobility = EComponentMobility::Movable;
+}
+
+void UGridOverlayComponent::OnUnregister()
+{
+    UnbindGrid();
+    Super::OnUnregister();
+}
+
+void UGridOverlayComponent::BindToGrid(UHeightMapGridBindingComponent* GridComponent)
+{
+    UnbindGrid();
+    ClearOverlay();
+
+    if (GridComponent)
+    {
+        BoundComponent = GridComponent;
+        BoundGrid = GridComponent->GetGridHandle();
+        ConfigChangedHandle = GridComponent->OnGridConfigChangedNative.AddUObject(this, &UGridOverlayComponent::OnGridConfigChanged);
+    }
+}
+
+void UGridOverlayComponent::UnbindGrid()
+{
+    if (UHeightMapGridBindingComponent* Component = BoundComponent.Get())
+    {
+        Component->OnGridConfigChangedNative.Remove(ConfigChangedHandle);
+    }
+    ConfigChangedHandle.Reset();
+    BoundComponent.Reset();
+    BoundGrid = FGridHandle{};
+}
+
+const FGridConfig* UGridOverlayComponent::ResolveBoundConfig()
+{
+    UGridWorldSubsystem* Grids = UGridWorldSubsystem::Get(this);
+    if (!Grids)
+    {
+        return nullptr;
+    }
+
+    if (!BoundGrid.IsSet())
+    {
+        if (UHeightMapGridBindingComponent* GridComponent = Grids->GetGridComponent(Grids->FindGridAtLocation(GetComponentLocation())))
+        {
+            BindToGrid(GridComponent);
+        }
+    }
+    return Grids->GetGridConfig(BoundGrid);
+}
+
+void UGridOverlayComponent::SetOverlayCells(const TArray<FIntPoint>& Cells)
+{
+    const FGridConfig* Config = ResolveBoundConfig();
+    if (!Config)
+    {
+        ClearOverlay();
+        return;
+    }
+
+    // Bounding window of the in-grid cells.
+    FIntPoint Min(MAX_int32, MAX_int32);
+    FIntPoint Max(MIN_int32, MIN_int32);
+    for (const FIntPoint& Cell : Cells)
+    {
+        if (Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Config->Width && Cell.Y < Config->Height)
+        {
+            Min = Min.ComponentMin(Cell);
+            Max = Max.ComponentMax(Cell);
+        }
+    }
+
+    FGridCellMask Mask;
+    if (Min.X <= Max.X)
+    {
+        Mask.Init(Min, Max.X - Min.X + 1, Max.Y - Min.Y + 1);
+        for (const FIntPoint& Cell : Cells)
+        {
+            Mask.SetCell(Cell);
+        }
+    }
+    ApplyMask(*Config, Mask);
+}
+
+void UGridOverlayComponent::SetOverlayMask(const FGridCellMask& Mask)
+{
+    const FGridConfig* Config = ResolveBoundConfig();
+    if (!Config)
+    {
+        ClearOverlay();
+        return;
+    }
+    ApplyMask(*Config, ClipToGrid(Mask, Config->Width, Config->Height));
+}
+
+void UGridOverlayComponent::ClearOverlay()
+{
+    if (InstanceCells.Num() > 0)
+    {
+        ClearInstances();
+    }
+    InstanceCells.Reset();
+    CellToInstance.Reset();
+    Shown.Empty();
+}
+
+void UGridOverlayComponent::ComputeTransforms(const FGridConfig& Config, TConstArrayView<FIntPoint> Cells, TArray<FTransform>& OutTransforms) const
+{
+    TArray<FVector> Locations;
+    Locations.SetNumUninitialized(Cells.Num());
+    UGridGeometryLibrary::GridToWorldGroundBatch(Config, Cells, Locations);
+
+    FVector AxisX;
+    FVector AxisY;
+    UGridGeometryLibrary::GetGridAxes(Config, AxisX, AxisY);
+    const FQuat Rotation = FRotationMatrix::MakeFromXY(AxisX, AxisY).ToQuat();
+
+    const float Scale = Config.CellSize * CellScale / FMath::Max(MeshFootprint, KINDA_SMALL_NUMBER);
+    const FVector Scale3D(Scale, Scale, 1.f);
+
+    OutTransforms.Reset(Cells.Num());
+    for (const FVector& Location : Locations)
+    {
+        OutTransforms.Emplace(Rotation, Location + FVector(0.f, 0.f, HeightOffset), Scale3D);
+    }
+}
+
+void UGridOverlayComponent::ApplyMask(const FGridConfig& Config, const FGridCellMask& New)
+{
+    // Cells that left the overlay free their instance; cells that entered need one.
+    TArray<int32> FreeSlots;
+    TArray<FIntPoint> Added;
+    FGridCellMask::ForEachDifference(Shown, New, [this, &FreeSlots, &Added](const FIntPoint& Cell, bool bNowSet)
+    {
+        if (bNowSet)
+        {
+            Added.Add(Cell);
+        }
+        else
+        {
+            int32 Slot = INDEX_NONE;
+            CellToInstance.RemoveAndCopyValue(Cell, Slot);
+            FreeSlots.Add(Slot);
+        }
+    });
+
+    Shown = New;
+    if (FreeSlots.Num() == 0 && Added.Num() == 0)
+    {
+        return;
+    }
+
+    TArray<FTransform> AddedTransforms;
+    ComputeTransforms(Config, Added, AddedTransforms);
+
+    // Reuse freed instances first: an in-place transform update instead of a remove plus an add.
+    const int32 NumReused = FMath::Min(FreeSlots.Num(), Added.Num());
+    for (int32 Index = 0; Index < NumReused; ++Index)
+    {
+        const int32 Slot = FreeSlots[Index];
+        InstanceCells[Slot] = Added[Index];
+        CellToInstance.Add(Added[Index], Slot);
+        UpdateInstanceTransform(Slot, AddedTransforms[Index], /*bWorldSpace*/ true, /*bMarkRenderStateDirty*/ false, /*bTeleport*/ true);
+    }
+
+    if (Added.Num() > NumReused)
+    {
+        const int32 FirstNew = InstanceCells.Num();
+        const TArray<FTransform> NewTransforms(AddedTransforms.GetData() + NumReused, Added.Num() - NumReused);
+        AddInstances(NewTransforms, /*bShouldReturnIndices*/ false, /*bWorldSpace*/ true);
+
+        for (int32 Index = NumReused; Index < Added.Num(); ++Index)
+        {
+            CellToInstance.Add(Added[Index], FirstNew + Index - NumReused);
+            InstanceCells.Add(Added[Index]);
+        }
+    }
+    else if (FreeSlots.Num() > NumReused)
+    {
+        // Surplus free instances: fill the holes below the new count with live instances
+        // from the tail, then drop the tail. Removing from the end never shifts an index.
+        const int32 NumSurplus = FreeSlots.Num() - NumReused;
+        const int32 NewCount = InstanceCells.Num() - NumSurplus;
+
+        TBitArray<> TailFree(false, NumSurplus);
+        TArray<int32> Holes;
+        for (int32 Index = NumReused; Index < FreeSlots.Num(); ++Index)
+        {
+            const int32 Slot = FreeSlots[Index];
+            if (Slot >= NewCount)
+            {
+                TailFree[Slot - NewCount] = true;
+            }
+            else
+            {
+                Holes.Add(Slot);
+            }
+        }
+
+        int32 HoleIndex = 0;
+        for (int32 Tail = NewCount; Tail < InstanceCells.Num() && HoleIndex < Holes.Num(); ++Tail)
+        {
+            if (TailFree[Tail - NewCount])
+            {
+                continue;
+            }
+
+            const int32 Hole = Holes[HoleIndex++];
+            FTransform Transform;
+            GetInstanceTransform(Tail, Transform, /*bWorldSpace*/ true);
+            UpdateInstanceTransform(Hole, Transform, /*bWorldSpace*/ true, /*bMarkRenderStateDirty*/ false, /*bTeleport*/ true);
+
+            InstanceCells[Hole] = InstanceCells[Tail];
+            CellToInstance[InstanceCells[Hole]] = Hole;
+        }
+
+        TArray<int32> TailIndices;
+        TailIndices.Reserve(NumSurplus);
+        for (int32 Index = InstanceCells.Num() - 1; Index >= NewCount; --Index)
+        {
+            TailIndices.Add(Index);
+        }
+        RemoveInstances(TailIndices);
+        InstanceCells.SetNum(NewCount);
+    }
+
+    MarkRenderStateDirty();
+}
+
+void UGridOverlayComponent::RefreshAllTransforms(const FGridConfig& Config)
+{
+    if (InstanceCells.Num() == 0)
+    {
+        return;
+    }
+
+    TArray<FTransform> Transforms;
+    ComputeTransforms(Config, InstanceCells, Transforms);
+    BatchUpdateInstancesTransforms(0, Transforms, /*bWorldSpace*/ true, /*bMarkRenderStateDirty*/ true, /*bTeleport*/ true);
+}
+
+void UGridOverlayComponent::OnGridConfigChanged(UHeightMapGridBindingComponent* Component, EGridConfigChange ChangedParts)
+{
+    const FGridConfig& Config = Component->GridConfig;
+
+    if (EnumHasAnyFlags(ChangedParts, EGridConfigChange::Dimensions))
+    {
+        // Cells may have left the grid: re-apply the clipped overlay from scratch.
+        const FGridCellMask Clipped = ClipToGrid(Shown, Config.Width, Config.Height);
+        ClearOverlay();
+        ApplyMask(Config, Clipped);
+        return;
+    }
+
+    if (EnumHasAnyFlags(ChangedParts, EGridConfigChange::Frame | EGridConfigChange::HeightData))
+    {
+        RefreshAllTransforms(Config);
+    }
+}
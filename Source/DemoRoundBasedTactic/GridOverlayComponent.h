@@ -0,0 +1,104 @@
+// GridOverlayComponent.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "GridCellMask.h"
+#include "GridTypes.h"
+#include "GridWorldSubsystem.h"
+#include "GridOverlayComponent.generated.h"
+
+class UHeightMapGridBindingComponent;
+
+/**
+ * Draws cell highlights (movement range, attack range, path previews) on a bound grid
+ * as instances of one mesh, so a whole overlay is a single draw call.
+ *
+ * Callers hand in the full set of cells every time (a cell list or an FGridCellMask);
+ * the component diffs it against what is shown and only touches the instances of cells
+ * that entered or left: freed instances are reused for new cells and any surplus is
+ * compacted to the end and removed, so no instance index ever shifts mid-update.
+ * Transforms are computed in one batch through the grid frame (GridToWorldGroundBatch).
+ *
+ * The mesh should be a flat tile lying in the XY plane, centred on its origin and
+ * MeshFootprint units across; instances are aligned with the grid axes.
+ */
+UCLASS(ClassGroup = (Grid), BlueprintType, meta = (BlueprintSpawnableComponent))
+class DEMOROUNDBASEDTACTIC_API UGridOverlayComponent : public UInstancedStaticMeshComponent
+{
+    GENERATED_BODY()
+
+public:
+    UGridOverlayComponent();
+
+    /** Width of the overlay mesh in its own units; instances are scaled so it spans CellScale of a cell. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Overlay", meta = (ClampMin = "0.01"))
+    float MeshFootprint = 100.f;
+
+    /** Fraction of the cell covered by each highlight; below 1 leaves a visible gap between cells. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Overlay", meta = (ClampMin = "0.01", ClampMax = "1.0"))
+    float CellScale = 0.9f;
+
+    /** Lift above the ground so the overlay does not z-fight with the terrain. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Overlay")
+    float HeightOffset = 2.f;
+
+    /**
+     * Show the overlay on this grid. Clears the current overlay; later changes of the grid's config
+     * re-place it. If no grid is bound when cells are first set, the grid under the component is used.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Overlay")
+    void BindToGrid(UHeightMapGridBindingComponent* GridComponent);
+
+    UFUNCTION(BlueprintPure, Category = "Overlay")
+    FGridHandle GetBoundGrid() const { return BoundGrid; }
+
+    /** Show exactly Cells (cells outside the grid are ignored). */
+    UFUNCTION(BlueprintCallable, Category = "Overlay")
+    void SetOverlayCells(const TArray<FIntPoint>& Cells);
+
+    /** Show exactly the set cells of Mask (cells outside the grid are ignored). */
+    void SetOverlayMask(const FGridCellMask& Mask);
+
+    UFUNCTION(BlueprintCallable, Category = "Overlay")
+    void ClearOverlay();
+
+    UFUNCTION(BlueprintPure, Category = "Overlay")
+    int32 GetOverlayCellCount() const { return InstanceCells.Num(); }
+
+    /** Cells currently shown. */
+    const FGridCellMask& GetOverlayMask() const { return Shown; }
+
+protected:
+    virtual void OnUnregister() override;
+
+private:
+    void UnbindGrid();
+    void OnGridConfigChanged(UHeightMapGridBindingComponent* Component, EGridConfigChange ChangedParts);
+
+    /** World transforms of the highlights on Cells (all inside the grid). */
+    void ComputeTransforms(const FGridConfig& Config, TConstArrayView<FIntPoint> Cells, TArray<FTransform>& OutTransforms) const;
+
+    /** Diff New against Shown and update the instances accordingly. New must be clipped to the grid. */
+    void ApplyMask(const FGridConfig& Config, const FGridCellMask& New);
+
+    /** Re-place every shown instance (grid frame or heights changed). */
+    void RefreshAllTransforms(const FGridConfig& Config);
+
+    /** Config of the bound grid (binding the grid under the component if none is bound yet), or null. */
+    const FGridConfig* ResolveBoundConfig();
+
+    FGridHandle BoundGrid;
+    TWeakObjectPtr<UHeightMapGridBindingComponent> BoundComponent;
+    FDelegateHandle ConfigChangedHandle;
+
+    /** Cells currently shown, in grid coordinates. */
+    FGridCellMask Shown;
+
+    /** Cell of each instance, by instance index. */
+    TArray<FIntPoint> InstanceCells;
+
+    /** Instance index of each shown cell. */
+    TMap<FIntPoint, int32> CellToInstance;
+};
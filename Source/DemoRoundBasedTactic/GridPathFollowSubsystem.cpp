@@ -0,0 +1,267 @@
+// GridPathFollowSubsystem.cpp
+
+#include "GridPathFollowSubsystem.h"
+#include "GridGeometryLibrary.h"
+#include "GridStats.h"
+
+#include "Components/SceneComponent.h"
+
+TSharedRef<const FGridPathPolyline, ESPMode::ThreadSafe> FGridPathPolyline::Build(const FGridConfig& Config, TConstArrayView<FIntPoint> Cells, int32 SmoothingIterations)
+{
+    GRID_QUERY_SCOPE(PathFollow);
+
+    TSharedRef<FGridPathPolyline, ESPMode::ThreadSafe> Polyline = MakeShared<FGridPathPolyline, ESPMode::ThreadSafe>();
+
+    TArray<FVector> Points;
+    Points.SetNumUninitialized(Cells.Num());
+    UGridGeometryLibrary::GridToWorldGroundBatch(Config, Cells, Points);
+
+    // Chaikin corner cutting: every segment is replaced by its 1/4 and 3/4 points,
+    // except that the first and last points stay where they are.
+    TArray<FVector> Cut;
+    for (int32 Iteration = 0; Iteration < SmoothingIterations && Points.Num() > 2; ++Iteration)
+    {
+        Cut.Reset(Points.Num() * 2);
+        Cut.Add(Points[0]);
+        for (int32 Index = 0; Index + 1 < Points.Num(); ++Index)
+        {
+            const FVector& A = Points[Index];
+            const FVector& B = Points[Index + 1];
+            if (Index > 0)
+            {
+                Cut.Add(FMath::Lerp(A, B, 0.25));
+            }
+            if (Index + 2 < Points.Num())
+            {
+                Cut.Add(FMath::Lerp(A, B, 0.75));
+            }
+        }
+        Cut.Add(Points.Last());
+        Swap(Points, Cut);
+    }
+
+    Polyline->CumulativeLength.SetNumUninitialized(Points.Num());
+    float Length = 0.f;
+    for (int32 Index = 0; Index < Points.Num(); ++Index)
+    {
+        if (Index > 0)
+        {
+            Length += float(FVector::Dist(Points[Index - 1], Points[Index]));
+        }
+        Polyline->CumulativeLength[Index] = Length;
+    }
+    Polyline->Points = MoveTemp(Points);
+
+    return Polyline;
+}
+
+FGridMoverHandle UGridPathFollowSubsystem::StartMove(USceneComponent* Component, FGridHandle Grid, const TArray<FIntPoint>& Path, float Speed, int32 SmoothingIterations, bool bOrientToPath)
+{
+    const UGridWorldSubsystem* Registry = UGridWorldSubsystem::Get(this);
+    const FGridConfig* Config = Registry ? Registry->GetGridConfig(Grid) : nullptr;
+    if (!Component || !Config || Path.Num() == 0)
+    {
+        return FGridMoverHandle{};
+    }
+
+    for (const FIntPoint& Cell : Path)
+    {
+        if (Cell.X < 0 || Cell.Y < 0 || Cell.X >= Config->Width || Cell.Y >= Config->Height)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("UGridPathFollowSubsystem::StartMove: path cell (%d, %d) is outside the grid."), Cell.X, Cell.Y);
+            return FGridMoverHandle{};
+        }
+    }
+
+    return StartMoveOnPolyline(Component, FGridPathPolyline::Build(*Config, Path, FMath::Clamp(SmoothingIterations, 0, 4)), Speed, bOrientToPath);
+}
+
+FGridMoverHandle UGridPathFollowSubsystem::StartMoveOnPolyline(USceneComponent* Component, TSharedRef<const FGridPathPolyline, ESPMode::ThreadSafe> Polyline, float Speed, bool bOrientToPath)
+{
+    if (!Component)
+    {
+        return FGridMoverHandle{};
+    }
+
+    // One mover per component: retargeting replaces the old path.
+    const int32 Existing = Movers.IndexOfByPredicate([Component](const FMover& Mover) { return Mover.Component.Get() == Component; });
+    if (Existing != INDEX_NONE)
+    {
+        RemoveMoverAt(Existing);
+    }
+
+    const int32 HandleId = FreeHandleIds.Num() > 0 ? FreeHandleIds.Pop(EAllowShrinking::No) : Handles.AddDefaulted();
+    FHandleEntry& Handle = Handles[HandleId];
+    Handle.MoverIndex = Movers.Num();
+    ++Handle.Serial;
+
+    FMover& Mover = Movers.AddDefaulted_GetRef();
+    Mover.Component = Component;
+    Mover.Polyline = Polyline;
+    Mover.HandleId = HandleId;
+    Mover.bOrientToPath = bOrientToPath;
+
+    Distances.Add(0.f);
+    Speeds.Add(FMath::Max(Speed, 0.f));
+    Segments.Add(0);
+
+    FGridMoverHandle Result;
+    Result.Id = HandleId;
+    Result.Serial = Handle.Serial;
+    return Result;
+}
+
+void UGridPathFollowSubsystem::StopMove(FGridMoverHandle Mover)
+{
+    const int32 MoverIndex = ResolveMover(Mover);
+    if (MoverIndex != INDEX_NONE)
+    {
+        RemoveMoverAt(MoverIndex);
+    }
+}
+
+void UGridPathFollowSubsystem::SetMoverSpeed(FGridMoverHandle Mover, float Speed)
+{
+    const int32 MoverIndex = ResolveMover(Mover);
+    if (MoverIndex != INDEX_NONE)
+    {
+        Speeds[MoverIndex] = FMath::Max(Speed, 0.f);
+    }
+}
+
+bool UGridPathFollowSubsystem::IsMoving(FGridMoverHandle Mover) const
+{
+    return ResolveMover(Mover) != INDEX_NONE;
+}
+
+float UGridPathFollowSubsystem::GetMoveProgress(FGridMoverHandle Mover) const
+{
+    const int32 MoverIndex = ResolveMover(Mover);
+    if (MoverIndex == INDEX_NONE)
+    {
+        return 0.f;
+    }
+
+    const float Length = Movers[MoverIndex].Polyline->GetLength();
+    return Length > UE_KINDA_SMALL_NUMBER ? FMath::Clamp(Distances[MoverIndex] / Length, 0.f, 1.f) : 1.f;
+}
+
+void UGridPathFollowSubsystem::UpdateMovers(float DeltaTime)
+{
+    if (Movers.Num() == 0)
+    {
+        return;
+    }
+
+    GRID_QUERY_SCOPE(PathFollow);
+
+    const int32 NumMovers = Movers.Num();
+
+    // Stepping pass: only the flat arrays and the polylines are touched.
+    for (int32 Index = 0; Index < NumMovers; ++Index)
+    {
+        Distances[Index] += Speeds[Index] * DeltaTime;
+    }
+
+    NewLocations.SetNumUninitialized(NumMovers, EAllowShrinking::No);
+    NewDirections.SetNumUninitialized(NumMovers, EAllowShrinking::No);
+    for (int32 Index = 0; Index < NumMovers; ++Index)
+    {
+        NewLocations[Index] = Movers[Index].Polyline->Advance(Distances[Index], Segments[Index], NewDirections[Index]);
+    }
+
+    // Write-back pass.
+    for (int32 Index = 0; Index < NumMovers; ++Index)
+    {
+        USceneComponent* Component = Movers[Index].Component.Get();
+        if (!Component)
+        {
+            continue;
+        }
+
+        const FVector Direction2D(NewDirections[Index].X, NewDirections[Index].Y, 0.0);
+        if (Movers[Index].bOrientToPath && !Direction2D.IsNearlyZero())
+        {
+            FRotator Rotation = Component->GetComponentRotation();
+            Rotation.Yaw = Direction2D.Rotation().Yaw;
+            Component->SetWorldLocationAndRotationNoPhysics(NewLocations[Index], Rotation);
+        }
+        else
+        {
+            Component->SetWorldLocation(NewLocations[Index]);
+        }
+    }
+
+    // Retire finished and dead movers from the back so indices below stay valid.
+    TArray<TPair<FGridMoverHandle, TWeakObjectPtr<USceneComponent>>, TInlineAllocator<8>> Finished;
+    for (int32 Index = NumMovers - 1; Index >= 0; --Index)
+    {
+        const FMover& Mover = Movers[Index];
+        const bool bArrived = Distances[Index] >= Mover.Polyline->GetLength();
+        if (!bArrived && Mover.Component.IsValid())
+        {
+            continue;
+        }
+
+        if (bArrived && Mover.Component.IsValid())
+        {
+            FGridMoverHandle Handle;
+            Handle.Id = Mover.HandleId;
+            Handle.Serial = Handles[Mover.HandleId].Serial;
+            Finished.Emplace(Handle, Mover.Component);
+        }
+        RemoveMoverAt(Index);
+    }
+
+    // Listeners may start new moves, so broadcast only once the arrays are consistent.
+    for (const TPair<FGridMoverHandle, TWeakObjectPtr<USceneComponent>>& Entry : Finished)
+    {
+        OnMoveFinished.Broadcast(Entry.Key, Entry.Value.Get());
+    }
+}
+
+void UGridPathFollowSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    UpdateMovers(DeltaTime);
+}
+
+TStatId UGridPathFollowSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UGridPathFollowSubsystem, STATGROUP_Tickables);
+}
+
+bool UGridPathFollowSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UGridPathFollowSubsystem::ResolveMover(FGridMoverHandle Mover) const
+{
+    if (!Handles.IsValidIndex(Mover.Id) || Handles[Mover.Id].Serial != Mover.Serial)
+    {
+        return INDEX_NONE;
+    }
+    return Handles[Mover.Id].MoverIndex;
+}
+
+void UGridPathFollowSubsystem::RemoveMoverAt(int32 MoverIndex)
+{
+    const int32 HandleId = Movers[MoverIndex].HandleId;
+    Handles[HandleId].MoverIndex = INDEX_NONE;
+    ++Handles[HandleId].Serial;
+    FreeHandleIds.Add(HandleId);
+
+    // Swap-remove keeps the arrays dense; fix up the handle of the mover moved into the hole.
+    const int32 Last = Movers.Num() - 1;
+    if (MoverIndex != Last)
+    {
+        Handles[Movers[Last].HandleId].MoverIndex = MoverIndex;
+    }
+
+    Movers.RemoveAtSwap(MoverIndex, 1, EAllowShrinking::No);
+    Distances.RemoveAtSwap(MoverIndex, 1, EAllowShrinking::No);
+    Speeds.RemoveAtSwap(MoverIndex, 1, EAllowShrinking::No);
+    Segments.RemoveAtSwap(MoverIndex, 1, EAllowShrinking::No);
+}
@@ -0,0 +1,173 @@
+// GridPathFollowSubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GridTypes.h"
+#include "GridWorldSubsystem.h"
+#include "GridPathFollowSubsystem.generated.h"
+
+class USceneComponent;
+
+/**
+ * World-space polyline of a cell path with cumulative arc length.
+ *
+ * Built once per path: the cell centres are converted with GridToWorldGroundBatch and
+ * the corners are rounded by Chaikin corner cutting (endpoints stay on their cells).
+ * Immutable afterwards, so several movers can share one polyline.
+ */
+struct DEMOROUNDBASEDTACTIC_API FGridPathPolyline
+{
+    TArray<FVector> Points;
+
+    /** CumulativeLength[i] = length of the polyline from Points[0] to Points[i]. */
+    TArray<float> CumulativeLength;
+
+    /**
+     * Build the polyline of Cells (all inside the grid).
+     * @param SmoothingIterations Rounds of corner cutting; 0 keeps the straight cell-to-cell segments.
+     */
+    static TSharedRef<const FGridPathPolyline, ESPMode::ThreadSafe> Build(const FGridConfig& Config, TConstArrayView<FIntPoint> Cells, int32 SmoothingIterations);
+
+    float GetLength() const { return CumulativeLength.Num() > 0 ? CumulativeLength.Last() : 0.f; }
+
+    /**
+     * Point at Distance along the polyline. InOutSegment is the segment found by the
+     * previous call and only ever steps forward, so a mover that advances a little each
+     * frame costs O(1) per frame instead of a binary search.
+     */
+    FORCEINLINE FVector Advance(float Distance, int32& InOutSegment, FVector& OutDirection) const
+    {
+        const int32 LastSegment = Points.Num() - 2;
+        if (LastSegment < 0)
+        {
+            OutDirection = FVector::ZeroVector;
+            return Points.Num() > 0 ? Points[0] : FVector::ZeroVector;
+        }
+
+        while (InOutSegment < LastSegment && CumulativeLength[InOutSegment + 1] < Distance)
+        {
+            ++InOutSegment;
+        }
+
+        const float SegmentStart = CumulativeLength[InOutSegment];
+        const float SegmentLength = CumulativeLength[InOutSegment + 1] - SegmentStart;
+        const float Alpha = SegmentLength > UE_KINDA_SMALL_NUMBER ? FMath::Clamp((Distance - SegmentStart) / SegmentLength, 0.f, 1.f) : 1.f;
+
+        OutDirection = Points[InOutSegment + 1] - Points[InOutSegment];
+        return FMath::Lerp(Points[InOutSegment], Points[InOutSegment + 1], Alpha);
+    }
+};
+
+/** Handle to a unit moving along a path in UGridPathFollowSubsystem. */
+USTRUCT(BlueprintType)
+struct FGridMoverHandle
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    int32 Id = INDEX_NONE;
+
+    UPROPERTY()
+    int32 Serial = 0;
+
+    bool IsSet() const { return Id != INDEX_NONE; }
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnGridMoveFinished, FGridMoverHandle, Mover, USceneComponent*, Component);
+
+/**
+ * Moves scene components along grid paths in one native pass per frame.
+ *
+ * StartMove turns the cell path into an FGridPathPolyline once; afterwards every frame
+ * advances all movers together: distances are stepped in a flat array, each mover walks
+ * its polyline forward from the segment it was on last frame, and the resulting
+ * transforms are written back to the components in a separate bulk pass. Yaw follows
+ * the path direction when bOrientToPath is set.
+ */
+UCLASS()
+class DEMOROUNDBASEDTACTIC_API UGridPathFollowSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    /**
+     * Start moving Component along Path (cells of Grid, e.g. from FindPath).
+     * A component that is already moving is retargeted to the new path.
+     *
+     * @param Speed               World units per second.
+     * @param SmoothingIterations Corner cutting rounds of the polyline (0 = straight segments).
+     * @return Invalid handle if the grid is unknown, the path is empty or leaves the grid.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Movement")
+    FGridMoverHandle StartMove(USceneComponent* Component, FGridHandle Grid, const TArray<FIntPoint>& Path, float Speed, int32 SmoothingIterations = 2, bool bOrientToPath = true);
+
+    /** Start moving along a polyline that has already been built (shared by several movers). */
+    FGridMoverHandle StartMoveOnPolyline(USceneComponent* Component, TSharedRef<const FGridPathPolyline, ESPMode::ThreadSafe> Polyline, float Speed, bool bOrientToPath = true);
+
+    /** Stop a mover where it is. OnMoveFinished is not broadcast. */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Movement")
+    void StopMove(FGridMoverHandle Mover);
+
+    UFUNCTION(BlueprintCallable, Category = "Grid|Movement")
+    void SetMoverSpeed(FGridMoverHandle Mover, float Speed);
+
+    UFUNCTION(BlueprintPure, Category = "Grid|Movement")
+    bool IsMoving(FGridMoverHandle Mover) const;
+
+    /** Fraction of the path covered so far, in [0, 1]; 0 for stale handles. */
+    UFUNCTION(BlueprintPure, Category = "Grid|Movement")
+    float GetMoveProgress(FGridMoverHandle Mover) const;
+
+    /** Number of active movers (for profiling / debugging). */
+    UFUNCTION(BlueprintPure, Category = "Grid|Movement")
+    int32 GetNumMovers() const { return Movers.Num(); }
+
+    /** Advance every mover by DeltaTime and write the transforms. Also done automatically once per frame. */
+    void UpdateMovers(float DeltaTime);
+
+    /** Broadcast after a mover reached the end of its path; the handle is already stale. */
+    UPROPERTY(BlueprintAssignable, Category = "Grid|Movement")
+    FOnGridMoveFinished OnMoveFinished;
+
+    // UTickableWorldSubsystem
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    /** Per-mover state other than the hot stepping arrays. */
+    struct FMover
+    {
+        TWeakObjectPtr<USceneComponent> Component;
+        TSharedPtr<const FGridPathPolyline, ESPMode::ThreadSafe> Polyline;
+        int32 HandleId = INDEX_NONE;
+        bool bOrientToPath = true;
+    };
+
+    struct FHandleEntry
+    {
+        int32 MoverIndex = INDEX_NONE;
+        int32 Serial = 0;
+    };
+
+    int32 ResolveMover(FGridMoverHandle Mover) const;
+    void RemoveMoverAt(int32 MoverIndex);
+
+    /** Hot stepping state, structure of arrays parallel to Movers. */
+    TArray<float> Distances;
+    TArray<float> Speeds;
+    TArray<int32> Segments;
+
+    TArray<FMover> Movers;
+    TArray<FHandleEntry> Handles;
+    TArray<int32> FreeHandleIds;
+
+    /** Scratch of UpdateMovers: results of the stepping pass, applied in the write-back pass. */
+    TArray<FVector> NewLocations;
+    TArray<FVector> NewDirections;
+};
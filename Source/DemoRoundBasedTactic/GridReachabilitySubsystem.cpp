@@ -0,0 +1,245 @@
+// GridReachabilitySubsystem.cpp
+
+#include "GridReachabilitySubsystem.h"
+#include "GridSearchLibrary.h"
+#include "HeightMapGridBindingComponent.h"
+
+#include "Engine/World.h"
+
+FGridReachabilityHandle UGridReachabilitySubsystem::RegisterProfile(FGridHandle Grid, const FGridMovementProfile& Profile)
+{
+    const UGridWorldSubsystem* GridWorld = GetWorld()->GetSubsystem<UGridWorldSubsystem>();
+    UHeightMapGridBindingComponent* Component = GridWorld ? GridWorld->GetGridComponent(Grid) : nullptr;
+    if (!Component)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("UGridReachabilitySubsystem::RegisterProfile: unknown grid."));
+        return FGridReachabilityHandle{};
+    }
+
+    FGridBinding& Binding = Bindings.FindOrAdd(Grid);
+    if (Binding.NumProfiles++ == 0)
+    {
+        Binding.Component = Component;
+        Binding.ConfigChangedHandle = Component->OnGridConfigChangedNative.AddUObject(this, &UGridReachabilitySubsystem::OnGridConfigChanged);
+    }
+
+    int32 Id = INDEX_NONE;
+    if (FreeEntryIds.Num() > 0)
+    {
+        Id = FreeEntryIds.Pop(EAllowShrinking::No);
+    }
+    else
+    {
+        Id = Entries.AddDefaulted();
+    }
+
+    FProfileEntry& Entry = Entries[Id];
+    Entry.Grid = Grid;
+    Entry.Graph.Build(Component->GridConfig, Profile);
+    Entry.Labels.Build(Entry.Graph);
+    Entry.Coarse.Build(Entry.Graph);
+    Entry.bAlive = true;
+
+    FGridReachabilityHandle Handle;
+    Handle.Id = Id;
+    Handle.Serial = Entry.Serial;
+    return Handle;
+}
+
+void UGridReachabilitySubsystem::UnregisterProfile(FGridReachabilityHandle Handle)
+{
+    if (!ResolveEntry(Handle))
+    {
+        return;
+    }
+
+    FProfileEntry& Entry = Entries[Handle.Id];
+    if (FGridBinding* Binding = Bindings.Find(Entry.Grid))
+    {
+        if (--Binding->NumProfiles == 0)
+        {
+            if (UHeightMapGridBindingComponent* Component = Binding->Component.Get())
+            {
+                Component->OnGridConfigChangedNative.Remove(Binding->ConfigChangedHandle);
+            }
+            Bindings.Remove(Entry.Grid);
+        }
+    }
+
+    const int32 Serial = Entry.Serial + 1;
+    Entry = FProfileEntry{};
+    Entry.Serial = Serial;
+    FreeEntryIds.Add(Handle.Id);
+}
+
+void UGridReachabilitySubsystem::SetCellBlocked(FGridHandle Grid, FIntPoint Cell, bool bBlocked)
+{
+    for (FProfileEntry& Entry : Entries)
+    {
+        if (!Entry.bAlive || Entry.Grid != Grid)
+        {
+            continue;
+        }
+
+        const FIntRect Rebaked = Entry.Graph.SetCellBlocked(Cell, bBlocked);
+        if (Rebaked.Area() > 0)
+        {
+            Entry.Labels.UpdateRegion(Entry.Graph, Rebaked);
+            Entry.Coarse.UpdateRegion(Entry.Graph, Rebaked);
+        }
+    }
+}
+
+void UGridReachabilitySubsystem::AddOccupant(FGridHandle Grid, FIntPoint Cell, int32 Faction)
+{
+    for (FProfileEntry& Entry : Entries)
+    {
+        if (Entry.bAlive && Entry.Grid == Grid)
+        {
+            Entry.Coarse.AddOccupant(Cell, Faction, +1);
+        }
+    }
+}
+
+void UGridReachabilitySubsystem::RemoveOccupant(FGridHandle Grid, FIntPoint Cell, int32 Faction)
+{
+    for (FProfileEntry& Entry : Entries)
+    {
+        if (Entry.bAlive && Entry.Grid == Grid)
+        {
+            Entry.Coarse.AddOccupant(Cell, Faction, -1);
+        }
+    }
+}
+
+void UGridReachabilitySubsystem::MoveOccupant(FGridHandle Grid, FIntPoint From, FIntPoint To, int32 Faction)
+{
+    for (FProfileEntry& Entry : Entries)
+    {
+        if (Entry.bAlive && Entry.Grid == Grid)
+        {
+            Entry.Coarse.MoveOccupant(From, To, Faction);
+        }
+    }
+}
+
+bool UGridReachabilitySubsystem::AreCellsConnected(FGridReachabilityHandle Handle, FIntPoint A, FIntPoint B) const
+{
+    const FProfileEntry* Entry = ResolveEntry(Handle);
+    if (!Entry || !Entry->Labels.IsValid())
+    {
+        return false;
+    }
+
+    const FGridRegionLabels& Labels = Entry->Labels;
+    const auto InGrid = [&Labels](const FIntPoint& Cell)
+    {
+        return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Labels.GetWidth() && Cell.Y < Labels.GetHeight();
+    };
+    return InGrid(A) && InGrid(B) && Labels.AreConnected(A, B);
+}
+
+int32 UGridReachabilitySubsystem::GetRegionLabel(FGridReachabilityHandle Handle, FIntPoint Cell) const
+{
+    const FProfileEntry* Entry = ResolveEntry(Handle);
+    if (!Entry || !Entry->Labels.IsValid() ||
+        Cell.X < 0 || Cell.Y < 0 || Cell.X >= Entry->Labels.GetWidth() || Cell.Y >= Entry->Labels.GetHeight())
+    {
+        return INDEX_NONE;
+    }
+    return Entry->Labels.GetLabel(Cell.Y * Entry->Labels.GetWidth() + Cell.X);
+}
+
+bool UGridReachabilitySubsystem::FindPath(FGridReachabilityHandle Handle, FIntPoint Start, FIntPoint Goal, TArray<FIntPoint>& OutPath, float& OutCost) const
+{
+    OutPath.Reset();
+    OutCost = -1.f;
+
+    if (!AreCellsConnected(Handle, Start, Goal))
+    {
+        return false;
+    }
+    return UGridSearchLibrary::FindPathOnGraph(Entries[Handle.Id].Graph, Start, Goal, OutPath, OutCost);
+}
+
+void UGridReachabilitySubsystem::FindReachableCells(FGridReachabilityHandle Handle, FIntPoint Start, float MaxCost, TArray<FIntPoint>& OutCells, TArray<float>& OutCosts) const
+{
+    OutCells.Reset();
+    OutCosts.Reset();
+
+    if (const FProfileEntry* Entry = ResolveEntry(Handle))
+    {
+        UGridSearchLibrary::FindReachableCellsOnGraph(Entry->Graph, Start, MaxCost, OutCells, OutCosts);
+    }
+}
+
+const FGridTraversalGraph* UGridReachabilitySubsystem::GetGraph(FGridReachabilityHandle Handle) const
+{
+    const FProfileEntry* Entry = ResolveEntry(Handle);
+    return Entry ? &Entry->Graph : nullptr;
+}
+
+const FGridRegionLabels* UGridReachabilitySubsystem::GetRegionLabels(FGridReachabilityHandle Handle) const
+{
+    const FProfileEntry* Entry = ResolveEntry(Handle);
+    return Entry ? &Entry->Labels : nullptr;
+}
+
+const FGridCoarseGrids* UGridReachabilitySubsystem::GetCoarseGrids(FGridReachabilityHandle Handle) const
+{
+    const FProfileEntry* Entry = ResolveEntry(Handle);
+    return Entry ? &Entry->Coarse : nullptr;
+}
+
+void UGridReachabilitySubsystem::Deinitialize()
+{
+    for (TPair<FGridHandle, FGridBinding>& Pair : Bindings)
+    {
+        if (UHeightMapGridBindingComponent* Component = Pair.Value.Component.Get())
+        {
+            Component->OnGridConfigChangedNative.Remove(Pair.Value.ConfigChangedHandle);
+        }
+    }
+
+    Bindings.Reset();
+    Entries.Reset();
+    FreeEntryIds.Reset();
+
+    Super::Deinitialize();
+}
+
+void UGridReachabilitySubsystem::OnGridConfigChanged(UHeightMapGridBindingComponent* Component, EGridConfigChange ChangedParts)
+{
+    // Frame-only changes move the grid in the world; steps and regions stay the same.
+    if (!EnumHasAnyFlags(ChangedParts, EGridConfigChange::Dimensions | EGridConfigChange::HeightData))
+    {
+        return;
+    }
+
+    const FGridHandle Grid = Component->GetGridHandle();
+    for (FProfileEntry& Entry : Entries)
+    {
+        if (!Entry.bAlive || Entry.Grid != Grid)
+        {
+            continue;
+        }
+
+        FIntRect Rebaked;
+        if (Entry.Graph.Update(Component->GridConfig, &Rebaked))
+        {
+            Entry.Labels.UpdateRegion(Entry.Graph, Rebaked);
+            Entry.Coarse.UpdateRegion(Entry.Graph, Rebaked);
+        }
+    }
+}
+
+const UGridReachabilitySubsystem::FProfileEntry* UGridReachabilitySubsystem::ResolveEntry(FGridReachabilityHandle Handle) const
+{
+    if (!Entries.IsValidIndex(Handle.Id))
+    {
+        return nullptr;
+    }
+
+    const FProfileEntry& Entry = Entries[Handle.Id];
+    return Entry.bAlive && Entry.Serial == Handle.Serial ? &Entry : nullptr;
+}
@@ -0,0 +1,127 @@
+// GridReachabilitySubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GridCoarseGrids.h"
+#include "GridRegionLabels.h"
+#include "GridTraversalGraph.h"
+#include "GridTypes.h"
+#include "GridWorldSubsystem.h"
+#include "GridReachabilitySubsystem.generated.h"
+
+class UHeightMapGridBindingComponent;
+
+/** Handle to a movement profile registered on a grid with UGridReachabilitySubsystem. */
+USTRUCT(BlueprintType)
+struct FGridReachabilityHandle
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    int32 Id = INDEX_NONE;
+
+    UPROPERTY()
+    int32 Serial = 0;
+
+    bool IsSet() const { return Id != INDEX_NONE; }
+};
+
+/**
+ * Baked traversal graph and connected-region labels per (grid, movement profile).
+ *
+ * Registering a profile bakes its FGridTraversalGraph and labels its regions once
+ * (both in parallel). Afterwards they follow the grid: height changes and blockers
+ * re-bake and re-label only the area around the change.
+ *
+ * AreCellsConnected is an O(1) label compare; use it to reject unreachable hover
+ * targets and AI candidates before any search. FindPath / FindReachableCells do so
+ * themselves and then search the baked graph.
+ *
+ * Each profile also keeps FGridCoarseGrids (2x/4x/8x aggregates) in step with its graph
+ * for strategic AI; unit occupancy is reported through Add/Remove/MoveOccupant.
+ */
+UCLASS()
+class DEMOROUNDBASEDTACTIC_API UGridReachabilitySubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    /** Bake Profile's graph and regions on Grid. Invalid handle if the grid is unknown. */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Reachability")
+    FGridReachabilityHandle RegisterProfile(FGridHandle Grid, const FGridMovementProfile& Profile);
+
+    UFUNCTION(BlueprintCallable, Category = "Grid|Reachability")
+    void UnregisterProfile(FGridReachabilityHandle Handle);
+
+    /** Block or unblock a cell (wall, prop) for every profile registered on Grid. */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Reachability")
+    void SetCellBlocked(FGridHandle Grid, FIntPoint Cell, bool bBlocked);
+
+    /**
+     * True if A and B lie in the same connected region, i.e. a path may exist.
+     * False means no path exists. O(1).
+     */
+    UFUNCTION(BlueprintPure, Category = "Grid|Reachability")
+    bool AreCellsConnected(FGridReachabilityHandle Handle, FIntPoint A, FIntPoint B) const;
+
+    /** Region label of a cell, or -1 for blocked / out-of-grid cells and stale handles. */
+    UFUNCTION(BlueprintPure, Category = "Grid|Reachability")
+    int32 GetRegionLabel(FGridReachabilityHandle Handle, FIntPoint Cell) const;
+
+    /** UGridSearchLibrary::FindPath on the baked graph, rejected up front if Goal is in another region. */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Reachability")
+    bool FindPath(FGridReachabilityHandle Handle, FIntPoint Start, FIntPoint Goal, TArray<FIntPoint>& OutPath, float& OutCost) const;
+
+    /** UGridSearchLibrary::FindReachableCells on the baked graph. */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Reachability")
+    void FindReachableCells(FGridReachabilityHandle Handle, FIntPoint Start, float MaxCost, TArray<FIntPoint>& OutCells, TArray<float>& OutCosts) const;
+
+    /** Count a unit of Faction on Cell in the coarse grids of every profile on Grid. */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Reachability")
+    void AddOccupant(FGridHandle Grid, FIntPoint Cell, int32 Faction);
+
+    UFUNCTION(BlueprintCallable, Category = "Grid|Reachability")
+    void RemoveOccupant(FGridHandle Grid, FIntPoint Cell, int32 Faction);
+
+    UFUNCTION(BlueprintCallable, Category = "Grid|Reachability")
+    void MoveOccupant(FGridHandle Grid, FIntPoint From, FIntPoint To, int32 Faction);
+
+    /** Baked data of a handle, or null for a stale one. Valid until the next register / unregister. */
+    const FGridTraversalGraph* GetGraph(FGridReachabilityHandle Handle) const;
+    const FGridRegionLabels* GetRegionLabels(FGridReachabilityHandle Handle) const;
+    const FGridCoarseGrids* GetCoarseGrids(FGridReachabilityHandle Handle) const;
+
+protected:
+    virtual void Deinitialize() override;
+
+private:
+    struct FProfileEntry
+    {
+        FGridHandle Grid;
+        FGridTraversalGraph Graph;
+        FGridRegionLabels Labels;
+        FGridCoarseGrids Coarse;
+
+        /** Bumped when the slot is freed so handles to an unregistered profile stop resolving. */
+        int32 Serial = 0;
+        bool bAlive = false;
+    };
+
+    struct FGridBinding
+    {
+        TWeakObjectPtr<UHeightMapGridBindingComponent> Component;
+        FDelegateHandle ConfigChangedHandle;
+        int32 NumProfiles = 0;
+    };
+
+    void OnGridConfigChanged(UHeightMapGridBindingComponent* Component, EGridConfigChange ChangedParts);
+
+    const FProfileEntry* ResolveEntry(FGridReachabilityHandle Handle) const;
+
+    TArray<FProfileEntry> Entries;
+    TArray<int32> FreeEntryIds;
+    TMap<FGridHandle, FGridBinding> Bindings;
+};
@@ -0,0 +1,243 @@
+// GridRegionLabels.cpp
+
+#include "GridRegionLabels.h"
+#include "GridStats.h"
+#include "GridTopology.h"
+#include "GridTraversalGraph.h"
+
+#include "Async/ParallelFor.h"
+
+namespace
+{
+    /** Root of Index's tree. Parents only ever move from a root to a smaller index, so plain reads are enough. */
+    static FORCEINLINE int32 FindRoot(const volatile int32* Parent, int32 Index)
+    {
+        int32 Next = Parent[Index];
+        while (Next != Index)
+        {
+            Index = Next;
+            Next = Parent[Index];
+        }
+        return Index;
+    }
+
+    /** Lock-free union: the larger root is linked under the smaller one, retrying if another thread got there first. */
+    static void Union(volatile int32* Parent, int32 A, int32 B)
+    {
+        for (;;)
+        {
+            int32 RootA = FindRoot(Parent, A);
+            int32 RootB = FindRoot(Parent, B);
+            if (RootA == RootB)
+            {
+                return;
+            }
+            if (RootA < RootB)
+            {
+                Swap(RootA, RootB);
+            }
+            if (FPlatformAtomics::InterlockedCompareExchange(&Parent[RootA], RootB, RootA) == RootA)
+            {
+                return;
+            }
+        }
+    }
+
+    /**
+     * Call Visit(NeighborIndex) for every cell joined to Index by a step in either direction.
+     * Incoming steps come from the graph's reverse adjacency; IndexDeltas[K] is the index
+     * offset of the topology's NeighborOffsets[K].
+     */
+    template <typename TopologyType, typename VisitorType>
+    static FORCEINLINE void ForEachUndirectedNeighbor(const FGridTraversalGraph& Graph, const int32* IndexDeltas, int32 Index, VisitorType&& Visit)
+    {
+        for (const int32 Next : Graph.GetNeighbors(Index))
+        {
+            Visit(Next);
+        }
+
+        uint32 Incoming = Graph.GetIncomingSteps(Index);
+        while (Incoming != 0)
+        {
+            const int32 Slot = (int32)FMath::CountTrailingZeros(Incoming);
+            Incoming &= Incoming - 1;
+            Visit(Index + IndexDeltas[Slot]);
+        }
+    }
+
+    /**
+     * Cells an incremental update may re-flood, as a fraction of the grid, before it gives
+     * up and relabels from scratch: past that the parallel Build is cheaper than the serial flood.
+     */
+    constexpr int32 MaxFloodFractionInv = 8;
+}
+
+void FGridRegionLabels::Reset()
+{
+    Width = 0;
+    Height = 0;
+    Labels.Empty();
+    Relabeled.Empty();
+    Touched.Empty();
+    Stack.Empty();
+}
+
+void FGridRegionLabels::Build(const FGridTraversalGraph& Graph)
+{
+    GRID_QUERY_SCOPE(RegionLabels);
+
+    if (!Graph.IsValid())
+    {
+        Reset();
+        return;
+    }
+
+    Width = Graph.GetWidth();
+    Height = Graph.GetHeight();
+    const int32 NumCells = Width * Height;
+
+    Labels.SetNumUninitialized(NumCells);
+    for (int32 Index = 0; Index < NumCells; ++Index)
+    {
+        Labels[Index] = Index;
+    }
+
+    // Union along every step; the root of each tree ends up being its smallest cell index.
+    volatile int32* Parent = Labels.GetData();
+    ParallelFor(Height, [&Graph, Parent, this](int32 Y)
+    {
+        for (int32 Index = Y * Width; Index < (Y + 1) * Width; ++Index)
+        {
+            for (const int32 Next : Graph.GetNeighbors(Index))
+            {
+                Union(Parent, Index, Next);
+            }
+        }
+    });
+
+    // Flatten. Roots never change any more, so every task sees final trees.
+    ParallelFor(Height, [&Graph, Parent, this](int32 Y)
+    {
+        for (int32 Index = Y * Width; Index < (Y + 1) * Width; ++Index)
+        {
+            Labels[Index] = Graph.IsCellBlocked(Index) ? INDEX_NONE : FindRoot(Parent, Index);
+        }
+    });
+}
+
+void FGridRegionLabels::UpdateRegion(const FGridTraversalGraph& Graph, const FIntRect& Rebaked)
+{
+    if (!IsValid() || Graph.GetWidth() != Width || Graph.GetHeight() != Height)
+    {
+        Build(Graph);
+        return;
+    }
+
+    if (Rebaked.Area() >= Width * Height)
+    {
+        Build(Graph);
+        return;
+    }
+
+    // A step that appeared or disappeared starts in Rebaked; its other end is at most one cell outside.
+    const FIntRect Seeds(
+        FMath::Max(Rebaked.Min.X - 1, 0), FMath::Max(Rebaked.Min.Y - 1, 0),
+        FMath::Min(Rebaked.Max.X + 1, Width), FMath::Min(Rebaked.Max.Y + 1, Height));
+    if (Seeds.Min.X >= Seeds.Max.X || Seeds.Min.Y >= Seeds.Max.Y)
+    {
+        return;
+    }
+
+    GRID_QUERY_SCOPE(RegionLabels);
+
+    // Scratch marks persist between updates; only the cells touched here are cleared again.
+    const int32 NumCells = Width * Height;
+    if (Relabeled.Num() != NumCells)
+    {
+        Relabeled.Init(false, NumCells);
+    }
+    Touched.Reset();
+
+    const int32 MaxFloodCells = FMath::Max(NumCells / MaxFloodFractionInv, Seeds.Area());
+    bool bWithinBudget = true;
+
+    for (int32 Y = Seeds.Min.Y; Y < Seeds.Max.Y && bWithinBudget; ++Y)
+    {
+        for (int32 X = Seeds.Min.X; X < Seeds.Max.X; ++X)
+        {
+            const int32 Index = Y * Width + X;
+            if (Relabeled[Index])
+            {
+                continue;
+            }
+
+            if (Graph.IsCellBlocked(Index))
+            {
+                Labels[Index] = INDEX_NONE;
+                Relabeled[Index] = true;
+                Touched.Add(Index);
+                continue;
+            }
+
+            if (!FloodRegion(Graph, Index, MaxFloodCells))
+            {
+                bWithinBudget = false;
+                break;
+            }
+        }
+    }
+
+    for (const int32 Index : Touched)
+    {
+        Relabeled[Index] = false;
+    }
+
+    if (!bWithinBudget)
+    {
+        // A large region split or merged; the flood has left labels half-updated.
+        Build(Graph);
+    }
+}
+
+bool FGridRegionLabels::FloodRegion(const FGridTraversalGraph& Graph, int32 Seed, int32 MaxFloodCells)
+{
+    bool bWithinBudget = true;
+    DispatchGridTopology(Graph.GetTopology(), [&](auto Topo)
+    {
+        using TopologyType = decltype(Topo);
+
+        int32 IndexDeltas[TopologyType::NumNeighbors];
+        for (int32 Slot = 0; Slot < TopologyType::NumNeighbors; ++Slot)
+        {
+            IndexDeltas[Slot] = TopologyType::NeighborOffsets[Slot].DY * Width + TopologyType::NeighborOffsets[Slot].DX;
+        }
+
+        Stack.Reset();
+        Stack.Add(Seed);
+        Relabeled[Seed] = true;
+        Touched.Add(Seed);
+
+        while (Stack.Num() > 0)
+        {
+            if (Touched.Num() > MaxFloodCells)
+            {
+                bWithinBudget = false;
+                return;
+            }
+
+            const int32 Index = Stack.Pop(EAllowShrinking::No);
+            Labels[Index] = Seed;
+
+            ForEachUndirectedNeighbor<TopologyType>(Graph, IndexDeltas, Index, [&](int32 Next)
+            {
+                if (!Relabeled[Next])
+                {
+                    Relabeled[Next] = true;
+                    Touched.Add(Next);
+                    Stack.Add(Next);
+                }
+            });
+        }
+    });
+    return bWithinBudget;
+}
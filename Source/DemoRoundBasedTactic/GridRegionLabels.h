@@ -0,0 +1,73 @@
+// GridRegionLabels.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FGridTraversalGraph;
+
+/**
+ * Connected-region label of every cell of an FGridTraversalGraph.
+ *
+ * Two cells with different labels can never reach each other, so a label compare
+ * rejects unreachable targets (cliff tops, islands, walled-off rooms) in O(1) before
+ * any path search runs. Regions ignore step direction: a one-way drop joins the cells
+ * on both sides, which keeps the rejection exact for "no path either way" and merely
+ * conservative for one-way terrain. Blocked cells have no label.
+ *
+ * The initial labelling is a lock-free parallel union-find over the graph's steps.
+ * After the graph re-bakes a rectangle (terrain edit, blocker placed or removed),
+ * UpdateRegion re-floods only the regions that touch it: splits and merges can only
+ * happen through steps whose ends lie in that rectangle or next to it. A flood that grows
+ * past an eighth of the grid stops and the labels are rebuilt in parallel instead.
+ *
+ * A label is the index of one cell of its region, so labels stay unique across updates.
+ */
+class DEMOROUNDBASEDTACTIC_API FGridRegionLabels
+{
+public:
+
+    /** Label every cell of Graph from scratch. */
+    void Build(const FGridTraversalGraph& Graph);
+
+    /** Refresh the labels after Graph re-baked the steps of Rebaked (see FGridTraversalGraph::Update). */
+    void UpdateRegion(const FGridTraversalGraph& Graph, const FIntRect& Rebaked);
+
+    void Reset();
+
+    bool IsValid() const { return Labels.Num() > 0; }
+
+    /** Region of a cell (Index = Y * Width + X), or INDEX_NONE for blocked cells. */
+    FORCEINLINE int32 GetLabel(int32 CellIndex) const { return Labels[CellIndex]; }
+
+    /** True if A and B lie in the same region, i.e. a path between them may exist. */
+    FORCEINLINE bool AreConnected(int32 CellA, int32 CellB) const
+    {
+        const int32 Label = Labels[CellA];
+        return Label != INDEX_NONE && Label == Labels[CellB];
+    }
+
+    FORCEINLINE bool AreConnected(const FIntPoint& A, const FIntPoint& B) const
+    {
+        return AreConnected(A.Y * Width + A.X, B.Y * Width + B.X);
+    }
+
+    int32 GetWidth() const { return Width; }
+    int32 GetHeight() const { return Height; }
+
+private:
+    /**
+     * Give the whole region around Seed (which is not blocked) the label Seed.
+     * @return False, leaving the region partly labelled, once more than MaxFloodCells are touched.
+     */
+    bool FloodRegion(const FGridTraversalGraph& Graph, int32 Seed, int32 MaxFloodCells);
+
+    int32 Width = 0;
+    int32 Height = 0;
+    TArray<int32> Labels;
+
+    /** UpdateRegion scratch, kept between updates: cells relabelled so far, and the list to clear them. */
+    TBitArray<> Relabeled;
+    TArray<int32> Touched;
+    TArray<int32> Stack;
+};
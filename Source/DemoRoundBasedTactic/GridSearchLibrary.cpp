@@ -0,0 +1,824 @@
+// GridSearchLibrary.cpp
+
+#include "GridSearchLibrary.h"
+#include "GridCellLayout.h"
+#include "GridLayers.h"
+#include "GridMovementRules.h"
+#include "GridStats.h"
+#include "GridTopology.h"
+#include "GridTraversalGraph.h"
+#include "Algo/Reverse.h"
+
+namespace
+{
+    /** Entry of the open list; ordered by Priority (lowest first). */
+    struct FOpenEntry
+    {
+        float Priority;
+        int32 Index;
+    };
+
+    struct FOpenEntryLess
+    {
+        FORCEINLINE bool operator()(const FOpenEntry& A, const FOpenEntry& B) const
+        {
+            return A.Priority < B.Priority;
+        }
+    };
+
+    /** Best known cost and predecessor of a search node. */
+    struct FNodeRecord
+    {
+        float Cost;
+        int32 Parent;
+    };
+
+    /**
+     * Per-thread storage behind FSearchNodes: pages of FNodeRecord handed out on first
+     * touch, and a page table over the node indices. Kept between searches so a search
+     * only initialises the pages it explores instead of a whole-grid array.
+     */
+    struct FSearchScratch
+    {
+        static constexpr int32 PageShift = 10;
+        static constexpr int32 PageSize = 1 << PageShift;
+        static constexpr int32 PageMask = PageSize - 1;
+
+        /** Pools above this many pages (8 MB) are freed after the search instead of kept. */
+        static constexpr int32 MaxRetainedPages = 1024;
+
+        TArray<int32> PageTable;
+        TArray<int32> TouchedPages;
+        TArray<FNodeRecord> Pool;
+        bool bInUse = false;
+
+        void Begin(int32 NumNodes)
+        {
+            const int32 NumPages = (NumNodes + PageMask) >> PageShift;
+            if (PageTable.Num() < NumPages)
+            {
+                const int32 OldNum = PageTable.Num();
+                PageTable.SetNumUninitialized(NumPages);
+                for (int32 Page = OldNum; Page < NumPages; ++Page)
+                {
+                    PageTable[Page] = INDEX_NONE;
+                }
+            }
+            bInUse = true;
+        }
+
+        void End()
+        {
+            for (const int32 Page : TouchedPages)
+            {
+                PageTable[Page] = INDEX_NONE;
+            }
+            if (TouchedPages.Num() > MaxRetainedPages)
+            {
+                Pool.Empty();
+                PageTable.Empty();
+            }
+            TouchedPages.Reset();
+            bInUse = false;
+        }
+
+        FORCEINLINE const FNodeRecord* Find(int32 Index) const
+        {
+            const int32 Slot = PageTable[Index >> PageShift];
+            return Slot == INDEX_NONE ? nullptr : &Pool[(Slot << PageShift) | (Index & PageMask)];
+        }
+
+        FORCEINLINE FNodeRecord& FindOrAdd(int32 Index)
+        {
+            int32& Slot = PageTable[Index >> PageShift];
+            if (Slot == INDEX_NONE)
+            {
+                Slot = TouchedPages.Num();
+                TouchedPages.Add(Index >> PageShift);
+                if (Pool.Num() < (Slot + 1) * PageSize)
+                {
+                    Pool.SetNumUninitialized((Slot + 1) * PageSize, EAllowShrinking::No);
+                }
+                for (int32 Offset = 0; Offset < PageSize; ++Offset)
+                {
+                    Pool[(Slot << PageShift) + Offset] = FNodeRecord{ MAX_flt, INDEX_NONE };
+                }
+            }
+            return Pool[(Slot << PageShift) | (Index & PageMask)];
+        }
+    };
+
+    /**
+     * Cost / parent table of one search. Unvisited nodes read as (MAX_flt, INDEX_NONE),
+     * and the work done is proportional to the explored area: a short move range on a
+     * huge grid no longer initialises arrays over every cell. Uses the thread's scratch,
+     * or a private one if a search is already running on this thread.
+     */
+    class FSearchNodes
+    {
+    public:
+        explicit FSearchNodes(int32 NumNodes)
+        {
+            static thread_local FSearchScratch ThreadScratch;
+            Scratch = &ThreadScratch;
+            if (Scratch->bInUse)
+            {
+                OwnedScratch = MakeUnique<FSearchScratch>();
+                Scratch = OwnedScratch.Get();
+            }
+            Scratch->Begin(NumNodes);
+        }
+
+        ~FSearchNodes()
+        {
+            Scratch->End();
+        }
+
+        FSearchNodes(const FSearchNodes&) = delete;
+        FSearchNodes& operator=(const FSearchNodes&) = delete;
+
+        FORCEINLINE float GetCost(int32 Index) const
+        {
+            const FNodeRecord* Record = Scratch->Find(Index);
+            return Record ? Record->Cost : MAX_flt;
+        }
+
+        FORCEINLINE int32 GetParent(int32 Index) const
+        {
+            const FNodeRecord* Record = Scratch->Find(Index);
+            return Record ? Record->Parent : INDEX_NONE;
+        }
+
+        FORCEINLINE void Set(int32 Index, float Cost, int32 Parent)
+        {
+            FNodeRecord& Record = Scratch->FindOrAdd(Index);
+            Record.Cost = Cost;
+            Record.Parent = Parent;
+        }
+
+    private:
+        FSearchScratch* Scratch = nullptr;
+        TUniquePtr<FSearchScratch> OwnedScratch;
+    };
+
+    static FORCEINLINE bool IsInBounds(int32 Width, int32 Height, int32 X, int32 Y)
+    {
+        return X >= 0 && X < Width && Y >= 0 && Y < Height;
+    }
+
+    static FORCEINLINE bool IsInBounds(const FGridConfig& Config, int32 X, int32 Y)
+    {
+        return IsInBounds(Config.Width, Config.Height, X, Y);
+    }
+
+    static FORCEINLINE float GetGroundHeight(const FGridConfig& Config, int32 X, int32 Y)
+    {
+        return Config.HeightProvider.IsValid() ? Config.HeightProvider->GetHeightAt(X, Y) : Config.GridOrigin.Z;
+    }
+
+    /** Neighbour source of the searches: steps evaluated on the fly from the config's heights. */
+    template <typename TopologyType>
+    struct TLiveNeighbors
+    {
+        const FGridConfig& Config;
+        const FGridMovementProfile& Profile;
+
+        template <typename VisitorType>
+        FORCEINLINE void operator()(int32 Index, VisitorType&& Visit) const
+        {
+            const FIntPoint Cell(Index % Config.Width, Index / Config.Width);
+            GridMovement::ForEachPassableNeighbor<TopologyType>(Config.Width, Config.Height, Profile, Cell,
+                GetGroundHeight(Config, Cell.X, Cell.Y),
+                [this](int32 X, int32 Y) { return GetGroundHeight(Config, X, Y); },
+                [&Visit](const FIntPoint& /*Next*/, int32 NextIndex, float StepCost) { Visit(NextIndex, StepCost); });
+        }
+    };
+
+    /** Neighbour source of the searches: steps evaluated on the fly from heights stored in any cell layout. */
+    template <typename TopologyType, typename IndexerType>
+    struct TLayoutNeighbors
+    {
+        const IndexerType& Indexer;
+        const float* Heights;
+        const FGridMovementProfile& Profile;
+
+        template <typename VisitorType>
+        FORCEINLINE void operator()(int32 Index, VisitorType&& Visit) const
+        {
+            const FIntPoint Cell = Indexer.ToCell(Index);
+            GridMovement::ForEachPassableNeighbor<TopologyType>(Indexer.Width, Indexer.Height, Profile, Cell, Heights[Index],
+                [this](int32 X, int32 Y) { return Heights[Indexer.ToIndex(X, Y)]; },
+                [this, &Visit](const FIntPoint& Next, int32 /*RowMajorIndex*/, float StepCost) { Visit(Indexer.ToIndex(Next.X, Next.Y), StepCost); });
+        }
+    };
+
+    /**
+     * Search nodes of a layered grid: nodes [0, NumCells) are the ground of each cell
+     * (row-major, so layer-0 nodes match the plain searches), the following nodes are the
+     * overflow slots of FGridLayerData, i.e. the extra layers.
+     */
+    struct FLayeredIndexer
+    {
+        const FGridLayerData& Layers;
+        int32 Width = 0;
+        int32 Height = 0;
+
+        FORCEINLINE int32 GetNumCells() const { return Width * Height; }
+        FORCEINLINE int32 GetNumStorage() const { return GetNumCells() + Layers.GetNumOverflow(); }
+
+        FORCEINLINE int32 ToIndex(int32 X, int32 Y) const { return Y * Width + X; }
+
+        FORCEINLINE int32 ToCellIndex(int32 Index) const
+        {
+            return Index < GetNumCells() ? Index : Layers.GetOverflowCell(Index - GetNumCells());
+        }
+
+        FORCEINLINE FIntPoint ToCell(int32 Index) const
+        {
+            const int32 CellIndex = ToCellIndex(Index);
+            return FIntPoint(CellIndex % Width, CellIndex / Width);
+        }
+
+        /** Node of a layered cell, or INDEX_NONE if the cell has no such layer. */
+        FORCEINLINE int32 ToNode(const FGridLayeredCell& LayeredCell) const
+        {
+            const int32 CellIndex = ToIndex(LayeredCell.Cell.X, LayeredCell.Cell.Y);
+            if (LayeredCell.Layer == 0)
+            {
+                return CellIndex;
+            }
+            if (LayeredCell.Layer < 0 || LayeredCell.Layer >= Layers.GetNumLayers(CellIndex))
+            {
+                return INDEX_NONE;
+            }
+            return GetNumCells() + Layers.GetOverflowStart(CellIndex) + LayeredCell.Layer - 1;
+        }
+
+        FORCEINLINE FGridLayeredCell ToLayeredCell(int32 Index) const
+        {
+            return Index < GetNumCells()
+                ? FGridLayeredCell(ToCell(Index), 0)
+                : FGridLayeredCell(ToCell(Index), Layers.GetOverflowLayer(Index - GetNumCells()));
+        }
+    };
+
+    /**
+     * Neighbour source of the searches on a layered grid: a step may land on any surface
+     * of the neighbour cell that the profile allows from the current surface. Neighbours
+     * with only the ground cost the same as in TLiveNeighbors.
+     */
+    template <typename TopologyType>
+    struct TLayeredNeighbors
+    {
+        const FGridConfig& Config;
+        const FGridMovementProfile& Profile;
+        const FLayeredIndexer& Indexer;
+
+        FORCEINLINE float GetNodeHeight(int32 Index) const
+        {
+            const int32 NumCells = Indexer.GetNumCells();
+            return Index < NumCells
+                ? GetGroundHeight(Config, Index % Config.Width, Index / Config.Width)
+                : Indexer.Layers.GetOverflowHeight(Index - NumCells);
+        }
+
+        /** Call Visit(Node, StepCost) for every surface of a cell reachable from FromZ. */
+        template <typename VisitorType>
+        FORCEINLINE void ForEachSurface(const FIntPoint& Cell, float FromZ, float BaseCost, VisitorType&& Visit) const
+        {
+            const int32 CellIndex = Cell.Y * Config.Width + Cell.X;
+            const float GroundCost = GridMovement::EvaluateStep(Profile, FromZ, GetGroundHeight(Config, Cell.X, Cell.Y), BaseCost);
+            if (GroundCost >= 0.f)
+            {
+                Visit(CellIndex, GroundCost);
+            }
+
+            const int32 NumExtra = Indexer.Layers.GetNumLayers(CellIndex) - 1;
+            if (NumExtra == 0)
+            {
+                return;
+            }
+
+            const int32 First = Indexer.Layers.GetOverflowStart(CellIndex);
+            for (int32 Slot = First; Slot < First + NumExtra; ++Slot)
+            {
+                const float Cost = GridMovement::EvaluateStep(Profile, FromZ, Indexer.Layers.GetOverflowHeight(Slot), BaseCost);
+                if (Cost >= 0.f)
+                {
+                    Visit(Indexer.GetNumCells() + Slot, Cost);
+                }
+            }
+        }
+
+        /** Whether any surface of a cell is reachable from FromZ (diagonal corner check). */
+        FORCEINLINE bool HasPassableSurface(const FIntPoint& Cell, float FromZ) const
+        {
+            bool bPassable = false;
+            ForEachSurface(Cell, FromZ, 1.f, [&bPassable](int32, float) { bPassable = true; });
+            return bPassable;
+        }
+
+        template <typename VisitorType>
+        FORCEINLINE void operator()(int32 Index, VisitorType&& Visit) const
+        {
+            const FIntPoint Cell = Indexer.ToCell(Index);
+            const float CellZ = GetNodeHeight(Index);
+
+            for (int32 N = 0; N < TopologyType::NumNeighbors; ++N)
+            {
+                const FGridNeighborOffset& Offset = TopologyType::NeighborOffsets[N];
+                const FIntPoint Next(Cell.X + Offset.DX, Cell.Y + Offset.DY);
+                if (!IsInBounds(Config, Next.X, Next.Y))
+                {
+                    continue;
+                }
+
+                if constexpr (TopologyType::Kind == EGridTopology::Square8)
+                {
+                    if (Offset.DX != 0 && Offset.DY != 0 && !Profile.bAllowCornerCutting &&
+                        (!HasPassableSurface(FIntPoint(Next.X, Cell.Y), CellZ) || !HasPassableSurface(FIntPoint(Cell.X, Next.Y), CellZ)))
+                    {
+                        continue;
+                    }
+                }
+
+                ForEachSurface(Next, CellZ, TopologyType::StepCosts[N], Visit);
+            }
+        }
+    };
+
+    /** Neighbour source of the searches: contiguous steps of a baked traversal graph. */
+    struct FGraphNeighbors
+    {
+        const FGridTraversalGraph& Graph;
+
+        template <typename VisitorType>
+        FORCEINLINE void operator()(int32 Index, VisitorType&& Visit) const
+        {
+            Graph.ForEachEdge(Index, Visit);
+        }
+    };
+
+    /**
+     * A* between two search nodes. Nodes are storage indices of Indexer; the heuristic
+     * only looks at their cells. OutNodes receives the path from start to goal.
+     */
+    template <typename TopologyType, typename IndexerType, typename NeighborsType>
+    static bool TFindPath(
+        const IndexerType& Indexer,
+        const NeighborsType& Neighbors,
+        int32 StartIndex,
+        int32 GoalIndex,
+        TArray<int32>& OutNodes,
+        float& OutCost)
+    {
+        const int32 NumCells = Indexer.GetNumStorage();
+        const FIntPoint Start = Indexer.ToCell(StartIndex);
+        const FIntPoint Goal = Indexer.ToCell(GoalIndex);
+
+        FSearchNodes Nodes(NumCells);
+
+        TArray<FOpenEntry> Open;
+        Open.HeapPush(FOpenEntry{ TopologyType::Heuristic(Start, Goal), StartIndex }, FOpenEntryLess());
+        Nodes.Set(StartIndex, 0.f, INDEX_NONE);
+
+        while (Open.Num() > 0)
+        {
+            FOpenEntry Current;
+            Open.HeapPop(Current, FOpenEntryLess(), EAllowShrinking::No);
+
+            if (Current.Index == GoalIndex)
+            {
+                break;
+            }
+
+            const FIntPoint Cell = Indexer.ToCell(Current.Index);
+            const float CellCost = Nodes.GetCost(Current.Index);
+
+            // Skip stale heap entries.
+            if (Current.Priority > CellCost + TopologyType::Heuristic(Cell, Goal) + KINDA_SMALL_NUMBER)
+            {
+                continue;
+            }
+
+            Neighbors(Current.Index, [&](int32 NextIndex, float StepCost)
+            {
+                const float NewCost = CellCost + StepCost;
+                if (NewCost < Nodes.GetCost(NextIndex))
+                {
+                    Nodes.Set(NextIndex, NewCost, Current.Index);
+                    const FIntPoint Next = Indexer.ToCell(NextIndex);
+                    Open.HeapPush(FOpenEntry{ NewCost + TopologyType::Heuristic(Next, Goal), NextIndex }, FOpenEntryLess());
+                }
+            });
+        }
+
+        const float GoalCost = Nodes.GetCost(GoalIndex);
+        if (GoalCost == MAX_flt)
+        {
+            return false;
+        }
+
+        for (int32 Index = GoalIndex; Index != INDEX_NONE; Index = Nodes.GetParent(Index))
+        {
+            OutNodes.Add(Index);
+        }
+        Algo::Reverse(OutNodes);
+
+        OutCost = GoalCost;
+        return true;
+    }
+
+    /** Dijkstra flood from a search node; calls Emit(Index, Cost) for every node within MaxCost, cheapest first. */
+    template <typename IndexerType, typename NeighborsType, typename EmitType>
+    static void TFindReachableNodes(
+        const IndexerType& Indexer,
+        const NeighborsType& Neighbors,
+        int32 StartIndex,
+        float MaxCost,
+        EmitType&& Emit)
+    {
+        const int32 NumCells = Indexer.GetNumStorage();
+
+        FSearchNodes Nodes(NumCells);
+
+        TArray<FOpenEntry> Open;
+        Open.HeapPush(FOpenEntry{ 0.f, StartIndex }, FOpenEntryLess());
+        Nodes.Set(StartIndex, 0.f, INDEX_NONE);
+
+        while (Open.Num() > 0)
+        {
+            FOpenEntry Current;
+            Open.HeapPop(Current, FOpenEntryLess(), EAllowShrinking::No);
+
+            if (Current.Priority > Nodes.GetCost(Current.Index))
+            {
+                continue;
+            }
+
+            Emit(Current.Index, Current.Priority);
+
+            Neighbors(Current.Index, [&](int32 NextIndex, float StepCost)
+            {
+                const float NewCost = Current.Priority + StepCost;
+                if (NewCost <= MaxCost && NewCost < Nodes.GetCost(NextIndex))
+                {
+                    Nodes.Set(NextIndex, NewCost, Current.Index);
+                    Open.HeapPush(FOpenEntry{ NewCost, NextIndex }, FOpenEntryLess());
+                }
+            });
+        }
+    }
+
+    /** TFindPath between two cells, returning the path as cells. */
+    template <typename TopologyType, typename IndexerType, typename NeighborsType>
+    static bool TFindPath(
+        const IndexerType& Indexer,
+        const NeighborsType& Neighbors,
+        const FIntPoint& Start,
+        const FIntPoint& Goal,
+        TArray<FIntPoint>& OutPath,
+        float& OutCost)
+    {
+        TArray<int32> Nodes;
+        if (!TFindPath<TopologyType>(Indexer, Neighbors, Indexer.ToIndex(Start.X, Start.Y), Indexer.ToIndex(Goal.X, Goal.Y), Nodes, OutCost))
+        {
+            return false;
+        }
+
+        OutPath.Reserve(Nodes.Num());
+        for (const int32 Node : Nodes)
+        {
+            OutPath.Add(Indexer.ToCell(Node));
+        }
+        return true;
+    }
+
+    template <typename IndexerType, typename NeighborsType>
+    static void TFindReachableCells(
+        const IndexerType& Indexer,
+        const NeighborsType& Neighbors,
+        const FIntPoint& Start,
+        float MaxCost,
+        TArray<FIntPoint>& OutCells,
+        TArray<float>& OutCosts)
+    {
+        TFindReachableNodes(Indexer, Neighbors, Indexer.ToIndex(Start.X, Start.Y), MaxCost, [&](int32 Index, float Cost)
+        {
+            OutCells.Add(Indexer.ToCell(Index));
+            OutCosts.Add(Cost);
+        });
+    }
+}
+
+bool UGridSearchLibrary::FindPath(
+    const FGridConfig& Config,
+    const FGridMovementProfile& Profile,
+    FIntPoint Start,
+    FIntPoint Goal,
+    TArray<FIntPoint>& OutPath,
+    float& OutCost
+)
+{
+    GRID_QUERY_SCOPE(FindPath);
+
+    OutPath.Reset();
+    OutCost = -1.f;
+
+    if (!IsInBounds(Config, Start.X, Start.Y) || !IsInBounds(Config, Goal.X, Goal.Y))
+    {
+        return false;
+    }
+
+    return DispatchGridTopology(Config.Topology, [&](auto Topo)
+    {
+        using TopologyType = decltype(Topo);
+        return TFindPath<TopologyType>(FGridRowMajorIndexer(Config.Width, Config.Height), TLiveNeighbors<TopologyType>{ Config, Profile }, Start, Goal, OutPath, OutCost);
+    });
+}
+
+void UGridSearchLibrary::FindReachableCells(
+    const FGridConfig& Config,
+    const FGridMovementProfile& Profile,
+    FIntPoint Start,
+    float MaxCost,
+    TArray<FIntPoint>& OutCells,
+    TArray<float>& OutCosts
+)
+{
+    GRID_QUERY_SCOPE(FindReachable);
+
+    OutCells.Reset();
+    OutCosts.Reset();
+
+    if (!IsInBounds(Config, Start.X, Start.Y) || MaxCost < 0.f)
+    {
+        return;
+    }
+
+    DispatchGridTopology(Config.Topology, [&](auto Topo)
+    {
+        using TopologyType = decltype(Topo);
+        TFindReachableCells(FGridRowMajorIndexer(Config.Width, Config.Height), TLiveNeighbors<TopologyType>{ Config, Profile }, Start, MaxCost, OutCells, OutCosts);
+    });
+}
+
+bool UGridSearchLibrary::FindPathOnGraph(
+    const FGridTraversalGraph& Graph,
+    FIntPoint Start,
+    FIntPoint Goal,
+    TArray<FIntPoint>& OutPath,
+    float& OutCost
+)
+{
+    GRID_QUERY_SCOPE(FindPath);
+
+    OutPath.Reset();
+    OutCost = -1.f;
+
+    const int32 Width = Graph.GetWidth();
+    const int32 Height = Graph.GetHeight();
+    if (!Graph.IsValid() || !IsInBounds(Width, Height, Start.X, Start.Y) || !IsInBounds(Width, Height, Goal.X, Goal.Y))
+    {
+        return false;
+    }
+
+    return DispatchGridTopology(Graph.GetTopology(), [&](auto Topo)
+    {
+        return TFindPath<decltype(Topo)>(FGridRowMajorIndexer(Width, Height), FGraphNeighbors{ Graph }, Start, Goal, OutPath, OutCost);
+    });
+}
+
+void UGridSearchLibrary::FindReachableCellsOnGraph(
+    const FGridTraversalGraph& Graph,
+    FIntPoint Start,
+    float MaxCost,
+    TArray<FIntPoint>& OutCells,
+    TArray<float>& OutCosts
+)
+{
+    GRID_QUERY_SCOPE(FindReachable);
+
+    OutCells.Reset();
+    OutCosts.Reset();
+
+    if (!Graph.IsValid() || !IsInBounds(Graph.GetWidth(), Graph.GetHeight(), Start.X, Start.Y) || MaxCost < 0.f)
+    {
+        return;
+    }
+
+    TFindReachableCells(FGridRowMajorIndexer(Graph.GetWidth(), Graph.GetHeight()), FGraphNeighbors{ Graph }, Start, MaxCost, OutCells, OutCosts);
+}
+
+bool UGridSearchLibrary::FindPathInLayout(
+    const TGridCellArray<float>& Heights,
+    EGridTopology Topology,
+    const FGridMovementProfile& Profile,
+    FIntPoint Start,
+    FIntPoint Goal,
+    TArray<FIntPoint>& OutPath,
+    float& OutCost
+)
+{
+    GRID_QUERY_SCOPE(FindPath);
+
+    OutPath.Reset();
+    OutCost = -1.f;
+
+    const int32 Width = Heights.GetWidth();
+    const int32 Height = Heights.GetHeight();
+    if (!IsInBounds(Width, Height, Start.X, Start.Y) || !IsInBounds(Width, Height, Goal.X, Goal.Y))
+    {
+        return false;
+    }
+
+    return Heights.GetLayout().Dispatch([&](const auto& Indexer)
+    {
+        using IndexerType = std::decay_t<decltype(Indexer)>;
+        return DispatchGridTopology(Topology, [&](auto Topo)
+        {
+            using TopologyType = decltype(Topo);
+            const TLayoutNeighbors<TopologyType, IndexerType> Neighbors{ Indexer, Heights.GetData(), Profile };
+            return TFindPath<TopologyType>(Indexer, Neighbors, Start, Goal, OutPath, OutCost);
+        });
+    });
+}
+
+void UGridSearchLibrary::FindReachableCellsInLayout(
+    const TGridCellArray<float>& Heights,
+    EGridTopology Topology,
+    const FGridMovementProfile& Profile,
+    FIntPoint Start,
+    float MaxCost,
+    TArray<FIntPoint>& OutCells,
+    TArray<float>& OutCosts
+)
+{
+    GRID_QUERY_SCOPE(FindReachable);
+
+    OutCells.Reset();
+    OutCosts.Reset();
+
+    if (!IsInBounds(Heights.GetWidth(), Heights.GetHeight(), Start.X, Start.Y) || MaxCost < 0.f)
+    {
+        return;
+    }
+
+    Heights.GetLayout().Dispatch([&](const auto& Indexer)
+    {
+        using IndexerType = std::decay_t<decltype(Indexer)>;
+        DispatchGridTopology(Topology, [&](auto Topo)
+        {
+            using TopologyType = decltype(Topo);
+            const TLayoutNeighbors<TopologyType, IndexerType> Neighbors{ Indexer, Heights.GetData(), Profile };
+            TFindReachableCells(Indexer, Neighbors, Start, MaxCost, OutCells, OutCosts);
+        });
+    });
+}
+
+bool UGridSearchLibrary::FindPathLayered(
+    const FGridConfig& Config,
+    const FGridMovementProfile& Profile,
+    const FGridLayeredCell& Start,
+    const FGridLayeredCell& Goal,
+    TArray<FGridLayeredCell>& OutPath,
+    float& OutCost
+)
+{
+    OutPath.Reset();
+    OutCost = -1.f;
+
+    if (!Config.Layers.IsValid())
+    {
+        // Single-layer grid: only the ground exists, run the plain search.
+        TArray<FIntPoint> Cells;
+        if (Start.Layer != 0 || Goal.Layer != 0 || !FindPath(Config, Profile, Start.Cell, Goal.Cell, Cells, OutCost))
+        {
+            return false;
+        }
+
+        OutPath.Reserve(Cells.Num());
+        for (const FIntPoint& Cell : Cells)
+        {
+            OutPath.Emplace(Cell, 0);
+        }
+        return true;
+    }
+
+    GRID_QUERY_SCOPE(FindPath);
+
+    if (!IsInBounds(Config, Start.Cell.X, Start.Cell.Y) || !IsInBounds(Config, Goal.Cell.X, Goal.Cell.Y))
+    {
+        return false;
+    }
+
+    const FLayeredIndexer Indexer{ *Config.Layers, Config.Width, Config.Height };
+    const int32 StartNode = Indexer.ToNode(Start);
+    const int32 GoalNode = Indexer.ToNode(Goal);
+    if (StartNode == INDEX_NONE || GoalNode == INDEX_NONE)
+    {
+        return false;
+    }
+
+    return DispatchGridTopology(Config.Topology, [&](auto Topo)
+    {
+        using TopologyType = decltype(Topo);
+
+        TArray<int32> Nodes;
+        if (!TFindPath<TopologyType>(Indexer, TLayeredNeighbors<TopologyType>{ Config, Profile, Indexer }, StartNode, GoalNode, Nodes, OutCost))
+        {
+            return false;
+        }
+
+        OutPath.Reserve(Nodes.Num());
+        for (const int32 Node : Nodes)
+        {
+            OutPath.Add(Indexer.ToLayeredCell(Node));
+        }
+        return true;
+    });
+}
+
+void UGridSearchLibrary::FindReachableCellsLayered(
+    const FGridConfig& Config,
+    const FGridMovementProfile& Profile,
+    const FGridLayeredCell& Start,
+    float MaxCost,
+    TArray<FGridLayeredCell>& OutCells,
+    TArray<float>& OutCosts
+)
+{
+    OutCells.Reset();
+    OutCosts.Reset();
+
+    if (!Config.Layers.IsValid())
+    {
+        if (Start.Layer != 0)
+        {
+            return;
+        }
+
+        TArray<FIntPoint> Cells;
+        FindReachableCells(Config, Profile, Start.Cell, MaxCost, Cells, OutCosts);
+
+        OutCells.Reserve(Cells.Num());
+        for (const FIntPoint& Cell : Cells)
+        {
+            OutCells.Emplace(Cell, 0);
+        }
+        return;
+    }
+
+    GRID_QUERY_SCOPE(FindReachable);
+
+    if (!IsInBounds(Config, Start.Cell.X, Start.Cell.Y) || MaxCost < 0.f)
+    {
+        return;
+    }
+
+    const FLayeredIndexer Indexer{ *Config.Layers, Config.Width, Config.Height };
+    const int32 StartNode = Indexer.ToNode(Start);
+    if (StartNode == INDEX_NONE)
+    {
+        return;
+    }
+
+    DispatchGridTopology(Config.Topology, [&](auto Topo)
+    {
+        using TopologyType = decltype(Topo);
+        TFindReachableNodes(Indexer, TLayeredNeighbors<TopologyType>{ Config, Profile, Indexer }, StartNode, MaxCost, [&](int32 Node, float Cost)
+        {
+            OutCells.Add(Indexer.ToLayeredCell(Node));
+            OutCosts.Add(Cost);
+        });
+    });
+}
+
+int32 UGridSearchLibrary::GetStepDistance(const FGridConfig& Config, FIntPoint A, FIntPoint B)
+{
+    return DispatchGridTopology(Config.Topology, [&](auto Topo)
+    {
+        return decltype(Topo)::StepDistance(A, B);
+    });
+}
+
+TArray<FIntPoint> UGridSearchLibrary::GetNeighbors(const FGridConfig& Config, FIntPoint Cell)
+{
+    TArray<FIntPoint> Result;
+
+    DispatchGridTopology(Config.Topology, [&](auto Topo)
+    {
+        using TopologyType = decltype(Topo);
+
+        for (const FGridNeighborOffset& Offset : TopologyType::NeighborOffsets)
+        {
+            const FIntPoint Next(Cell.X + Offset.DX, Cell.Y + Offset.DY);
+            if (IsInBounds(Config, Next.X, Next.Y))
+            {
+                Result.Add(Next);
+            }
+        }
+    });
+
+    return Result;
+}
@@ -0,0 +1,143 @@
+// GridSearchLibrary.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "GridTypes.h"
+#include "GridLayers.h"
+#include "GridSearchLibrary.generated.h"
+
+class FGridTraversalGraph;
+template <typename ElementType> class TGridCellArray;
+
+/**
+ * Blueprint-friendly grid search helpers (path finding, movement range).
+ *
+ * Each entry point selects the search instantiation for Config.Topology once;
+ * the inner loops are specialised per topology and never branch on it.
+ * Passability and step costs come from an FGridMovementProfile evaluated
+ * against the ground heights of the grid, or from an FGridTraversalGraph baked
+ * for that profile (the *OnGraph variants).
+ *
+ * Every variant (including *InLayout and *Layered) keeps its per-node costs in a
+ * per-thread paged scratch, so a search only initialises the pages it explores:
+ * tiled padding and overflow layers add no setup cost to a short search.
+ */
+UCLASS()
+class DEMOROUNDBASEDTACTIC_API UGridSearchLibrary : public UBlueprintFunctionLibrary
+{
+    GENERATED_BODY()
+
+public:
+
+    /**
+     * Find a cheapest path between two cells (A*).
+     *
+     * @param OutPath Cells from Start to Goal, both included. Empty if no path exists.
+     * @param OutCost Total step cost of the path, or -1 if no path exists.
+     * @return True if a path was found.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Search")
+    static bool FindPath(
+        const FGridConfig& Config,
+        const FGridMovementProfile& Profile,
+        FIntPoint Start,
+        FIntPoint Goal,
+        TArray<FIntPoint>& OutPath,
+        float& OutCost
+    );
+
+    /**
+     * Collect every cell reachable from Start with a total step cost of at most MaxCost (Dijkstra).
+     *
+     * @param OutCells Reachable cells, in order of increasing cost (Start first).
+     * @param OutCosts Cost to reach each entry of OutCells.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Search")
+    static void FindReachableCells(
+        const FGridConfig& Config,
+        const FGridMovementProfile& Profile,
+        FIntPoint Start,
+        float MaxCost,
+        TArray<FIntPoint>& OutCells,
+        TArray<float>& OutCosts
+    );
+
+    /** FindPath over a baked traversal graph: same result, no height reads or step evaluation. */
+    static bool FindPathOnGraph(
+        const FGridTraversalGraph& Graph,
+        FIntPoint Start,
+        FIntPoint Goal,
+        TArray<FIntPoint>& OutPath,
+        float& OutCost
+    );
+
+    /** FindReachableCells over a baked traversal graph. */
+    static void FindReachableCellsOnGraph(
+        const FGridTraversalGraph& Graph,
+        FIntPoint Start,
+        float MaxCost,
+        TArray<FIntPoint>& OutCells,
+        TArray<float>& OutCosts
+    );
+
+    /**
+     * FindPath over heights copied into a TGridCellArray, e.g. in the tiled layout for
+     * better cache locality on wide maps. Finds a path of the same cost as FindPath on the same heights.
+     */
+    static bool FindPathInLayout(
+        const TGridCellArray<float>& Heights,
+        EGridTopology Topology,
+        const FGridMovementProfile& Profile,
+        FIntPoint Start,
+        FIntPoint Goal,
+        TArray<FIntPoint>& OutPath,
+        float& OutCost
+    );
+
+    /** FindReachableCells over heights copied into a TGridCellArray. */
+    static void FindReachableCellsInLayout(
+        const TGridCellArray<float>& Heights,
+        EGridTopology Topology,
+        const FGridMovementProfile& Profile,
+        FIntPoint Start,
+        float MaxCost,
+        TArray<FIntPoint>& OutCells,
+        TArray<float>& OutCosts
+    );
+
+    /**
+     * FindPath between surfaces of a layered grid (Config.Layers): a step may go onto any
+     * layer of the neighbour cell within the profile's step limits, so units cross
+     * bridges and walk under them. Without extra layers this is FindPath on layer 0.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Search")
+    static bool FindPathLayered(
+        const FGridConfig& Config,
+        const FGridMovementProfile& Profile,
+        const FGridLayeredCell& Start,
+        const FGridLayeredCell& Goal,
+        TArray<FGridLayeredCell>& OutPath,
+        float& OutCost
+    );
+
+    /** FindReachableCells over the surfaces of a layered grid. */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Search")
+    static void FindReachableCellsLayered(
+        const FGridConfig& Config,
+        const FGridMovementProfile& Profile,
+        const FGridLayeredCell& Start,
+        float MaxCost,
+        TArray<FGridLayeredCell>& OutCells,
+        TArray<float>& OutCosts
+    );
+
+    /** Minimum number of steps between two cells for the config's topology, ignoring heights. */
+    UFUNCTION(BlueprintPure, Category = "Grid|Search")
+    static int32 GetStepDistance(const FGridConfig& Config, FIntPoint A, FIntPoint B);
+
+    /** In-bounds neighbours of a cell for the config's topology, ignoring heights. */
+    UFUNCTION(BlueprintPure, Category = "Grid|Search")
+    static TArray<FIntPoint> GetNeighbors(const FGridConfig& Config, FIntPoint Cell);
+};
@@ -0,0 +1,211 @@
+// GridShadowcast.cpp
+
+#include "GridShadowcast.h"
+#include "GridTemplateCache.h"
+#include "GridTopology.h"
+
+namespace
+{
+    /** Horizon resolution: enough bins that a cell at the radius still spans a few. */
+    static int32 ComputeNumBins(int32 Radius)
+    {
+        return FMath::Clamp(8 * Radius, 64, 4096);
+    }
+
+    /** Range of horizon bins covered by an angular interval [Angle - HalfWidth, Angle + HalfWidth]. */
+    static void ComputeBinRange(float Angle, float HalfWidth, int32 NumBins, uint16& OutBegin, uint16& OutCount)
+    {
+        const float BinsPerRadian = NumBins / UE_TWO_PI;
+        const int32 First = FMath::FloorToInt((Angle - HalfWidth) * BinsPerRadian);
+        const int32 Last = FMath::CeilToInt((Angle + HalfWidth) * BinsPerRadian);
+
+        OutBegin = static_cast<uint16>(((First % NumBins) + NumBins) % NumBins);
+        OutCount = static_cast<uint16>(FMath::Clamp(Last - First, 1, NumBins));
+    }
+
+    /** Slack on the radius test, so cells exactly at the radius count on every topology. */
+    constexpr double RadiusSlack = 0.01;
+
+    /**
+     * Lattice of a topology in local units: moving one row shifts a cell by Shear along X
+     * and RowStep along Y (CellToLocal is linear in the cell offset for every topology).
+     */
+    template <typename TopologyType>
+    static void GetRowGeometry(double& OutShear, double& OutRowStep)
+    {
+        const FVector2D Centre = TopologyType::CellToLocal(FIntPoint::ZeroValue);
+        const FVector2D NextRow = TopologyType::CellToLocal(FIntPoint(0, 1));
+        OutShear = NextRow.X - Centre.X;
+        OutRowStep = NextRow.Y - Centre.Y;
+    }
+
+    static TSharedRef<FGridShadowcastTemplate, ESPMode::ThreadSafe> BuildTemplate(EGridTopology Topology, int32 Radius)
+    {
+        TSharedRef<FGridShadowcastTemplate, ESPMode::ThreadSafe> Template = MakeShared<FGridShadowcastTemplate, ESPMode::ThreadSafe>();
+        Template->NumBins = ComputeNumBins(Radius);
+
+        DispatchGridTopology(Topology, [&](auto Topo)
+        {
+            using TopologyType = decltype(Topo);
+
+            // Rows within the radius, and in each row the X range around the row's shear.
+            double Shear = 0.0;
+            double RowStep = 1.0;
+            GetRowGeometry<TopologyType>(Shear, RowStep);
+            const double Reach = Radius + RadiusSlack;
+            const int32 MaxDY = FMath::FloorToInt32(Reach / RowStep);
+
+            const FVector2D Centre = TopologyType::CellToLocal(FIntPoint::ZeroValue);
+            for (int32 DY = -MaxDY; DY <= MaxDY; ++DY)
+            {
+                const int32 MinDX = FMath::CeilToInt32(-Reach - Shear * DY);
+                const int32 MaxDX = FMath::FloorToInt32(Reach - Shear * DY);
+                for (int32 DX = MinDX; DX <= MaxDX; ++DX)
+                {
+                    if (DX == 0 && DY == 0)
+                    {
+                        continue;
+                    }
+
+                    const FVector2D Local = TopologyType::CellToLocal(FIntPoint(DX, DY)) - Centre;
+                    const float Distance = static_cast<float>(Local.Size());
+                    if (Distance > Reach)
+                    {
+                        continue;
+                    }
+
+                    float Angle = static_cast<float>(FMath::Atan2(Local.Y, Local.X));
+                    if (Angle < 0.f)
+                    {
+                        Angle += UE_TWO_PI;
+                    }
+                    const float HalfWidth = FMath::Atan2(0.5f, Distance);
+
+                    FGridShadowcastTemplate::FEntry& Entry = Template->Entries.AddDefaulted_GetRef();
+                    Entry.Offset = FIntPoint(DX, DY);
+                    Entry.Distance = Distance;
+                    ComputeBinRange(Angle, HalfWidth, Template->NumBins, Entry.BinBegin, Entry.BinCount);
+                    ComputeBinRange(Angle, 0.5f * HalfWidth, Template->NumBins, Entry.CoreBegin, Entry.CoreCount);
+                }
+            }
+        });
+
+        Template->Entries.Sort([](const FGridShadowcastTemplate::FEntry& A, const FGridShadowcastTemplate::FEntry& B)
+        {
+            return A.Distance < B.Distance;
+        });
+
+        return Template;
+    }
+
+    /**
+     * Templates are immutable once built; readers keep their own reference. A radius-512
+     * template is ~16 MB, so the cache is bounded and drops the least recently used.
+     */
+    TGridTemplateCache<uint32, FGridShadowcastTemplate> GTemplates(64, 64 * 1024 * 1024);
+}
+
+namespace GridShadowcast
+{
+    FIntPoint GetSightExtent(EGridTopology Topology, int32 Radius)
+    {
+        return DispatchGridTopology(Topology, [Radius](auto Topo)
+        {
+            double Shear = 0.0;
+            double RowStep = 1.0;
+            GetRowGeometry<decltype(Topo)>(Shear, RowStep);
+
+            const double Reach = FMath::Max(Radius, 0) + RadiusSlack;
+            const int32 MaxDY = FMath::FloorToInt32(Reach / RowStep);
+            return FIntPoint(FMath::FloorToInt32(Reach + FMath::Abs(Shear) * MaxDY), MaxDY);
+        });
+    }
+
+    TSharedRef<const FGridShadowcastTemplate, ESPMode::ThreadSafe> GetTemplate(EGridTopology Topology, int32 Radius)
+    {
+        Radius = FMath::Clamp(Radius, 0, 0xFFFF);
+        const uint32 Key = (uint32(Topology) << 24) | uint32(Radius);
+
+        return GTemplates.FindOrBuild(Key,
+            [Topology, Radius]() -> TSharedRef<const FGridShadowcastTemplate, ESPMode::ThreadSafe> { return BuildTemplate(Topology, Radius); },
+            [](const FGridShadowcastTemplate& Template) { return Template.Entries.GetAllocatedSize(); });
+    }
+
+    void ComputeFieldOfView(
+        const FGridConfig& Config,
+        FIntPoint Cell,
+        int32 Radius,
+        float EyeHeight,
+        const float* CellHeights,
+        const float* BlockerHeights,
+        FGridCellMask& OutMask)
+    {
+        const FIntPoint Extent = GetSightExtent(Config.Topology, Radius);
+        const FIntPoint Min(FMath::Max(Cell.X - Extent.X, 0), FMath::Max(Cell.Y - Extent.Y, 0));
+        const FIntPoint Max(FMath::Min(Cell.X + Extent.X + 1, Config.Width), FMath::Min(Cell.Y + Extent.Y + 1, Config.Height));
+        if (Radius < 0 || Min.X >= Max.X || Min.Y >= Max.Y ||
+            Cell.X < 0 || Cell.Y < 0 || Cell.X >= Config.Width || Cell.Y >= Config.Height)
+        {
+            OutMask.Empty();
+            return;
+        }
+        OutMask.Init(Min, Max.X - Min.X, Max.Y - Min.Y);
+
+        const TSharedRef<const FGridShadowcastTemplate, ESPMode::ThreadSafe> TemplateRef = GetTemplate(Config.Topology, Radius);
+        const FGridShadowcastTemplate& Template = *TemplateRef;
+
+        auto GroundAt = [CellHeights, &Config](int32 Index)
+        {
+            return CellHeights ? CellHeights[Index] : static_cast<float>(Config.GridOrigin.Z);
+        };
+
+        const float Eye = EyeHeight >= 0.f ? EyeHeight : Config.DefaultEyeHeight;
+        const float EyeZ = GroundAt(Cell.Y * Config.Width + Cell.X) + Eye;
+        OutMask.SetCell(Cell);
+
+        // Highest elevation tangent seen so far in each direction.
+        const int32 NumBins = Template.NumBins;
+        TArray<float, TInlineAllocator<1024>> Horizon;
+        Horizon.Init(-MAX_flt, NumBins);
+        float* HorizonData = Horizon.GetData();
+
+        const float CellSize = FMath::Max(Config.CellSize, KINDA_SMALL_NUMBER);
+
+        for (const FGridShadowcastTemplate::FEntry& Entry : Template.Entries)
+        {
+            const int32 X = Cell.X + Entry.Offset.X;
+            const int32 Y = Cell.Y + Entry.Offset.Y;
+            if (X < 0 || Y < 0 || X >= Config.Width || Y >= Config.Height)
+            {
+                continue;
+            }
+
+            const int32 Index = Y * Config.Width + X;
+            const float Ground = GroundAt(Index);
+            const float InvDistance = 1.f / (Entry.Distance * CellSize);
+
+            // Visible if the ground rises above the horizon somewhere in the cell's angular extent.
+            const float TargetTan = (Ground - EyeZ) * InvDistance + KINDA_SMALL_NUMBER;
+            int32 Bin = Entry.BinBegin;
+            for (int32 Step = 0; Step < Entry.BinCount; ++Step)
+            {
+                if (HorizonData[Bin] <= TargetTan)
+                {
+                    OutMask.SetCell(X, Y);
+                    break;
+                }
+                Bin = (Bin + 1 == NumBins) ? 0 : Bin + 1;
+            }
+
+            // The cell's top (ground plus any blocker) shadows what lies behind its core.
+            const float Top = Ground + (BlockerHeights ? BlockerHeights[Index] : 0.f);
+            const float BlockTan = (Top - EyeZ) * InvDistance;
+            Bin = Entry.CoreBegin;
+            for (int32 Step = 0; Step < Entry.CoreCount; ++Step)
+            {
+                HorizonData[Bin] = FMath::Max(HorizonData[Bin], BlockTan);
+                Bin = (Bin + 1 == NumBins) ? 0 : Bin + 1;
+            }
+        }
+    }
+}
@@ -0,0 +1,76 @@
+// GridShadowcast.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridCellMask.h"
+#include "GridTypes.h"
+
+/**
+ * Visiting order of height-aware shadowcasting for one topology and radius.
+ * Built on first use per (topology, radius) and shared; immutable afterwards.
+ */
+struct DEMOROUNDBASEDTACTIC_API FGridShadowcastTemplate
+{
+    struct FEntry
+    {
+        FIntPoint Offset;
+
+        /** Lateral distance in cell units. */
+        float Distance = 0.f;
+
+        /** Horizon bins covered by the whole cell (visibility test) and by its core (occlusion). */
+        uint16 BinBegin = 0;
+        uint16 BinCount = 0;
+        uint16 CoreBegin = 0;
+        uint16 CoreCount = 0;
+    };
+
+    /** Sorted by Distance. Excludes the centre cell. */
+    TArray<FEntry> Entries;
+
+    /** Number of horizon bins around the full circle. */
+    int32 NumBins = 0;
+};
+
+/**
+ * Height-aware shadowcasting over a grid.
+ *
+ * Cells around the viewer are visited in order of distance from its eye and every
+ * cell raises an angular horizon behind it to the elevation angle of its top (ground
+ * plus blocker height). A cell is visible when its ground rises above the horizon in
+ * at least part of its angular extent. The same sweep serves square and hex topologies.
+ */
+namespace GridShadowcast
+{
+    /**
+     * Largest |DX| and |DY| of a cell offset within Radius (centre-to-centre distance in
+     * cell units). On hex grids rows are closer than a cell and sheared by half a cell, so
+     * this exceeds Radius; field of view windows and dirty checks must use it.
+     */
+    DEMOROUNDBASEDTACTIC_API FIntPoint GetSightExtent(EGridTopology Topology, int32 Radius);
+
+    /**
+     * Shared visiting order for Topology and Radius. Thread-safe; built on first use and
+     * kept in a bounded LRU cache, so hold the returned reference for as long as it is read.
+     */
+    DEMOROUNDBASEDTACTIC_API TSharedRef<const FGridShadowcastTemplate, ESPMode::ThreadSafe> GetTemplate(EGridTopology Topology, int32 Radius);
+
+    /**
+     * Cells visible from Cell within Radius (centre-to-centre distance in cell units).
+     * Pure function of its inputs; safe to call from worker threads.
+     *
+     * @param EyeHeight      Eye height above the viewer's ground; negative uses Config.DefaultEyeHeight.
+     * @param CellHeights    Row-major ground heights (Width × Height), or null for a flat grid at GridOrigin.Z.
+     * @param BlockerHeights Optional row-major extra height per cell that blocks sight (units, walls).
+     * @param OutMask        Re-initialised to the grid-clipped GetSightExtent window around Cell.
+     */
+    DEMOROUNDBASEDTACTIC_API void ComputeFieldOfView(
+        const FGridConfig& Config,
+        FIntPoint Cell,
+        int32 Radius,
+        float EyeHeight,
+        const float* CellHeights,
+        const float* BlockerHeights,
+        FGridCellMask& OutMask);
+}
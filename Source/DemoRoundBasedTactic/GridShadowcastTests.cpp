@@ -0,0 +1,77 @@
+// GridShadowcastTests.cpp
+
+#include "Misc/AutomationTest.h"
+#include "GridShadowcast.h"
+#include "GridTopology.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GridShadowcastTests
+{
+    static constexpr int32 GridSize = 41;
+    static constexpr int32 SightRadius = 10;
+
+    /** Every in-grid cell within Radius of Cell by centre distance; on flat ground all of them are visible. */
+    template <typename TopologyType>
+    static TSet<FIntPoint> BruteForceDisc(const FIntPoint& Cell, int32 Radius)
+    {
+        TSet<FIntPoint> Disc;
+        const FVector2D Centre = TopologyType::CellToLocal(Cell);
+        for (int32 Y = 0; Y < GridSize; ++Y)
+        {
+            for (int32 X = 0; X < GridSize; ++X)
+            {
+                if ((TopologyType::CellToLocal(FIntPoint(X, Y)) - Centre).Size() <= Radius + 0.01)
+                {
+                    Disc.Add(FIntPoint(X, Y));
+                }
+            }
+        }
+        return Disc;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridShadowcastHexDiscTest, "DemoRoundBasedTactic.Grid.HexFieldOfView",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGridShadowcastHexDiscTest::RunTest(const FString& Parameters)
+{
+    using namespace GridShadowcastTests;
+
+    FGridConfig Config;
+    Config.Width = GridSize;
+    Config.Height = GridSize;
+    Config.Topology = EGridTopology::HexAxial;
+
+    const FIntPoint Viewer(GridSize / 2, GridSize / 2);
+    FGridCellMask Visible;
+    GridShadowcast::ComputeFieldOfView(Config, Viewer, SightRadius, -1.f, nullptr, nullptr, Visible);
+
+    const TSet<FIntPoint> Expected = BruteForceDisc<TGridTopology<EGridTopology::HexAxial>>(Viewer, SightRadius);
+    TSet<FIntPoint> Actual;
+    for (const FIntPoint& Cell : Visible.ToCellArray())
+    {
+        Actual.Add(Cell);
+    }
+
+    TestEqual(TEXT("Visible cell count"), Actual.Num(), Expected.Num());
+    for (const FIntPoint& Cell : Expected)
+    {
+        TestTrue(FString::Printf(TEXT("Cell in range is visible: (%d, %d)"), Cell.X, Cell.Y), Actual.Contains(Cell));
+    }
+    for (const FIntPoint& Cell : Actual)
+    {
+        TestTrue(FString::Printf(TEXT("Visible cell is in range: (%d, %d)"), Cell.X, Cell.Y), Expected.Contains(Cell));
+    }
+
+    // Offsets outside the old square window that are still within the radius.
+    TestTrue(TEXT("Far row (-5, 11) is visible"), Visible.Contains(Viewer + FIntPoint(-5, 11)));
+    TestTrue(TEXT("Sheared column (-11, 6) is visible"), Visible.Contains(Viewer + FIntPoint(-11, 6)));
+
+    const FIntPoint Extent = GridShadowcast::GetSightExtent(EGridTopology::HexAxial, SightRadius);
+    TestTrue(TEXT("Hex sight extent covers the far row"), Extent.Y >= 11);
+    TestTrue(TEXT("Hex sight extent covers the sheared column"), Extent.X >= 11);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,220 @@
+// GridStats.cpp
+
+#include "GridStats.h"
+
+#include "Misc/CoreDelegates.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+DEFINE_STAT(STAT_Grid_GridToWorld);
+DEFINE_STAT(STAT_Grid_WorldToGrid);
+DEFINE_STAT(STAT_Grid_Raycast);
+DEFINE_STAT(STAT_Grid_FindPath);
+DEFINE_STAT(STAT_Grid_FindReachable);
+DEFINE_STAT(STAT_Grid_RebuildConfig);
+DEFINE_STAT(STAT_Grid_HeightMapImport);
+DEFINE_STAT(STAT_Grid_Visibility);
+DEFINE_STAT(STAT_Grid_Targeting);
+DEFINE_STAT(STAT_Grid_GraphBuild);
+DEFINE_STAT(STAT_Grid_RegionLabels);
+DEFINE_STAT(STAT_Grid_BattleSearch);
+DEFINE_STAT(STAT_Grid_CoarseGrid);
+DEFINE_STAT(STAT_Grid_Ballistics);
+DEFINE_STAT(STAT_Grid_PathFollow);
+DEFINE_STAT(STAT_Grid_UnitTracking);
+DEFINE_STAT(STAT_Grid_HeightBake);
+
+DEFINE_STAT(STAT_Grid_GridToWorld_Calls);
+DEFINE_STAT(STAT_Grid_WorldToGrid_Calls);
+DEFINE_STAT(STAT_Grid_Raycast_Calls);
+DEFINE_STAT(STAT_Grid_FindPath_Calls);
+DEFINE_STAT(STAT_Grid_FindReachable_Calls);
+DEFINE_STAT(STAT_Grid_HeightRead_Calls);
+DEFINE_STAT(STAT_Grid_RebuildConfig_Calls);
+DEFINE_STAT(STAT_Grid_HeightMapImport_Calls);
+DEFINE_STAT(STAT_Grid_Visibility_Calls);
+DEFINE_STAT(STAT_Grid_Targeting_Calls);
+DEFINE_STAT(STAT_Grid_GraphBuild_Calls);
+DEFINE_STAT(STAT_Grid_RegionLabels_Calls);
+DEFINE_STAT(STAT_Grid_BattleSearch_Calls);
+DEFINE_STAT(STAT_Grid_CoarseGrid_Calls);
+DEFINE_STAT(STAT_Grid_Ballistics_Calls);
+DEFINE_STAT(STAT_Grid_PathFollow_Calls);
+DEFINE_STAT(STAT_Grid_UnitTracking_Calls);
+DEFINE_STAT(STAT_Grid_HeightBake_Calls);
+
+UE_TRACE_CHANNEL_DEFINE(GridChannel);
+
+#if GRID_STATS_ENABLED
+
+namespace GridStats::Detail
+{
+    /** Every thread's counters, newest first. Blocks are never removed. */
+    static std::atomic<FThreadCounters*> ThreadCountersHead{ nullptr };
+
+    FThreadCounters& GetThreadCounters()
+    {
+        static thread_local FThreadCounters* Counters = nullptr;
+        if (!Counters)
+        {
+            // Deliberately never freed: the totals of a thread that exits still count.
+            Counters = new FThreadCounters();
+            Counters->Next = ThreadCountersHead.load();
+            while (!ThreadCountersHead.compare_exchange_weak(Counters->Next, Counters))
+            {
+            }
+        }
+        return *Counters;
+    }
+}
+
+TRACE_DECLARE_INT_COUNTER(GridTrace_GridToWorld, TEXT("Grid/GridToWorld Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_WorldToGrid, TEXT("Grid/WorldToGrid Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_Raycast, TEXT("Grid/Raycast Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_FindPath, TEXT("Grid/FindPath Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_FindReachable, TEXT("Grid/FindReachable Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_HeightRead, TEXT("Grid/HeightRead Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_RebuildConfig, TEXT("Grid/RebuildConfig Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_HeightMapImport, TEXT("Grid/HeightMapImport Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_Visibility, TEXT("Grid/Visibility Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_Targeting, TEXT("Grid/Targeting Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_GraphBuild, TEXT("Grid/GraphBuild Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_RegionLabels, TEXT("Grid/RegionLabels Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_BattleSearch, TEXT("Grid/BattleSearch Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_CoarseGrid, TEXT("Grid/CoarseGrid Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_Ballistics, TEXT("Grid/Ballistics Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_PathFollow, TEXT("Grid/PathFollow Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_UnitTracking, TEXT("Grid/UnitTracking Calls"));
+TRACE_DECLARE_INT_COUNTER(GridTrace_HeightBake, TEXT("Grid/HeightBake Calls"));
+
+namespace
+{
+    const TCHAR* const QueryNames[(int32)EGridQuery::Num] =
+    {
+        TEXT("GridToWorld"),
+        TEXT("WorldToGrid"),
+        TEXT("Raycast"),
+        TEXT("FindPath"),
+        TEXT("FindReachable"),
+        TEXT("HeightRead"),
+        TEXT("RebuildConfig"),
+        TEXT("HeightMapImport"),
+        TEXT("Visibility"),
+        TEXT("Targeting"),
+        TEXT("GraphBuild"),
+        TEXT("RegionLabels"),
+        TEXT("BattleSearch"),
+        TEXT("CoarseGrid"),
+        TEXT("Ballistics"),
+        TEXT("PathFollow"),
+        TEXT("UnitTracking"),
+        TEXT("HeightBake"),
+    };
+
+    constexpr int32 NumQueries = (int32)EGridQuery::Num;
+
+    /** Sum of all threads' totals since startup. */
+    void SumThreadCounters(int64 (&OutCalls)[NumQueries], uint64 (&OutCycles)[NumQueries])
+    {
+        FMemory::Memzero(OutCalls);
+        FMemory::Memzero(OutCycles);
+
+        for (const GridStats::Detail::FThreadCounters* Counters = GridStats::Detail::ThreadCountersHead.load(); Counters; Counters = Counters->Next)
+        {
+            for (int32 Index = 0; Index < NumQueries; ++Index)
+            {
+                OutCalls[Index] += Counters->Calls[Index].load(std::memory_order_relaxed);
+                OutCycles[Index] += Counters->Cycles[Index].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /** Totals at the last frame flush and at BeginTurn. Game thread. */
+    int64 FrameStartCalls[NumQueries] = {};
+    int64 TurnStartCalls[NumQueries] = {};
+    uint64 TurnStartCycles[NumQueries] = {};
+
+    /** Publish the per-frame call counts to Insights and start the next frame. */
+    void FlushFrameCounters()
+    {
+        int64 Calls[NumQueries];
+        uint64 Cycles[NumQueries];
+        SumThreadCounters(Calls, Cycles);
+
+        int64 FrameCalls[NumQueries];
+        for (int32 Index = 0; Index < NumQueries; ++Index)
+        {
+            FrameCalls[Index] = Calls[Index] - FrameStartCalls[Index];
+            FrameStartCalls[Index] = Calls[Index];
+        }
+
+        auto Take = [&FrameCalls](EGridQuery Query)
+        {
+            return FrameCalls[(int32)Query];
+        };
+
+        TRACE_COUNTER_SET(GridTrace_GridToWorld, Take(EGridQuery::GridToWorld));
+        TRACE_COUNTER_SET(GridTrace_WorldToGrid, Take(EGridQuery::WorldToGrid));
+        TRACE_COUNTER_SET(GridTrace_Raycast, Take(EGridQuery::Raycast));
+        TRACE_COUNTER_SET(GridTrace_FindPath, Take(EGridQuery::FindPath));
+        TRACE_COUNTER_SET(GridTrace_FindReachable, Take(EGridQuery::FindReachable));
+        TRACE_COUNTER_SET(GridTrace_HeightRead, Take(EGridQuery::HeightRead));
+        TRACE_COUNTER_SET(GridTrace_RebuildConfig, Take(EGridQuery::RebuildConfig));
+        TRACE_COUNTER_SET(GridTrace_HeightMapImport, Take(EGridQuery::HeightMapImport));
+        TRACE_COUNTER_SET(GridTrace_Visibility, Take(EGridQuery::Visibility));
+        TRACE_COUNTER_SET(GridTrace_Targeting, Take(EGridQuery::Targeting));
+        TRACE_COUNTER_SET(GridTrace_GraphBuild, Take(EGridQuery::GraphBuild));
+        TRACE_COUNTER_SET(GridTrace_RegionLabels, Take(EGridQuery::RegionLabels));
+        TRACE_COUNTER_SET(GridTrace_BattleSearch, Take(EGridQuery::BattleSearch));
+        TRACE_COUNTER_SET(GridTrace_CoarseGrid, Take(EGridQuery::CoarseGrid));
+        TRACE_COUNTER_SET(GridTrace_Ballistics, Take(EGridQuery::Ballistics));
+        TRACE_COUNTER_SET(GridTrace_PathFollow, Take(EGridQuery::PathFollow));
+        TRACE_COUNTER_SET(GridTrace_UnitTracking, Take(EGridQuery::UnitTracking));
+        TRACE_COUNTER_SET(GridTrace_HeightBake, Take(EGridQuery::HeightBake));
+    }
+
+    FDelayedAutoRegisterHelper GRegisterGridFrameFlush(EDelayedRegisterRunPhase::EndOfEngineInit, []()
+    {
+        FCoreDelegates::OnEndFrame.AddStatic(&FlushFrameCounters);
+    });
+}
+
+#endif
+
+namespace GridStats
+{
+    void BeginTurn()
+    {
+#if GRID_STATS_ENABLED
+        SumThreadCounters(TurnStartCalls, TurnStartCycles);
+#endif
+    }
+
+    FGridQueryTotals EndTurn(const FString& Label)
+    {
+        FGridQueryTotals Totals;
+
+#if GRID_STATS_ENABLED
+        int64 TotalCalls[NumQueries];
+        uint64 TotalCycles[NumQueries];
+        SumThreadCounters(TotalCalls, TotalCycles);
+
+        for (int32 Index = 0; Index < NumQueries; ++Index)
+        {
+            const int64 Calls = TotalCalls[Index] - TurnStartCalls[Index];
+            const double Milliseconds = FPlatformTime::ToMilliseconds64(TotalCycles[Index] - TurnStartCycles[Index]);
+
+            Totals.Queries.Add(QueryNames[Index]);
+            Totals.Calls.Add(Calls);
+            Totals.Milliseconds.Add(static_cast<float>(Milliseconds));
+
+            if (!Label.IsEmpty() && Calls > 0)
+            {
+                UE_LOG(LogTemp, Log, TEXT("GridStats [%s] %-16s %10lld calls %10.3f ms"), *Label, QueryNames[Index], Calls, Milliseconds);
+            }
+        }
+#endif
+
+        return Totals;
+    }
+}
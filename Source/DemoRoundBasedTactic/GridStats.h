@@ -0,0 +1,222 @@
+// GridStats.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+#include <atomic>
+
+#include "GridStats.generated.h"
+
+/**
+ * Hot-path instrumentation for grid queries.
+ *
+ * Every instrumented query feeds three sinks:
+ *  - the "Grid" stats group (`stat Grid`): per-frame cycle and call counters,
+ *  - the "Grid" Unreal Insights trace channel (`-trace=cpu,counters -tracechannels=Grid`):
+ *    one CPU scope per call plus per-frame call counters,
+ *  - per-turn totals (calls and time per query) collected between
+ *    GridStats::BeginTurn and GridStats::EndTurn.
+ *
+ * Scopes belong on whole queries and batches. Per-cell helpers (GridToWorldGround,
+ * WorldToGrid, GetHeightAt) are not instrumented, since the instrumentation would cost
+ * more than the call; their batched variants count the cells they process instead.
+ *
+ * Everything compiles to nothing when GRID_STATS_ENABLED is 0, which is the default
+ * for Shipping; define it to 0 in Build.cs to strip it from other configurations.
+ */
+#ifndef GRID_STATS_ENABLED
+#define GRID_STATS_ENABLED (!UE_BUILD_SHIPPING)
+#endif
+
+/** Instrumented grid queries. Append new queries before Num. */
+enum class EGridQuery : uint8
+{
+    GridToWorld,
+    WorldToGrid,
+    Raycast,
+    FindPath,
+    FindReachable,
+    HeightRead,
+    RebuildConfig,
+    HeightMapImport,
+    Visibility,
+    Targeting,
+    GraphBuild,
+    RegionLabels,
+    BattleSearch,
+    CoarseGrid,
+    Ballistics,
+    PathFollow,
+    UnitTracking,
+    HeightBake,
+
+    Num
+};
+
+/** Calls and accumulated time of every query over one turn. */
+USTRUCT(BlueprintType)
+struct FGridQueryTotals
+{
+    GENERATED_BODY()
+
+    /** Query name per entry, parallel to Calls / Milliseconds. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid|Stats")
+    TArray<FName> Queries;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid|Stats")
+    TArray<int64> Calls;
+
+    /** Inclusive time; zero for count-only queries (height reads of batched queries). */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid|Stats")
+    TArray<float> Milliseconds;
+};
+
+DECLARE_STATS_GROUP(TEXT("Grid"), STATGROUP_Grid, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("GridToWorld"), STAT_Grid_GridToWorld, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("WorldToGrid"), STAT_Grid_WorldToGrid, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Raycast"), STAT_Grid_Raycast, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FindPath"), STAT_Grid_FindPath, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FindReachable"), STAT_Grid_FindReachable, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RebuildConfig"), STAT_Grid_RebuildConfig, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("HeightMapImport"), STAT_Grid_HeightMapImport, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Visibility"), STAT_Grid_Visibility, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Targeting"), STAT_Grid_Targeting, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("GraphBuild"), STAT_Grid_GraphBuild, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RegionLabels"), STAT_Grid_RegionLabels, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("BattleSearch"), STAT_Grid_BattleSearch, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CoarseGrid"), STAT_Grid_CoarseGrid, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ballistics"), STAT_Grid_Ballistics, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PathFollow"), STAT_Grid_PathFollow, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("UnitTracking"), STAT_Grid_UnitTracking, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("HeightBake"), STAT_Grid_HeightBake, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("GridToWorld Calls"), STAT_Grid_GridToWorld_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("WorldToGrid Calls"), STAT_Grid_WorldToGrid_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Raycast Calls"), STAT_Grid_Raycast_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("FindPath Calls"), STAT_Grid_FindPath_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("FindReachable Calls"), STAT_Grid_FindReachable_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("HeightRead Calls"), STAT_Grid_HeightRead_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("RebuildConfig Calls"), STAT_Grid_RebuildConfig_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("HeightMapImport Calls"), STAT_Grid_HeightMapImport_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Visibility Calls"), STAT_Grid_Visibility_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Targeting Calls"), STAT_Grid_Targeting_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("GraphBuild Calls"), STAT_Grid_GraphBuild_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("RegionLabels Calls"), STAT_Grid_RegionLabels_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("BattleSearch Calls"), STAT_Grid_BattleSearch_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("CoarseGrid Calls"), STAT_Grid_CoarseGrid_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Ballistics Calls"), STAT_Grid_Ballistics_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("PathFollow Calls"), STAT_Grid_PathFollow_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("UnitTracking Calls"), STAT_Grid_UnitTracking_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("HeightBake Calls"), STAT_Grid_HeightBake_Calls, STATGROUP_Grid, DEMOROUNDBASEDTACTIC_API);
+
+UE_TRACE_CHANNEL_EXTERN(GridChannel, DEMOROUNDBASEDTACTIC_API);
+
+namespace GridStats
+{
+#if GRID_STATS_ENABLED
+    namespace Detail
+    {
+        /**
+         * Running totals of one thread since it first reported. Only the owning thread
+         * writes them (plain load + store, no locked read-modify-write), each block sits
+         * on its own cache lines, and reporting sums all blocks and subtracts the totals
+         * seen at the last frame / turn boundary. Instrumented queries on worker threads
+         * therefore never contend on shared counters.
+         */
+        struct alignas(PLATFORM_CACHE_LINE_SIZE) FThreadCounters
+        {
+            std::atomic<int64> Calls[(int32)EGridQuery::Num] = {};
+            std::atomic<uint64> Cycles[(int32)EGridQuery::Num] = {};
+            FThreadCounters* Next = nullptr;
+        };
+
+        /** This thread's counters, registered on first use. */
+        DEMOROUNDBASEDTACTIC_API FThreadCounters& GetThreadCounters();
+
+        template <typename ValueType>
+        FORCEINLINE void Add(std::atomic<ValueType>& Counter, ValueType Value)
+        {
+            Counter.store(Counter.load(std::memory_order_relaxed) + Value, std::memory_order_relaxed);
+        }
+    }
+
+    FORCEINLINE void AddCalls(EGridQuery Query, int64 Count)
+    {
+        Detail::Add(Detail::GetThreadCounters().Calls[(int32)Query], Count);
+    }
+
+    /** Counts one call and its inclusive time towards the frame and turn totals. */
+    class FQueryScope
+    {
+    public:
+        explicit FQueryScope(EGridQuery InQuery)
+            : Query(InQuery)
+            , StartCycles(FPlatformTime::Cycles64())
+        {
+        }
+
+        ~FQueryScope()
+        {
+            Detail::FThreadCounters& Counters = Detail::GetThreadCounters();
+            Detail::Add(Counters.Calls[(int32)Query], int64(1));
+            Detail::Add(Counters.Cycles[(int32)Query], FPlatformTime::Cycles64() - StartCycles);
+        }
+
+        UE_NONCOPYABLE(FQueryScope);
+
+    private:
+        EGridQuery Query;
+        uint64 StartCycles;
+    };
+#endif
+
+    /** Start a new turn: resets the per-turn totals. Game thread. */
+    DEMOROUNDBASEDTACTIC_API void BeginTurn();
+
+    /** Totals since BeginTurn, logged under Label when non-empty. Game thread. */
+    DEMOROUNDBASEDTACTIC_API FGridQueryTotals EndTurn(const FString& Label);
+}
+
+#if GRID_STATS_ENABLED
+
+/** Times the enclosing scope as one call of Query (stat cycle counter, Insights scope, turn totals). */
+#define GRID_QUERY_SCOPE(Query) \
+    SCOPE_CYCLE_COUNTER(STAT_Grid_##Query); \
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Grid_##Query, GridChannel); \
+    INC_DWORD_STAT(STAT_Grid_##Query##_Calls); \
+    GridStats::FQueryScope GridQueryScope_##Query(EGridQuery::Query)
+
+/** Counts Count calls of Query without timing them, for reads too small to time individually. */
+#define GRID_QUERY_COUNT(Query, Count) \
+    INC_DWORD_STAT_BY(STAT_Grid_##Query##_Calls, Count); \
+    GridStats::AddCalls(EGridQuery::Query, Count)
+
+#else
+
+#define GRID_QUERY_SCOPE(Query)
+#define GRID_QUERY_COUNT(Query, Count)
+
+#endif
+
+/** Blueprint access to the per-turn totals, for turn logic that lives in Blueprints. */
+UCLASS()
+class DEMOROUNDBASEDTACTIC_API UGridStatsLibrary : public UBlueprintFunctionLibrary
+{
+    GENERATED_BODY()
+
+public:
+
+    /** See GridStats::BeginTurn. */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Stats")
+    static void BeginGridStatsTurn() { GridStats::BeginTurn(); }
+
+    /** See GridStats::EndTurn. Returns empty totals when stats are compiled out. */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Stats")
+    static FGridQueryTotals EndGridStatsTurn(const FString& Label) { return GridStats::EndTurn(Label); }
+};
@@ -0,0 +1,345 @@
+// GridTargetingLibrary.cpp
+
+#include "GridTargetingLibrary.h"
+#include "GridHeightField.h"
+#include "GridShadowcast.h"
+#include "GridStats.h"
+#include "GridTemplateCache.h"
+#include "GridTopology.h"
+
+namespace
+{
+    /** Upper bound on template radius; keeps a careless Blueprint value from building a huge mask. */
+    constexpr int32 MaxTemplateRadius = 512;
+
+    /** Cache key: template parameters quantised so that nearby aims share a template. */
+    struct FTemplateKey
+    {
+        EGridTopology Topology = EGridTopology::Square4;
+        EGridTargetShape Shape = EGridTargetShape::Disc;
+        int32 Radius = 0;
+        int32 InnerRadius = 0;
+        int32 Direction = 0;      // degrees, [0, 360), multiple of AngleStep(Radius)
+        int32 ConeHalfAngle = 0;  // degrees, multiple of AngleStep(Radius)
+        int32 LineHalfWidth = 0;  // tenths of a cell
+
+        bool operator==(const FTemplateKey& Other) const
+        {
+            return Topology == Other.Topology && Shape == Other.Shape && Radius == Other.Radius &&
+                InnerRadius == Other.InnerRadius && Direction == Other.Direction &&
+                ConeHalfAngle == Other.ConeHalfAngle && LineHalfWidth == Other.LineHalfWidth;
+        }
+
+        friend uint32 GetTypeHash(const FTemplateKey& Key)
+        {
+            uint32 Hash = HashCombine(uint32(Key.Topology), uint32(Key.Shape));
+            Hash = HashCombine(Hash, uint32(Key.Radius));
+            Hash = HashCombine(Hash, uint32(Key.InnerRadius));
+            Hash = HashCombine(Hash, uint32(Key.Direction));
+            Hash = HashCombine(Hash, uint32(Key.ConeHalfAngle));
+            return HashCombine(Hash, uint32(Key.LineHalfWidth));
+        }
+    };
+
+    /**
+     * Angle quantum for a template radius: one step moves the template's outer arc by about
+     * half a cell, so finer aims would rasterise to the same cells anyway. 1° from radius 30 up.
+     */
+    static int32 AngleStep(int32 Radius)
+    {
+        return FMath::Clamp(30 / FMath::Max(Radius, 1), 1, 15);
+    }
+
+    static int32 QuantizeAngle(float Degrees, int32 Step)
+    {
+        return FMath::RoundToInt(Degrees / Step) * Step;
+    }
+
+    static FTemplateKey MakeKey(EGridTopology Topology, const FGridTargetTemplate& Template)
+    {
+        FTemplateKey Key;
+        Key.Topology = Topology;
+        Key.Shape = Template.Shape;
+        Key.Radius = FMath::Clamp(Template.Radius, 0, MaxTemplateRadius);
+
+        // Only keep the parameters the shape actually uses, so irrelevant fields do not split the cache.
+        switch (Template.Shape)
+        {
+        case EGridTargetShape::Ring:
+            Key.InnerRadius = FMath::Clamp(Template.InnerRadius, 0, Key.Radius);
+            break;
+        case EGridTargetShape::Cone:
+            Key.Direction = ((QuantizeAngle(Template.DirectionDegrees, AngleStep(Key.Radius)) % 360) + 360) % 360;
+            Key.ConeHalfAngle = FMath::Clamp(QuantizeAngle(Template.ConeHalfAngle, AngleStep(Key.Radius)), 0, 180);
+            break;
+        case EGridTargetShape::Line:
+            Key.Direction = ((QuantizeAngle(Template.DirectionDegrees, AngleStep(Key.Radius)) % 360) + 360) % 360;
+            Key.LineHalfWidth = FMath::Clamp(FMath::RoundToInt(Template.LineHalfWidth * 10.f), 0, Key.Radius * 10);
+            break;
+        default:
+            break;
+        }
+        return Key;
+    }
+
+    /** Rasterise a template into a mask over [-Radius, Radius]²; the centre cell is never set. */
+    static FGridCellMask BuildTemplateMask(const FTemplateKey& Key)
+    {
+        const int32 Radius = Key.Radius;
+        FGridCellMask Mask(FIntPoint(-Radius, -Radius), 2 * Radius + 1, 2 * Radius + 1);
+
+        const float DirectionRad = FMath::DegreesToRadians(static_cast<float>(Key.Direction));
+        const FVector2D Direction(FMath::Cos(DirectionRad), FMath::Sin(DirectionRad));
+        const float CosHalfAngle = FMath::Cos(FMath::DegreesToRadians(static_cast<float>(Key.ConeHalfAngle)));
+        const float HalfWidth = Key.LineHalfWidth * 0.1f;
+
+        DispatchGridTopology(Key.Topology, [&](auto Topo)
+        {
+            using TopologyType = decltype(Topo);
+
+            const FVector2D Centre = TopologyType::CellToLocal(FIntPoint::ZeroValue);
+            for (int32 DY = -Radius; DY <= Radius; ++DY)
+            {
+                for (int32 DX = -Radius; DX <= Radius; ++DX)
+                {
+                    const FIntPoint Offset(DX, DY);
+                    const int32 Steps = TopologyType::StepDistance(FIntPoint::ZeroValue, Offset);
+                    if (Steps == 0)
+                    {
+                        continue;
+                    }
+
+                    const FVector2D Local = TopologyType::CellToLocal(Offset) - Centre;
+                    bool bInside = false;
+
+                    switch (Key.Shape)
+                    {
+                    case EGridTargetShape::Disc:
+                        bInside = Steps <= Radius;
+                        break;
+                    case EGridTargetShape::Ring:
+                        bInside = Steps <= Radius && Steps >= Key.InnerRadius;
+                        break;
+                    case EGridTargetShape::Cone:
+                        // Small slack so cells exactly on the cone edge are included on every topology.
+                        bInside = Steps <= Radius &&
+                            FVector2D::DotProduct(Local, Direction) >= (CosHalfAngle - 1.e-3f) * Local.Size();
+                        break;
+                    case EGridTargetShape::Line:
+                    {
+                        const double Along = FVector2D::DotProduct(Local, Direction);
+                        const double Across = FMath::Abs(FVector2D::CrossProduct(Direction, Local));
+                        bInside = Along > 0.0 && Along <= Radius + 0.01 && Across <= HalfWidth + 0.01;
+                        break;
+                    }
+                    }
+
+                    if (bInside)
+                    {
+                        Mask.SetCell(Offset);
+                    }
+                }
+            }
+        });
+
+        return Mask;
+    }
+
+    /**
+     * Templates are immutable once built; readers keep their own reference.
+     * A radius-512 mask is ~140 KB, so the cache is bounded and drops the least recently used.
+     */
+    TGridTemplateCache<FTemplateKey, FGridCellMask> GTemplates(256, 16 * 1024 * 1024);
+
+    /** The 64 bits of a mask row starting at BitOffset; bits past the row read as zero. */
+    static FORCEINLINE uint64 ReadRowBits(const uint64* Row, int32 NumWords, int32 BitOffset)
+    {
+        const int32 WordIndex = BitOffset >> 6;
+        const int32 Shift = BitOffset & 63;
+        const uint64 Low = WordIndex < NumWords ? Row[WordIndex] : 0;
+        if (Shift == 0)
+        {
+            return Low;
+        }
+        const uint64 High = WordIndex + 1 < NumWords ? Row[WordIndex + 1] : 0;
+        return (Low >> Shift) | (High << (64 - Shift));
+    }
+
+    /** Bits of the last word of a row that lie inside a window NumCells wide. */
+    static FORCEINLINE uint64 LastWordMask(int32 NumCells)
+    {
+        const int32 Tail = NumCells & 63;
+        return Tail == 0 ? ~uint64(0) : (uint64(1) << Tail) - 1;
+    }
+
+    /**
+     * Clear the bits of one mask row whose height lies outside [MinZ, MaxZ].
+     * Heights points at the height of the row's first cell; cells are tested four at a time.
+     */
+    static void FilterRowByHeight(uint64* Words, int32 NumCells, const float* Heights, float MinZ, float MaxZ)
+    {
+        const VectorRegister4Float VMin = VectorSetFloat1(MinZ);
+        const VectorRegister4Float VMax = VectorSetFloat1(MaxZ);
+
+        const int32 NumWords = (NumCells + 63) >> 6;
+        for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+        {
+            const uint64 Word = Words[WordIndex];
+            if (Word == 0)
+            {
+                continue;
+            }
+
+            uint64 Keep = 0;
+            for (int32 Bit = 0; Bit < 64; Bit += 4)
+            {
+                if (((Word >> Bit) & 0xF) == 0)
+                {
+                    continue;
+                }
+
+                const int32 X = (WordIndex << 6) + Bit;
+                uint64 Pass = 0;
+                if (X + 4 <= NumCells)
+                {
+                    const VectorRegister4Float Z = VectorLoad(Heights + X);
+                    Pass = uint64(VectorMaskBits(VectorBitwiseAnd(VectorCompareGE(Z, VMin), VectorCompareLE(Z, VMax))));
+                }
+                else
+                {
+                    for (int32 Lane = 0; X + Lane < NumCells; ++Lane)
+                    {
+                        const float Z = Heights[X + Lane];
+                        Pass |= uint64(Z >= MinZ && Z <= MaxZ) << Lane;
+                    }
+                }
+                Keep |= Pass << Bit;
+            }
+            Words[WordIndex] = Word & Keep;
+        }
+    }
+}
+
+TSharedRef<const FGridCellMask, ESPMode::ThreadSafe> UGridTargetingLibrary::GetTemplateMask(EGridTopology Topology, const FGridTargetTemplate& Template)
+{
+    const FTemplateKey Key = MakeKey(Topology, Template);
+    return GTemplates.FindOrBuild(Key,
+        [&Key]() { return MakeShared<const FGridCellMask, ESPMode::ThreadSafe>(BuildTemplateMask(Key)); },
+        [](const FGridCellMask& Mask) { return Mask.GetAllocatedSize(); });
+}
+
+bool UGridTargetingLibrary::QueryTargetMask(
+    const FGridConfig& Config,
+    FIntPoint Caster,
+    const FGridTargetTemplate& Template,
+    const FGridTargetFilter& Filter,
+    FGridCellMask& OutMask)
+{
+    GRID_QUERY_SCOPE(Targeting);
+
+    if (Caster.X < 0 || Caster.Y < 0 || Caster.X >= Config.Width || Caster.Y >= Config.Height)
+    {
+        OutMask.Empty();
+        return false;
+    }
+
+    const TSharedRef<const FGridCellMask, ESPMode::ThreadSafe> TemplateMask = GetTemplateMask(Config.Topology, Template);
+    const int32 Radius = -TemplateMask->GetOrigin().X;
+
+    // Template window placed on the caster, clipped to the grid.
+    const FIntPoint TemplateMin = Caster - FIntPoint(Radius, Radius);
+    const FIntPoint Min(FMath::Max(TemplateMin.X, 0), FMath::Max(TemplateMin.Y, 0));
+    const FIntPoint Max(FMath::Min(Caster.X + Radius + 1, Config.Width), FMath::Min(Caster.Y + Radius + 1, Config.Height));
+    OutMask.Init(Min, Max.X - Min.X, Max.Y - Min.Y);
+
+    const int32 OutWidth = OutMask.GetWidth();
+    const int32 OutWords = OutMask.GetWordsPerRow();
+    const uint64 TailMask = LastWordMask(OutWidth);
+
+    // Copy the template a word at a time; the left clip becomes a bit shift.
+    const int32 ClipLeft = Min.X - TemplateMin.X;
+    for (int32 LocalY = 0; LocalY < OutMask.GetHeight(); ++LocalY)
+    {
+        const uint64* Source = TemplateMask->GetRowWords(Min.Y - TemplateMin.Y + LocalY);
+        uint64* Dest = OutMask.GetRowWords(LocalY);
+        for (int32 WordIndex = 0; WordIndex < OutWords; ++WordIndex)
+        {
+            Dest[WordIndex] = ReadRowBits(Source, TemplateMask->GetWordsPerRow(), ClipLeft + (WordIndex << 6));
+        }
+        Dest[OutWords - 1] &= TailMask;
+    }
+
+    const IGridHeightProvider* Provider = Config.HeightProvider.Get();
+    const FGridHeightSnapshot* Snapshot = Provider ? Provider->GetHeightSnapshot() : nullptr;
+    const bool bSnapshotMatches = Snapshot && Snapshot->GetWidth() == Config.Width && Snapshot->GetHeight() == Config.Height;
+    const float* CellHeights = bSnapshotMatches ? Snapshot->GetCellHeights().GetData() : nullptr;
+
+    // Height filter. A flat grid (no provider) always passes.
+    if (Filter.bFilterHeight && Provider)
+    {
+        const float CasterZ = Provider->GetHeightAt(Caster.X, Caster.Y);
+        const float MinZ = CasterZ - Filter.MaxHeightBelow;
+        const float MaxZ = CasterZ + Filter.MaxHeightAbove;
+
+        for (int32 LocalY = 0; LocalY < OutMask.GetHeight(); ++LocalY)
+        {
+            const int32 GridY = Min.Y + LocalY;
+            uint64* Row = OutMask.GetRowWords(LocalY);
+
+            if (CellHeights)
+            {
+                FilterRowByHeight(Row, OutWidth, CellHeights + GridY * Config.Width + Min.X, MinZ, MaxZ);
+                continue;
+            }
+
+            for (int32 WordIndex = 0; WordIndex < OutWords; ++WordIndex)
+            {
+                uint64 Remaining = Row[WordIndex];
+                while (Remaining != 0)
+                {
+                    const int32 Bit = (int32)FMath::CountTrailingZeros64(Remaining);
+                    Remaining &= Remaining - 1;
+                    const float Z = Provider->GetHeightAt(Min.X + (WordIndex << 6) + Bit, GridY);
+                    if (Z < MinZ || Z > MaxZ)
+                    {
+                        Row[WordIndex] &= ~(uint64(1) << Bit);
+                    }
+                }
+            }
+        }
+    }
+
+    // Line of sight: one shadowcast from the caster covering the whole template, ANDed in.
+    if (Filter.bRequireLineOfSight && !OutMask.IsEmpty())
+    {
+        const int32 SightRadius = FMath::CeilToInt(Radius * UE_SQRT_2) + 1;
+
+        FGridCellMask Visible;
+        GridShadowcast::ComputeFieldOfView(Config, Caster, SightRadius, Filter.EyeHeight, CellHeights, nullptr, Visible);
+
+        const int32 VisibleOffsetX = Min.X - Visible.GetOrigin().X;
+        for (int32 LocalY = 0; LocalY < OutMask.GetHeight(); ++LocalY)
+        {
+            const uint64* Source = Visible.GetRowWords(Min.Y - Visible.GetOrigin().Y + LocalY);
+            uint64* Dest = OutMask.GetRowWords(LocalY);
+            for (int32 WordIndex = 0; WordIndex < OutWords; ++WordIndex)
+            {
+                Dest[WordIndex] &= ReadRowBits(Source, Visible.GetWordsPerRow(), VisibleOffsetX + (WordIndex << 6));
+            }
+        }
+    }
+
+    OutMask.SetCell(Caster, Filter.bIncludeCaster);
+    return true;
+}
+
+TArray<FIntPoint> UGridTargetingLibrary::GetTargetCells(
+    const FGridConfig& Config,
+    FIntPoint Caster,
+    const FGridTargetTemplate& Template,
+    const FGridTargetFilter& Filter)
+{
+    FGridCellMask Mask;
+    QueryTargetMask(Config, Caster, Template, Filter, Mask);
+    return Mask.ToCellArray();
+}
@@ -0,0 +1,136 @@
+// GridTargetingLibrary.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "GridCellMask.h"
+#include "GridTypes.h"
+#include "GridTargetingLibrary.generated.h"
+
+/** Shape of an ability's area-of-effect / targeting template. */
+UENUM(BlueprintType)
+enum class EGridTargetShape : uint8
+{
+    /** Every cell within Radius steps. */
+    Disc UMETA(DisplayName = "Disc"),
+
+    /** Cells between InnerRadius and Radius steps (inclusive). */
+    Ring UMETA(DisplayName = "Ring"),
+
+    /** Cells within Radius steps whose direction is within ConeHalfAngle of Direction. */
+    Cone UMETA(DisplayName = "Cone"),
+
+    /** Cells along Direction up to Radius cells away, LineHalfWidth cells to either side. */
+    Line UMETA(DisplayName = "Line")
+};
+
+/**
+ * Caster-relative targeting template.
+ *
+ * Distances are in grid steps of the grid's topology (Manhattan for Square4, Chebyshev for
+ * Square8, hex distance for HexAxial). Directions are angles in the grid plane, measured
+ * from the grid X axis towards the grid Y axis.
+ */
+USTRUCT(BlueprintType)
+struct FGridTargetTemplate
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Targeting")
+    EGridTargetShape Shape = EGridTargetShape::Disc;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Targeting", meta = (ClampMin = "0"))
+    int32 Radius = 3;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Targeting", meta = (ClampMin = "0", EditCondition = "Shape == EGridTargetShape::Ring"))
+    int32 InnerRadius = 1;
+
+    /**
+     * Aim direction in degrees (cones and lines). Rounded for template reuse: to whole degrees
+     * from radius 30 up, coarser for small templates where a degree does not move a cell.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Targeting")
+    float DirectionDegrees = 0.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Targeting", meta = (ClampMin = "0", ClampMax = "180", EditCondition = "Shape == EGridTargetShape::Cone"))
+    float ConeHalfAngle = 45.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Targeting", meta = (ClampMin = "0", EditCondition = "Shape == EGridTargetShape::Line"))
+    float LineHalfWidth = 0.5f;
+};
+
+/** Per-query filters applied on top of the template. */
+USTRUCT(BlueprintType)
+struct FGridTargetFilter
+{
+    GENERATED_BODY()
+
+    /** Add the caster's own cell; templates never contain it otherwise. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Targeting")
+    bool bIncludeCaster = false;
+
+    /** Drop cells whose ground is more than MaxHeightAbove above / MaxHeightBelow below the caster's ground. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Targeting")
+    bool bFilterHeight = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Targeting", meta = (EditCondition = "bFilterHeight"))
+    float MaxHeightAbove = 100.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Targeting", meta = (EditCondition = "bFilterHeight"))
+    float MaxHeightBelow = 200.f;
+
+    /** Drop cells the caster cannot see (height-aware shadowcasting from its eye). */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Targeting")
+    bool bRequireLineOfSight = false;
+
+    /** Caster eye height for the line-of-sight test; negative uses the grid's DefaultEyeHeight. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid|Targeting", meta = (EditCondition = "bRequireLineOfSight"))
+    float EyeHeight = -1.f;
+};
+
+/**
+ * Area-of-effect and targeting template queries.
+ *
+ * Templates are rasterised once per topology and shape parameters into a caster-relative
+ * FGridCellMask and kept in a bounded LRU cache, so a query is a row copy of the template plus the filters:
+ * the height filter compares four cells at a time against the height snapshot rows,
+ * and line of sight intersects the result with one shadowcast from the caster.
+ * Results are bit masks; Blueprints get the cell list.
+ */
+UCLASS()
+class DEMOROUNDBASEDTACTIC_API UGridTargetingLibrary : public UBlueprintFunctionLibrary
+{
+    GENERATED_BODY()
+
+public:
+
+    /**
+     * Cells covered by Template around Caster, after Filter. Native entry point.
+     *
+     * @param OutMask Window of the template around Caster; cells outside the grid are never set.
+     * @return False if Caster is outside the grid (OutMask is then empty).
+     */
+    static bool QueryTargetMask(
+        const FGridConfig& Config,
+        FIntPoint Caster,
+        const FGridTargetTemplate& Template,
+        const FGridTargetFilter& Filter,
+        FGridCellMask& OutMask
+    );
+
+    /** Blueprint version of QueryTargetMask that returns the covered cells. */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Targeting")
+    static TArray<FIntPoint> GetTargetCells(
+        const FGridConfig& Config,
+        FIntPoint Caster,
+        const FGridTargetTemplate& Template,
+        const FGridTargetFilter& Filter
+    );
+
+    /**
+     * Cached caster-relative mask of a template (window origin = (-Radius, -Radius)).
+     * Thread-safe; the returned mask is immutable.
+     */
+    static TSharedRef<const FGridCellMask, ESPMode::ThreadSafe> GetTemplateMask(EGridTopology Topology, const FGridTargetTemplate& Template);
+};
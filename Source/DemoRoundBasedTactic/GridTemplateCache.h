@@ -0,0 +1,126 @@
+// GridTemplateCache.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+
+#include <atomic>
+
+/**
+ * Thread-safe cache of immutable, shared templates (targeting masks, shadowcast orders)
+ * bounded by entry count and bytes; the least recently used entries are evicted first.
+ *
+ * Lookups only take the read lock and stamp the entry with an atomic use counter, so
+ * concurrent queries on a warm cache do not serialise. Evicted templates stay alive
+ * for as long as a caller still holds the returned reference.
+ */
+template <typename KeyType, typename TemplateType>
+class TGridTemplateCache
+{
+public:
+    using FTemplateRef = TSharedRef<const TemplateType, ESPMode::ThreadSafe>;
+
+    TGridTemplateCache(int32 InMaxEntries, SIZE_T InMaxBytes)
+        : MaxEntries(FMath::Max(InMaxEntries, 1))
+        , MaxBytes(InMaxBytes)
+    {
+    }
+
+    /**
+     * Cached template for Key, built with Build() on a miss.
+     * Build runs without the lock held; SizeOf(Template) gives the bytes it pins.
+     */
+    template <typename BuildFuncType, typename SizeFuncType>
+    FTemplateRef FindOrBuild(const KeyType& Key, BuildFuncType&& Build, SizeFuncType&& SizeOf)
+    {
+        {
+            FReadScopeLock ReadLock(Lock);
+            if (const FEntry* Existing = Entries.Find(Key))
+            {
+                Existing->LastUse.store(UseClock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+                return Existing->Template;
+            }
+        }
+
+        FTemplateRef Built = Build();
+        const SIZE_T Bytes = SizeOf(*Built);
+
+        FWriteScopeLock WriteLock(Lock);
+        if (const FEntry* Existing = Entries.Find(Key))
+        {
+            Existing->LastUse.store(UseClock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+            return Existing->Template;
+        }
+
+        // Make room first; a single template larger than the budget is still cached on its own.
+        while (Entries.Num() > 0 && (Entries.Num() >= MaxEntries || TotalBytes + Bytes > MaxBytes))
+        {
+            EvictOldest();
+        }
+
+        FEntry& Entry = Entries.Emplace(Key, FEntry(Built, Bytes));
+        Entry.LastUse.store(UseClock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+        TotalBytes += Bytes;
+        return Built;
+    }
+
+    /** Drop every cached template. */
+    void Reset()
+    {
+        FWriteScopeLock WriteLock(Lock);
+        Entries.Reset();
+        TotalBytes = 0;
+    }
+
+private:
+    struct FEntry
+    {
+        FEntry(const FTemplateRef& InTemplate, SIZE_T InBytes)
+            : Template(InTemplate)
+            , Bytes(InBytes)
+        {
+        }
+
+        FEntry(FEntry&& Other)
+            : Template(Other.Template)
+            , Bytes(Other.Bytes)
+            , LastUse(Other.LastUse.load(std::memory_order_relaxed))
+        {
+        }
+
+        FTemplateRef Template;
+        SIZE_T Bytes = 0;
+
+        /** Written under the read lock by concurrent lookups. */
+        mutable std::atomic<uint64> LastUse{ 0 };
+    };
+
+    /** Linear scan; the entry cap keeps the map small. Write lock held. */
+    void EvictOldest()
+    {
+        const KeyType* OldestKey = nullptr;
+        uint64 OldestUse = MAX_uint64;
+        for (const TPair<KeyType, FEntry>& Pair : Entries)
+        {
+            const uint64 Use = Pair.Value.LastUse.load(std::memory_order_relaxed);
+            if (Use < OldestUse)
+            {
+                OldestUse = Use;
+                OldestKey = &Pair.Key;
+            }
+        }
+
+        const KeyType Key = *OldestKey;
+        TotalBytes -= Entries.FindChecked(Key).Bytes;
+        Entries.Remove(Key);
+    }
+
+    const int32 MaxEntries;
+    const SIZE_T MaxBytes;
+
+    FRWLock Lock;
+    TMap<KeyType, FEntry> Entries;
+    SIZE_T TotalBytes = 0;
+    std::atomic<uint64> UseClock{ 0 };
+};
@@ -0,0 +1,212 @@
+// GridTopology.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridTypes.h"
+
+/**
+ * Compile-time grid topologies.
+ *
+ * Each TGridTopology specialisation provides constexpr neighbour tables, a
+ * distance heuristic and the conversion between cell coordinates and continuous
+ * grid-plane coordinates (in cell units, relative to FGridConfig::GridOrigin).
+ *
+ * Hot loops are written once as templates over the topology and instantiated
+ * per specialisation, so neighbour iteration never branches on the topology.
+ * Runtime code selects the instantiation once with DispatchGridTopology.
+ */
+
+/** Integer offset from a cell to one of its neighbours. */
+struct FGridNeighborOffset
+{
+    int32 DX;
+    int32 DY;
+};
+
+template <EGridTopology Topology>
+struct TGridTopology;
+
+namespace GridTopologyDetail
+{
+    /** Shared square-cell geometry: cell (X, Y) spans [X, X+1) × [Y, Y+1) in grid-plane units. */
+    struct FSquareGeometry
+    {
+        static FORCEINLINE FVector2D CellToLocal(const FIntPoint& Cell)
+        {
+            // Offset to move from the cell origin to the cell centre.
+            constexpr double HalfCell = 0.5;
+            return FVector2D(Cell.X + HalfCell, Cell.Y + HalfCell);
+        }
+
+        static FORCEINLINE FIntPoint LocalToCell(const FVector2D& Local, EGridRoundingPolicy Rounding)
+        {
+            switch (Rounding)
+            {
+            case EGridRoundingPolicy::Round:
+                return FIntPoint(FMath::RoundToInt(Local.X), FMath::RoundToInt(Local.Y));
+
+            case EGridRoundingPolicy::Ceil:
+                return FIntPoint(FMath::CeilToInt(Local.X), FMath::CeilToInt(Local.Y));
+
+            case EGridRoundingPolicy::Floor:
+            default:
+                return FIntPoint(FMath::FloorToInt(Local.X), FMath::FloorToInt(Local.Y));
+            }
+        }
+    };
+}
+
+/** Square cells, orthogonal neighbours only. */
+template <>
+struct TGridTopology<EGridTopology::Square4> : GridTopologyDetail::FSquareGeometry
+{
+    static constexpr EGridTopology Kind = EGridTopology::Square4;
+    static constexpr int32 NumNeighbors = 4;
+
+    static constexpr FGridNeighborOffset NeighborOffsets[NumNeighbors] =
+    {
+        { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 }
+    };
+
+    /** Movement cost of a step to each neighbour, in cells. */
+    static constexpr float StepCosts[NumNeighbors] = { 1.f, 1.f, 1.f, 1.f };
+
+    /** Minimum number of steps between two cells (Manhattan distance). */
+    static FORCEINLINE int32 StepDistance(const FIntPoint& A, const FIntPoint& B)
+    {
+        return FMath::Abs(A.X - B.X) + FMath::Abs(A.Y - B.Y);
+    }
+
+    /** Admissible estimate of the StepCosts-weighted distance. */
+    static FORCEINLINE float Heuristic(const FIntPoint& A, const FIntPoint& B)
+    {
+        return static_cast<float>(StepDistance(A, B));
+    }
+};
+
+/** Square cells, orthogonal and diagonal neighbours. */
+template <>
+struct TGridTopology<EGridTopology::Square8> : GridTopologyDetail::FSquareGeometry
+{
+    static constexpr EGridTopology Kind = EGridTopology::Square8;
+    static constexpr int32 NumNeighbors = 8;
+
+    static constexpr FGridNeighborOffset NeighborOffsets[NumNeighbors] =
+    {
+        { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 },
+        { 1, 1 }, { -1, 1 }, { -1, -1 }, { 1, -1 }
+    };
+
+    static constexpr float StepCosts[NumNeighbors] =
+    {
+        1.f, 1.f, 1.f, 1.f,
+        UE_SQRT_2, UE_SQRT_2, UE_SQRT_2, UE_SQRT_2
+    };
+
+    /** Minimum number of steps between two cells (Chebyshev distance). */
+    static FORCEINLINE int32 StepDistance(const FIntPoint& A, const FIntPoint& B)
+    {
+        return FMath::Max(FMath::Abs(A.X - B.X), FMath::Abs(A.Y - B.Y));
+    }
+
+    /** Octile distance: exact cost on an open grid. */
+    static FORCEINLINE float Heuristic(const FIntPoint& A, const FIntPoint& B)
+    {
+        const int32 DX = FMath::Abs(A.X - B.X);
+        const int32 DY = FMath::Abs(A.Y - B.Y);
+        return static_cast<float>(FMath::Max(DX, DY)) + (UE_SQRT_2 - 1.f) * static_cast<float>(FMath::Min(DX, DY));
+    }
+};
+
+/**
+ * Pointy-top hex cells in axial coordinates (X = Q, Y = R).
+ *
+ * Cell centres sit one cell unit apart. The +0.5 offset mirrors the square
+ * topologies so that GridOrigin is the outer corner of cell (0,0) in both cases.
+ */
+template <>
+struct TGridTopology<EGridTopology::HexAxial>
+{
+    static constexpr EGridTopology Kind = EGridTopology::HexAxial;
+    static constexpr int32 NumNeighbors = 6;
+
+    static constexpr FGridNeighborOffset NeighborOffsets[NumNeighbors] =
+    {
+        { 1, 0 }, { 1, -1 }, { 0, -1 }, { -1, 0 }, { -1, 1 }, { 0, 1 }
+    };
+
+    static constexpr float StepCosts[NumNeighbors] = { 1.f, 1.f, 1.f, 1.f, 1.f, 1.f };
+
+    /** Vertical distance between two hex rows, in cell units (sqrt(3) / 2). */
+    static constexpr double RowSpacing = 0.86602540378443864676;
+
+    /** Minimum number of steps between two cells (cube distance). */
+    static FORCEINLINE int32 StepDistance(const FIntPoint& A, const FIntPoint& B)
+    {
+        const int32 DQ = A.X - B.X;
+        const int32 DR = A.Y - B.Y;
+        return (FMath::Abs(DQ) + FMath::Abs(DR) + FMath::Abs(DQ + DR)) / 2;
+    }
+
+    static FORCEINLINE float Heuristic(const FIntPoint& A, const FIntPoint& B)
+    {
+        return static_cast<float>(StepDistance(A, B));
+    }
+
+    static FORCEINLINE FVector2D CellToLocal(const FIntPoint& Cell)
+    {
+        return FVector2D(Cell.X + 0.5 * Cell.Y + 0.5, RowSpacing * Cell.Y + 0.5);
+    }
+
+    /**
+     * Map a grid-plane position to the hex containing it (cube rounding).
+     * Rounding policies do not apply to hex cells and are ignored.
+     */
+    static FORCEINLINE FIntPoint LocalToCell(const FVector2D& Local, EGridRoundingPolicy /*Rounding*/)
+    {
+        const double FR = (Local.Y - 0.5) / RowSpacing;
+        const double FQ = (Local.X - 0.5) - 0.5 * FR;
+        const double FS = -FQ - FR;
+
+        double Q = FMath::RoundToDouble(FQ);
+        double R = FMath::RoundToDouble(FR);
+        const double S = FMath::RoundToDouble(FS);
+
+        const double DQ = FMath::Abs(Q - FQ);
+        const double DR = FMath::Abs(R - FR);
+        const double DS = FMath::Abs(S - FS);
+
+        if (DQ > DR && DQ > DS)
+        {
+            Q = -R - S;
+        }
+        else if (DR > DS)
+        {
+            R = -Q - S;
+        }
+
+        return FIntPoint(static_cast<int32>(Q), static_cast<int32>(R));
+    }
+};
+
+/**
+ * Invoke Func with a default-constructed TGridTopology matching the runtime value.
+ * Func is typically a generic lambda: [&](auto Topo) { using TopoType = decltype(Topo); ... }.
+ */
+template <typename FuncType>
+FORCEINLINE decltype(auto) DispatchGridTopology(EGridTopology Topology, FuncType&& Func)
+{
+    switch (Topology)
+    {
+    case EGridTopology::Square8:
+        return Func(TGridTopology<EGridTopology::Square8>{});
+
+    case EGridTopology::HexAxial:
+        return Func(TGridTopology<EGridTopology::HexAxial>{});
+
+    case EGridTopology::Square4:
+    default:
+        return Func(TGridTopology<EGridTopology::Square4>{});
+    }
+}
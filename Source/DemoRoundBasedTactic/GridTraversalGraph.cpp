@@ -0,0 +1,458 @@
+// GridTraversalGraph.cpp
+
+#include "GridTraversalGraph.h"
+#include "GridMovementRules.h"
+#include "GridStats.h"
+#include "GridTopology.h"
+#include "TerrainHeightMapAsset.h"
+
+#include "Async/ParallelFor.h"
+
+namespace
+{
+    /** Steps of a rectangle of cells, MaxDegree slots per cell (row-major within the rectangle). */
+    struct FBakedRect
+    {
+        FIntRect Rect;
+        int32 Stride = 0;
+        TArray<int32> Targets;
+        TArray<float> Costs;
+        TArray<uint8> Degrees;
+
+        FORCEINLINE int32 LocalIndex(int32 X, int32 Y) const
+        {
+            return (Y - Rect.Min.Y) * Rect.Width() + (X - Rect.Min.X);
+        }
+    };
+
+    template <typename TopologyType>
+    static void TBakeRect(const FGridHeightSnapshot& Heights, const TBitArray<>& Blocked, const FGridMovementProfile& Profile, const FIntRect& Rect, FBakedRect& Out)
+    {
+        const int32 NumRectCells = Rect.Width() * Rect.Height();
+        Out.Rect = Rect;
+        Out.Stride = TopologyType::NumNeighbors;
+        Out.Targets.SetNumUninitialized(NumRectCells * Out.Stride);
+        Out.Costs.SetNumUninitialized(NumRectCells * Out.Stride);
+        Out.Degrees.SetNumUninitialized(NumRectCells);
+
+        const int32 Width = Heights.GetWidth();
+        const int32 Height = Heights.GetHeight();
+        const float* Data = Heights.GetCellHeights().GetData();
+        const bool bAnyBlocked = Blocked.Num() > 0;
+
+        // A blocked cell reads as infinitely high, so no step or corner check passes it.
+        auto HeightAt = [Data, Width, &Blocked, bAnyBlocked](int32 X, int32 Y)
+        {
+            const int32 Index = Y * Width + X;
+            return (bAnyBlocked && Blocked[Index]) ? MAX_flt : Data[Index];
+        };
+
+        ParallelFor(Rect.Height(), [&](int32 RowIndex)
+        {
+            const int32 Y = Rect.Min.Y + RowIndex;
+            for (int32 X = Rect.Min.X; X < Rect.Max.X; ++X)
+            {
+                const int32 Local = Out.LocalIndex(X, Y);
+                int32* CellTargets = Out.Targets.GetData() + Local * Out.Stride;
+                float* CellCosts = Out.Costs.GetData() + Local * Out.Stride;
+
+                uint8 Degree = 0;
+                if (bAnyBlocked && Blocked[Y * Width + X])
+                {
+                    Out.Degrees[Local] = 0;
+                    continue;
+                }
+
+                GridMovement::ForEachPassableNeighbor<TopologyType>(Width, Height, Profile, FIntPoint(X, Y), HeightAt(X, Y), HeightAt,
+                    [&](const FIntPoint& /*Next*/, int32 NextIndex, float StepCost)
+                    {
+                        CellTargets[Degree] = NextIndex;
+                        CellCosts[Degree] = StepCost;
+                        ++Degree;
+                    });
+                Out.Degrees[Local] = Degree;
+            }
+        });
+    }
+
+    static void BakeRect(EGridTopology Topology, const FGridHeightSnapshot& Heights, const TBitArray<>& Blocked, const FGridMovementProfile& Profile, const FIntRect& Rect, FBakedRect& Out)
+    {
+        DispatchGridTopology(Topology, [&](auto Topo)
+        {
+            TBakeRect<decltype(Topo)>(Heights, Blocked, Profile, Rect, Out);
+        });
+    }
+
+    /** Heights of Config as a snapshot: the provider's own if it has one, otherwise a copy. */
+    static FGridHeightSnapshotRef MakeHeights(const FGridConfig& Config)
+    {
+        const IGridHeightProvider* Provider = Config.HeightProvider.Get();
+        if (const FGridHeightSnapshot* Snapshot = Provider ? Provider->GetHeightSnapshot() : nullptr)
+        {
+            if (Snapshot->GetWidth() == Config.Width && Snapshot->GetHeight() == Config.Height)
+            {
+                return FGridHeightSnapshotRef(Snapshot);
+            }
+        }
+
+        TArray<float> CellHeights;
+        CellHeights.SetNumUninitialized(Config.Width * Config.Height);
+        for (int32 Y = 0; Y < Config.Height; ++Y)
+        {
+            for (int32 X = 0; X < Config.Width; ++X)
+            {
+                CellHeights[Y * Config.Width + X] = Provider ? Provider->GetHeightAt(X, Y) : static_cast<float>(Config.GridOrigin.Z);
+            }
+        }
+        return new FGridHeightSnapshot(Config.Width, Config.Height, MoveTemp(CellHeights), Config.Version.HeightVersion);
+    }
+}
+
+void FGridTraversalGraph::Reset()
+{
+    Width = 0;
+    Height = 0;
+    Heights = nullptr;
+    Blocked.Empty();
+    RowStart.Empty();
+    Targets.Empty();
+    Costs.Empty();
+    IncomingSteps.Empty();
+}
+
+void FGridTraversalGraph::Build(const FGridConfig& Config, const FGridMovementProfile& InProfile)
+{
+    if (Config.Width <= 0 || Config.Height <= 0)
+    {
+        Reset();
+        return;
+    }
+    BuildFromHeights(MakeHeights(Config), Config.Topology, InProfile);
+}
+
+void FGridTraversalGraph::Build(const UTerrainHeightMapAsset& Asset, EGridTopology InTopology, const FGridMovementProfile& InProfile)
+{
+    if (Asset.Width <= 0 || Asset.Height <= 0 || Asset.CellHeights.Num() != Asset.Width * Asset.Height)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FGridTraversalGraph: height map asset %s has no valid height data."), *Asset.GetName());
+        Reset();
+        return;
+    }
+    BuildFromHeights(new FGridHeightSnapshot(Asset.Width, Asset.Height, Asset.CellHeights), InTopology, InProfile);
+}
+
+void FGridTraversalGraph::BuildFromHeights(FGridHeightSnapshotRef InHeights, EGridTopology InTopology, const FGridMovementProfile& InProfile)
+{
+    GRID_QUERY_SCOPE(GraphBuild);
+
+    if (InHeights->GetWidth() != Width || InHeights->GetHeight() != Height)
+    {
+        Blocked.Empty();
+    }
+
+    Width = InHeights->GetWidth();
+    Height = InHeights->GetHeight();
+    Topology = InTopology;
+    Profile = InProfile;
+    Heights = MoveTemp(InHeights);
+
+    FBakedRect Baked;
+    BakeRect(Topology, *Heights, Blocked, Profile, FIntRect(0, 0, Width, Height), Baked);
+
+    const int32 NumCells = Width * Height;
+    RowStart.SetNumUninitialized(NumCells + 1);
+    int32 NumEdges = 0;
+    for (int32 Index = 0; Index < NumCells; ++Index)
+    {
+        RowStart[Index] = NumEdges;
+        NumEdges += Baked.Degrees[Index];
+    }
+    RowStart[NumCells] = NumEdges;
+
+    Targets.SetNumUninitialized(NumEdges);
+    Costs.SetNumUninitialized(NumEdges);
+
+    // Compact the fixed-stride bake into CSR, one grid row per task.
+    ParallelFor(Height, [this, &Baked](int32 Y)
+    {
+        for (int32 Index = Y * Width; Index < (Y + 1) * Width; ++Index)
+        {
+            const int32 Degree = Baked.Degrees[Index];
+            FMemory::Memcpy(Targets.GetData() + RowStart[Index], Baked.Targets.GetData() + Index * Baked.Stride, Degree * sizeof(int32));
+            FMemory::Memcpy(Costs.GetData() + RowStart[Index], Baked.Costs.GetData() + Index * Baked.Stride, Degree * sizeof(float));
+        }
+    });
+
+    IncomingSteps.SetNumUninitialized(NumCells);
+    BakeIncomingSteps(FIntRect(0, 0, Width, Height));
+}
+
+void FGridTraversalGraph::BakeIncomingSteps(const FIntRect& Rect)
+{
+    DispatchGridTopology(Topology, [&](auto Topo)
+    {
+        using TopologyType = decltype(Topo);
+
+        ParallelFor(Rect.Height(), [this, &Rect](int32 RowIndex)
+        {
+            const int32 Y = Rect.Min.Y + RowIndex;
+            for (int32 X = Rect.Min.X; X < Rect.Max.X; ++X)
+            {
+                const int32 Index = Y * Width + X;
+                uint8 Incoming = 0;
+                for (int32 Slot = 0; Slot < TopologyType::NumNeighbors; ++Slot)
+                {
+                    const int32 NX = X + TopologyType::NeighborOffsets[Slot].DX;
+                    const int32 NY = Y + TopologyType::NeighborOffsets[Slot].DY;
+                    if (NX >= 0 && NX < Width && NY >= 0 && NY < Height && HasEdge(NY * Width + NX, Index))
+                    {
+                        Incoming |= uint8(1) << Slot;
+                    }
+                }
+                IncomingSteps[Index] = Incoming;
+            }
+        });
+    });
+}
+
+bool FGridTraversalGraph::Update(const FGridConfig& Config, FIntRect* OutRebaked)
+{
+    if (OutRebaked)
+    {
+        *OutRebaked = FIntRect();
+    }
+
+    if (!IsValid() || Config.Width != Width || Config.Height != Height || Config.Topology != Topology)
+    {
+        const FGridMovementProfile KeptProfile = Profile;
+        Build(Config, KeptProfile);
+        if (OutRebaked)
+        {
+            *OutRebaked = FIntRect(0, 0, Width, Height);
+        }
+        return true;
+    }
+
+    FGridHeightSnapshotRef NewHeights = MakeHeights(Config);
+    if (NewHeights == Heights)
+    {
+        return false;
+    }
+
+    // Bounding rectangle of the cells whose height changed.
+    const float* OldData = Heights->GetCellHeights().GetData();
+    const float* NewData = NewHeights->GetCellHeights().GetData();
+    FIntRect Changed(MAX_int32, MAX_int32, MIN_int32, MIN_int32);
+    for (int32 Y = 0; Y < Height; ++Y)
+    {
+        // Bit patterns, like the Memcmp: +0/-0 or NaN payloads must not compare equal past the row.
+        const uint32* OldRow = reinterpret_cast<const uint32*>(OldData + Y * Width);
+        const uint32* NewRow = reinterpret_cast<const uint32*>(NewData + Y * Width);
+        if (FMemory::Memcmp(OldRow, NewRow, Width * sizeof(float)) == 0)
+        {
+            continue;
+        }
+
+        int32 First = 0;
+        while (First < Width && OldRow[First] == NewRow[First])
+        {
+            ++First;
+        }
+        int32 Last = Width - 1;
+        while (Last > First && OldRow[Last] == NewRow[Last])
+        {
+            --Last;
+        }
+
+        Changed.Min.X = FMath::Min(Changed.Min.X, First);
+        Changed.Max.X = FMath::Max(Changed.Max.X, Last + 1);
+        Changed.Min.Y = FMath::Min(Changed.Min.Y, Y);
+        Changed.Max.Y = Y + 1;
+    }
+
+    if (Changed.Min.X >= Changed.Max.X)
+    {
+        // Same heights, new snapshot (e.g. a frame-only rebuild).
+        Heights = MoveTemp(NewHeights);
+        return false;
+    }
+
+    const FIntRect Rebaked = RebuildRegion(MoveTemp(NewHeights), Changed);
+    if (OutRebaked)
+    {
+        *OutRebaked = Rebaked;
+    }
+    return true;
+}
+
+FIntRect FGridTraversalGraph::SetCellBlocked(FIntPoint Cell, bool bBlocked)
+{
+    if (!IsValid() || Cell.X < 0 || Cell.Y < 0 || Cell.X >= Width || Cell.Y >= Height)
+    {
+        return FIntRect();
+    }
+
+    const int32 Index = Cell.Y * Width + Cell.X;
+    if (IsCellBlocked(Index) == bBlocked)
+    {
+        return FIntRect();
+    }
+
+    if (Blocked.Num() == 0)
+    {
+        Blocked.Init(false, Width * Height);
+    }
+    Blocked[Index] = bBlocked;
+
+    return RebuildRegion(Heights, FIntRect(Cell, Cell + FIntPoint(1, 1)));
+}
+
+FIntRect FGridTraversalGraph::RebuildRegion(FGridHeightSnapshotRef NewHeights, const FIntRect& Region)
+{
+    if (!IsValid() || !NewHeights.IsValid() || NewHeights->GetWidth() != Width || NewHeights->GetHeight() != Height)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FGridTraversalGraph::RebuildRegion: graph not built or heights of a different size."));
+        return FIntRect();
+    }
+
+    check(IsInGameThread());
+    GRID_QUERY_SCOPE(GraphBuild);
+
+    // Steps into a changed cell start from its neighbours (and Square8 corner checks read
+    // the cells beside a diagonal), all within one cell of it.
+    const FIntRect Rect(
+        FMath::Max(Region.Min.X - 1, 0), FMath::Max(Region.Min.Y - 1, 0),
+        FMath::Min(Region.Max.X + 1, Width), FMath::Min(Region.Max.Y + 1, Height));
+    Heights = MoveTemp(NewHeights);
+    if (Rect.Min.X >= Rect.Max.X || Rect.Min.Y >= Rect.Max.Y)
+    {
+        return FIntRect();
+    }
+
+    FBakedRect Baked;
+    BakeRect(Topology, *Heights, Blocked, Profile, Rect, Baked);
+
+    // The re-baked steps end at most one cell outside Rect.
+    const FIntRect IncomingRect(
+        FMath::Max(Rect.Min.X - 1, 0), FMath::Max(Rect.Min.Y - 1, 0),
+        FMath::Min(Rect.Max.X + 1, Width), FMath::Min(Rect.Max.Y + 1, Height));
+
+    bool bSameDegrees = true;
+    for (int32 Y = Rect.Min.Y; Y < Rect.Max.Y && bSameDegrees; ++Y)
+    {
+        for (int32 X = Rect.Min.X; X < Rect.Max.X; ++X)
+        {
+            const int32 Index = Y * Width + X;
+            if (Baked.Degrees[Baked.LocalIndex(X, Y)] != RowStart[Index + 1] - RowStart[Index])
+            {
+                bSameDegrees = false;
+                break;
+            }
+        }
+    }
+
+    if (bSameDegrees)
+    {
+        // Only costs or targets changed: overwrite the rows in place.
+        for (int32 Y = Rect.Min.Y; Y < Rect.Max.Y; ++Y)
+        {
+            for (int32 X = Rect.Min.X; X < Rect.Max.X; ++X)
+            {
+                const int32 Index = Y * Width + X;
+                const int32 Local = Baked.LocalIndex(X, Y);
+                const int32 Degree = Baked.Degrees[Local];
+                FMemory::Memcpy(Targets.GetData() + RowStart[Index], Baked.Targets.GetData() + Local * Baked.Stride, Degree * sizeof(int32));
+                FMemory::Memcpy(Costs.GetData() + RowStart[Index], Baked.Costs.GetData() + Local * Baked.Stride, Degree * sizeof(float));
+            }
+        }
+        BakeIncomingSteps(IncomingRect);
+        return Rect;
+    }
+
+    // Some cell gained or lost a step. Cells before the first re-baked one and after the
+    // last keep their edges, so only the span between them is spliced; the tail of the edge
+    // arrays moves by the change in edge count and its offsets shift by the same amount.
+    const int32 SpanBegin = Rect.Min.Y * Width + Rect.Min.X;
+    const int32 SpanEnd = (Rect.Max.Y - 1) * Width + Rect.Max.X;
+    const int32 OldSpanEdges = RowStart[SpanEnd] - RowStart[SpanBegin];
+
+    // Visit(X, Y, Index, bRebaked) for every cell of the span, row by row.
+    auto ForEachSpanCell = [&](auto&& Visit)
+    {
+        for (int32 Y = Rect.Min.Y; Y < Rect.Max.Y; ++Y)
+        {
+            const int32 First = Y == Rect.Min.Y ? Rect.Min.X : 0;
+            const int32 Last = Y == Rect.Max.Y - 1 ? Rect.Max.X : Width;
+            for (int32 X = First; X < Last; ++X)
+            {
+                Visit(X, Y, Y * Width + X, X >= Rect.Min.X && X < Rect.Max.X);
+            }
+        }
+    };
+
+    TArray<int32> SpanRowStart;
+    SpanRowStart.SetNumUninitialized(SpanEnd - SpanBegin);
+    int32 NumSpanEdges = 0;
+    ForEachSpanCell([&](int32 X, int32 Y, int32 Index, bool bRebaked)
+    {
+        SpanRowStart[Index - SpanBegin] = NumSpanEdges;
+        NumSpanEdges += bRebaked ? Baked.Degrees[Baked.LocalIndex(X, Y)] : RowStart[Index + 1] - RowStart[Index];
+    });
+
+    TArray<int32> SpanTargets;
+    TArray<float> SpanCosts;
+    SpanTargets.SetNumUninitialized(NumSpanEdges);
+    SpanCosts.SetNumUninitialized(NumSpanEdges);
+    ForEachSpanCell([&](int32 X, int32 Y, int32 Index, bool bRebaked)
+    {
+        const int32 Offset = SpanRowStart[Index - SpanBegin];
+        if (bRebaked)
+        {
+            const int32 Local = Baked.LocalIndex(X, Y);
+            const int32 Degree = Baked.Degrees[Local];
+            FMemory::Memcpy(SpanTargets.GetData() + Offset, Baked.Targets.GetData() + Local * Baked.Stride, Degree * sizeof(int32));
+            FMemory::Memcpy(SpanCosts.GetData() + Offset, Baked.Costs.GetData() + Local * Baked.Stride, Degree * sizeof(float));
+        }
+        else
+        {
+            const int32 Degree = RowStart[Index + 1] - RowStart[Index];
+            FMemory::Memcpy(SpanTargets.GetData() + Offset, Targets.GetData() + RowStart[Index], Degree * sizeof(int32));
+            FMemory::Memcpy(SpanCosts.GetData() + Offset, Costs.GetData() + RowStart[Index], Degree * sizeof(float));
+        }
+    });
+
+    const int32 NumCells = Width * Height;
+    const int32 OldNumEdges = Targets.Num();
+    const int32 Delta = NumSpanEdges - OldSpanEdges;
+    const int32 SpanFirstEdge = RowStart[SpanBegin];
+    const int32 OldTailBegin = SpanFirstEdge + OldSpanEdges;
+    const int32 TailCount = OldNumEdges - OldTailBegin;
+
+    if (Delta > 0)
+    {
+        Targets.AddUninitialized(Delta);
+        Costs.AddUninitialized(Delta);
+    }
+    FMemory::Memmove(Targets.GetData() + OldTailBegin + Delta, Targets.GetData() + OldTailBegin, TailCount * sizeof(int32));
+    FMemory::Memmove(Costs.GetData() + OldTailBegin + Delta, Costs.GetData() + OldTailBegin, TailCount * sizeof(float));
+    if (Delta < 0)
+    {
+        Targets.SetNum(OldNumEdges + Delta, EAllowShrinking::No);
+        Costs.SetNum(OldNumEdges + Delta, EAllowShrinking::No);
+    }
+
+    FMemory::Memcpy(Targets.GetData() + SpanFirstEdge, SpanTargets.GetData(), NumSpanEdges * sizeof(int32));
+    FMemory::Memcpy(Costs.GetData() + SpanFirstEdge, SpanCosts.GetData(), NumSpanEdges * sizeof(float));
+
+    for (int32 Index = SpanBegin; Index < SpanEnd; ++Index)
+    {
+        RowStart[Index] = SpanFirstEdge + SpanRowStart[Index - SpanBegin];
+    }
+    for (int32 Index = SpanEnd; Index <= NumCells; ++Index)
+    {
+        RowStart[Index] += Delta;
+    }
+
+    BakeIncomingSteps(IncomingRect);
+    return Rect;
+}
@@ -0,0 +1,149 @@
+// GridTraversalGraph.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridHeightField.h"
+#include "GridTypes.h"
+
+class UTerrainHeightMapAsset;
+
+/**
+ * Traversal graph of a grid baked for one movement profile, in compressed sparse
+ * row (CSR) form.
+ *
+ * The passable steps out of cell I are Targets[RowStart[I] .. RowStart[I + 1]) with
+ * their costs at the same positions in Costs, so searches iterate neighbours as two
+ * contiguous arrays instead of re-reading heights and re-evaluating step rules.
+ * Passability and costs are exactly those of GridMovement::ForEachPassableNeighbor.
+ * Each cell also keeps a bit mask of the neighbours that step into it, so undirected
+ * walks (region labels) find incoming steps without scanning the neighbours' rows.
+ *
+ * Building evaluates rows of cells in parallel. Terrain edits only re-bake the rows of
+ * the cells around the changed region: in place if no cell gained or lost a step,
+ * otherwise by splicing the span from the first to the last re-baked cell and shifting
+ * the edges and offsets after it.
+ *
+ * Cells can be marked blocked (walls, props): they have no steps in or out, and count as
+ * impassable for Square8 corner checks. Blocked cells survive rebuilds of the same size.
+ *
+ * The graph keeps a reference to the height snapshot it was baked from. Update,
+ * RebuildRegion and SetCellBlocked edit the arrays in place, so they run on the game
+ * thread and no other thread may read the graph meanwhile. To share a graph with worker
+ * threads, hand out a TSharedRef<const FGridTraversalGraph> and stop editing it (the
+ * battle search does this).
+ */
+class DEMOROUNDBASEDTACTIC_API FGridTraversalGraph
+{
+public:
+
+    /** Bake the graph of Config's grid (heights from its height snapshot or provider). */
+    void Build(const FGridConfig& Config, const FGridMovementProfile& Profile);
+
+    /** Bake the graph of a height map asset laid out with Topology. */
+    void Build(const UTerrainHeightMapAsset& Asset, EGridTopology Topology, const FGridMovementProfile& Profile);
+
+    /**
+     * Bring the graph up to date with Config after a grid rebuild. Only the region whose
+     * heights differ from the baked snapshot is re-baked; a change of dimensions or topology
+     * rebuilds everything.
+     *
+     * @param OutRebaked If set, receives the cells whose steps were re-baked (empty if none).
+     * @return True if any edge may have changed.
+     */
+    bool Update(const FGridConfig& Config, FIntRect* OutRebaked = nullptr);
+
+    /**
+     * Re-bake the steps touching Region (half-open, grid coordinates) against NewHeights,
+     * which must have the graph's dimensions. Use this after a terrain edit whose extent is known.
+     *
+     * @return The cells whose steps were re-baked (Region grown by one cell, clipped to the grid).
+     */
+    FIntRect RebuildRegion(FGridHeightSnapshotRef NewHeights, const FIntRect& Region);
+
+    /**
+     * Block or unblock a cell and re-bake the steps around it.
+     *
+     * @return The cells whose steps were re-baked; empty if the cell's state did not change.
+     */
+    FIntRect SetCellBlocked(FIntPoint Cell, bool bBlocked);
+
+    bool IsCellBlocked(int32 CellIndex) const { return Blocked.Num() > CellIndex && Blocked[CellIndex]; }
+
+    /**
+     * Reverse adjacency of CellIndex: bit K is set if the neighbour at the topology's
+     * NeighborOffsets[K] has a step into CellIndex.
+     */
+    FORCEINLINE uint8 GetIncomingSteps(int32 CellIndex) const { return IncomingSteps[CellIndex]; }
+
+    /** True if there is a step From -> To. */
+    bool HasEdge(int32 From, int32 To) const
+    {
+        return GetNeighbors(From).Contains(To);
+    }
+
+    void Reset();
+
+    bool IsValid() const { return RowStart.Num() == Width * Height + 1 && Width > 0 && Height > 0; }
+
+    int32 GetWidth() const { return Width; }
+    int32 GetHeight() const { return Height; }
+    int32 GetNumCells() const { return Width * Height; }
+    int32 GetNumEdges() const { return Targets.Num(); }
+    EGridTopology GetTopology() const { return Topology; }
+    const FGridMovementProfile& GetProfile() const { return Profile; }
+
+    /** Heights the graph was baked from. */
+    const FGridHeightSnapshotRef& GetHeights() const { return Heights; }
+
+    /** Cell indices reachable in one step from CellIndex (Index = Y * Width + X). */
+    FORCEINLINE TConstArrayView<int32> GetNeighbors(int32 CellIndex) const
+    {
+        return TConstArrayView<int32>(Targets.GetData() + RowStart[CellIndex], RowStart[CellIndex + 1] - RowStart[CellIndex]);
+    }
+
+    /** Costs of the steps returned by GetNeighbors, in the same order. */
+    FORCEINLINE TConstArrayView<float> GetCosts(int32 CellIndex) const
+    {
+        return TConstArrayView<float>(Costs.GetData() + RowStart[CellIndex], RowStart[CellIndex + 1] - RowStart[CellIndex]);
+    }
+
+    /** Call Visit(NeighborIndex, StepCost) for every passable step out of CellIndex. */
+    template <typename VisitorType>
+    FORCEINLINE void ForEachEdge(int32 CellIndex, VisitorType&& Visit) const
+    {
+        const int32 End = RowStart[CellIndex + 1];
+        for (int32 Edge = RowStart[CellIndex]; Edge < End; ++Edge)
+        {
+            Visit(Targets[Edge], Costs[Edge]);
+        }
+    }
+
+    SIZE_T GetAllocatedSize() const
+    {
+        return RowStart.GetAllocatedSize() + Targets.GetAllocatedSize() + Costs.GetAllocatedSize() + IncomingSteps.GetAllocatedSize();
+    }
+
+private:
+    void BuildFromHeights(FGridHeightSnapshotRef InHeights, EGridTopology InTopology, const FGridMovementProfile& InProfile);
+
+    /** Recompute IncomingSteps for the cells of Rect from the forward edges. */
+    void BakeIncomingSteps(const FIntRect& Rect);
+
+    int32 Width = 0;
+    int32 Height = 0;
+    EGridTopology Topology = EGridTopology::Square4;
+    FGridMovementProfile Profile;
+    FGridHeightSnapshotRef Heights;
+
+    /** One bit per cell; empty until the first cell is blocked. */
+    TBitArray<> Blocked;
+
+    /** NumCells + 1 offsets into Targets / Costs. */
+    TArray<int32> RowStart;
+    TArray<int32> Targets;
+    TArray<float> Costs;
+
+    /** One neighbour-slot bit mask per cell, see GetIncomingSteps. */
+    TArray<uint8> IncomingSteps;
+};
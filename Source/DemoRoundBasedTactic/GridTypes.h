@@ -16,12 +16,92 @@ enum class EGridRoundingPolicy : uint8
     Ceil  UMETA(DisplayName = "Ceil")
 };
 
+/**
+ * Cell shape and neighbourhood of a logical grid.
+ *
+ * Square grids use plain (X, Y) cell indices. Hex grids use axial (Q, R) coordinates
+ * stored in FIntPoint as (X = Q, Y = R) with pointy-top cells; together with the
+ * row-major storage this makes a hex map a rhombus of Width × Height cells.
+ */
+UENUM(BlueprintType)
+enum class EGridTopology : uint8
+{
+    Square4  UMETA(DisplayName = "Square (4 neighbours)"),
+    Square8  UMETA(DisplayName = "Square (8 neighbours)"),
+    HexAxial UMETA(DisplayName = "Hex (axial)")
+};
+
+/**
+ * Parts of an FGridConfig that can change independently.
+ * Used as a bit mask by change notifications and FGridConfigVersion::Diff.
+ */
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EGridConfigChange : uint8
+{
+    None       = 0 UMETA(Hidden),
+
+    /** World embedding: origin, orientation, cell size, eye height. */
+    Frame      = 1 << 0,
+
+    /** Logical shape: width, height, topology. */
+    Dimensions = 1 << 1,
+
+    /** Ground heights served by the height provider. */
+    HeightData = 1 << 2
+};
+ENUM_CLASS_FLAGS(EGridConfigChange);
+
+/**
+ * Version stamps of the independently changing parts of an FGridConfig.
+ *
+ * Each counter is drawn from one process-wide monotonically increasing sequence,
+ * so equal values always mean "same data" and caches can detect stale results
+ * with a plain comparison, without locks.
+ */
+USTRUCT(BlueprintType)
+struct FGridConfigVersion
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid|Version")
+    int32 FrameVersion = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid|Version")
+    int32 DimensionsVersion = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid|Version")
+    int32 HeightVersion = 0;
+
+    /** Parts whose version differs between this stamp and Other. */
+    EGridConfigChange Diff(const FGridConfigVersion& Other) const
+    {
+        EGridConfigChange Result = EGridConfigChange::None;
+        if (FrameVersion != Other.FrameVersion)           { Result |= EGridConfigChange::Frame; }
+        if (DimensionsVersion != Other.DimensionsVersion) { Result |= EGridConfigChange::Dimensions; }
+        if (HeightVersion != Other.HeightVersion)         { Result |= EGridConfigChange::HeightData; }
+        return Result;
+    }
+
+    bool operator==(const FGridConfigVersion& Other) const { return Diff(Other) == EGridConfigChange::None; }
+    bool operator!=(const FGridConfigVersion& Other) const { return !(*this == Other); }
+};
+
+struct FGridHeightTiles;
+class FGridHeightSnapshot;
+class FGridLayerData;
+
 /**
  * Lightweight C++ height provider interface used by the grid geometry utilities.
  * 
  * Implementations are free to read from textures, arrays, or any other data source.
  * This is intentionally not a UObject interface to keep the core math deterministic
  * and easily testable.
+ *
+ * Thread safety: a provider must be immutable once it has been injected into an
+ * FGridConfig, so that GetHeightAt can be called from any thread. New height data
+ * is published by swapping in a new provider, never by editing an existing one.
+ * Worker threads should not read a component's FGridConfig directly (the game thread
+ * replaces it on rebuild); they should acquire an FGridHeightSnapshot instead.
  */
 class IGridHeightProvider
 {
@@ -34,6 +114,56 @@ public:
      * if used together with a correctly configured FGridConfig.
      */
     virtual float GetHeightAt(int32 GridX, int32 GridY) const = 0;
+
+    /**
+     * Optional coarse max-height tiles covering the same grid.
+     * Ray and arc queries use them to skip whole tiles; returning nullptr simply
+     * disables that acceleration.
+     */
+    virtual const FGridHeightTiles* GetMaxHeightTiles() const { return nullptr; }
+
+    /**
+     * Optional immutable row-major copy of the heights this provider serves.
+     * Bulk consumers (visibility, templates, graph bakes) read it directly instead of
+     * calling GetHeightAt per cell; nullptr means they must fall back to GetHeightAt.
+     */
+    virtual const FGridHeightSnapshot* GetHeightSnapshot() const { return nullptr; }
+};
+
+/**
+ * Movement rules used by grid searches to decide which steps are passable and
+ * how much they cost.
+ *
+ * A step costs the topology's base step cost (1 for orthogonal / hex steps,
+ * sqrt(2) for diagonals) plus a per-unit penalty for the height gained or lost.
+ */
+USTRUCT(BlueprintType)
+struct FGridMovementProfile
+{
+    GENERATED_BODY()
+
+    /** Largest upward height difference (world units) a single step may climb. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
+    float MaxStepUp = 60.f;
+
+    /** Largest downward height difference (world units) a single step may drop. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
+    float MaxStepDown = 120.f;
+
+    /** Extra cost per world unit of height gained. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
+    float ClimbCostPerUnit = 0.01f;
+
+    /** Extra cost per world unit of height lost. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
+    float DescendCostPerUnit = 0.f;
+
+    /**
+     * Square (8 neighbours) only: if false, a diagonal step is allowed only when
+     * both orthogonal steps around the corner are passable.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
+    bool bAllowCornerCutting = false;
 };
 
 /**
@@ -56,6 +186,13 @@ struct FGridConfig
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
     int32 Height = 0;
 
+    /**
+     * Cell shape and neighbourhood. Geometry and search functions select a
+     * specialised implementation from this value once per call.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
+    EGridTopology Topology = EGridTopology::Square4;
+
     /**
      * World-space location of cell (0,0), at the *centre* of the cell.
      *
@@ -99,6 +236,7 @@ struct FGridConfig
     /**
      * Physical size of a single cell along each grid axis (in world units).
      * For square cells, this value is used for both the X and Y directions.
+     * For hex cells, this is the distance between the centres of two adjacent cells.
      */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
     float CellSize = 100.f;
@@ -110,10 +248,23 @@ struct FGridConfig
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
     float DefaultEyeHeight = 160.f;
 
+    /**
+     * Version stamps of this config, maintained by whoever builds it
+     * (see UHeightMapGridBindingComponent::RebuildGridConfig).
+     */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid|Version")
+    FGridConfigVersion Version;
+
     /**
      * This pointer is *not* exposed to Blueprints on purpose; in purely Blueprint
      * scenarios the grid will fall back to GridOrigin.Z as the ground height.
      * C++ systems can inject a concrete implementation at runtime.
      */
     TSharedPtr<IGridHeightProvider> HeightProvider;
+
+    /**
+     * Extra walkable surfaces above the ground (bridges, floors), see FGridLayerData.
+     * Null on grids where every cell has only the ground. Not exposed to Blueprints.
+     */
+    TSharedPtr<const FGridLayerData, ESPMode::ThreadSafe> Layers;
 };
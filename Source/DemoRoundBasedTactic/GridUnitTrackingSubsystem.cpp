@@ -0,0 +1,292 @@
+// GridUnitTrackingSubsystem.cpp
+
+#include "GridUnitTrackingSubsystem.h"
+#include "GridGeometryLibrary.h"
+#include "GridStats.h"
+#include "GridTopology.h"
+
+#include "GameFramework/Actor.h"
+
+namespace
+{
+    const FIntPoint OutsideCell(-1, -1);
+
+    /** Keep-zone size of a cell: half the cell (square) or its inscribed radius (hex, unit neighbour spacing). */
+    constexpr float CellHalfExtent = 0.5f;
+
+    /** Unit normals of a hex cell's three edge pairs (the directions to its neighbours). */
+    const FVector2D HexEdgeNormals[3] =
+    {
+        FVector2D(1.0, 0.0),
+        FVector2D(0.5, TGridTopology<EGridTopology::HexAxial>::RowSpacing),
+        FVector2D(-0.5, TGridTopology<EGridTopology::HexAxial>::RowSpacing),
+    };
+
+    /** True if Delta (from the cell centre) lies within Extent of the centre across every hex edge. */
+    FORCEINLINE bool IsInsideHex(const FVector2D& Delta, float Extent)
+    {
+        return FMath::Abs(Delta | HexEdgeNormals[0]) <= Extent
+            && FMath::Abs(Delta | HexEdgeNormals[1]) <= Extent
+            && FMath::Abs(Delta | HexEdgeNormals[2]) <= Extent;
+    }
+}
+
+FGridTrackerHandle UGridUnitTrackingSubsystem::TrackActor(AActor* Actor, FGridHandle Grid, float Hysteresis)
+{
+    const UGridWorldSubsystem* Registry = UGridWorldSubsystem::Get(this);
+    const FGridConfig* Config = Registry ? Registry->GetGridConfig(Grid) : nullptr;
+    if (!Actor || !Config)
+    {
+        return FGridTrackerHandle{};
+    }
+
+    const int32 TrackerId = FreeTrackerIds.Num() > 0 ? FreeTrackerIds.Pop(EAllowShrinking::No) : Trackers.AddDefaulted();
+    FTrackerEntry& Entry = Trackers[TrackerId];
+    Entry.Grid = Grid;
+    ++Entry.Serial;
+
+    FGridBucket& Bucket = Buckets.FindOrAdd(Grid);
+    Entry.Slot = Bucket.Num();
+
+    // The starting cell is not a transition, so resolve it here instead of on the next update.
+    FIntPoint Cell;
+    if (!UGridGeometryLibrary::WorldToGrid(*Config, Actor->GetActorLocation(), Cell, false))
+    {
+        Cell = OutsideCell;
+    }
+
+    Bucket.Actors.Add(Actor);
+    Bucket.TrackerIds.Add(TrackerId);
+    Bucket.Cells.Add(Cell);
+    Bucket.Hysteresis.Add(FMath::Max(Hysteresis, 0.f));
+    Bucket.Centers.Add(FVector2D::ZeroVector);
+    Bucket.Extents.Add(-1.f);
+
+    FGridTrackerHandle Handle;
+    Handle.Id = TrackerId;
+    Handle.Serial = Entry.Serial;
+    return Handle;
+}
+
+void UGridUnitTrackingSubsystem::UntrackActor(FGridTrackerHandle Tracker)
+{
+    if (!Trackers.IsValidIndex(Tracker.Id) || Trackers[Tracker.Id].Serial != Tracker.Serial || Trackers[Tracker.Id].Slot == INDEX_NONE)
+    {
+        return;
+    }
+
+    FTrackerEntry& Entry = Trackers[Tracker.Id];
+    if (FGridBucket* Bucket = Buckets.Find(Entry.Grid))
+    {
+        RemoveSlot(*Bucket, Entry.Slot);
+        if (Bucket->Num() == 0)
+        {
+            Buckets.Remove(Entry.Grid);
+        }
+    }
+}
+
+FIntPoint UGridUnitTrackingSubsystem::GetTrackedCell(FGridTrackerHandle Tracker) const
+{
+    if (!Trackers.IsValidIndex(Tracker.Id) || Trackers[Tracker.Id].Serial != Tracker.Serial || Trackers[Tracker.Id].Slot == INDEX_NONE)
+    {
+        return OutsideCell;
+    }
+
+    const FTrackerEntry& Entry = Trackers[Tracker.Id];
+    const FGridBucket* Bucket = Buckets.Find(Entry.Grid);
+    return Bucket ? Bucket->Cells[Entry.Slot] : OutsideCell;
+}
+
+int32 UGridUnitTrackingSubsystem::GetNumTrackers() const
+{
+    int32 NumTrackers = 0;
+    for (const TPair<FGridHandle, FGridBucket>& Pair : Buckets)
+    {
+        NumTrackers += Pair.Value.Num();
+    }
+    return NumTrackers;
+}
+
+void UGridUnitTrackingSubsystem::UpdateTrackers()
+{
+    if (Buckets.Num() == 0)
+    {
+        return;
+    }
+
+    GRID_QUERY_SCOPE(UnitTracking);
+
+    TArray<FCellChange> Changes;
+    for (TPair<FGridHandle, FGridBucket>& Pair : Buckets)
+    {
+        UpdateBucket(Pair.Key, Pair.Value, Changes);
+    }
+
+    for (auto It = Buckets.CreateIterator(); It; ++It)
+    {
+        if (It.Value().Num() == 0)
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    // Listeners may track or untrack actors, so broadcast once the buckets are consistent.
+    for (const FCellChange& Change : Changes)
+    {
+        OnCellChanged.Broadcast(Change.Tracker, Change.Actor.Get(), Change.OldCell, Change.NewCell);
+    }
+}
+
+void UGridUnitTrackingSubsystem::UpdateBucket(FGridHandle Grid, FGridBucket& Bucket, TArray<FCellChange>& OutChanges)
+{
+    const UGridWorldSubsystem* Registry = UGridWorldSubsystem::Get(this);
+    const FGridConfig* Config = Registry ? Registry->GetGridConfig(Grid) : nullptr;
+    if (!Config || Config->CellSize <= KINDA_SMALL_NUMBER)
+    {
+        return;
+    }
+
+    // A moved or resized grid invalidates every cached keep zone.
+    if (EnumHasAnyFlags(Config->Version.Diff(Bucket.Version), EGridConfigChange::Frame | EGridConfigChange::Dimensions))
+    {
+        for (float& Extent : Bucket.Extents)
+        {
+            Extent = -1.f;
+        }
+        Bucket.Version = Config->Version;
+    }
+
+    FVector XAxis;
+    FVector YAxis;
+    UGridGeometryLibrary::GetGridAxes(*Config, XAxis, YAxis);
+    XAxis /= Config->CellSize;
+    YAxis /= Config->CellSize;
+
+    const bool bHex = Config->Topology == EGridTopology::HexAxial;
+
+    for (int32 Slot = Bucket.Num() - 1; Slot >= 0; --Slot)
+    {
+        if (!Bucket.Actors[Slot].IsValid())
+        {
+            RemoveSlot(Bucket, Slot);
+        }
+    }
+
+    // Projection pass: one location read and two dot products per actor.
+    Bucket.Locals.SetNumUninitialized(Bucket.Num(), EAllowShrinking::No);
+    Bucket.Pending.Reset();
+    for (int32 Slot = 0; Slot < Bucket.Num(); ++Slot)
+    {
+        const AActor* Actor = Bucket.Actors[Slot].Get();
+        const FVector Local = Actor->GetActorLocation() - Config->GridOrigin;
+        const FVector2D Plane(FVector::DotProduct(Local, XAxis), FVector::DotProduct(Local, YAxis));
+        Bucket.Locals[Slot] = Plane;
+
+        const FVector2D Delta = Plane - Bucket.Centers[Slot];
+        const float Extent = Bucket.Extents[Slot];
+        const bool bInside = bHex
+            ? IsInsideHex(Delta, Extent)
+            : FMath::Abs(Delta.X) <= Extent && FMath::Abs(Delta.Y) <= Extent;
+
+        if (Extent < 0.f || !bInside)
+        {
+            Bucket.Pending.Add(Slot);
+        }
+    }
+
+    if (Bucket.Pending.Num() == 0)
+    {
+        return;
+    }
+
+    GRID_QUERY_COUNT(WorldToGrid, Bucket.Pending.Num());
+
+    // Conversion pass over the actors that left their keep zone.
+    DispatchGridTopology(Config->Topology, [&](auto Topo)
+    {
+        using TopologyType = decltype(Topo);
+
+        for (const int32 Slot : Bucket.Pending)
+        {
+            FIntPoint Cell = TopologyType::LocalToCell(Bucket.Locals[Slot], EGridRoundingPolicy::Floor);
+
+            // Square cells: an axis still inside its band keeps its coordinate, so leaving
+            // across one edge near a corner cannot jump to the diagonal cell.
+            const float Extent = Bucket.Extents[Slot];
+            if (!bHex && Extent >= 0.f)
+            {
+                const FVector2D Delta = Bucket.Locals[Slot] - Bucket.Centers[Slot];
+                if (FMath::Abs(Delta.X) <= Extent)
+                {
+                    Cell.X = Bucket.Cells[Slot].X;
+                }
+                if (FMath::Abs(Delta.Y) <= Extent)
+                {
+                    Cell.Y = Bucket.Cells[Slot].Y;
+                }
+            }
+
+            const bool bInGrid = Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Config->Width && Cell.Y < Config->Height;
+            if (!bInGrid)
+            {
+                Cell = OutsideCell;
+            }
+
+            if (Cell != Bucket.Cells[Slot])
+            {
+                const int32 TrackerId = Bucket.TrackerIds[Slot];
+                FCellChange& Change = OutChanges.AddDefaulted_GetRef();
+                Change.Tracker.Id = TrackerId;
+                Change.Tracker.Serial = Trackers[TrackerId].Serial;
+                Change.Actor = Bucket.Actors[Slot];
+                Change.OldCell = Bucket.Cells[Slot];
+                Change.NewCell = Cell;
+                Bucket.Cells[Slot] = Cell;
+            }
+
+            // Outside the grid there is no cell to stay in, so keep converting.
+            Bucket.Centers[Slot] = bInGrid ? TopologyType::CellToLocal(Cell) : FVector2D::ZeroVector;
+            Bucket.Extents[Slot] = bInGrid ? CellHalfExtent + Bucket.Hysteresis[Slot] : -1.f;
+        }
+    });
+}
+
+void UGridUnitTrackingSubsystem::RemoveSlot(FGridBucket& Bucket, int32 Slot)
+{
+    FTrackerEntry& Entry = Trackers[Bucket.TrackerIds[Slot]];
+    Entry.Slot = INDEX_NONE;
+    ++Entry.Serial;
+    FreeTrackerIds.Add(Bucket.TrackerIds[Slot]);
+
+    // Swap-remove keeps the arrays dense; fix up the tracker moved into the hole.
+    const int32 Last = Bucket.Num() - 1;
+    if (Slot != Last)
+    {
+        Trackers[Bucket.TrackerIds[Last]].Slot = Slot;
+    }
+
+    Bucket.Actors.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    Bucket.TrackerIds.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    Bucket.Cells.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    Bucket.Centers.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    Bucket.Extents.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+    Bucket.Hysteresis.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+}
+
+void UGridUnitTrackingSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    UpdateTrackers();
+}
+
+TStatId UGridUnitTrackingSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UGridUnitTrackingSubsystem, STATGROUP_Tickables);
+}
+
+bool UGridUnitTrackingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
@@ -0,0 +1,132 @@
+// GridUnitTrackingSubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GridTypes.h"
+#include "GridWorldSubsystem.h"
+#include "GridUnitTrackingSubsystem.generated.h"
+
+class AActor;
+
+/** Handle to an actor tracked by UGridUnitTrackingSubsystem. */
+USTRUCT(BlueprintType)
+struct FGridTrackerHandle
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    int32 Id = INDEX_NONE;
+
+    UPROPERTY()
+    int32 Serial = 0;
+
+    bool IsSet() const { return Id != INDEX_NONE; }
+};
+
+/** Fired when a tracked actor's cell changes; OldCell / NewCell are (-1,-1) outside the grid. */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnGridTrackedCellChanged, FGridTrackerHandle, Tracker, AActor*, Actor, FIntPoint, OldCell, FIntPoint, NewCell);
+
+/**
+ * Keeps the cell of every registered actor in sync with its location.
+ *
+ * Each tracker remembers its current cell and that cell's extent on the grid plane,
+ * grown by a hysteresis margin. Once per frame the actor locations of a grid are
+ * projected onto the grid plane in one pass (axes resolved once per grid); actors still
+ * inside their cell's extent are skipped, and only the rest go through the topology's
+ * LocalToCell. OnCellChanged is broadcast for real transitions only, and the margin
+ * stops an actor standing on a cell border from flickering between the two cells.
+ *
+ * On hex grids the extent is the hexagon itself, grown across each of its three edge
+ * pairs. On square grids an actor leaving across one edge keeps its coordinate on the
+ * other axis while that axis is still inside its margin.
+ */
+UCLASS()
+class DEMOROUNDBASEDTACTIC_API UGridUnitTrackingSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    /**
+     * Start tracking Actor on Grid.
+     *
+     * @param Hysteresis Distance in cells the actor must move past a cell border before
+     *                   its cell changes.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Tracking")
+    FGridTrackerHandle TrackActor(AActor* Actor, FGridHandle Grid, float Hysteresis = 0.1f);
+
+    UFUNCTION(BlueprintCallable, Category = "Grid|Tracking")
+    void UntrackActor(FGridTrackerHandle Tracker);
+
+    /** Current cell of a tracker as of the last update; (-1,-1) if stale or outside the grid. */
+    UFUNCTION(BlueprintPure, Category = "Grid|Tracking")
+    FIntPoint GetTrackedCell(FGridTrackerHandle Tracker) const;
+
+    /** Number of trackers (for profiling / debugging). */
+    UFUNCTION(BlueprintPure, Category = "Grid|Tracking")
+    int32 GetNumTrackers() const;
+
+    /** Update every tracker now. Also done automatically once per frame. */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Tracking")
+    void UpdateTrackers();
+
+    UPROPERTY(BlueprintAssignable, Category = "Grid|Tracking")
+    FOnGridTrackedCellChanged OnCellChanged;
+
+    // UTickableWorldSubsystem
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    /** Trackers of one grid, structure of arrays. */
+    struct FGridBucket
+    {
+        /** Version of the grid frame the cached extents were computed in. */
+        FGridConfigVersion Version;
+
+        TArray<TWeakObjectPtr<AActor>> Actors;
+        TArray<int32> TrackerIds;
+        TArray<FIntPoint> Cells;
+
+        /** Centre of the current cell on the grid plane, in cell units. */
+        TArray<FVector2D> Centers;
+
+        /** Half size (square) or radius (hex) of the keep zone, in cell units; negative forces a conversion. */
+        TArray<float> Extents;
+        TArray<float> Hysteresis;
+
+        /** Scratch of UpdateTrackers. */
+        TArray<FVector2D> Locals;
+        TArray<int32> Pending;
+
+        int32 Num() const { return Actors.Num(); }
+    };
+
+    struct FTrackerEntry
+    {
+        FGridHandle Grid;
+        int32 Slot = INDEX_NONE;
+        int32 Serial = 0;
+    };
+
+    struct FCellChange
+    {
+        FGridTrackerHandle Tracker;
+        TWeakObjectPtr<AActor> Actor;
+        FIntPoint OldCell;
+        FIntPoint NewCell;
+    };
+
+    void UpdateBucket(FGridHandle Grid, FGridBucket& Bucket, TArray<FCellChange>& OutChanges);
+    void RemoveSlot(FGridBucket& Bucket, int32 Slot);
+
+    TMap<FGridHandle, FGridBucket> Buckets;
+    TArray<FTrackerEntry> Trackers;
+    TArray<int32> FreeTrackerIds;
+};
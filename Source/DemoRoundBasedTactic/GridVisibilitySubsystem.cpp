@@ -0,0 +1,433 @@
+// GridVisibilitySubsystem.cpp
+
+#include "GridVisibilitySubsystem.h"
+#include "GridHeightField.h"
+#include "GridShadowcast.h"
+#include "GridStats.h"
+#include "HeightMapGridBindingComponent.h"
+
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+
+FGridViewerHandle UGridVisibilitySubsystem::AddViewer(FGridHandle Grid, int32 Faction, FIntPoint Cell, int32 SightRadius, float EyeHeight)
+{
+    int32 Id = INDEX_NONE;
+    if (FreeViewerIds.Num() > 0)
+    {
+        Id = FreeViewerIds.Pop(EAllowShrinking::No);
+    }
+    else
+    {
+        Id = Viewers.AddDefaulted();
+    }
+
+    FViewer& Viewer = Viewers[Id];
+    const int32 Serial = Viewer.Serial;
+    Viewer = FViewer{};
+    Viewer.Serial = Serial;
+    Viewer.Grid = Grid;
+    Viewer.Faction = Faction;
+    Viewer.Cell = Cell;
+    Viewer.SightRadius = FMath::Clamp(SightRadius, 0, 0xFFFF);
+    Viewer.EyeHeight = EyeHeight;
+    Viewer.bAlive = true;
+    Viewer.bDirty = true;
+    bAnyDirty = true;
+
+    FGridViewerHandle Handle;
+    Handle.Id = Id;
+    Handle.Serial = Serial;
+    return Handle;
+}
+
+void UGridVisibilitySubsystem::RemoveViewer(FGridViewerHandle Viewer)
+{
+    FViewer* Entry = ResolveViewer(Viewer);
+    if (!Entry)
+    {
+        return;
+    }
+
+    if (FGridState* State = Grids.Find(Entry->Grid))
+    {
+        bool bChanged = false;
+        ApplyMask(*State, Entry->Faction, Entry->Mask, -1, bChanged);
+        if (bChanged)
+        {
+            OnVisibilityChanged.Broadcast(Entry->Grid, Entry->Faction);
+        }
+    }
+
+    const int32 Serial = Entry->Serial + 1;
+    *Entry = FViewer{};
+    Entry->Serial = Serial;
+    FreeViewerIds.Add(Viewer.Id);
+}
+
+void UGridVisibilitySubsystem::MoveViewer(FGridViewerHandle Viewer, FIntPoint Cell)
+{
+    FViewer* Entry = ResolveViewer(Viewer);
+    if (Entry && Entry->Cell != Cell)
+    {
+        Entry->Cell = Cell;
+        Entry->bDirty = true;
+        bAnyDirty = true;
+    }
+}
+
+void UGridVisibilitySubsystem::SetViewerSightRadius(FGridViewerHandle Viewer, int32 SightRadius)
+{
+    FViewer* Entry = ResolveViewer(Viewer);
+    SightRadius = FMath::Clamp(SightRadius, 0, 0xFFFF);
+    if (Entry && Entry->SightRadius != SightRadius)
+    {
+        Entry->SightRadius = SightRadius;
+        Entry->bDirty = true;
+        bAnyDirty = true;
+    }
+}
+
+void UGridVisibilitySubsystem::SetCellBlocker(FGridHandle Grid, FIntPoint Cell, float BlockerHeight)
+{
+    FGridState* State = FindOrAddGridState(Grid);
+    if (!State || Cell.X < 0 || Cell.Y < 0 || Cell.X >= State->Width || Cell.Y >= State->Height)
+    {
+        return;
+    }
+
+    BlockerHeight = FMath::Max(BlockerHeight, 0.f);
+    if (State->BlockerHeights.Num() == 0)
+    {
+        if (BlockerHeight == 0.f)
+        {
+            return;
+        }
+        State->BlockerHeights.SetNumZeroed(State->Width * State->Height);
+    }
+
+    float& Stored = State->BlockerHeights[Cell.Y * State->Width + Cell.X];
+    if (Stored != BlockerHeight)
+    {
+        Stored = BlockerHeight;
+        DirtyViewersInRegion(Grid, FIntRect(Cell, Cell + FIntPoint(1, 1)));
+    }
+}
+
+void UGridVisibilitySubsystem::NotifyTerrainChanged(FGridHandle Grid, const FIntRect& Region)
+{
+    DirtyViewersInRegion(Grid, Region);
+}
+
+void UGridVisibilitySubsystem::DirtyViewersInRegion(FGridHandle Grid, const FIntRect& Region)
+{
+    const FGridState* State = Grids.Find(Grid);
+    const EGridTopology Topology = State ? State->Topology : EGridTopology::Square4;
+
+    for (FViewer& Viewer : Viewers)
+    {
+        if (!Viewer.bAlive || Viewer.bDirty || Viewer.Grid != Grid)
+        {
+            continue;
+        }
+
+        // Same bounds as the field of view window: hex sight reaches past the square box.
+        const FIntPoint Extent = GridShadowcast::GetSightExtent(Topology, Viewer.SightRadius);
+        const FIntRect Range(Viewer.Cell - Extent, Viewer.Cell + Extent + FIntPoint(1, 1));
+        if (Range.Min.X < Region.Max.X && Region.Min.X < Range.Max.X &&
+            Range.Min.Y < Region.Max.Y && Region.Min.Y < Range.Max.Y)
+        {
+            Viewer.bDirty = true;
+            bAnyDirty = true;
+        }
+    }
+}
+
+void UGridVisibilitySubsystem::UpdateVisibility()
+{
+    if (!bAnyDirty)
+    {
+        return;
+    }
+    bAnyDirty = false;
+
+    GRID_QUERY_SCOPE(Visibility);
+
+    const UGridWorldSubsystem* GridWorld = GetWorld()->GetSubsystem<UGridWorldSubsystem>();
+
+    struct FJob
+    {
+        int32 ViewerId = INDEX_NONE;
+        const FGridConfig* Config = nullptr;
+        const float* CellHeights = nullptr;
+        const float* BlockerHeights = nullptr;
+        FGridCellMask NewMask;
+    };
+
+    // Game thread: collect the dirty viewers and everything they read.
+    TArray<FJob> Jobs;
+    for (int32 Id = 0; Id < Viewers.Num(); ++Id)
+    {
+        FViewer& Viewer = Viewers[Id];
+        if (!Viewer.bAlive || !Viewer.bDirty)
+        {
+            continue;
+        }
+        Viewer.bDirty = false;
+
+        FJob& Job = Jobs.AddDefaulted_GetRef();
+        Job.ViewerId = Id;
+        Job.Config = GridWorld ? GridWorld->GetGridConfig(Viewer.Grid) : nullptr;
+        if (!FindOrAddGridState(Viewer.Grid))
+        {
+            Job.Config = nullptr;
+        }
+    }
+
+    // The snapshots keep the height buffers alive until the jobs are done.
+    TMap<FGridHandle, FGridHeightSnapshotRef> Snapshots;
+    for (FJob& Job : Jobs)
+    {
+        if (!Job.Config)
+        {
+            continue;
+        }
+
+        const FViewer& Viewer = Viewers[Job.ViewerId];
+        const FGridState& State = Grids.FindChecked(Viewer.Grid);
+
+        FGridHeightSnapshotRef* Snapshot = Snapshots.Find(Viewer.Grid);
+        if (!Snapshot)
+        {
+            Snapshot = &Snapshots.Add(Viewer.Grid, GridWorld->AcquireHeightSnapshot(Viewer.Grid));
+        }
+
+        const FGridHeightSnapshot* Heights = Snapshot->GetReference();
+        if (Heights && Heights->GetWidth() == Job.Config->Width && Heights->GetHeight() == Job.Config->Height)
+        {
+            Job.CellHeights = Heights->GetCellHeights().GetData();
+        }
+        Job.BlockerHeights = State.BlockerHeights.Num() > 0 ? State.BlockerHeights.GetData() : nullptr;
+    }
+
+    ParallelFor(Jobs.Num(), [this, &Jobs](int32 JobIndex)
+    {
+        FJob& Job = Jobs[JobIndex];
+        if (Job.Config)
+        {
+            const FViewer& Viewer = Viewers[Job.ViewerId];
+            GridShadowcast::ComputeFieldOfView(*Job.Config, Viewer.Cell, Viewer.SightRadius, Viewer.EyeHeight,
+                Job.CellHeights, Job.BlockerHeights, Job.NewMask);
+        }
+    });
+
+    // Game thread: apply only the cells that entered or left each view.
+    TSet<TPair<FGridHandle, int32>> ChangedFactions;
+    for (FJob& Job : Jobs)
+    {
+        FViewer& Viewer = Viewers[Job.ViewerId];
+        FGridState* State = Grids.Find(Viewer.Grid);
+        if (!State)
+        {
+            Viewer.Mask = MoveTemp(Job.NewMask);
+            continue;
+        }
+
+        TArray<uint16>& Counts = State->FactionCounts.FindOrAdd(Viewer.Faction);
+        if (Counts.Num() != State->Width * State->Height)
+        {
+            Counts.SetNumZeroed(State->Width * State->Height);
+        }
+
+        bool bChanged = false;
+        FGridCellMask::ForEachDifference(Viewer.Mask, Job.NewMask, [&](const FIntPoint& Cell, bool bNowVisible)
+        {
+            uint16& Count = Counts[Cell.Y * State->Width + Cell.X];
+            if (bNowVisible)
+            {
+                bChanged |= (Count++ == 0);
+            }
+            else
+            {
+                bChanged |= (--Count == 0);
+            }
+        });
+
+        Viewer.Mask = MoveTemp(Job.NewMask);
+        if (bChanged)
+        {
+            ChangedFactions.Add(TPair<FGridHandle, int32>(Viewer.Grid, Viewer.Faction));
+        }
+    }
+
+    for (const TPair<FGridHandle, int32>& Changed : ChangedFactions)
+    {
+        OnVisibilityChanged.Broadcast(Changed.Key, Changed.Value);
+    }
+}
+
+bool UGridVisibilitySubsystem::IsCellVisible(FGridHandle Grid, int32 Faction, FIntPoint Cell) const
+{
+    const FGridState* State = Grids.Find(Grid);
+    const TArray<uint16>* Counts = State ? State->FactionCounts.Find(Faction) : nullptr;
+    if (!Counts || Cell.X < 0 || Cell.Y < 0 || Cell.X >= State->Width || Cell.Y >= State->Height)
+    {
+        return false;
+    }
+    return (*Counts)[Cell.Y * State->Width + Cell.X] > 0;
+}
+
+TArray<FIntPoint> UGridVisibilitySubsystem::GetVisibleCells(FGridHandle Grid, int32 Faction) const
+{
+    TArray<FIntPoint> Result;
+
+    const FGridState* State = Grids.Find(Grid);
+    const TArray<uint16>* Counts = State ? State->FactionCounts.Find(Faction) : nullptr;
+    if (!Counts)
+    {
+        return Result;
+    }
+
+    for (int32 Index = 0; Index < Counts->Num(); ++Index)
+    {
+        if ((*Counts)[Index] > 0)
+        {
+            Result.Add(FIntPoint(Index % State->Width, Index / State->Width));
+        }
+    }
+    return Result;
+}
+
+const FGridCellMask* UGridVisibilitySubsystem::GetViewerMask(FGridViewerHandle Viewer) const
+{
+    const FViewer* Entry = ResolveViewer(Viewer);
+    return Entry ? &Entry->Mask : nullptr;
+}
+
+void UGridVisibilitySubsystem::Tick(float DeltaTime)
+{
+    UpdateVisibility();
+}
+
+TStatId UGridVisibilitySubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UGridVisibilitySubsystem, STATGROUP_Tickables);
+}
+
+void UGridVisibilitySubsystem::Deinitialize()
+{
+    for (TPair<FGridHandle, FGridState>& Pair : Grids)
+    {
+        if (UHeightMapGridBindingComponent* Component = Pair.Value.Component.Get())
+        {
+            Component->OnGridConfigChangedNative.Remove(Pair.Value.ConfigChangedHandle);
+        }
+    }
+
+    Grids.Reset();
+    Viewers.Reset();
+    FreeViewerIds.Reset();
+
+    Super::Deinitialize();
+}
+
+UGridVisibilitySubsystem::FGridState* UGridVisibilitySubsystem::FindOrAddGridState(FGridHandle Grid)
+{
+    if (FGridState* Existing = Grids.Find(Grid))
+    {
+        return Existing;
+    }
+
+    const UGridWorldSubsystem* GridWorld = GetWorld()->GetSubsystem<UGridWorldSubsystem>();
+    UHeightMapGridBindingComponent* Component = GridWorld ? GridWorld->GetGridComponent(Grid) : nullptr;
+    if (!Component)
+    {
+        return nullptr;
+    }
+
+    FGridState& State = Grids.Add(Grid);
+    State.Component = Component;
+    State.Width = Component->GridConfig.Width;
+    State.Height = Component->GridConfig.Height;
+    State.Topology = Component->GridConfig.Topology;
+    State.ConfigChangedHandle = Component->OnGridConfigChangedNative.AddUObject(this, &UGridVisibilitySubsystem::OnGridConfigChanged);
+    return &State;
+}
+
+void UGridVisibilitySubsystem::OnGridConfigChanged(UHeightMapGridBindingComponent* Component, EGridConfigChange ChangedParts)
+{
+    const FGridHandle Grid = Component->GetGridHandle();
+    FGridState* State = Grids.Find(Grid);
+    if (!State)
+    {
+        return;
+    }
+
+    State->Topology = Component->GridConfig.Topology;
+
+    const bool bResized = EnumHasAnyFlags(ChangedParts, EGridConfigChange::Dimensions);
+    if (bResized)
+    {
+        // Cell indices are meaningless now: start every view and count from scratch.
+        State->Width = Component->GridConfig.Width;
+        State->Height = Component->GridConfig.Height;
+        State->BlockerHeights.Reset();
+        State->FactionCounts.Reset();
+    }
+
+    for (FViewer& Viewer : Viewers)
+    {
+        if (Viewer.bAlive && Viewer.Grid == Grid)
+        {
+            if (bResized)
+            {
+                Viewer.Mask.Empty();
+            }
+            Viewer.bDirty = true;
+            bAnyDirty = true;
+        }
+    }
+}
+
+void UGridVisibilitySubsystem::ApplyMask(FGridState& State, int32 Faction, const FGridCellMask& Mask, int32 Delta, bool& bOutChanged)
+{
+    TArray<uint16>* Counts = State.FactionCounts.Find(Faction);
+    if (!Counts || Counts->Num() != State.Width * State.Height)
+    {
+        return;
+    }
+
+    Mask.ForEachSetCell([&](const FIntPoint& Cell)
+    {
+        uint16& Count = (*Counts)[Cell.Y * State.Width + Cell.X];
+        if (Delta > 0)
+        {
+            bOutChanged |= (Count++ == 0);
+        }
+        else
+        {
+            bOutChanged |= (--Count == 0);
+        }
+    });
+}
+
+UGridVisibilitySubsystem::FViewer* UGridVisibilitySubsystem::ResolveViewer(FGridViewerHandle Viewer)
+{
+    if (!Viewers.IsValidIndex(Viewer.Id))
+    {
+        return nullptr;
+    }
+
+    FViewer& Entry = Viewers[Viewer.Id];
+    return Entry.bAlive && Entry.Serial == Viewer.Serial ? &Entry : nullptr;
+}
+
+const UGridVisibilitySubsystem::FViewer* UGridVisibilitySubsystem::ResolveViewer(FGridViewerHandle Viewer) const
+{
+    if (!Viewers.IsValidIndex(Viewer.Id))
+    {
+        return nullptr;
+    }
+
+    const FViewer& Entry = Viewers[Viewer.Id];
+    return Entry.bAlive && Entry.Serial == Viewer.Serial ? &Entry : nullptr;
+}
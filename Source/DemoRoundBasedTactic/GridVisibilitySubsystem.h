@@ -0,0 +1,162 @@
+// GridVisibilitySubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GridCellMask.h"
+#include "GridTypes.h"
+#include "GridWorldSubsystem.h"
+#include "GridVisibilitySubsystem.generated.h"
+
+class UHeightMapGridBindingComponent;
+
+/** Handle to a viewer (unit) registered with UGridVisibilitySubsystem. */
+USTRUCT(BlueprintType)
+struct FGridViewerHandle
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    int32 Id = INDEX_NONE;
+
+    UPROPERTY()
+    int32 Serial = 0;
+
+    bool IsSet() const { return Id != INDEX_NONE; }
+};
+
+/** Fired after UpdateVisibility when the visible set of a faction on a grid changed. */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnGridVisibilityChanged, FGridHandle /*Grid*/, int32 /*Faction*/);
+
+/**
+ * Incremental fog of war over height-bound grids.
+ *
+ * Every viewer (unit) owns its field of view as an FGridCellMask around its cell.
+ * Viewers are only recomputed when they are dirty: they moved, their sight radius
+ * changed, a sight blocker appeared / disappeared within their radius, or the terrain
+ * of their grid changed. Each faction keeps a per-cell reference count of the viewers
+ * that see the cell, so applying a recomputed view only touches the cells that
+ * entered or left it, and a cell is visible to a faction while its count is non-zero.
+ *
+ * Field of view uses height-aware shadowcasting from the viewer's eye (see GridShadowcast)
+ * with cell blockers as extra height; the per-radius visiting order is shared by all viewers.
+ *
+ * Dirty viewers are recomputed in parallel against the grid's immutable height snapshot.
+ * Per-faction counts take 2 bytes per cell of the grid.
+ */
+UCLASS()
+class DEMOROUNDBASEDTACTIC_API UGridVisibilitySubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    /**
+     * Register a viewer.
+     *
+     * @param SightRadius Radius in cells (centre-to-centre distance in cell units).
+     * @param EyeHeight   Eye height above the ground; negative uses the grid's DefaultEyeHeight.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Visibility")
+    FGridViewerHandle AddViewer(FGridHandle Grid, int32 Faction, FIntPoint Cell, int32 SightRadius, float EyeHeight = -1.f);
+
+    UFUNCTION(BlueprintCallable, Category = "Grid|Visibility")
+    void RemoveViewer(FGridViewerHandle Viewer);
+
+    /** Move a viewer; only marks it dirty if the cell actually changed. */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Visibility")
+    void MoveViewer(FGridViewerHandle Viewer, FIntPoint Cell);
+
+    UFUNCTION(BlueprintCallable, Category = "Grid|Visibility")
+    void SetViewerSightRadius(FGridViewerHandle Viewer, int32 SightRadius);
+
+    /**
+     * Place (BlockerHeight > 0) or remove (0) a sight blocker on a cell, e.g. an occupying
+     * unit or a wall. Only viewers within sight range of the cell are recomputed.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Visibility")
+    void SetCellBlocker(FGridHandle Grid, FIntPoint Cell, float BlockerHeight);
+
+    /**
+     * Heights inside Region (half-open, grid coordinates) changed without a full grid rebuild.
+     * Viewers whose sight range overlaps the region are recomputed.
+     */
+    void NotifyTerrainChanged(FGridHandle Grid, const FIntRect& Region);
+
+    /** Recompute all dirty viewers now. Also done automatically once per frame. */
+    UFUNCTION(BlueprintCallable, Category = "Grid|Visibility")
+    void UpdateVisibility();
+
+    /** True if at least one viewer of Faction sees Cell (as of the last update). */
+    UFUNCTION(BlueprintPure, Category = "Grid|Visibility")
+    bool IsCellVisible(FGridHandle Grid, int32 Faction, FIntPoint Cell) const;
+
+    /** Every cell currently visible to Faction on Grid. */
+    UFUNCTION(BlueprintPure, Category = "Grid|Visibility")
+    TArray<FIntPoint> GetVisibleCells(FGridHandle Grid, int32 Faction) const;
+
+    /** Field of view of one viewer, or null for a stale handle. */
+    const FGridCellMask* GetViewerMask(FGridViewerHandle Viewer) const;
+
+    /** Broadcast from UpdateVisibility once per (grid, faction) whose visible set changed. */
+    FOnGridVisibilityChanged OnVisibilityChanged;
+
+    // UTickableWorldSubsystem
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual void Deinitialize() override;
+
+private:
+    struct FViewer
+    {
+        FGridHandle Grid;
+        int32 Faction = 0;
+        FIntPoint Cell = FIntPoint::ZeroValue;
+        int32 SightRadius = 0;
+        float EyeHeight = -1.f;
+
+        /** Current field of view; its cells are counted in the faction's counts. */
+        FGridCellMask Mask;
+
+        /** Bumped when the slot is freed so handles to a removed viewer stop resolving. */
+        int32 Serial = 0;
+
+        bool bAlive = false;
+        bool bDirty = false;
+    };
+
+    struct FGridState
+    {
+        TWeakObjectPtr<UHeightMapGridBindingComponent> Component;
+        FDelegateHandle ConfigChangedHandle;
+        int32 Width = 0;
+        int32 Height = 0;
+        EGridTopology Topology = EGridTopology::Square4;
+
+        /** Blocker height per cell (row-major); empty until the first blocker is placed. */
+        TArray<float> BlockerHeights;
+
+        /** Per faction: number of viewers that see each cell (row-major). */
+        TMap<int32, TArray<uint16>> FactionCounts;
+    };
+
+    FGridState* FindOrAddGridState(FGridHandle Grid);
+    void OnGridConfigChanged(UHeightMapGridBindingComponent* Component, EGridConfigChange ChangedParts);
+
+    /** Mark viewers on Grid whose sight range overlaps Region (half-open) dirty. */
+    void DirtyViewersInRegion(FGridHandle Grid, const FIntRect& Region);
+
+    /** Add (Delta = +1) or remove (-1) every cell of Mask to / from the faction's counts. */
+    static void ApplyMask(FGridState& State, int32 Faction, const FGridCellMask& Mask, int32 Delta, bool& bOutChanged);
+
+    FViewer* ResolveViewer(FGridViewerHandle Viewer);
+    const FViewer* ResolveViewer(FGridViewerHandle Viewer) const;
+
+    TArray<FViewer> Viewers;
+    TArray<int32> FreeViewerIds;
+    TMap<FGridHandle, FGridState> Grids;
+    bool bAnyDirty = false;
+};
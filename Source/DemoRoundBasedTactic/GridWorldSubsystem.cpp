@@ -0,0 +1,318 @@
+// GridWorldSubsystem.cpp
+
+#include "GridWorldSubsystem.h"
+#include "GridGeometryLibrary.h"
+#include "HeightMapGridBindingComponent.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+UGridWorldSubsystem* UGridWorldSubsystem::Get(const UObject* WorldContextObject)
+{
+    const UWorld* World = GEngine
+        ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull)
+        : nullptr;
+
+    return World ? World->GetSubsystem<UGridWorldSubsystem>() : nullptr;
+}
+
+void UGridWorldSubsystem::Deinitialize()
+{
+    Slots.Reset();
+    FreeSlots.Reset();
+    Bounds.Reset();
+
+    Super::Deinitialize();
+}
+
+FGridHandle UGridWorldSubsystem::RegisterGrid(UHeightMapGridBindingComponent* Component)
+{
+    if (!Component)
+    {
+        return FGridHandle{};
+    }
+
+    int32 SlotIndex = INDEX_NONE;
+    if (FreeSlots.Num() > 0)
+    {
+        SlotIndex = FreeSlots.Pop(EAllowShrinking::No);
+    }
+    else
+    {
+        SlotIndex = Slots.AddDefaulted();
+    }
+
+    FGridSlot& Slot = Slots[SlotIndex];
+    Slot.Component = Component;
+    Slot.Config = &Component->GridConfig;
+    Slot.Serial = NextSerial++;
+
+    FGridHandle Handle;
+    Handle.Index = SlotIndex;
+    Handle.Serial = Slot.Serial;
+
+    RefreshGrid(Handle);
+    return Handle;
+}
+
+void UGridWorldSubsystem::UnregisterGrid(FGridHandle Handle)
+{
+    if (!ResolveSlot(Handle))
+    {
+        return;
+    }
+
+    RemoveBounds(Handle.Index);
+
+    FGridSlot& Slot = Slots[Handle.Index];
+    Slot = FGridSlot{};
+    FreeSlots.Add(Handle.Index);
+}
+
+void UGridWorldSubsystem::RefreshGrid(FGridHandle Handle)
+{
+    const FGridSlot* Slot = ResolveSlot(Handle);
+    if (!Slot)
+    {
+        return;
+    }
+
+    RemoveBounds(Handle.Index);
+
+    const FGridConfig& Config = *Slot->Config;
+    if (Config.Width <= 0 || Config.Height <= 0)
+    {
+        return;
+    }
+
+    // Lateral extent: the four corner cell centres grown by one cell covers every topology.
+    FBox Box(ForceInit);
+    const FIntPoint Corners[4] =
+    {
+        FIntPoint(0, 0),
+        FIntPoint(Config.Width - 1, 0),
+        FIntPoint(0, Config.Height - 1),
+        FIntPoint(Config.Width - 1, Config.Height - 1)
+    };
+    for (const FIntPoint& Corner : Corners)
+    {
+        Box += UGridGeometryLibrary::GridToWorldGround(Config, Corner);
+    }
+
+    // Vertical extent: one pass over the heights, only on (rare) rebuilds.
+    float MinZ = Config.GridOrigin.Z;
+    float MaxZ = Config.GridOrigin.Z;
+    if (Config.HeightProvider.IsValid())
+    {
+        MinZ = MAX_flt;
+        MaxZ = -MAX_flt;
+        for (int32 Y = 0; Y < Config.Height; ++Y)
+        {
+            for (int32 X = 0; X < Config.Width; ++X)
+            {
+                const float Z = Config.HeightProvider->GetHeightAt(X, Y);
+                MinZ = FMath::Min(MinZ, Z);
+                MaxZ = FMath::Max(MaxZ, Z);
+            }
+        }
+    }
+
+    Box.Min.Z = MinZ;
+    Box.Max.Z = MaxZ;
+    Box = Box.ExpandBy(FVector(Config.CellSize, Config.CellSize, 0.f));
+
+    FGridBounds& Entry = Bounds.AddDefaulted_GetRef();
+    Entry.Box = Box;
+    Entry.SlotIndex = Handle.Index;
+}
+
+const FGridConfig* UGridWorldSubsystem::GetGridConfig(FGridHandle Handle) const
+{
+    const FGridSlot* Slot = ResolveSlot(Handle);
+    return Slot ? Slot->Config : nullptr;
+}
+
+FGridHeightSnapshotRef UGridWorldSubsystem::AcquireHeightSnapshot(FGridHandle Handle) const
+{
+    const UHeightMapGridBindingComponent* Component = GetGridComponent(Handle);
+    return Component ? Component->AcquireHeightSnapshot() : FGridHeightSnapshotRef();
+}
+
+bool UGridWorldSubsystem::IsValidGrid(FGridHandle Handle) const
+{
+    return ResolveSlot(Handle) != nullptr;
+}
+
+UHeightMapGridBindingComponent* UGridWorldSubsystem::GetGridComponent(FGridHandle Handle) const
+{
+    const FGridSlot* Slot = ResolveSlot(Handle);
+    return Slot ? Slot->Component.Get() : nullptr;
+}
+
+TArray<FGridHandle> UGridWorldSubsystem::GetAllGrids() const
+{
+    TArray<FGridHandle> Result;
+    Result.Reserve(Bounds.Num());
+
+    for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); ++SlotIndex)
+    {
+        if (Slots[SlotIndex].Config)
+        {
+            FGridHandle& Handle = Result.AddDefaulted_GetRef();
+            Handle.Index = SlotIndex;
+            Handle.Serial = Slots[SlotIndex].Serial;
+        }
+    }
+
+    return Result;
+}
+
+FGridHandle UGridWorldSubsystem::FindGridAtLocation(const FVector& WorldPosition, float FloorTolerance) const
+{
+    FGridHandle Best;
+    float BestBelowZ = -MAX_flt;
+    float BestAboveZ = MAX_flt;
+    bool bFoundBelow = false;
+
+    const FVector2D Position2D(WorldPosition);
+
+    for (const FGridBounds& Entry : Bounds)
+    {
+        // Cheap lateral reject first; the vertical test is done against the actual floor below.
+        if (Position2D.X < Entry.Box.Min.X || Position2D.X > Entry.Box.Max.X ||
+            Position2D.Y < Entry.Box.Min.Y || Position2D.Y > Entry.Box.Max.Y)
+        {
+            continue;
+        }
+
+        const FGridSlot& Slot = Slots[Entry.SlotIndex];
+        const FGridConfig& Config = *Slot.Config;
+
+        FIntPoint Cell;
+        if (!UGridGeometryLibrary::WorldToGrid(Config, WorldPosition, Cell, false))
+        {
+            continue;
+        }
+
+        const float GroundZ = Config.HeightProvider.IsValid()
+            ? Config.HeightProvider->GetHeightAt(Cell.X, Cell.Y)
+            : Config.GridOrigin.Z;
+
+        FGridHandle Candidate;
+        Candidate.Index = Entry.SlotIndex;
+        Candidate.Serial = Slot.Serial;
+
+        if (GroundZ <= WorldPosition.Z + FloorTolerance)
+        {
+            if (GroundZ > BestBelowZ)
+            {
+                BestBelowZ = GroundZ;
+                Best = Candidate;
+                bFoundBelow = true;
+            }
+        }
+        else if (!bFoundBelow && GroundZ < BestAboveZ)
+        {
+            BestAboveZ = GroundZ;
+            Best = Candidate;
+        }
+    }
+
+    return Best;
+}
+
+FVector UGridWorldSubsystem::GridToWorldGround(FGridHandle Handle, FIntPoint GridCoord) const
+{
+    const FGridConfig* Config = GetGridConfig(Handle);
+    return Config ? UGridGeometryLibrary::GridToWorldGround(*Config, GridCoord) : FVector::ZeroVector;
+}
+
+FVector UGridWorldSubsystem::GridToWorldEye(FGridHandle Handle, FIntPoint GridCoord) const
+{
+    const FGridConfig* Config = GetGridConfig(Handle);
+    return Config ? UGridGeometryLibrary::GridToWorldEye(*Config, GridCoord) : FVector::ZeroVector;
+}
+
+bool UGridWorldSubsystem::WorldToGrid(
+    FGridHandle Handle,
+    const FVector& WorldPosition,
+    FIntPoint& OutGrid,
+    bool bClampToBounds,
+    EGridRoundingPolicy Rounding
+) const
+{
+    const FGridConfig* Config = GetGridConfig(Handle);
+    if (!Config)
+    {
+        OutGrid = FIntPoint(-1, -1);
+        return false;
+    }
+
+    return UGridGeometryLibrary::WorldToGrid(*Config, WorldPosition, OutGrid, bClampToBounds, Rounding);
+}
+
+bool UGridWorldSubsystem::RaycastGrids(
+    const FVector& RayOrigin,
+    const FVector& RayDirection,
+    float MaxDistance,
+    FGridHandle& OutHandle,
+    FIntPoint& OutGrid,
+    FVector& OutHitPoint
+) const
+{
+    OutHandle = FGridHandle{};
+    OutGrid = FIntPoint(-1, -1);
+    OutHitPoint = FVector::ZeroVector;
+
+    float BestDistance = MaxDistance;
+    bool bHit = false;
+
+    for (const FGridBounds& Entry : Bounds)
+    {
+        const FGridSlot& Slot = Slots[Entry.SlotIndex];
+
+        FIntPoint Cell;
+        FVector HitPoint;
+        if (UGridGeometryLibrary::RaycastHeightField(*Slot.Config, RayOrigin, RayDirection, BestDistance, Cell, HitPoint))
+        {
+            // Later grids only need to search up to the closest hit found so far.
+            BestDistance = FVector::Dist(RayOrigin, HitPoint);
+            OutHandle.Index = Entry.SlotIndex;
+            OutHandle.Serial = Slot.Serial;
+            OutGrid = Cell;
+            OutHitPoint = HitPoint;
+            bHit = true;
+        }
+    }
+
+    return bHit;
+}
+
+const UGridWorldSubsystem::FGridSlot* UGridWorldSubsystem::ResolveSlot(FGridHandle Handle) const
+{
+    if (!Slots.IsValidIndex(Handle.Index))
+    {
+        return nullptr;
+    }
+
+    const FGridSlot& Slot = Slots[Handle.Index];
+    if (Slot.Config == nullptr || Slot.Serial != Handle.Serial)
+    {
+        return nullptr;
+    }
+
+    return &Slot;
+}
+
+void UGridWorldSubsystem::RemoveBounds(int32 SlotIndex)
+{
+    const int32 EntryIndex = Bounds.IndexOfByPredicate([SlotIndex](const FGridBounds& Entry)
+    {
+        return Entry.SlotIndex == SlotIndex;
+    });
+
+    if (EntryIndex != INDEX_NONE)
+    {
+        Bounds.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+    }
+}
@@ -0,0 +1,171 @@
+// GridWorldSubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GridTypes.h"
+#include "GridHeightField.h"
+#include "GridWorldSubsystem.generated.h"
+
+class UHeightMapGridBindingComponent;
+
+/**
+ * Small value handle that identifies a grid registered with UGridWorldSubsystem.
+ *
+ * Handles are cheap to copy and never keep the grid alive. A handle becomes
+ * stale once its grid is unregistered; the serial number makes sure a reused
+ * slot is never mistaken for the old grid.
+ */
+USTRUCT(BlueprintType)
+struct FGridHandle
+{
+    GENERATED_BODY()
+
+    /** Slot index inside the subsystem registry, or INDEX_NONE. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid")
+    int32 Index = INDEX_NONE;
+
+    /** Registration serial of the slot at the time the handle was issued. */
+    UPROPERTY()
+    int32 Serial = 0;
+
+    bool IsSet() const { return Index != INDEX_NONE; }
+
+    bool operator==(const FGridHandle& Other) const { return Index == Other.Index && Serial == Other.Serial; }
+    bool operator!=(const FGridHandle& Other) const { return !(*this == Other); }
+
+    friend uint32 GetTypeHash(const FGridHandle& Handle) { return HashCombine(::GetTypeHash(Handle.Index), ::GetTypeHash(Handle.Serial)); }
+};
+
+/**
+ * Per-world registry of every UHeightMapGridBindingComponent.
+ *
+ * Grids register themselves when their component is registered and are addressed
+ * through FGridHandle afterwards. Geometry queries on the subsystem read the
+ * component's FGridConfig in place, so unlike UHeightMapGridBindingComponent::GetGridConfig
+ * they never copy the struct or touch the HeightProvider reference count.
+ *
+ * Several grids per level are supported (multiple battlefields, stacked floors);
+ * FindGridAtLocation resolves a world position to the grid underneath it.
+ */
+UCLASS()
+class DEMOROUNDBASEDTACTIC_API UGridWorldSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+
+    /** Register a grid component and return its handle. Called by the component itself. */
+    FGridHandle RegisterGrid(UHeightMapGridBindingComponent* Component);
+
+    /** Remove a grid from the registry. Stale or unset handles are ignored. */
+    void UnregisterGrid(FGridHandle Handle);
+
+    /** Recompute the cached world bounds of a grid after its config was rebuilt. */
+    void RefreshGrid(FGridHandle Handle);
+
+    /**
+     * Native access to a registered grid's config, without copying.
+     * The pointer stays valid until the grid is unregistered; do not cache it across frames.
+     */
+    const FGridConfig* GetGridConfig(FGridHandle Handle) const;
+
+    /**
+     * Immutable height snapshot of a grid, or null for a stale handle / flat grid.
+     * Must be called on the game thread; the returned snapshot may then be read from any thread.
+     */
+    FGridHeightSnapshotRef AcquireHeightSnapshot(FGridHandle Handle) const;
+
+    /** True if the handle refers to a currently registered grid. */
+    UFUNCTION(BlueprintPure, Category = "Grid|World")
+    bool IsValidGrid(FGridHandle Handle) const;
+
+    /** Component that owns the grid, or nullptr for a stale handle. */
+    UFUNCTION(BlueprintPure, Category = "Grid|World")
+    UHeightMapGridBindingComponent* GetGridComponent(FGridHandle Handle) const;
+
+    /** Handles of all registered grids. */
+    UFUNCTION(BlueprintPure, Category = "Grid|World")
+    TArray<FGridHandle> GetAllGrids() const;
+
+    /**
+     * Find the grid underneath a world position.
+     *
+     * When several grids overlap in XY (stacked floors), the grid whose ground at that
+     * position is the highest one not above WorldPosition.Z + FloorTolerance wins;
+     * if every candidate floor is above the position, the lowest one is returned.
+     *
+     * @return The grid handle, or an unset handle if no grid covers the position.
+     */
+    UFUNCTION(BlueprintPure, Category = "Grid|World")
+    FGridHandle FindGridAtLocation(const FVector& WorldPosition, float FloorTolerance = 50.f) const;
+
+    /** Handle-based UGridGeometryLibrary::GridToWorldGround. Returns ZeroVector for a stale handle. */
+    UFUNCTION(BlueprintPure, Category = "Grid|World")
+    FVector GridToWorldGround(FGridHandle Handle, FIntPoint GridCoord) const;
+
+    /** Handle-based UGridGeometryLibrary::GridToWorldEye. Returns ZeroVector for a stale handle. */
+    UFUNCTION(BlueprintPure, Category = "Grid|World")
+    FVector GridToWorldEye(FGridHandle Handle, FIntPoint GridCoord) const;
+
+    /** Handle-based UGridGeometryLibrary::WorldToGrid. Returns false for a stale handle. */
+    UFUNCTION(BlueprintPure, Category = "Grid|World")
+    bool WorldToGrid(
+        FGridHandle Handle,
+        const FVector& WorldPosition,
+        FIntPoint& OutGrid,
+        bool bClampToBounds,
+        EGridRoundingPolicy Rounding = EGridRoundingPolicy::Floor
+    ) const;
+
+    /**
+     * Ray-pick against every registered grid and return the nearest hit.
+     * See UGridGeometryLibrary::RaycastHeightField.
+     */
+    UFUNCTION(BlueprintPure, Category = "Grid|World")
+    bool RaycastGrids(
+        const FVector& RayOrigin,
+        const FVector& RayDirection,
+        float MaxDistance,
+        FGridHandle& OutHandle,
+        FIntPoint& OutGrid,
+        FVector& OutHitPoint
+    ) const;
+
+    /** Subsystem of the world that owns WorldContextObject, or nullptr. */
+    static UGridWorldSubsystem* Get(const UObject* WorldContextObject);
+
+protected:
+    virtual void Deinitialize() override;
+
+private:
+    struct FGridSlot
+    {
+        TWeakObjectPtr<UHeightMapGridBindingComponent> Component;
+
+        /** Points into the component; valid while the slot is registered. */
+        const FGridConfig* Config = nullptr;
+
+        int32 Serial = 0;
+    };
+
+    /**
+     * Packed bounds used by FindGridAtLocation. Kept separate from the slots so
+     * the lookup only streams through a few small structs.
+     */
+    struct FGridBounds
+    {
+        FBox Box;
+        int32 SlotIndex = INDEX_NONE;
+    };
+
+    const FGridSlot* ResolveSlot(FGridHandle Handle) const;
+
+    void RemoveBounds(int32 SlotIndex);
+
+    TArray<FGridSlot> Slots;
+    TArray<int32> FreeSlots;
+    TArray<FGridBounds> Bounds;
+    int32 NextSerial = 1;
+};
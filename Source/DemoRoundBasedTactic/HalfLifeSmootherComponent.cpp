@@ -1,19 +1,28 @@
 #include "HalfLifeSmootherComponent.h"
 #include "Math/UnrealMathUtility.h"
+#include "SmoothingMath.h"
+#include "Engine/World.h"
 
 
-static FORCEINLINE float ExpSmoothHL_Component(float Current, float Desire, float HalfLife, float dt)
+UHalfLifeSmootherComponent::UHalfLifeSmootherComponent()
 {
-	if (HalfLife <= SMALL_NUMBER) return Desire;
-	const float Lambda = 0.6931471805599453f / HalfLife; // ln(2)/T
-	const float OneMinusS = 1.f - FMath::Exp(-Lambda * FMath::Max(0.f, dt));
-	return Current + (Desire - Current) * OneMinusS;
+	PrimaryComponentTick.bCanEverTick = false; // Call Update(dt) from BP or C++ Tick
 }
 
 
-UHalfLifeSmootherComponent::UHalfLifeSmootherComponent()
+void UHalfLifeSmootherComponent::BeginPlay()
 {
-	PrimaryComponentTick.bCanEverTick = false; // Call Update(dt) from BP or C++ Tick
+	Super::BeginPlay();
+
+	UHalfLifeSmoothingSubsystem::RegisterBatched(this, BatchHandle);
+}
+
+
+void UHalfLifeSmootherComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UHalfLifeSmoothingSubsystem::UnregisterBatched(this, BatchHandle);
+
+	Super::EndPlay(EndPlayReason);
 }
 
 
@@ -36,7 +45,7 @@ float UHalfLifeSmootherComponent::Update(float DeltaTime)
 		Desire = FMath::Clamp(Desire, MinValue, MaxValue);
 		Current = FMath::Clamp(Current, MinValue, MaxValue);
 	}
-	Current = ExpSmoothHL_Component(Current, Desire, HalfLife, DeltaTime);
+	Current = SmoothingMath::ExpSmoothHL(Current, Desire, HalfLife, DeltaTime);
 	if (bClamp) Current = FMath::Clamp(Current, MinValue, MaxValue);
 	return Current;
 }
\ No newline at end of file
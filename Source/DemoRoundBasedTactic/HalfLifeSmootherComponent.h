@@ -1,5 +1,6 @@
 #pragma once
 #include "Components/ActorComponent.h"
+#include "HalfLifeSmoothingSubsystem.h"
 #include "HalfLifeSmootherComponent.generated.h"
 
 
@@ -16,6 +17,9 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Smoothing") float MaxValue = 1000.f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Smoothing") bool bClamp = true;
 
+	// Opt-in: advanced once per frame by UHalfLifeSmoothingSubsystem (after actor ticks) instead of by Update calls
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Smoothing") bool bUseBatchedUpdate = false;
+
 
 	UHalfLifeSmootherComponent();
 
@@ -23,4 +27,16 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Smoothing") void SetDesire(float NewDesire);
 	UFUNCTION(BlueprintCallable, Category = "Smoothing") void SetCurrent(float NewCurrent);
 	UFUNCTION(BlueprintCallable, Category = "Smoothing") float Update(float DeltaTime); // returns Current
+
+	// Handle in UHalfLifeSmoothingSubsystem while bUseBatchedUpdate is active (for GetSmoothedValue)
+	UFUNCTION(BlueprintPure, Category = "Smoothing") FHalfLifeSmootherHandle GetBatchHandle() const { return BatchHandle; }
+
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+
+private:
+	FHalfLifeSmootherHandle BatchHandle;
 };
\ No newline at end of file
@@ -0,0 +1,414 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HalfLifeSmoothingSubsystem.h"
+#include "CameraMovementSmoothing_Components.h"
+#include "HalfLifeSmootherComponent.h"
+#include "SmoothingMath.h"
+#include "Engine/World.h"
+
+
+UHalfLifeSmoothingSubsystem* UHalfLifeSmoothingSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UHalfLifeSmoothingSubsystem>() : nullptr;
+}
+
+
+void UHalfLifeSmoothingSubsystem::UnregisterBatched(const UObject* Smoother, FHalfLifeSmootherHandle& Handle)
+{
+	if (!Handle.IsValid()) return;
+	if (UHalfLifeSmoothingSubsystem* Batch = Get(Smoother))
+	{
+		Batch->UnregisterSmoother(Handle);
+	}
+	Handle = FHalfLifeSmootherHandle{};
+}
+
+
+FHalfLifeSmootherHandle UHalfLifeSmoothingSubsystem::RegisterSmoother(UHalfLifeSmootherComponent* Smoother)
+{
+	if (!Smoother) return FHalfLifeSmootherHandle{};
+
+	FLaneBinding Lane;
+	Lane.CurrentF = &Smoother->Current;
+	Lane.DesireF = &Smoother->Desire;
+	Lane.ClampEnabled = &Smoother->bClamp;
+	Lane.ClampMin = &Smoother->MinValue;
+	Lane.ClampMax = &Smoother->MaxValue;
+
+	return AddHandle(Smoother, &Smoother->HalfLife, ELaneModel::Exp, MakeArrayView(&Lane, 1));
+}
+
+
+FHalfLifeSmootherHandle UHalfLifeSmoothingSubsystem::RegisterSmoother(UCameraMovement_ExpHalfLifeComponent* Smoother)
+{
+	if (!Smoother) return FHalfLifeSmootherHandle{};
+
+	FLaneBinding Lanes[3];
+	Lanes[0].CurrentF = &Smoother->Current1D;
+	Lanes[0].DesireF = &Smoother->Desire1D;
+	Lanes[1].CurrentD = &Smoother->Current2D.X;
+	Lanes[1].DesireD = &Smoother->Desire2D.X;
+	Lanes[2].CurrentD = &Smoother->Current2D.Y;
+	Lanes[2].DesireD = &Smoother->Desire2D.Y;
+
+	return AddHandle(Smoother, &Smoother->HalfLife, ELaneModel::Exp, Lanes);
+}
+
+
+FHalfLifeSmootherHandle UHalfLifeSmoothingSubsystem::RegisterSmoother(UCameraMovement_SpringHalfLifeComponent* Smoother)
+{
+	if (!Smoother) return FHalfLifeSmootherHandle{};
+
+	FLaneBinding Lanes[3];
+	Lanes[0].CurrentF = &Smoother->Current1D;
+	Lanes[0].DesireF = &Smoother->Desire1D;
+	Lanes[0].VelocityF = &Smoother->Velocity1D;
+	Lanes[1].CurrentD = &Smoother->Current2D.X;
+	Lanes[1].DesireD = &Smoother->Desire2D.X;
+	Lanes[1].VelocityD = &Smoother->Velocity2D.X;
+	Lanes[2].CurrentD = &Smoother->Current2D.Y;
+	Lanes[2].DesireD = &Smoother->Desire2D.Y;
+	Lanes[2].VelocityD = &Smoother->Velocity2D.Y;
+
+	return AddHandle(Smoother, &Smoother->HalfLife, ELaneModel::Spring, Lanes);
+}
+
+
+void UHalfLifeSmoothingSubsystem::UnregisterSmoother(FHalfLifeSmootherHandle& Handle)
+{
+	if (!IsHandleValid(Handle))
+	{
+		Handle = FHalfLifeSmootherHandle{};
+		return;
+	}
+
+	DetachLanes(Handle.Id);
+	const int32 Serial = Handles[Handle.Id].Serial;
+	Handles[Handle.Id] = FHandleEntry{};
+	Handles[Handle.Id].Serial = Serial + 1;
+	FreeHandleIds.Add(Handle.Id);
+
+	Handle = FHalfLifeSmootherHandle{};
+}
+
+
+float UHalfLifeSmoothingSubsystem::GetSmoothedValue(FHalfLifeSmootherHandle Handle, int32 Lane) const
+{
+	if (!IsHandleValid(Handle)) return 0.f;
+
+	const FHandleEntry& Entry = Handles[Handle.Id];
+	if (Entry.GroupIndex == INDEX_NONE || !Entry.LaneIndices.IsValidIndex(Lane)) return 0.f;
+
+	return static_cast<float>(Groups[Entry.GroupIndex].Current[Entry.LaneIndices[Lane]]);
+}
+
+
+int32 UHalfLifeSmoothingSubsystem::GetNumActiveLanes() const
+{
+	int32 NumLanes = 0;
+	for (const FSmootherGroup& Group : Groups)
+	{
+		NumLanes += Group.Bindings.Num();
+	}
+	return NumLanes;
+}
+
+
+TStatId UHalfLifeSmoothingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHalfLifeSmoothingSubsystem, STATGROUP_Tickables);
+}
+
+
+bool UHalfLifeSmoothingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+void UHalfLifeSmoothingSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Move smoothers whose HalfLife was edited since the last pass (and drop dead owners).
+	for (int32 HandleId = 0; HandleId < Handles.Num(); ++HandleId)
+	{
+		FHandleEntry& Entry = Handles[HandleId];
+		if (!Entry.HalfLifeSource) continue;
+
+		if (!Entry.Owner.IsValid())
+		{
+			FHalfLifeSmootherHandle Stale;
+			Stale.Id = HandleId;
+			Stale.Serial = Entry.Serial;
+			UnregisterSmoother(Stale);
+			continue;
+		}
+
+		if (*Entry.HalfLifeSource != Groups[Entry.GroupIndex].HalfLife)
+		{
+			DetachLanes(HandleId);
+			AttachLanes(HandleId);
+		}
+	}
+
+	for (FSmootherGroup& Group : Groups)
+	{
+		if (Group.Bindings.Num() == 0) continue;
+
+		GatherGroup(Group);
+		AdvanceGroup(Group, DeltaTime);
+		ScatterGroup(Group);
+	}
+}
+
+
+FHalfLifeSmootherHandle UHalfLifeSmoothingSubsystem::AddHandle(UObject* Owner, const float* HalfLifeSource, ELaneModel Model, TArrayView<const FLaneBinding> Bindings)
+{
+	const int32 HandleId = FreeHandleIds.Num() > 0 ? FreeHandleIds.Pop(EAllowShrinking::No) : Handles.AddDefaulted();
+
+	FHandleEntry& Entry = Handles[HandleId];
+	Entry.Owner = Owner;
+	Entry.HalfLifeSource = HalfLifeSource;
+	Entry.Model = Model;
+	Entry.Bindings.Append(Bindings.GetData(), Bindings.Num());
+
+	AttachLanes(HandleId);
+
+	FHalfLifeSmootherHandle Handle;
+	Handle.Id = HandleId;
+	Handle.Serial = Entry.Serial;
+	return Handle;
+}
+
+
+bool UHalfLifeSmoothingSubsystem::IsHandleValid(const FHalfLifeSmootherHandle& Handle) const
+{
+	return Handles.IsValidIndex(Handle.Id) && Handles[Handle.Id].HalfLifeSource && Handles[Handle.Id].Serial == Handle.Serial;
+}
+
+
+void UHalfLifeSmoothingSubsystem::AttachLanes(int32 HandleId)
+{
+	FHandleEntry& Entry = Handles[HandleId];
+	Entry.GroupIndex = FindOrAddGroup(Entry.Model, *Entry.HalfLifeSource);
+	Entry.LaneIndices.Reset();
+
+	FSmootherGroup& Group = Groups[Entry.GroupIndex];
+	for (int32 SubLane = 0; SubLane < Entry.Bindings.Num(); ++SubLane)
+	{
+		FLaneBinding Binding = Entry.Bindings[SubLane];
+		Binding.HandleId = HandleId;
+		Binding.SubLane = SubLane;
+
+		Entry.LaneIndices.Add(Group.Bindings.Add(Binding));
+		Group.Current.Add(0.0);
+		Group.Desire.Add(0.0);
+		Group.Velocity.Add(0.0);
+		Group.MinValue.Add(-UE_DOUBLE_BIG_NUMBER);
+		Group.MaxValue.Add(UE_DOUBLE_BIG_NUMBER);
+	}
+}
+
+
+void UHalfLifeSmoothingSubsystem::DetachLanes(int32 HandleId)
+{
+	FHandleEntry& Entry = Handles[HandleId];
+	if (Entry.GroupIndex == INDEX_NONE) return;
+
+	FSmootherGroup& Group = Groups[Entry.GroupIndex];
+
+	// Remove from the highest lane down so earlier indices of this handle stay valid.
+	TArray<int32, TInlineAllocator<3>> Lanes = Entry.LaneIndices;
+	Lanes.Sort(TGreater<int32>());
+
+	for (const int32 Lane : Lanes)
+	{
+		const int32 Last = Group.Bindings.Num() - 1;
+
+		Group.Bindings.RemoveAtSwap(Lane, 1, EAllowShrinking::No);
+		Group.Current.RemoveAtSwap(Lane, 1, EAllowShrinking::No);
+		Group.Desire.RemoveAtSwap(Lane, 1, EAllowShrinking::No);
+		Group.Velocity.RemoveAtSwap(Lane, 1, EAllowShrinking::No);
+		Group.MinValue.RemoveAtSwap(Lane, 1, EAllowShrinking::No);
+		Group.MaxValue.RemoveAtSwap(Lane, 1, EAllowShrinking::No);
+
+		// Fix up the handle of the lane that was swapped into the hole.
+		if (Lane != Last)
+		{
+			const FLaneBinding& Moved = Group.Bindings[Lane];
+			Handles[Moved.HandleId].LaneIndices[Moved.SubLane] = Lane;
+		}
+	}
+
+	const int32 GroupIndex = Entry.GroupIndex;
+	Entry.LaneIndices.Reset();
+	Entry.GroupIndex = INDEX_NONE;
+
+	if (Group.Bindings.Num() == 0)
+	{
+		RemoveGroup(GroupIndex);
+	}
+}
+
+
+void UHalfLifeSmoothingSubsystem::RemoveGroup(int32 GroupIndex)
+{
+	const int32 Last = Groups.Num() - 1;
+	Groups.RemoveAtSwap(GroupIndex, 1, EAllowShrinking::No);
+
+	// Repoint the handles of the group that was swapped into the hole.
+	if (GroupIndex != Last)
+	{
+		for (const FLaneBinding& Binding : Groups[GroupIndex].Bindings)
+		{
+			Handles[Binding.HandleId].GroupIndex = GroupIndex;
+		}
+	}
+}
+
+
+int32 UHalfLifeSmoothingSubsystem::FindOrAddGroup(ELaneModel Model, float HalfLife)
+{
+	// Only a handful of distinct half-lives exist in practice; a linear scan beats hashing here.
+	const int32 Existing = Groups.IndexOfByPredicate([Model, HalfLife](const FSmootherGroup& Group)
+	{
+		return Group.Model == Model && Group.HalfLife == HalfLife;
+	});
+	if (Existing != INDEX_NONE) return Existing;
+
+	FSmootherGroup& Group = Groups.AddDefaulted_GetRef();
+	Group.Model = Model;
+	Group.HalfLife = HalfLife;
+	return Groups.Num() - 1;
+}
+
+
+void UHalfLifeSmoothingSubsystem::GatherGroup(FSmootherGroup& Group)
+{
+	const int32 NumLanes = Group.Bindings.Num();
+	for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+	{
+		const FLaneBinding& B = Group.Bindings[Lane];
+		Group.Current[Lane] = B.CurrentF ? static_cast<double>(*B.CurrentF) : *B.CurrentD;
+		Group.Desire[Lane] = B.DesireF ? static_cast<double>(*B.DesireF) : *B.DesireD;
+
+		if (B.VelocityF || B.VelocityD)
+		{
+			Group.Velocity[Lane] = B.VelocityF ? static_cast<double>(*B.VelocityF) : *B.VelocityD;
+		}
+
+		if (B.ClampEnabled && *B.ClampEnabled)
+		{
+			Group.MinValue[Lane] = *B.ClampMin;
+			Group.MaxValue[Lane] = *B.ClampMax;
+
+			// Same pre-clamp as UHalfLifeSmootherComponent::Update.
+			Group.Desire[Lane] = FMath::Clamp(Group.Desire[Lane], Group.MinValue[Lane], Group.MaxValue[Lane]);
+			Group.Current[Lane] = FMath::Clamp(Group.Current[Lane], Group.MinValue[Lane], Group.MaxValue[Lane]);
+		}
+		else
+		{
+			Group.MinValue[Lane] = -UE_DOUBLE_BIG_NUMBER;
+			Group.MaxValue[Lane] = UE_DOUBLE_BIG_NUMBER;
+		}
+	}
+}
+
+
+void UHalfLifeSmoothingSubsystem::AdvanceGroup(FSmootherGroup& Group, float DeltaTime)
+{
+	const int32 NumLanes = Group.Bindings.Num();
+	const int32 NumVectorLanes = NumLanes & ~3;
+
+	double* RESTRICT Current = Group.Current.GetData();
+	double* RESTRICT Velocity = Group.Velocity.GetData();
+	const double* RESTRICT Desire = Group.Desire.GetData();
+	const double* RESTRICT MinValue = Group.MinValue.GetData();
+	const double* RESTRICT MaxValue = Group.MaxValue.GetData();
+
+	if (Group.Model == ELaneModel::Exp)
+	{
+		// Same result as SmoothingMath::ExpSmoothHL, with the decay computed once per group.
+		const double K = Group.HalfLife <= SMALL_NUMBER
+			? 0.0
+			: FMath::Exp(-(SmoothingMath::Ln2 / Group.HalfLife) * FMath::Max(0.f, DeltaTime));
+		const VectorRegister4Double KV = MakeVectorRegisterDouble(K, K, K, K);
+
+		for (int32 Lane = 0; Lane < NumVectorLanes; Lane += 4)
+		{
+			const VectorRegister4Double D = VectorLoad(Desire + Lane);
+			VectorRegister4Double C = VectorLoad(Current + Lane);
+			C = VectorMultiplyAdd(VectorSubtract(C, D), KV, D);
+			C = VectorMin(VectorMax(C, VectorLoad(MinValue + Lane)), VectorLoad(MaxValue + Lane));
+			VectorStore(C, Current + Lane);
+		}
+		for (int32 Lane = NumVectorLanes; Lane < NumLanes; ++Lane)
+		{
+			const double C = Desire[Lane] + (Current[Lane] - Desire[Lane]) * K;
+			Current[Lane] = FMath::Clamp(C, MinValue[Lane], MaxValue[Lane]);
+		}
+		return;
+	}
+
+	// Critically damped spring, see SmoothingMath::SpringUpdate1D.
+	if (Group.HalfLife <= 0.f)
+	{
+		for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+		{
+			Current[Lane] = Desire[Lane];
+			Velocity[Lane] = 0.0;
+		}
+		return;
+	}
+
+	const double W = SmoothingMath::Ln2 / Group.HalfLife;
+	const double Dt = DeltaTime;
+	const double E = FMath::Exp(-W * Dt);
+
+	const VectorRegister4Double WV = MakeVectorRegisterDouble(W, W, W, W);
+	const VectorRegister4Double DtV = MakeVectorRegisterDouble(Dt, Dt, Dt, Dt);
+	const VectorRegister4Double EV = MakeVectorRegisterDouble(E, E, E, E);
+	const VectorRegister4Double WDtV = MakeVectorRegisterDouble(W * Dt, W * Dt, W * Dt, W * Dt);
+
+	for (int32 Lane = 0; Lane < NumVectorLanes; Lane += 4)
+	{
+		const VectorRegister4Double D = VectorLoad(Desire + Lane);
+		const VectorRegister4Double V = VectorLoad(Velocity + Lane);
+		VectorRegister4Double Y = VectorSubtract(VectorLoad(Current + Lane), D);
+		const VectorRegister4Double J = VectorMultiplyAdd(WV, Y, V);
+
+		Y = VectorMultiply(VectorMultiplyAdd(J, DtV, Y), EV);
+		VectorStore(VectorMultiply(VectorNegateMultiplyAdd(J, WDtV, V), EV), Velocity + Lane);
+		VectorStore(VectorAdd(D, Y), Current + Lane);
+	}
+	for (int32 Lane = NumVectorLanes; Lane < NumLanes; ++Lane)
+	{
+		double Y = Current[Lane] - Desire[Lane];
+		const double J = Velocity[Lane] + W * Y;
+		Y = (Y + J * Dt) * E;
+		Velocity[Lane] = (Velocity[Lane] - W * J * Dt) * E;
+		Current[Lane] = Desire[Lane] + Y;
+	}
+}
+
+
+void UHalfLifeSmoothingSubsystem::ScatterGroup(const FSmootherGroup& Group)
+{
+	const int32 NumLanes = Group.Bindings.Num();
+	for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+	{
+		const FLaneBinding& B = Group.Bindings[Lane];
+
+		if (B.CurrentF) *B.CurrentF = static_cast<float>(Group.Current[Lane]);
+		else *B.CurrentD = Group.Current[Lane];
+
+		if (B.VelocityF) *B.VelocityF = static_cast<float>(Group.Velocity[Lane]);
+		else if (B.VelocityD) *B.VelocityD = Group.Velocity[Lane];
+
+		// Clamped smoothers also store their clamped Desire, like UHalfLifeSmootherComponent::Update.
+		if (B.ClampEnabled && *B.ClampEnabled) *B.DesireF = static_cast<float>(Group.Desire[Lane]);
+	}
+}
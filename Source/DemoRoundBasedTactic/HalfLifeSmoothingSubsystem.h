@@ -0,0 +1,160 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HalfLifeSmoothingSubsystem.generated.h"
+
+class UHalfLifeSmootherComponent;
+class UCameraMovement_ExpHalfLifeComponent;
+class UCameraMovement_SpringHalfLifeComponent;
+
+/** Handle to a smoother registered with UHalfLifeSmoothingSubsystem. */
+USTRUCT(BlueprintType)
+struct FHalfLifeSmootherHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Id = INDEX_NONE;
+
+	UPROPERTY()
+	int32 Serial = 0;
+
+	bool IsValid() const { return Id != INDEX_NONE; }
+};
+
+/**
+ * Opt-in batched tick manager for half-life smoothers.
+ *
+ * Instead of one Blueprint Update call per smoother per frame, registered smoothers
+ * are advanced together once per frame after actors have ticked. Every smoothed
+ * scalar becomes one lane in structure-of-arrays storage, grouped by model
+ * (exponential / critically damped spring) and HalfLife, so each group computes its
+ * decay coefficients once per DeltaTime and advances all lanes in one vectorized pass.
+ * 2D states simply occupy two lanes.
+ *
+ * The component properties stay authoritative: each pass reads Desire / Current
+ * (so Blueprint writes and Snap calls keep working) and writes the results back.
+ * Changing HalfLife at runtime moves the smoother to the matching group; groups are
+ * removed when their last lane leaves, so animating HalfLife does not accumulate them.
+ */
+UCLASS()
+class DEMOROUNDBASEDTACTIC_API UHalfLifeSmoothingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UHalfLifeSmoothingSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Register Smoother if it opted in with bUseBatchedUpdate. Shared by the smoother components' BeginPlay. */
+	template <typename SmootherType>
+	static void RegisterBatched(SmootherType* Smoother, FHalfLifeSmootherHandle& OutHandle)
+	{
+		if (!Smoother || !Smoother->bUseBatchedUpdate) return;
+		if (UHalfLifeSmoothingSubsystem* Batch = Get(Smoother))
+		{
+			OutHandle = Batch->RegisterSmoother(Smoother);
+		}
+	}
+
+	/** Counterpart of RegisterBatched for EndPlay; resets the handle. */
+	static void UnregisterBatched(const UObject* Smoother, FHalfLifeSmootherHandle& Handle);
+
+	FHalfLifeSmootherHandle RegisterSmoother(UHalfLifeSmootherComponent* Smoother);
+	FHalfLifeSmootherHandle RegisterSmoother(UCameraMovement_ExpHalfLifeComponent* Smoother);
+	FHalfLifeSmootherHandle RegisterSmoother(UCameraMovement_SpringHalfLifeComponent* Smoother);
+
+	/** Remove a smoother from the batch and reset the handle. */
+	void UnregisterSmoother(FHalfLifeSmootherHandle& Handle);
+
+	/**
+	 * Value of one lane after the last batched pass; 0 for a stale handle.
+	 * Lane 0 is the 1D value; for camera components lanes 1 and 2 are the 2D X and Y.
+	 * The components expose their handle through GetBatchHandle.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Smoothing|Batched")
+	float GetSmoothedValue(FHalfLifeSmootherHandle Handle, int32 Lane = 0) const;
+
+	/** Number of lanes advanced per frame (for profiling / debugging). */
+	UFUNCTION(BlueprintPure, Category = "Smoothing|Batched")
+	int32 GetNumActiveLanes() const;
+
+	// UTickableWorldSubsystem
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	enum class ELaneModel : uint8
+	{
+		Exp,
+		Spring
+	};
+
+	/** Where a lane's state lives on its component. Exactly one of the F / D pointer sets is used. */
+	struct FLaneBinding
+	{
+		float* CurrentF = nullptr;
+		float* DesireF = nullptr;
+		float* VelocityF = nullptr;
+
+		double* CurrentD = nullptr;
+		double* DesireD = nullptr;
+		double* VelocityD = nullptr;
+
+		/** Optional clamp settings (UHalfLifeSmootherComponent only). */
+		const bool* ClampEnabled = nullptr;
+		const float* ClampMin = nullptr;
+		const float* ClampMax = nullptr;
+
+		/** Owning handle and index of this lane inside it. */
+		int32 HandleId = INDEX_NONE;
+		int32 SubLane = 0;
+	};
+
+	/** All lanes of one model sharing one HalfLife, stored as structure of arrays. */
+	struct FSmootherGroup
+	{
+		ELaneModel Model = ELaneModel::Exp;
+		float HalfLife = 0.f;
+
+		TArray<double> Current;
+		TArray<double> Desire;
+		TArray<double> Velocity;
+		TArray<double> MinValue;
+		TArray<double> MaxValue;
+		TArray<FLaneBinding> Bindings;
+	};
+
+	struct FHandleEntry
+	{
+		TWeakObjectPtr<UObject> Owner;
+		const float* HalfLifeSource = nullptr;
+		ELaneModel Model = ELaneModel::Exp;
+		int32 GroupIndex = INDEX_NONE;
+		int32 Serial = 0;
+		TArray<int32, TInlineAllocator<3>> LaneIndices;
+
+		/** Lane bindings of the owner; copied into the group when (re)attached. */
+		TArray<FLaneBinding, TInlineAllocator<3>> Bindings;
+	};
+
+	FHalfLifeSmootherHandle AddHandle(UObject* Owner, const float* HalfLifeSource, ELaneModel Model, TArrayView<const FLaneBinding> Bindings);
+	void AttachLanes(int32 HandleId);
+	void DetachLanes(int32 HandleId);
+	int32 FindOrAddGroup(ELaneModel Model, float HalfLife);
+	void RemoveGroup(int32 GroupIndex);
+	bool IsHandleValid(const FHalfLifeSmootherHandle& Handle) const;
+
+	static void GatherGroup(FSmootherGroup& Group);
+	static void AdvanceGroup(FSmootherGroup& Group, float DeltaTime);
+	static void ScatterGroup(const FSmootherGroup& Group);
+
+	TArray<FSmootherGroup> Groups;
+	TArray<FHandleEntry> Handles;
+	TArray<int32> FreeHandleIds;
+};
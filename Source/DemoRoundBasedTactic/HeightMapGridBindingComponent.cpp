@@ -1,43 +1,15 @@
 #include "HeightMapGridBindingComponent.h"
+#include "GridHeightField.h"
+#include "GridLayers.h"
+#include "GridStats.h"
 
 #include "Engine/World.h"
 #include "GameFramework/Actor.h"
 
-// Anonymous namespace for a simple array-backed height provider implementation.
-namespace
-{
-    class FArrayGridHeightProvider final : public IGridHeightProvider
-    {
-    public:
-        FArrayGridHeightProvider(int32 InWidth,
-            int32 InHeight,
-            const TArray<float>& InCellHeights)
-            : Width(InWidth)
-            , Height(InHeight)
-            , CellHeights(InCellHeights) // copy into an internal buffer
-        {
-#if DO_CHECK
-            check(CellHeights.Num() == Width * Height);
-#endif
-        }
-
-        virtual float GetHeightAt(int32 GridX, int32 GridY) const override
-        {
-            const int32 Index = GridY * Width + GridX;
-#if DO_CHECK
-            check(Index >= 0 && Index < CellHeights.Num());
-#endif
-            return CellHeights[Index];
-        }
-
-    private:
-        int32 Width = 0;
-        int32 Height = 0;
-        TArray<float> CellHeights;
-    };
-}
+#include <atomic>
 
 UHeightMapGridBindingComponent::UHeightMapGridBindingComponent()
+    : HeightPublisher(MakeShared<FGridHeightSnapshotPublisher, ESPMode::ThreadSafe>())
 {
     PrimaryComponentTick.bCanEverTick = false;
 }
@@ -48,56 +20,161 @@ void UHeightMapGridBindingComponent::OnRegister()
 
     // Build an initial config whenever the component is registered.
     RebuildGridConfig();
+
+    if (UGridWorldSubsystem* Registry = UGridWorldSubsystem::Get(this))
+    {
+        GridHandle = Registry->RegisterGrid(this);
+    }
+}
+
+void UHeightMapGridBindingComponent::OnUnregister()
+{
+    if (UGridWorldSubsystem* Registry = UGridWorldSubsystem::Get(this))
+    {
+        Registry->UnregisterGrid(GridHandle);
+    }
+    GridHandle = FGridHandle{};
+
+    Super::OnUnregister();
+}
+
+namespace
+{
+    /** Process-wide source of FGridConfigVersion stamps. */
+    static int32 AllocateGridVersion()
+    {
+        static std::atomic<int32> NextVersion{ 1 };
+        return NextVersion.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static EGridConfigChange DiffGridConfigs(const FGridConfig& A, const FGridConfig& B)
+    {
+        EGridConfigChange Changes = EGridConfigChange::None;
+
+        if (A.Width != B.Width || A.Height != B.Height || A.Topology != B.Topology)
+        {
+            Changes |= EGridConfigChange::Dimensions;
+        }
+
+        if (!A.GridOrigin.Equals(B.GridOrigin, 0.0) ||
+            A.bUseRotation != B.bUseRotation ||
+            !A.GridRotation.Equals(B.GridRotation, 0.0) ||
+            !A.AxisX.Equals(B.AxisX, 0.0) ||
+            !A.AxisY.Equals(B.AxisY, 0.0) ||
+            A.CellSize != B.CellSize ||
+            A.DefaultEyeHeight != B.DefaultEyeHeight)
+        {
+            Changes |= EGridConfigChange::Frame;
+        }
+
+        return Changes;
+    }
 }
 
 void UHeightMapGridBindingComponent::RebuildGridConfig()
 {
+    GRID_QUERY_SCOPE(RebuildConfig);
+
+    const FGridConfig Previous = MoveTemp(GridConfig);
+    const uint32 PreviousHeightDataHash = HeightDataHash;
+
     // Reset to a clean config first.
     GridConfig = FGridConfig{};
+    HeightDataHash = 0;
 
-    if (!HeightMapAsset)
+    const bool bHasHeightData = BuildGridConfig();
+
+    EGridConfigChange Changes = DiffGridConfigs(Previous, GridConfig);
+    if (HeightDataHash != PreviousHeightDataHash ||
+        bHasHeightData != Previous.HeightProvider.IsValid() ||
+        (bHasHeightData && EnumHasAnyFlags(Changes, EGridConfigChange::Dimensions)))
     {
-        UE_LOG(LogTemp, Warning,
-            TEXT("HeightMapGridBindingComponent '%s' on '%s' has no HeightMapAsset set."),
-            *GetName(),
-            GetOwner() ? *GetOwner()->GetName() : TEXT("<no owner>"));
-        return;
+        // A reshaped grid reinterprets the same buffer, so treat it as new height data too.
+        Changes |= EGridConfigChange::HeightData;
     }
 
-    if (HeightMapAsset->Width <= 0 || HeightMapAsset->Height <= 0 ||
-        HeightMapAsset->CellHeights.Num() != HeightMapAsset->Width * HeightMapAsset->Height)
+    // Carry the previous stamps over and only bump the parts that changed.
+    GridConfig.Version = Previous.Version;
+    if (EnumHasAnyFlags(Changes, EGridConfigChange::Frame))
     {
-        UE_LOG(LogTemp, Warning,
-            TEXT("HeightMapGridBindingComponent '%s' has invalid HeightMapAsset '%s' (Width=%d, Height=%d, NumHeights=%d)."),
-            *GetName(),
-            *HeightMapAsset->GetName(),
+        GridConfig.Version.FrameVersion = AllocateGridVersion();
+    }
+    if (EnumHasAnyFlags(Changes, EGridConfigChange::Dimensions))
+    {
+        GridConfig.Version.DimensionsVersion = AllocateGridVersion();
+    }
+    if (EnumHasAnyFlags(Changes, EGridConfigChange::HeightData))
+    {
+        GridConfig.Version.HeightVersion = AllocateGridVersion();
+    }
+
+    // Height data: keep sharing the old immutable snapshot when nothing changed;
+    // otherwise publish a new one. Readers holding the old snapshot keep it alive.
+    if (!EnumHasAnyFlags(Changes, EGridConfigChange::HeightData))
+    {
+        GridConfig.HeightProvider = Previous.HeightProvider;
+        GridConfig.Layers = Previous.Layers;
+    }
+    else if (bHasHeightData)
+    {
+        FGridHeightSnapshotRef Snapshot = new FGridHeightSnapshot(
             HeightMapAsset->Width,
             HeightMapAsset->Height,
-            HeightMapAsset->CellHeights.Num());
+            HeightMapAsset->CellHeights,
+            GridConfig.Version.HeightVersion);
+
+        HeightPublisher->Publish(Snapshot);
+
+        // Inject a runtime height provider backed by the asset data.
+        GridConfig.HeightProvider = MakeShared<FArrayGridHeightProvider>(MoveTemp(Snapshot));
+        GridConfig.Layers = FGridLayerData::Create(HeightMapAsset->Width, HeightMapAsset->Height, HeightMapAsset->ExtraLayers);
+    }
+    else
+    {
+        HeightPublisher->Publish(nullptr);
+    }
+
+    if (Changes == EGridConfigChange::None)
+    {
         return;
     }
 
+    // Keep the world registry's cached bounds in sync before anyone reacts to the change.
+    if (UGridWorldSubsystem* Registry = UGridWorldSubsystem::Get(this))
+    {
+        Registry->RefreshGrid(GridHandle);
+    }
+
+    OnGridConfigChangedNative.Broadcast(this, Changes);
+    OnGridConfigChanged.Broadcast(this, static_cast<int32>(Changes));
+}
+
+FGridConfig UHeightMapGridBindingComponent::MakeGridFrame(int32 InWidth, int32 InHeight) const
+{
+    FGridConfig Frame;
+
     // Shape
-    GridConfig.Width = HeightMapAsset->Width;
-    GridConfig.Height = HeightMapAsset->Height;
-    GridConfig.CellSize = CellSize;
+    Frame.Width = InWidth;
+    Frame.Height = InHeight;
+    Frame.CellSize = CellSize;
+    Frame.Topology = Topology;
 
     // Position / orientation
-    GridConfig.bUseRotation = bUseRotation;
-    GridConfig.GridRotation = GridRotation;
+    Frame.bUseRotation = bUseRotation;
+    Frame.GridRotation = GridRotation;
 
 
     FVector BasisX;
     FVector BasisY;
 
-    if (GridConfig.bUseRotation)
+    if (Frame.bUseRotation)
     {
-        const FRotationMatrix R(GridConfig.GridRotation);
+        const FRotationMatrix R(Frame.GridRotation);
         BasisX = R.GetUnitAxis(EAxis::X);
         BasisY = R.GetUnitAxis(EAxis::Y);
 
-        GridConfig.AxisX = BasisX;
-        GridConfig.AxisY = BasisY;
+        Frame.AxisX = BasisX;
+        Frame.AxisY = BasisY;
     }
     else
     {
@@ -116,8 +193,8 @@ void UHeightMapGridBindingComponent::RebuildGridConfig()
             BasisY = FVector::RightVector;
         }
 
-        GridConfig.AxisX = BasisX;
-        GridConfig.AxisY = BasisY;
+        Frame.AxisX = BasisX;
+        Frame.AxisY = BasisY;
     }
 
     // --------------------------
@@ -125,20 +202,49 @@ void UHeightMapGridBindingComponent::RebuildGridConfig()
     // --------------------------
     const FVector MapCenterWS = GridOrigin; // 组件上的 GridOrigin 始终表示“整张地图的中心”
 
-    const float HalfSizeX = 0.5f * static_cast<float>(GridConfig.Width)  * GridConfig.CellSize;
-    const float HalfSizeY = 0.5f * static_cast<float>(GridConfig.Height) * GridConfig.CellSize;
+    const float HalfSizeX = 0.5f * static_cast<float>(Frame.Width)  * Frame.CellSize;
+    const float HalfSizeY = 0.5f * static_cast<float>(Frame.Height) * Frame.CellSize;
 
     // 这里得到的是“左下角角点”的世界坐标
-    GridConfig.GridOrigin = MapCenterWS - BasisX * HalfSizeX - BasisY * HalfSizeY;
+    Frame.GridOrigin = MapCenterWS - BasisX * HalfSizeX - BasisY * HalfSizeY;
+
+    return Frame;
+}
+
+bool UHeightMapGridBindingComponent::BuildGridConfig()
+{
+    if (!HeightMapAsset)
+    {
+        UE_LOG(LogTemp, Warning,
+            TEXT("HeightMapGridBindingComponent '%s' on '%s' has no HeightMapAsset set."),
+            *GetName(),
+            GetOwner() ? *GetOwner()->GetName() : TEXT("<no owner>"));
+        return false;
+    }
+
+    if (HeightMapAsset->Width <= 0 || HeightMapAsset->Height <= 0 ||
+        HeightMapAsset->CellHeights.Num() != HeightMapAsset->Width * HeightMapAsset->Height)
+    {
+        UE_LOG(LogTemp, Warning,
+            TEXT("HeightMapGridBindingComponent '%s' has invalid HeightMapAsset '%s' (Width=%d, Height=%d, NumHeights=%d)."),
+            *GetName(),
+            *HeightMapAsset->GetName(),
+            HeightMapAsset->Width,
+            HeightMapAsset->Height,
+            HeightMapAsset->CellHeights.Num());
+        return false;
+    }
+
+    GridConfig = MakeGridFrame(HeightMapAsset->Width, HeightMapAsset->Height);
 
     // --------------------------
     // 4. 高度配置
     // --------------------------
     GridConfig.DefaultEyeHeight = DefaultEyeHeight;
 
-    // Inject a runtime height provider backed by the asset data.
-    GridConfig.HeightProvider = MakeShared<FArrayGridHeightProvider>(
-        HeightMapAsset->Width,
-        HeightMapAsset->Height,
-        HeightMapAsset->CellHeights);
+    HeightDataHash = FCrc::MemCrc32(HeightMapAsset->CellHeights.GetData(), HeightMapAsset->CellHeights.Num() * sizeof(float));
+    HeightDataHash = FCrc::MemCrc32(HeightMapAsset->ExtraLayers.GetData(), HeightMapAsset->ExtraLayers.Num() * sizeof(FGridLayerSurface), HeightDataHash);
+
+    // The height provider itself is injected by RebuildGridConfig once the versions are known.
+    return true;
 }
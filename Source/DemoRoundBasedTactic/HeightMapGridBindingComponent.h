@@ -1,8 +1,18 @@
 #pragma once
 #include "GridTypes.h"
+#include "GridHeightField.h"
+#include "GridWorldSubsystem.h"
 #include "TerrainHeightMapAsset.h"
 #include "HeightMapGridBindingComponent.generated.h"
 
+class UHeightMapGridBindingComponent;
+
+/** Native notification: ChangedParts is never None. */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnGridConfigChangedNative, UHeightMapGridBindingComponent* /*Component*/, EGridConfigChange /*ChangedParts*/);
+
+/** Blueprint notification: ChangedParts is an EGridConfigChange bit mask. */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnGridConfigChanged, UHeightMapGridBindingComponent*, Component, int32, ChangedParts);
+
 
 /**
 * Scene component that owns a logical grid configuration and binds it to a height map asset.
@@ -35,6 +45,11 @@ public:
 	float CellSize = 100.f;
 
 
+	/** Cell shape and neighbourhood of the grid (square 4/8-connected or axial hex). */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid")
+	EGridTopology Topology = EGridTopology::Square4;
+
+
 	/** World-space centre of the whole grid map. */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid")
 	FVector GridOrigin = FVector::ZeroVector;
@@ -75,17 +90,88 @@ public:
 	FGridConfig GridConfig;
 
 
-	/** Rebuild the GridConfig from the current properties and HeightMapAsset. */
+	/**
+	* Broadcast after RebuildGridConfig when at least one part of the config changed.
+	* Caches that only depend on some parts (e.g. heights) can ignore unrelated changes.
+	*/
+	UPROPERTY(BlueprintAssignable, Category = "Grid")
+	FOnGridConfigChanged OnGridConfigChanged;
+
+
+	/** Native counterpart of OnGridConfigChanged. */
+	FOnGridConfigChangedNative OnGridConfigChangedNative;
+
+
+	/**
+	* Rebuild the GridConfig from the current properties and HeightMapAsset.
+	*
+	* Only the versions of the parts that actually changed (frame, dimensions, height data)
+	* are bumped, and the change delegates fire only if something changed.
+	*/
 	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Grid")
 	void RebuildGridConfig();
 
 
+	/**
+	* Shape and world frame (origin, axes, cell size, topology) this component gives a
+	* InWidth x InHeight grid, without any height data. Used by RebuildGridConfig and by
+	* the level height bake, so both always agree on where cells are.
+	*/
+	FGridConfig MakeGridFrame(int32 InWidth, int32 InHeight) const;
+
+
 	/** Blueprint-friendly accessor that returns a copy of the current grid config. */
 	UFUNCTION(BlueprintPure, Category = "Grid")
 	FGridConfig GetGridConfig() const { return GridConfig; }
 
 
+	/**
+	* Handle of this grid in the world's UGridWorldSubsystem.
+	* Prefer the handle-based subsystem queries over GetGridConfig in per-frame code: they do not copy the config.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Grid")
+	FGridHandle GetGridHandle() const { return GridHandle; }
+
+
+	/**
+	* Current immutable height snapshot, or null if the grid has no height data.
+	* Safe to call from any thread; hold the returned reference for the duration of a job.
+	*/
+	FGridHeightSnapshotRef AcquireHeightSnapshot() const { return HeightPublisher->Acquire(); }
+
+
+	/**
+	* Publication point for this grid's height snapshots. Hand it to async jobs that may
+	* outlive a rebuild and let them Acquire fresh data when they start.
+	*/
+	TSharedRef<FGridHeightSnapshotPublisher, ESPMode::ThreadSafe> GetHeightPublisher() const { return HeightPublisher; }
+
+
 protected:
 	// Called when the component is registered with the world (both in editor and at runtime).
 	virtual void OnRegister() override;
+
+	// Called when the component is unregistered; removes the grid from the world registry.
+	virtual void OnUnregister() override;
+
+
+private:
+	/**
+	* Fill GridConfig (except the height provider) from the current properties.
+	* GridConfig must be reset beforehand. Returns true if HeightMapAsset provides valid height data.
+	*/
+	bool BuildGridConfig();
+
+
+	/** Registry handle, valid while the component is registered with a world. */
+	UPROPERTY(Transient)
+	FGridHandle GridHandle;
+
+
+	/** CRC of the height data behind GridConfig.HeightProvider (0 when there is none). */
+	uint32 HeightDataHash = 0;
+
+
+	/** Outlives rebuilds; every height data change publishes a new snapshot here. */
+	TSharedRef<FGridHeightSnapshotPublisher, ESPMode::ThreadSafe> HeightPublisher;
 };
\ No newline at end of file
@@ -5,27 +5,19 @@
 #include "GameFramework/SpringArmComponent.h"
 #include "Camera/CameraComponent.h"
 #include "Math/UnrealMathUtility.h"
-
-
-static FORCEINLINE float ExpSmoothHL_Internal(float Current, float Target, float HalfLife, float dt)
-{
-	if (HalfLife <= SMALL_NUMBER) return Target; // zero/near‑zero T → snap
-	const float Lambda = 0.6931471805599453f / HalfLife; // ln(2)/T
-	const float OneMinusS = 1.f - FMath::Exp(-Lambda * FMath::Max(0.f, dt));
-	return Current + (Target - Current) * OneMinusS;
-}
+#include "SmoothingMath.h"
 
 
 float USmoothingBlueprintLibrary::ExpSmoothingHL(float Current, float Target, float HalfLife, float DeltaTime)
 {
-	return ExpSmoothHL_Internal(Current, Target, HalfLife, DeltaTime);
+	return SmoothingMath::ExpSmoothHL(Current, Target, HalfLife, DeltaTime);
 }
 
 
 float USmoothingBlueprintLibrary::SmoothSpringArmLength(USpringArmComponent* SpringArm, float TargetLength, float HalfLife, float DeltaTime)
 {
 	if (!SpringArm) return TargetLength;
-	const float Smoothed = ExpSmoothHL_Internal(SpringArm->TargetArmLength, TargetLength, HalfLife, DeltaTime);
+	const float Smoothed = SmoothingMath::ExpSmoothHL(SpringArm->TargetArmLength, TargetLength, HalfLife, DeltaTime);
 	SpringArm->TargetArmLength = Smoothed;
 	return Smoothed;
 }
@@ -34,7 +26,33 @@ float USmoothingBlueprintLibrary::SmoothSpringArmLength(USpringArmComponent* Spr
 float USmoothingBlueprintLibrary::SmoothCameraFOV(UCameraComponent* Camera, float TargetFOV, float HalfLife, float DeltaTime)
 {
 	if (!Camera) return TargetFOV;
-	const float Smoothed = ExpSmoothHL_Internal(Camera->FieldOfView, TargetFOV, HalfLife, DeltaTime);
+	const float Smoothed = SmoothingMath::ExpSmoothHL(Camera->FieldOfView, TargetFOV, HalfLife, DeltaTime);
 	Camera->SetFieldOfView(Smoothed);
 	return Smoothed;
-}
\ No newline at end of file
+}
+
+
+FVector USmoothingBlueprintLibrary::ExpSmoothingVectorHL(const FVector& Current, const FVector& Target, const FVector& TargetVelocity, float HalfLife, float DeltaTime)
+{
+	return SmoothingMath::ExpSmoothExact(Current, Target, TargetVelocity, HalfLife, DeltaTime);
+}
+
+
+FRotator USmoothingBlueprintLibrary::ExpSmoothingRotatorHL(const FRotator& Current, const FRotator& Target, float HalfLife, float DeltaTime)
+{
+	return SmoothingMath::ExpSmoothRotator(Current, Target, HalfLife, DeltaTime);
+}
+
+
+FVector USmoothingBlueprintLibrary::SpringSmoothingVectorHL(FVector& Current, FVector& Velocity, const FVector& Target, const FVector& TargetVelocity, float HalfLife, float DeltaTime)
+{
+	SmoothingMath::SpringUpdateExact(HalfLife, DeltaTime, Target, TargetVelocity, Current, Velocity);
+	return Current;
+}
+
+
+FRotator USmoothingBlueprintLibrary::SpringSmoothingRotatorHL(FRotator& Current, FVector& AngularVelocity, const FRotator& Target, float HalfLife, float DeltaTime)
+{
+	SmoothingMath::SpringUpdateRotator(HalfLife, DeltaTime, Target, Current, AngularVelocity);
+	return Current;
+}
@@ -27,4 +27,24 @@ public:
 	// Convenience: smooth and set Camera->FieldOfView, returns the new value
 	UFUNCTION(BlueprintCallable, Category = "Smoothing|HalfLife")
 	static float SmoothCameraFOV(class UCameraComponent* Camera, float TargetFOV, float HalfLife, float DeltaTime);
+
+
+	// Exact: smooths all three axes toward a target moving with TargetVelocity; frame-rate independent
+	UFUNCTION(BlueprintPure, Category = "Smoothing|HalfLife", meta = (DisplayName = "Exp Smoothing Vector (Half-Life)"))
+	static FVector ExpSmoothingVectorHL(const FVector& Current, const FVector& Target, const FVector& TargetVelocity, float HalfLife, float DeltaTime);
+
+
+	// Exact: smooths each rotator axis along its shortest arc
+	UFUNCTION(BlueprintPure, Category = "Smoothing|HalfLife", meta = (DisplayName = "Exp Smoothing Rotator (Half-Life)"))
+	static FRotator ExpSmoothingRotatorHL(const FRotator& Current, const FRotator& Target, float HalfLife, float DeltaTime);
+
+
+	// Exact critically damped spring on a vector; Current / Velocity are the caller's state, returns the new Current
+	UFUNCTION(BlueprintCallable, Category = "Smoothing|HalfLife", meta = (DisplayName = "Spring Smoothing Vector (Half-Life)"))
+	static FVector SpringSmoothingVectorHL(UPARAM(ref) FVector& Current, UPARAM(ref) FVector& Velocity, const FVector& Target, const FVector& TargetVelocity, float HalfLife, float DeltaTime);
+
+
+	// Exact critically damped spring on a rotation (integrated on quaternions), returns the new Current
+	UFUNCTION(BlueprintCallable, Category = "Smoothing|HalfLife", meta = (DisplayName = "Spring Smoothing Rotator (Half-Life)"))
+	static FRotator SpringSmoothingRotatorHL(UPARAM(ref) FRotator& Current, UPARAM(ref) FVector& AngularVelocity, const FRotator& Target, float HalfLife, float DeltaTime);
 };
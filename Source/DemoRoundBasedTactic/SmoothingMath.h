@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Shared half-life smoothing math used by the smoothing components, the stateless
+ * Blueprint library and the batched smoothing subsystem.
+ * All functions are stateless; callers own Current / Velocity.
+ */
+namespace SmoothingMath
+{
+	/** ln(2): converts a half-life T into a decay rate ln(2)/T. */
+	inline constexpr float Ln2 = 0.6931471805599453f;
+
+	/** Decay coefficient for the given half-life and step: the error is multiplied by this value. */
+	static FORCEINLINE float HalfLifeDecayK(float HalfLife, float Dt)
+	{
+		if (HalfLife <= 0.f) return 0.f; // snap to target in one step
+		return FMath::Pow(0.5f, Dt / HalfLife);
+	}
+
+	/** Exponential smoothing of Current toward Desire with half-life T (negative steps are ignored). */
+	static FORCEINLINE float ExpSmoothHL(float Current, float Desire, float HalfLife, float Dt)
+	{
+		if (HalfLife <= SMALL_NUMBER) return Desire; // zero/near-zero T -> snap
+		const float Lambda = Ln2 / HalfLife; // ln(2)/T
+		const float OneMinusS = 1.f - FMath::Exp(-Lambda * FMath::Max(0.f, Dt));
+		return Current + (Desire - Current) * OneMinusS;
+	}
+
+	/** Advance a critically damped spring (1D) for one step. The target is treated as constant during the step. */
+	static FORCEINLINE void SpringUpdate1D(float HalfLife, float Dt, float Desire, float& Current, float& Velocity)
+	{
+		if (HalfLife <= 0.f)
+		{
+			Current = Desire; Velocity = 0.f; return;
+		}
+		const float W = Ln2 / HalfLife;
+		const float E = FMath::Exp(-W * Dt);
+		float y = Current - Desire;
+		const float j = Velocity + W * y;
+		y = (y + j * Dt) * E;
+		Velocity = (Velocity - W * j * Dt) * E;
+		Current = Desire + y;
+	}
+
+	/** Advance a critically damped spring (2D) for one step. Each component is updated independently. */
+	static FORCEINLINE void SpringUpdate2D(float HalfLife, float Dt, const FVector2D& Desire, FVector2D& Current, FVector2D& Velocity)
+	{
+		if (HalfLife <= 0.f)
+		{
+			Current = Desire; Velocity = FVector2D::ZeroVector; return;
+		}
+		const float W = Ln2 / HalfLife;
+		const float E = FMath::Exp(-W * Dt);
+		FVector2D y = Current - Desire;
+		const FVector2D j = Velocity + y * W;
+		y = (y + j * Dt) * E;
+		Velocity = (Velocity - j * (W * Dt)) * E;
+		Current = Desire + y;
+	}
+
+	/*
+	 * Exact ("closed-form") variants.
+	 *
+	 * The target moves linearly during the step: it starts at Desire and moves with DesireVelocity.
+	 * Both the exponential and the spring ODEs are integrated analytically under that assumption, so
+	 * for piecewise-linear targets one large step gives the same result as any number of small ones
+	 * and the outcome no longer depends on how frame time was split (hitches, replays).
+	 * With DesireVelocity = 0 they reduce to ExpSmoothHL / SpringUpdate1D / SpringUpdate2D.
+	 *
+	 * T is float, FVector2D or FVector; the vector variants advance every axis in one call.
+	 */
+
+	/** Exact exponential smoothing toward a linearly moving target. Returns Current after Dt. */
+	template <typename T>
+	static FORCEINLINE T ExpSmoothExact(const T& Current, const T& Desire, const T& DesireVelocity, float HalfLife, float Dt)
+	{
+		Dt = FMath::Max(0.f, Dt);
+		const T DesireEnd = Desire + DesireVelocity * Dt;
+		if (HalfLife <= SMALL_NUMBER) return DesireEnd;
+
+		// e' = -L e - v  =>  e(t) = (e0 + v/L) K - v/L, with e = Current - Desire(t).
+		const float Lambda = Ln2 / HalfLife;
+		const float K = FMath::Exp(-Lambda * Dt);
+		const T Lag = DesireVelocity * (1.f / Lambda);
+		return DesireEnd + (Current - Desire + Lag) * K - Lag;
+	}
+
+	/** Exact critically damped spring toward a linearly moving target. */
+	template <typename T>
+	static FORCEINLINE void SpringUpdateExact(float HalfLife, float Dt, const T& Desire, const T& DesireVelocity, T& Current, T& Velocity)
+	{
+		Dt = FMath::Max(0.f, Dt);
+		const T DesireEnd = Desire + DesireVelocity * Dt;
+		if (HalfLife <= 0.f)
+		{
+			Current = DesireEnd; Velocity = DesireVelocity; return;
+		}
+
+		// The error relative to the moving target obeys the constant-target spring equation.
+		const float W = Ln2 / HalfLife;
+		const float E = FMath::Exp(-W * Dt);
+		const T y = Current - Desire;
+		const T v = Velocity - DesireVelocity;
+		const T j = v + y * W;
+		Current = DesireEnd + (y + j * Dt) * E;
+		Velocity = DesireVelocity + (v - j * (W * Dt)) * E;
+	}
+
+	/** Exact exponential smoothing of a rotation along the shortest arc (constant target). */
+	static FORCEINLINE FQuat ExpSmoothQuat(const FQuat& Current, const FQuat& Desire, float HalfLife, float Dt)
+	{
+		const float K = HalfLifeDecayK(HalfLife, FMath::Max(0.f, Dt));
+		return FQuat::Slerp(Current, Desire, 1.f - K);
+	}
+
+	/**
+	 * Exact critically damped spring on rotations (constant target).
+	 * AngularVelocity is a world-space rotation vector rate (axis * radians per second).
+	 */
+	static FORCEINLINE void SpringUpdateQuat(float HalfLife, float Dt, const FQuat& Desire, FQuat& Current, FVector& AngularVelocity)
+	{
+		if (HalfLife <= 0.f)
+		{
+			Current = Desire; AngularVelocity = FVector::ZeroVector; return;
+		}
+		Dt = FMath::Max(0.f, Dt);
+
+		// Error as a rotation vector on the shortest arc, then the vector spring solution.
+		FQuat Diff = Current * Desire.Inverse();
+		if (Diff.W < 0.f) Diff *= -1.f;
+		const FVector y = Diff.ToRotationVector();
+
+		const float W = Ln2 / HalfLife;
+		const float E = FMath::Exp(-W * Dt);
+		const FVector j = AngularVelocity + y * W;
+		Current = FQuat::MakeFromRotationVector((y + j * Dt) * E) * Desire;
+		Current.Normalize();
+		AngularVelocity = (AngularVelocity - j * (W * Dt)) * E;
+	}
+
+	/** Exact exponential smoothing of each rotator axis along its shortest arc (constant target). */
+	static FORCEINLINE FRotator ExpSmoothRotator(const FRotator& Current, const FRotator& Desire, float HalfLife, float Dt)
+	{
+		const float OneMinusK = 1.f - HalfLifeDecayK(HalfLife, FMath::Max(0.f, Dt));
+		return FRotator(
+			FRotator::NormalizeAxis(Current.Pitch + FMath::FindDeltaAngleDegrees(Current.Pitch, Desire.Pitch) * OneMinusK),
+			FRotator::NormalizeAxis(Current.Yaw + FMath::FindDeltaAngleDegrees(Current.Yaw, Desire.Yaw) * OneMinusK),
+			FRotator::NormalizeAxis(Current.Roll + FMath::FindDeltaAngleDegrees(Current.Roll, Desire.Roll) * OneMinusK));
+	}
+
+	/** Critically damped spring on a rotator, integrated on quaternions (see SpringUpdateQuat). */
+	static FORCEINLINE void SpringUpdateRotator(float HalfLife, float Dt, const FRotator& Desire, FRotator& Current, FVector& AngularVelocity)
+	{
+		FQuat Q = Current.Quaternion();
+		SpringUpdateQuat(HalfLife, Dt, Desire.Quaternion(), Q, AngularVelocity);
+		Current = Q.Rotator();
+	}
+}
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+#include "SmoothingMath.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SmoothingMathTests
+{
+	/** Ways to cut the same 1 s of time into frames; each must give the result of a single 1 s step. */
+	static TArray<TArray<float>> MakeStepSplits()
+	{
+		TArray<TArray<float>> Splits;
+		Splits.Add({ 0.5f, 0.5f });
+		Splits.Add({ 0.1f, 0.25f, 0.05f, 0.6f });
+		Splits.Add({ 0.9f, 0.01f, 0.01f, 0.08f });
+
+		TArray<float>& Fine = Splits.AddDefaulted_GetRef();
+		Fine.Init(0.01f, 100);
+		return Splits;
+	}
+
+	static constexpr float TotalTime = 1.f;
+	static constexpr float HalfLife = 0.3f;
+	static constexpr double Tolerance = 1.e-3;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSmoothingMathStepInvarianceTest, "DemoRoundBasedTactic.Smoothing.StepInvariance",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FSmoothingMathStepInvarianceTest::RunTest(const FString& Parameters)
+{
+	using namespace SmoothingMathTests;
+
+	// Target moving linearly for the whole second; every frame starts from Desire at that time.
+	const FVector Desire(10.f, -20.f, 5.f);
+	const FVector DesireVelocity(5.f, 3.f, -1.f);
+	const FVector StartVelocity(3.f, 0.f, 0.f);
+	const FQuat QuatDesire(FRotator(20.f, 150.f, -10.f));
+
+	const FVector ExpOnce = SmoothingMath::ExpSmoothExact(FVector::ZeroVector, Desire, DesireVelocity, HalfLife, TotalTime);
+
+	FVector SpringOnce = FVector::ZeroVector;
+	FVector SpringOnceVelocity = StartVelocity;
+	SmoothingMath::SpringUpdateExact(HalfLife, TotalTime, Desire, DesireVelocity, SpringOnce, SpringOnceVelocity);
+
+	float Spring1DOnce = 0.f;
+	float Spring1DOnceVelocity = 0.f;
+	SmoothingMath::SpringUpdate1D(HalfLife, TotalTime, Desire.X, Spring1DOnce, Spring1DOnceVelocity);
+
+	FQuat QuatOnce = FQuat::Identity;
+	FVector QuatOnceVelocity = FVector::ZeroVector;
+	SmoothingMath::SpringUpdateQuat(HalfLife, TotalTime, QuatDesire, QuatOnce, QuatOnceVelocity);
+
+	for (const TArray<float>& Split : MakeStepSplits())
+	{
+		FVector Exp = FVector::ZeroVector;
+		FVector Spring = FVector::ZeroVector;
+		FVector SpringVelocity = StartVelocity;
+		float Spring1D = 0.f;
+		float Spring1DVelocity = 0.f;
+		FQuat Quat = FQuat::Identity;
+		FVector QuatVelocity = FVector::ZeroVector;
+
+		float Time = 0.f;
+		for (const float Dt : Split)
+		{
+			const FVector FrameDesire = Desire + DesireVelocity * Time;
+			Exp = SmoothingMath::ExpSmoothExact(Exp, FrameDesire, DesireVelocity, HalfLife, Dt);
+			SmoothingMath::SpringUpdateExact(HalfLife, Dt, FrameDesire, DesireVelocity, Spring, SpringVelocity);
+			SmoothingMath::SpringUpdate1D(HalfLife, Dt, Desire.X, Spring1D, Spring1DVelocity);
+			SmoothingMath::SpringUpdateQuat(HalfLife, Dt, QuatDesire, Quat, QuatVelocity);
+			Time += Dt;
+		}
+
+		const FString Steps = FString::Printf(TEXT("%d steps"), Split.Num());
+		TestTrue(FString::Printf(TEXT("ExpSmoothExact, %s"), *Steps), FVector::Dist(Exp, ExpOnce) <= Tolerance);
+		TestTrue(FString::Printf(TEXT("SpringUpdateExact position, %s"), *Steps), FVector::Dist(Spring, SpringOnce) <= Tolerance);
+		TestTrue(FString::Printf(TEXT("SpringUpdateExact velocity, %s"), *Steps), FVector::Dist(SpringVelocity, SpringOnceVelocity) <= Tolerance);
+		TestTrue(FString::Printf(TEXT("SpringUpdate1D, %s"), *Steps), FMath::Abs(Spring1D - Spring1DOnce) <= Tolerance);
+		TestTrue(FString::Printf(TEXT("SpringUpdateQuat, %s"), *Steps), FMath::RadiansToDegrees(QuatOnce.AngularDistance(Quat)) <= Tolerance);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
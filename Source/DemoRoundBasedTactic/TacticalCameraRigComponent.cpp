@@ -0,0 +1,191 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TacticalCameraRigComponent.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "Camera/CameraComponent.h"
+#include "GridGeometryLibrary.h"
+#include "HeightMapGridBindingComponent.h"
+#include "SmoothingMath.h"
+
+
+UTacticalCameraRigComponent::UTacticalCameraRigComponent()
+{
+	// Evaluate after the pawn has consumed input, so desired values set this frame are used this frame.
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+
+void UTacticalCameraRigComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	AActor* Owner = GetOwner();
+	if (!SpringArm) SpringArm = Owner->FindComponentByClass<USpringArmComponent>();
+	if (!Camera) Camera = Owner->FindComponentByClass<UCameraComponent>();
+
+	// Start from whatever the level placed, so the first frames do not swing.
+	CurrentPan = FVector2D(Owner->GetActorLocation());
+	PanVelocity = FVector2D::ZeroVector;
+	if (SpringArm)
+	{
+		CurrentZoom = SpringArm->TargetArmLength;
+		CurrentYaw = SpringArm->GetRelativeRotation().Yaw;
+	}
+	if (Camera)
+	{
+		CurrentFOV = Camera->FieldOfView;
+	}
+	DesiredPan = CurrentPan;
+	DesiredZoom = CurrentZoom;
+	DesiredYaw = CurrentYaw;
+	DesiredFOV = CurrentFOV;
+
+	if (bAutoBindGrid && !BoundGrid.IsSet())
+	{
+		if (const UGridWorldSubsystem* Grids = UGridWorldSubsystem::Get(this))
+		{
+			BoundGrid = Grids->FindGridAtLocation(Owner->GetActorLocation());
+		}
+	}
+	bHasGridBounds = false;
+}
+
+
+void UTacticalCameraRigComponent::BindToGrid(UHeightMapGridBindingComponent* GridComponent)
+{
+	BoundGrid = GridComponent ? GridComponent->GetGridHandle() : FGridHandle{};
+	bHasGridBounds = false;
+}
+
+
+FVector UTacticalCameraRigComponent::GetPanDirection(const FVector2D& InputXY) const
+{
+	// Yaw-only basis without building a rotation matrix: Forward = (C, S), Right = (-S, C).
+	float S, C;
+	FMath::SinCos(&S, &C, FMath::DegreesToRadians(CurrentYaw));
+	return FVector(C * InputXY.Y - S * InputXY.X, S * InputXY.Y + C * InputXY.X, 0.f);
+}
+
+
+void UTacticalCameraRigComponent::AddPanInput(const FVector2D& InputXY, float Distance)
+{
+	DesiredPan += FVector2D(GetPanDirection(InputXY)) * Distance;
+}
+
+
+void UTacticalCameraRigComponent::UpdateGridBounds()
+{
+	const UGridWorldSubsystem* Grids = BoundGrid.IsSet() ? UGridWorldSubsystem::Get(this) : nullptr;
+	const FGridConfig* Config = Grids ? Grids->GetGridConfig(BoundGrid) : nullptr;
+	if (!Config || Config->Width <= 0 || Config->Height <= 0)
+	{
+		bHasGridBounds = false;
+		return;
+	}
+
+	// Pan bounds only depend on the frame and the dimensions; height edits keep the cache.
+	const EGridConfigChange Relevant = EGridConfigChange::Frame | EGridConfigChange::Dimensions;
+	if (bHasGridBounds && !EnumHasAnyFlags(Config->Version.Diff(GridBoundsVersion), Relevant))
+	{
+		return;
+	}
+
+	UGridGeometryLibrary::GetGridAxes(*Config, GridAxisX, GridAxisY);
+	GridOrigin = Config->GridOrigin;
+
+	// Corner cell centres in grid-plane coordinates cover every topology (the hex rhombus included).
+	GridLocalBounds = FBox2D(ForceInit);
+	const FIntPoint Corners[4] =
+	{
+		FIntPoint(0, 0),
+		FIntPoint(Config->Width - 1, 0),
+		FIntPoint(0, Config->Height - 1),
+		FIntPoint(Config->Width - 1, Config->Height - 1)
+	};
+	for (const FIntPoint& Corner : Corners)
+	{
+		const FVector Offset = UGridGeometryLibrary::GridToWorldGround(*Config, Corner) - GridOrigin;
+		GridLocalBounds += FVector2D(FVector::DotProduct(Offset, GridAxisX), FVector::DotProduct(Offset, GridAxisY));
+	}
+	GridLocalBounds = GridLocalBounds.ExpandBy(0.5f * Config->CellSize);
+
+	GridBoundsVersion = Config->Version;
+	bHasGridBounds = true;
+}
+
+
+void UTacticalCameraRigComponent::ClampDesired()
+{
+	DesiredZoom = FMath::Clamp(DesiredZoom, MinZoom, MaxZoom);
+	DesiredFOV = FMath::Clamp(DesiredFOV, MinFOV, MaxFOV);
+	DesiredYaw = FRotator::NormalizeAxis(DesiredYaw);
+
+	UpdateGridBounds();
+	if (!bHasGridBounds)
+	{
+		return;
+	}
+
+	const FVector Offset = FVector(DesiredPan, GridOrigin.Z) - GridOrigin;
+	FVector2D Local(FVector::DotProduct(Offset, GridAxisX), FVector::DotProduct(Offset, GridAxisY));
+
+	// A negative margin larger than half the grid collapses to the centre instead of inverting.
+	const FBox2D Bounds = GridLocalBounds.ExpandBy(FMath::Max(GridBoundsMargin, -0.5f * GridLocalBounds.GetSize().GetMin()));
+	Local.X = FMath::Clamp(Local.X, Bounds.Min.X, Bounds.Max.X);
+	Local.Y = FMath::Clamp(Local.Y, Bounds.Min.Y, Bounds.Max.Y);
+
+	DesiredPan = FVector2D(GridOrigin + GridAxisX * Local.X + GridAxisY * Local.Y);
+}
+
+
+void UTacticalCameraRigComponent::ApplyToTargets() const
+{
+	AActor* Owner = GetOwner();
+	const FVector Location = Owner->GetActorLocation();
+	Owner->SetActorLocation(FVector(CurrentPan, Location.Z));
+
+	if (SpringArm)
+	{
+		SpringArm->TargetArmLength = CurrentZoom;
+		FRotator Rotation = SpringArm->GetRelativeRotation();
+		Rotation.Yaw = CurrentYaw;
+		SpringArm->SetRelativeRotation(Rotation);
+	}
+	if (Camera)
+	{
+		Camera->SetFieldOfView(CurrentFOV);
+	}
+}
+
+
+void UTacticalCameraRigComponent::SnapToDesired()
+{
+	ClampDesired();
+	CurrentPan = DesiredPan;
+	PanVelocity = FVector2D::ZeroVector;
+	CurrentZoom = DesiredZoom;
+	CurrentYaw = DesiredYaw;
+	CurrentFOV = DesiredFOV;
+	ApplyToTargets();
+}
+
+
+void UTacticalCameraRigComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	ClampDesired();
+
+	SmoothingMath::SpringUpdate2D(PanHalfLife, DeltaTime, DesiredPan, CurrentPan, PanVelocity);
+	CurrentZoom = SmoothingMath::ExpSmoothHL(CurrentZoom, DesiredZoom, ZoomHalfLife, DeltaTime);
+	CurrentFOV = SmoothingMath::ExpSmoothHL(CurrentFOV, DesiredFOV, FovHalfLife, DeltaTime);
+
+	// Smooth the shortest signed arc so that crossing +-180 never spins the long way round.
+	const float YawError = FMath::FindDeltaAngleDegrees(CurrentYaw, DesiredYaw);
+	CurrentYaw = FRotator::NormalizeAxis(DesiredYaw - SmoothingMath::ExpSmoothHL(YawError, 0.f, YawHalfLife, DeltaTime));
+
+	ApplyToTargets();
+}
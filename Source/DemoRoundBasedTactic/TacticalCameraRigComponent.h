@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "GridTypes.h"
+#include "GridWorldSubsystem.h"
+#include "TacticalCameraRigComponent.generated.h"
+
+class USpringArmComponent;
+class UCameraComponent;
+class UHeightMapGridBindingComponent;
+
+/**
+ * Native tactical camera rig: owns the pan, zoom, yaw and FOV channels of a top-down camera
+ * and evaluates all of them in a single tick.
+ *
+ * Blueprints only feed desired values (AddPanInput / AddZoomInput / AddYawInput / SetDesired*).
+ * Each tick the rig clamps the desired pan to the bound grid, advances the channels
+ * (pan: critically damped spring, zoom / yaw / FOV: exponential half-life) and writes the
+ * results to the owner location, the spring arm (length + yaw) and the camera FOV.
+ *
+ * Replaces per-frame chains of SmoothSpringArmLength / SmoothCameraFOV /
+ * ComputeMoveDir_FromRotator nodes and separate smoother components.
+ */
+UCLASS(ClassGroup = (Camera), BlueprintType, meta = (BlueprintSpawnableComponent))
+class DEMOROUNDBASEDTACTIC_API UTacticalCameraRigComponent : public UActorComponent
+{
+	GENERATED_BODY()
+public:
+	UTacticalCameraRigComponent();
+
+	/** Spring arm driven by the zoom and yaw channels. Found on the owner at BeginPlay if unset. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Targets")
+	USpringArmComponent* SpringArm = nullptr;
+
+	/** Camera driven by the FOV channel. Found on the owner at BeginPlay if unset. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Targets")
+	UCameraComponent* Camera = nullptr;
+
+	/** Pan response (critically damped spring), in seconds. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Params")
+	float PanHalfLife = 0.2f;
+
+	/** Zoom response (exponential), in seconds. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Params")
+	float ZoomHalfLife = 0.15f;
+
+	/** Yaw response (exponential, shortest arc), in seconds. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Params")
+	float YawHalfLife = 0.1f;
+
+	/** FOV response (exponential), in seconds. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Params")
+	float FovHalfLife = 0.2f;
+
+	/** Spring arm length range. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Limits")
+	float MinZoom = 600.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Limits")
+	float MaxZoom = 3000.f;
+
+	/** Field of view range, in degrees. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Limits")
+	float MinFOV = 30.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Limits")
+	float MaxFOV = 90.f;
+
+	/**
+	 * Extra distance (world units) the pan target may leave the bound grid's outer cell edges.
+	 * Negative values keep the focus further inside the grid.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Limits")
+	float GridBoundsMargin = 0.f;
+
+	/** If true and no grid is bound at BeginPlay, bind to the grid underneath the owner. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Grid")
+	bool bAutoBindGrid = true;
+
+	/** Desired focus point on the ground plane (world XY). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Desired")
+	FVector2D DesiredPan = FVector2D::ZeroVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Desired")
+	float DesiredZoom = 1500.f;
+
+	/** Desired yaw in degrees; may be unwound (e.g. 370), the rig always turns the short way. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Desired")
+	float DesiredYaw = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rig|Desired")
+	float DesiredFOV = 60.f;
+
+	/** Current smoothed focus point (world XY). */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Rig|Current")
+	FVector2D CurrentPan = FVector2D::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Rig|Current")
+	FVector2D PanVelocity = FVector2D::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Rig|Current")
+	float CurrentZoom = 1500.f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Rig|Current")
+	float CurrentYaw = 0.f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Rig|Current")
+	float CurrentFOV = 60.f;
+
+	/**
+	 * Move the desired focus along the camera's yaw-only basis (X = Right, Y = Forward).
+	 * Distance is in world units; scale by DeltaTime for continuous input.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Rig|Input")
+	void AddPanInput(const FVector2D& InputXY, float Distance);
+
+	/** Add to the desired arm length (positive zooms out). */
+	UFUNCTION(BlueprintCallable, Category = "Rig|Input")
+	void AddZoomInput(float Delta) { DesiredZoom += Delta; }
+
+	/** Add to the desired yaw, in degrees. */
+	UFUNCTION(BlueprintCallable, Category = "Rig|Input")
+	void AddYawInput(float DeltaDegrees) { DesiredYaw += DeltaDegrees; }
+
+	/** Focus on a world location (only XY is used). */
+	UFUNCTION(BlueprintCallable, Category = "Rig|Input")
+	void SetDesiredFocus(const FVector& WorldLocation) { DesiredPan = FVector2D(WorldLocation); }
+
+	/** Instantly move every channel to its (clamped) desired value and apply it. */
+	UFUNCTION(BlueprintCallable, Category = "Rig|Utilities")
+	void SnapToDesired();
+
+	/** Bind the rig to a grid; pan is clamped to its bounds. Passing null unbinds. */
+	UFUNCTION(BlueprintCallable, Category = "Rig|Grid")
+	void BindToGrid(UHeightMapGridBindingComponent* GridComponent);
+
+	UFUNCTION(BlueprintPure, Category = "Rig|Grid")
+	FGridHandle GetBoundGrid() const { return BoundGrid; }
+
+	/** World-space direction for a 2D input on the current (smoothed) yaw-only basis. */
+	UFUNCTION(BlueprintPure, Category = "Rig|Input")
+	FVector GetPanDirection(const FVector2D& InputXY) const;
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	/** Clamp the desired values to the configured limits and the bound grid. */
+	void ClampDesired();
+
+	/** Refresh the cached grid-space bounds if the bound grid's frame or dimensions changed. */
+	void UpdateGridBounds();
+
+	/** Write the current channel values to the owner, spring arm and camera. */
+	void ApplyToTargets() const;
+
+	FGridHandle BoundGrid;
+
+	/** Cached pan bounds in grid-plane coordinates (relative to GridOrigin, along the grid axes). */
+	FBox2D GridLocalBounds = FBox2D(ForceInit);
+	FVector GridOrigin = FVector::ZeroVector;
+	FVector GridAxisX = FVector::ForwardVector;
+	FVector GridAxisY = FVector::RightVector;
+	FGridConfigVersion GridBoundsVersion;
+	bool bHasGridBounds = false;
+};
@@ -1,17 +1,294 @@
 ﻿#include "TerrainHeightMapAsset.h"
+#include "GridStats.h"
+#include "HeightMapGridBindingComponent.h"
 
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "AssetToolsModule.h"
 #include "Engine/Texture.h"              // FTextureSource, TSF_G16
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
 #include "IAssetTools.h"
 #include "Misc/PackageName.h"
 #include "UObject/Package.h"
 #include "UObject/SavePackage.h"
 
+namespace
+{
+    /**
+     * Read one channel of mip 0 of a texture source, one value per texel in row-major
+     * order. 8-bit channels are returned as 0..255, 16-bit channels as 0..65535;
+     * grayscale sources return the same value for every channel.
+     */
+    static bool ReadTextureChannel(FTextureSource& Source, EGridTextureChannel Channel, TArray<uint16>& OutSamples)
+    {
+        const ETextureSourceFormat Format = Source.GetFormat();
+        if (Format != TSF_G8 && Format != TSF_G16 && Format != TSF_BGRA8 && Format != TSF_RGBA16)
+        {
+            return false;
+        }
+
+        const uint8* RawData = Source.LockMipReadOnly(0);
+        if (!RawData)
+        {
+            return false;
+        }
+
+        const int32 NumTexels = Source.GetSizeX() * Source.GetSizeY();
+        OutSamples.SetNumUninitialized(NumTexels);
+
+        // BGRA8 stores bytes as B, G, R, A; RGBA16 stores words as R, G, B, A.
+        static constexpr int32 BGRA8Offsets[4] = { 2, 1, 0, 3 };
+        const int32 ChannelIndex = static_cast<int32>(Channel);
+
+        for (int32 Index = 0; Index < NumTexels; ++Index)
+        {
+            switch (Format)
+            {
+            case TSF_G8:
+                OutSamples[Index] = RawData[Index];
+                break;
+            case TSF_G16:
+                OutSamples[Index] = reinterpret_cast<const uint16*>(RawData)[Index];
+                break;
+            case TSF_BGRA8:
+                OutSamples[Index] = RawData[Index * 4 + BGRA8Offsets[ChannelIndex]];
+                break;
+            default:
+                OutSamples[Index] = reinterpret_cast<const uint16*>(RawData)[Index * 4 + ChannelIndex];
+                break;
+            }
+        }
+
+        Source.UnlockMip(0);
+        return true;
+    }
+
+    static void SaveAssetPackage(UPackage* Package, UObject* Asset, const TCHAR* Context)
+    {
+        const FString PackageName = Package->GetName();
+        const FString FilePath = FPackageName::LongPackageNameToFilename(
+            PackageName,
+            FPackageName::GetAssetPackageExtension()
+        );
+
+        FSavePackageArgs SaveArgs;
+        SaveArgs.TopLevelFlags         = RF_Public | RF_Standalone;
+        SaveArgs.Error                 = GError;
+        SaveArgs.bWarnOfLongFilename   = false;
+
+        const bool bSuccess = UPackage::SavePackage(Package, Asset, *FilePath, SaveArgs);
+        if (!bSuccess)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("%s: Failed to save package '%s' to '%s'."), Context, *PackageName, *FilePath);
+        }
+    }
+
+    static FORCEINLINE uint32 GetValueMask(int32 BitsPerValue)
+    {
+        return BitsPerValue >= 32 ? MAX_uint32 : (1u << BitsPerValue) - 1;
+    }
+
+    /** Value Index of a packed channel; Index must lie inside its words. */
+    static FORCEINLINE uint32 ReadPackedValue(const FGridPackedAttributeChannel& Packed, int32 Index)
+    {
+        const int64 Bit = int64(Index) * Packed.BitsPerValue;
+        return (Packed.Words[Bit >> 5] >> (Bit & 31)) & GetValueMask(Packed.BitsPerValue);
+    }
+
+    /** Store Value (clamped to the bit width) as value Index of a packed channel. */
+    static FORCEINLINE void WritePackedValue(FGridPackedAttributeChannel& Packed, int32 Index, uint32 Value)
+    {
+        const uint32 Mask = GetValueMask(Packed.BitsPerValue);
+        const int64 Bit = int64(Index) * Packed.BitsPerValue;
+        uint32& Word = Packed.Words[Bit >> 5];
+        const int32 Shift = int32(Bit & 31);
+        Word = (Word & ~(Mask << Shift)) | (FMath::Min(Value, Mask) << Shift);
+    }
+
+    /** Create an empty height map asset in a new uniquely named package under FolderPath. */
+    static UTerrainHeightMapAsset* CreateHeightMapAsset(const FString& FolderPath, const FString& BaseName, const TCHAR* Context)
+    {
+        // Use AssetTools to create a unique package + asset name.
+        FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools");
+
+        FString PackageName;
+        FString AssetName;
+        AssetToolsModule.Get().CreateUniqueAssetName(
+            FolderPath / BaseName,
+            TEXT(""),
+            PackageName,
+            AssetName
+        );
+
+        UPackage* Package = CreatePackage(*PackageName);
+        if (!Package)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("%s: Failed to create package '%s'."), Context, *PackageName);
+            return nullptr;
+        }
+
+        // Create the asset object inside the package.
+        UTerrainHeightMapAsset* NewAsset = NewObject<UTerrainHeightMapAsset>(
+            Package,
+            *AssetName,
+            RF_Public | RF_Standalone
+        );
+
+        if (!NewAsset)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("%s: Failed to create UTerrainHeightMapAsset in package '%s'."), Context, *PackageName);
+            return nullptr;
+        }
+
+        return NewAsset;
+    }
+}
+
+void UTerrainHeightMapAsset::RebuildAttributeChannels()
+{
+    const int32 NumCells = FMath::Max(Width, 0) * FMath::Max(Height, 0);
+
+    TArray<FGridPackedAttributeChannel> Previous = MoveTemp(AttributeChannels);
+
+    // Channels saved before the data carried a name were stored in schema order.
+    for (int32 Channel = 0; Channel < Previous.Num() && Channel < AttributeSchema.Num(); ++Channel)
+    {
+        FGridPackedAttributeChannel& Legacy = Previous[Channel];
+        if (Legacy.Name.IsNone() && Legacy.Width == 0 && Legacy.Height == 0 &&
+            Legacy.Words.Num() == FGridPackedAttributeChannel::GetNumWords(NumCells, Legacy.BitsPerValue))
+        {
+            Legacy.Name = AttributeSchema[Channel].Name;
+            Legacy.Width = Width;
+            Legacy.Height = Height;
+            Legacy.DefaultValue = AttributeSchema[Channel].DefaultValue;
+        }
+    }
+
+    AttributeChannels.SetNum(AttributeSchema.Num());
+    for (int32 Channel = 0; Channel < AttributeSchema.Num(); ++Channel)
+    {
+        const FGridAttributeChannelDesc& Desc = AttributeSchema[Channel];
+        const int32 Bits = Desc.GetStoredBits();
+
+        FGridPackedAttributeChannel* Old = Previous.FindByPredicate([&Desc](const FGridPackedAttributeChannel& Packed)
+        {
+            return !Packed.Name.IsNone() && Packed.Name == Desc.Name;
+        });
+
+        // Values are only meaningful on the grid they were stored for.
+        const bool bSameCells = Old && Old->Width == Width && Old->Height == Height && Old->BitsPerValue > 0 &&
+            Old->Words.Num() == FGridPackedAttributeChannel::GetNumWords(NumCells, Old->BitsPerValue);
+
+        FGridPackedAttributeChannel& Packed = AttributeChannels[Channel];
+        if (bSameCells && Old->BitsPerValue == Bits && Old->DefaultValue == Desc.DefaultValue)
+        {
+            Packed = MoveTemp(*Old);
+            Old->Name = NAME_None;
+            continue;
+        }
+
+        Packed = FGridPackedAttributeChannel();
+        Packed.Name = Desc.Name;
+        Packed.Width = Width;
+        Packed.Height = Height;
+        Packed.DefaultValue = Desc.DefaultValue;
+        Packed.BitsPerValue = Bits;
+        Packed.Words.SetNumZeroed(FGridPackedAttributeChannel::GetNumWords(NumCells, Bits));
+
+        for (int32 Index = 0; Index < NumCells; ++Index)
+        {
+            uint32 Value = uint32(Desc.DefaultValue);
+            if (bSameCells)
+            {
+                const uint32 OldValue = ReadPackedValue(*Old, Index);
+                Value = OldValue == uint32(Old->DefaultValue) ? Value : OldValue;
+            }
+            if (Value != 0)
+            {
+                WritePackedValue(Packed, Index, Value);
+            }
+        }
+
+        if (Old)
+        {
+            Old->Name = NAME_None;
+        }
+    }
+}
+
+int32 UTerrainHeightMapAsset::FindAttributeChannel(FName Name) const
+{
+    return AttributeSchema.IndexOfByPredicate([Name](const FGridAttributeChannelDesc& Desc) { return Desc.Name == Name; });
+}
+
+FGridAttributeView UTerrainHeightMapAsset::GetAttributeView(int32 Channel) const
+{
+    const int32 NumCells = Width * Height;
+    if (!AttributeChannels.IsValidIndex(Channel) || !AttributeSchema.IsValidIndex(Channel) ||
+        AttributeChannels[Channel].Words.Num() < FGridPackedAttributeChannel::GetNumWords(NumCells, AttributeChannels[Channel].BitsPerValue))
+    {
+        return FGridAttributeView();
+    }
+    return FGridAttributeView(AttributeChannels[Channel], AttributeSchema[Channel], NumCells);
+}
+
+void UTerrainHeightMapAsset::SetAttribute(int32 Channel, int32 X, int32 Y, uint32 Value)
+{
+    if (!AttributeChannels.IsValidIndex(Channel) || X < 0 || Y < 0 || X >= Width || Y >= Height)
+    {
+        return;
+    }
+
+    FGridPackedAttributeChannel& Packed = AttributeChannels[Channel];
+    const int32 Index = Y * Width + X;
+    if (Packed.BitsPerValue <= 0 || ((int64(Index) * Packed.BitsPerValue) >> 5) >= Packed.Words.Num())
+    {
+        return;
+    }
+    WritePackedValue(Packed, Index, Value);
+}
+
+int32 UTerrainHeightMapAsset::GetAttributeValue(FName Channel, FIntPoint Cell) const
+{
+    const FGridAttributeView View = GetAttributeView(FindAttributeChannel(Channel));
+    if (!View.IsValid() || Cell.X < 0 || Cell.Y < 0 || Cell.X >= Width || Cell.Y >= Height)
+    {
+        return 0;
+    }
+    return int32(View[Cell.Y * Width + Cell.X]);
+}
+
+float UTerrainHeightMapAsset::GetAttributeFloat(FName Channel, FIntPoint Cell) const
+{
+    const FGridAttributeView View = GetAttributeView(FindAttributeChannel(Channel));
+    if (!View.IsValid() || Cell.X < 0 || Cell.Y < 0 || Cell.X >= Width || Cell.Y >= Height)
+    {
+        return 0.f;
+    }
+    return View.GetFloat(Cell.Y * Width + Cell.X);
+}
+
+#if WITH_EDITOR
+void UTerrainHeightMapAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    const FName PropertyName = PropertyChangedEvent.GetMemberPropertyName();
+    if (PropertyName == GET_MEMBER_NAME_CHECKED(UTerrainHeightMapAsset, AttributeSchema) ||
+        PropertyName == GET_MEMBER_NAME_CHECKED(UTerrainHeightMapAsset, Width) ||
+        PropertyName == GET_MEMBER_NAME_CHECKED(UTerrainHeightMapAsset, Height))
+    {
+        RebuildAttributeChannels();
+    }
+}
+#endif
+
 UTerrainHeightMapAsset* UTerrainHeightMapLibrary::CreateHeightMapAssetFromTexture(
     TSoftObjectPtr<UTexture2D> HeightTexture,
     float WorldZScale)
 {
+    GRID_QUERY_SCOPE(HeightMapImport);
+
     // Resolve the texture from the soft reference.
     UTexture2D* Texture = HeightTexture.LoadSynchronous();
     if (!Texture)
@@ -41,36 +318,23 @@ UTerrainHeightMapAsset* UTerrainHeightMapLibrary::CreateHeightMapAssetFromTextur
         return nullptr;
     }
 
-    // Access raw 16-bit grayscale data from mip 0.
-    const uint8* RawData = Source.LockMipReadOnly(0);
-    if (!RawData)
+    // Copy and convert to world-space float heights.
+    TArray<uint16> Samples;
+    if (!ReadTextureChannel(Source, EGridTextureChannel::R, Samples))
     {
         UE_LOG(LogTemp, Warning, TEXT("CreateHeightMapAssetFromTexture: Failed to lock texture mip 0."));
         return nullptr;
     }
 
-    // Copy and convert to world-space float heights.
     TArray<float> CellHeights;
     CellHeights.SetNumUninitialized(Width * Height);
 
-    const uint16* Pixels = reinterpret_cast<const uint16*>(RawData);
-
-    for (int32 Y = 0; Y < Height; ++Y)
+    for (int32 Index = 0; Index < Samples.Num(); ++Index)
     {
-        for (int32 X = 0; X < Width; ++X)
-        {
-            const int32 Index   = Y * Width + X;
-            const uint16 Sample = Pixels[Index];
-
-            const float Normalized = static_cast<float>(Sample) / 65535.0f; // [0,1]
-            const float WorldZ     = Normalized * WorldZScale;
-
-            CellHeights[Index] = WorldZ;
-        }
+        const float Normalized = static_cast<float>(Samples[Index]) / 65535.0f; // [0,1]
+        CellHeights[Index] = Normalized * WorldZScale;
     }
 
-    Source.UnlockMip(0);
-
     // Derive folder and base asset name from the texture's package and asset name.
     const FString SourcePackageName = Texture->GetOutermost()->GetName(); // e.g. "/Game/Terrain/HeightMaps/T_Height_S42_256x256"
     const FString FolderPath        = FPackageName::GetLongPackagePath(SourcePackageName); // e.g. "/Game/Terrain/HeightMaps"
@@ -83,37 +347,12 @@ UTerrainHeightMapAsset* UTerrainHeightMapLibrary::CreateHeightMapAssetFromTextur
         return nullptr;
     }
 
-    // Use AssetTools to create a unique package + asset name.
-    FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools");
-
-    FString PackageName;
-    FString AssetName;
-    AssetToolsModule.Get().CreateUniqueAssetName(
-        FolderPath / BaseName,
-        TEXT(""),
-        PackageName,
-        AssetName
-    );
-
-    UPackage* Package = CreatePackage(*PackageName);
-    if (!Package)
-    {
-        UE_LOG(LogTemp, Warning, TEXT("CreateHeightMapAssetFromTexture: Failed to create package '%s'."), *PackageName);
-        return nullptr;
-    }
-
-    // Create the asset object inside the package.
-    UTerrainHeightMapAsset* NewAsset = NewObject<UTerrainHeightMapAsset>(
-        Package,
-        *AssetName,
-        RF_Public | RF_Standalone
-    );
-
+    UTerrainHeightMapAsset* NewAsset = CreateHeightMapAsset(FolderPath, BaseName, TEXT("CreateHeightMapAssetFromTexture"));
     if (!NewAsset)
     {
-        UE_LOG(LogTemp, Warning, TEXT("CreateHeightMapAssetFromTexture: Failed to create UTerrainHeightMapAsset in package '%s'."), *PackageName);
         return nullptr;
     }
+    UPackage* Package = NewAsset->GetOutermost();
 
     // Fill asset data.
     NewAsset->Width       = Width;
@@ -125,21 +364,133 @@ UTerrainHeightMapAsset* UTerrainHeightMapLibrary::CreateHeightMapAssetFromTextur
     Package->MarkPackageDirty();
 
     // Save the package immediately so that the .uasset appears on disk.
-    const FString FilePath = FPackageName::LongPackageNameToFilename(
-        PackageName,
-        FPackageName::GetAssetPackageExtension()
-    );
+    SaveAssetPackage(Package, NewAsset, TEXT("CreateHeightMapAssetFromTexture"));
 
-    FSavePackageArgs SaveArgs;
-    SaveArgs.TopLevelFlags         = RF_Public | RF_Standalone;
-    SaveArgs.Error                 = GError;
-    SaveArgs.bWarnOfLongFilename   = false;
+    return NewAsset;
+}
+
+bool UTerrainHeightMapLibrary::ImportAttributeChannelsFromTexture(
+    UTerrainHeightMapAsset* Asset,
+    TSoftObjectPtr<UTexture2D> AttributeTexture,
+    const TArray<FGridAttributeChannelImport>& Channels)
+{
+    GRID_QUERY_SCOPE(HeightMapImport);
 
-    const bool bSuccess = UPackage::SavePackage(Package, NewAsset, *FilePath, SaveArgs);
-    if (!bSuccess)
+    UTexture2D* Texture = AttributeTexture.LoadSynchronous();
+    if (!Asset || !Texture)
     {
-        UE_LOG(LogTemp, Warning, TEXT("CreateHeightMapAssetFromTexture: Failed to save package '%s' to '%s'."), *PackageName, *FilePath);
+        UE_LOG(LogTemp, Warning, TEXT("ImportAttributeChannelsFromTexture: Asset or AttributeTexture is null."));
+        return false;
     }
 
-    return NewAsset;
+    FTextureSource& Source = Texture->Source;
+    if (!Source.IsValid() || Source.GetSizeX() != Asset->Width || Source.GetSizeY() != Asset->Height)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ImportAttributeChannelsFromTexture: Texture source is invalid or not %dx%d."), Asset->Width, Asset->Height);
+        return false;
+    }
+
+    Asset->RebuildAttributeChannels();
+
+    int32 NumImported = 0;
+    TArray<uint16> Samples;
+    for (const FGridAttributeChannelImport& Import : Channels)
+    {
+        const int32 Channel = Asset->FindAttributeChannel(Import.Channel);
+        if (Channel == INDEX_NONE)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ImportAttributeChannelsFromTexture: Channel '%s' is not in the asset's schema."), *Import.Channel.ToString());
+            continue;
+        }
+
+        if (!ReadTextureChannel(Source, Import.SourceChannel, Samples))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ImportAttributeChannelsFromTexture: Texture source is not G8, G16, BGRA8 or RGBA16."));
+            return false;
+        }
+
+        for (int32 Index = 0; Index < Samples.Num(); ++Index)
+        {
+            Asset->SetAttribute(Channel, Index % Asset->Width, Index / Asset->Width, uint32(Samples[Index]) >> FMath::Clamp(Import.Shift, 0, 15));
+        }
+        ++NumImported;
+    }
+
+    if (NumImported == 0)
+    {
+        return false;
+    }
+
+    UPackage* Package = Asset->GetOutermost();
+    Package->MarkPackageDirty();
+    SaveAssetPackage(Package, Asset, TEXT("ImportAttributeChannelsFromTexture"));
+    return true;
+}
+
+UTerrainHeightMapAsset* UTerrainHeightMapLibrary::BakeHeightMapAssetFromLevel(
+    UHeightMapGridBindingComponent* Binding,
+    const FGridHeightBakeSettings& Settings)
+{
+    UWorld* World = Binding ? Binding->GetWorld() : nullptr;
+    if (!World)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("BakeHeightMapAssetFromLevel: Binding is null or not in a world."));
+        return nullptr;
+    }
+
+    UTerrainHeightMapAsset* Asset = Binding->HeightMapAsset;
+    const int32 Width = Asset && Asset->Width > 0 ? Asset->Width : Settings.Width;
+    const int32 Height = Asset && Asset->Height > 0 ? Asset->Height : Settings.Height;
+
+    FGridHeightBakeResult Result;
+    if (!GridHeightBake::BakeHeights(World, Binding->MakeGridFrame(Width, Height), Settings, Binding->GetOwner(), Result))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("BakeHeightMapAssetFromLevel: Invalid grid frame (%dx%d, CellSize %.1f)."), Width, Height, Binding->CellSize);
+        return nullptr;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("BakeHeightMapAssetFromLevel: %dx%d cells, %lld traces (%lld missed) in %.2f s."),
+        Width, Height, Result.NumTraces, Result.NumMisses, Result.Seconds);
+
+    if (!Asset)
+    {
+        const FString FolderPath = FPackageName::GetLongPackagePath(World->GetOutermost()->GetName());
+        const FString OwnerName = Binding->GetOwner() ? Binding->GetOwner()->GetName() : Binding->GetName();
+        Asset = CreateHeightMapAsset(FolderPath, FString::Printf(TEXT("DA_%s_Baked"), *OwnerName), TEXT("BakeHeightMapAssetFromLevel"));
+        if (!Asset)
+        {
+            return nullptr;
+        }
+        FAssetRegistryModule::AssetCreated(Asset);
+    }
+
+    Asset->Modify();
+    Asset->Width = Width;
+    Asset->Height = Height;
+    Asset->CellHeights = MoveTemp(Result.Heights);
+    Asset->RebuildAttributeChannels();
+
+    // A deck at or below the new ground, or off the grid, is no longer a surface above its cell.
+    const int32 NumStaleLayers = Asset->ExtraLayers.RemoveAll([Asset](const FGridLayerSurface& Surface)
+    {
+        return Surface.Cell.X < 0 || Surface.Cell.Y < 0 || Surface.Cell.X >= Asset->Width || Surface.Cell.Y >= Asset->Height ||
+            Surface.Height <= Asset->CellHeights[Surface.Cell.Y * Asset->Width + Surface.Cell.X];
+    });
+    if (NumStaleLayers > 0)
+    {
+        UE_LOG(LogTemp, Display, TEXT("BakeHeightMapAssetFromLevel: removed %d extra layers at or below the baked ground."), NumStaleLayers);
+    }
+
+    UPackage* Package = Asset->GetOutermost();
+    Package->MarkPackageDirty();
+    SaveAssetPackage(Package, Asset, TEXT("BakeHeightMapAssetFromLevel"));
+
+    if (Binding->HeightMapAsset != Asset)
+    {
+        Binding->Modify();
+        Binding->HeightMapAsset = Asset;
+    }
+    Binding->RebuildGridConfig();
+
+    return Asset;
 }
@@ -4,8 +4,13 @@
 #include "Engine/DataAsset.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Engine/Texture2D.h"
+#include "GridCellAttributes.h"
+#include "GridHeightBake.h"
+#include "GridLayers.h"
 #include "TerrainHeightMapAsset.generated.h"
 
+class UHeightMapGridBindingComponent;
+
 /**
  * Data asset that stores a height map decoded from a 16‑bit grayscale texture.
  *
@@ -38,6 +43,56 @@ public:
      */
     UPROPERTY(EditAnywhere, BlueprintReadOnly)
     TArray<float> CellHeights;
+
+    /**
+     * Walkable surfaces above the ground of some cells (bridge decks, upper floors),
+     * in world units like CellHeights. A cell may have several; they become layers
+     * 1, 2, ... of the cell in order of height. Leave empty for plain terrain.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    TArray<FGridLayerSurface> ExtraLayers;
+
+    /**
+     * Per-cell attribute channels (terrain type, cost multipliers, cover, blockers, ...).
+     * Each entry gets a bit-packed array parallel to CellHeights in AttributeChannels;
+     * call RebuildAttributeChannels after editing the schema from code.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly)
+    TArray<FGridAttributeChannelDesc> AttributeSchema;
+
+    /** Packed values of each AttributeSchema entry, same order, each tagged with its channel name. */
+    UPROPERTY()
+    TArray<FGridPackedAttributeChannel> AttributeChannels;
+
+    /**
+     * Match AttributeChannels to the schema and Width x Height. Data is matched to schema
+     * entries by name, so reordering, inserting or removing channels keeps the values of the
+     * others. After a size change the channel is reset to DefaultValue. A new bit width keeps
+     * the values, clamped to the new range. A new DefaultValue replaces the cells that still
+     * hold the old one.
+     */
+    void RebuildAttributeChannels();
+
+    /** Index of a schema channel, or INDEX_NONE. */
+    int32 FindAttributeChannel(FName Name) const;
+
+    /** Bulk view of a channel; invalid if Channel is out of range or not built. */
+    FGridAttributeView GetAttributeView(int32 Channel) const;
+
+    /** Store Value (clamped to the channel's bit width) at a cell. */
+    void SetAttribute(int32 Channel, int32 X, int32 Y, uint32 Value);
+
+    /** Raw attribute of a cell, or 0 if the channel or cell does not exist. */
+    UFUNCTION(BlueprintPure, Category = "Terrain|Attributes")
+    int32 GetAttributeValue(FName Channel, FIntPoint Cell) const;
+
+    /** Attribute of a cell as Value * Scale + Offset, or 0 if the channel or cell does not exist. */
+    UFUNCTION(BlueprintPure, Category = "Terrain|Attributes")
+    float GetAttributeFloat(FName Channel, FIntPoint Cell) const;
+
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 };
 
 /**
@@ -70,4 +125,37 @@ public:
         TSoftObjectPtr<UTexture2D> HeightTexture,
         float WorldZScale
     );
+
+    /**
+     * Fill attribute channels of an existing height map asset from the colour channels of
+     * a texture of the same size (G8, G16, BGRA8 or RGBA16 source). Channels missing from
+     * the asset's schema are skipped with a warning. The asset package is saved.
+     *
+     * @return True if at least one channel was imported.
+     */
+    UFUNCTION(BlueprintCallable, CallInEditor, Category = "Terrain|HeightMap")
+    static bool ImportAttributeChannelsFromTexture(
+        UTerrainHeightMapAsset* Asset,
+        TSoftObjectPtr<UTexture2D> AttributeTexture,
+        const TArray<FGridAttributeChannelImport>& Channels
+    );
+
+    /**
+     * Bake CellHeights from the level geometry under a grid binding component.
+     *
+     * Cells are laid out by the component's frame (GridOrigin, axes, CellSize, Topology).
+     * They are sampled with GridHeightBake::BakeHeights and written into the component's
+     * HeightMapAsset, whose size is kept. Without a HeightMapAsset, a Settings.Width x
+     * Settings.Height asset is created next to the level and assigned to the component.
+     * The bake only finds the top surface, so authored ExtraLayers are kept, except
+     * surfaces that now lie at or below the baked ground of their cell.
+     * The asset package is saved and the component's grid config is rebuilt.
+     *
+     * @return The baked asset, or nullptr on failure.
+     */
+    UFUNCTION(BlueprintCallable, CallInEditor, Category = "Terrain|HeightMap")
+    static UTerrainHeightMapAsset* BakeHeightMapAssetFromLevel(
+        UHeightMapGridBindingComponent* Binding,
+        const FGridHeightBakeSettings& Settings
+    );
 };